@@ -1,6 +1,9 @@
 Debug = {
 	SendServerState = false
 }
+EditorSettings = {
+	UndoMemoryLimit = 256 -- In MiB, 0 means unlimited
+}
 Resources = {
 	FastDownloadURLs = [[
 https://burgwar.digitalpulse.software/resources
@@ -34,6 +34,7 @@ namespace bw
 			float GetFOV() const;
 			Nz::Vector2f GetPosition() const;
 			const Nz::Recti& GetViewport() const;
+			Nz::Rectf GetVisibleRect() const;
 			inline float GetZoomFactor() const;
 
 			inline bool IsPerspective() const;
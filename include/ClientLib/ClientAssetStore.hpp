@@ -8,29 +8,56 @@
 #define BURGWAR_CLIENTLIB_CLIENTASSETSTORE_HPP
 
 #include <CoreLib/AssetStore.hpp>
+#include <CoreLib/Utility/ThreadPool.hpp>
 #include <ClientLib/Export.hpp>
 #include <Nazara/Audio/SoundBuffer.hpp>
+#include <Nazara/Graphics/Material.hpp>
 #include <Nazara/Graphics/Model.hpp>
 #include <Nazara/Renderer/Texture.hpp>
+#include <Nazara/Utility/Image.hpp>
+#include <array>
+#include <future>
+#include <vector>
 
 namespace bw
 {
 	class BURGWAR_CLIENTLIB_API ClientAssetStore : public AssetStore
 	{
 		public:
-			using AssetStore::AssetStore;
+			ClientAssetStore(const Logger& logger, std::shared_ptr<VirtualDirectory> assetDirectory);
 			~ClientAssetStore() = default;
 
 			void Clear() override;
 
 			const Nz::ModelRef& GetModel(const std::string& modelPath) const;
 			const Nz::SoundBufferRef& GetSoundBuffer(const std::string& soundPath) const;
+			const Nz::MaterialRef& GetSpriteMaterial(const std::string& texturePath, bool repeatTexture = false) const;
 			const Nz::TextureRef& GetTexture(const std::string& texturePath) const;
+			const Nz::TextureRef& GetTextureAsync(const std::string& texturePath) const;
+
+			inline bool HasPendingLoads() const;
+
+			void Prefetch(const std::string& assetPath);
+			void PrefetchModel(const std::string& modelPath);
+			void PrefetchSoundBuffer(const std::string& soundPath);
+			void PrefetchTexture(const std::string& texturePath);
+
+			void UpdateLoading(Nz::UInt64 timeBudget);
+
+			static constexpr Nz::UInt64 AssetLoadingTimeBudget = 2000; //< in microseconds, per frame
 
 		private:
+			void FinishSoundBufferLoading(const std::string& soundPath, std::future<Nz::SoundBufferRef>& result) const;
+			void FinishTextureLoading(const std::string& texturePath, std::future<Nz::ImageRef>& result) const;
+
 			mutable tsl::hopscotch_map<std::string, Nz::ModelRef> m_models;
 			mutable tsl::hopscotch_map<std::string, Nz::SoundBufferRef> m_soundBuffers;
+			mutable std::array<tsl::hopscotch_map<std::string, Nz::MaterialRef>, 2> m_spriteMaterials; //< indexed by repeatTexture
 			mutable tsl::hopscotch_map<std::string, Nz::TextureRef> m_textures;
+			mutable tsl::hopscotch_map<std::string, std::future<Nz::SoundBufferRef>> m_pendingSoundBuffers;
+			mutable tsl::hopscotch_map<std::string, std::future<Nz::ImageRef>> m_pendingTextures;
+			std::vector<std::string> m_pendingModels;
+			mutable ThreadPool m_loadWorkers; //< Must be destroyed before pending loads
 	};
 }
 
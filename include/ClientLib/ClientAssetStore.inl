@@ -6,4 +6,8 @@
 
 namespace bw
 {
+	inline bool ClientAssetStore::HasPendingLoads() const
+	{
+		return !m_pendingModels.empty() || !m_pendingSoundBuffers.empty() || !m_pendingTextures.empty();
+	}
 }
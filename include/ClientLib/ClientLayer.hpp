@@ -55,6 +55,8 @@ namespace bw
 			ClientLayerEntity& RegisterEntity(ClientLayerEntity layerEntity);
 			ClientLayerSound& RegisterSound(ClientLayerSound layerEntity);
 
+			void SetVisibleRect(std::optional<Nz::Rectf> visibleRect);
+
 			void SyncVisuals();
 
 			ClientLayer& operator=(const ClientLayer&) = delete;
@@ -110,6 +112,7 @@ namespace bw
 			tsl::hopscotch_map<Nz::UInt32 /*serverEntityId*/, EntityId> m_serverEntityIds;
 			std::vector<std::optional<SoundData>> m_sounds;
 			Nz::Bitset<Nz::UInt64> m_freeSoundIds;
+			std::optional<Nz::Rectf> m_visibleRect; //< entities outside of it are not interpolated nor synced
 			Nz::Color m_backgroundColor;
 			bool m_isEnabled;
 			bool m_isPredictionEnabled;
@@ -8,6 +8,7 @@
 #define BURGWAR_CLIENTLIB_CLIENTMATCH_HPP
 
 #include <CoreLib/AnimationManager.hpp>
+#include <CoreLib/Map.hpp>
 #include <CoreLib/PropertyValues.hpp>
 #include <CoreLib/SharedMatch.hpp>
 #include <CoreLib/SharedLayer.hpp>
@@ -34,6 +35,7 @@
 #include <NDK/EntityOwner.hpp>
 #include <tsl/hopscotch_map.h>
 #include <tsl/hopscotch_set.h>
+#include <array>
 #include <memory>
 #include <optional>
 #include <variant>
@@ -84,6 +86,7 @@ namespace bw
 			inline const ClientPlayer* GetLocalPlayerClientPlayer(std::size_t localPlayerIndex) const;
 			inline std::size_t GetLocalPlayerCount() const;
 			inline const PlayerInputData& GetLocalPlayerInputs(std::size_t localPlayerIndex) const;
+			inline const Map* GetMap() const;
 			const NetworkStringStore& GetNetworkStringStore() const override;
 			inline ParticleRegistry& GetParticleRegistry();
 			inline const ParticleRegistry& GetParticleRegistry() const;
@@ -96,6 +99,7 @@ namespace bw
 			void InitDebugGhosts();
 
 			void LoadAssets(std::shared_ptr<VirtualDirectory> assetDir);
+			void LoadAssets(std::shared_ptr<ClientAssetStore> assetStore);
 			void LoadScripts(const std::shared_ptr<VirtualDirectory>& scriptDir);
 
 			inline void Quit();
@@ -174,9 +178,13 @@ namespace bw
 			void InitializeRemoteConsole();
 			void InitializeScoreboard();
 			void OnTick(bool lastTick) override;
+			void PrepareAssets();
 			void PushTickPacket(Nz::UInt16 tick, const TickPacketContent& packet);
 			bool SendInputs(Nz::UInt16 serverTick, bool force);
 
+			static constexpr std::size_t RedundantInputCount = 8; //< how many ticks of inputs are sent in each input packet
+			static constexpr float VisualCullingMargin = 256.f; //< around the camera, entities further away aren't interpolated nor synced
+
 			struct LocalPlayerData
 			{
 				struct Weapon
@@ -267,17 +275,20 @@ namespace bw
 
 			typename Nz::Signal<const std::string&>::ConnectionGuard m_nicknameUpdateSlot;
 
-			std::optional<ClientAssetStore> m_assetStore;
+			std::shared_ptr<ClientAssetStore> m_assetStore;
 			std::optional<ClientEntityStore> m_entityStore;
 			std::optional<ClientWeaponStore> m_weaponStore;
 			std::optional<Camera> m_camera;
 			std::optional<Console> m_remoteConsole;
 			std::optional<Debug> m_debug;
 			std::optional<ClientConsole> m_localConsole;
+			std::optional<Map> m_map;
 			std::optional<ParticleRegistry> m_particleRegistry;
 			std::shared_ptr<ClientGamemode> m_gamemode;
 			std::shared_ptr<ScriptingContext> m_scriptingContext;
 			std::string m_gamemodeName;
+			std::string m_mapAssetPath;
+			std::vector<std::string> m_assetPrefetchList;
 			std::vector<std::unique_ptr<ClientLayer>> m_layers;
 			std::vector<LocalPlayerData> m_localPlayers;
 			std::vector<std::optional<ClientPlayer>> m_matchPlayers;
@@ -304,6 +315,7 @@ namespace bw
 			PropertyValueMap m_gamemodeProperties;
 			Scoreboard* m_scoreboard;
 			Packets::PlayersInput m_inputPacket;
+			std::array<Nz::UInt8, 20> m_mapChecksum; //< of m_mapAssetPath
 			bool m_hasFocus;
 			bool m_isLeavingMatch;
 			float m_errorCorrectionTimer;
@@ -41,7 +41,7 @@ namespace bw
 
 	inline ClientAssetStore& ClientMatch::GetAssetStore()
 	{
-		assert(m_assetStore.has_value());
+		assert(m_assetStore);
 		return *m_assetStore;
 	}
 
@@ -92,6 +92,14 @@ namespace bw
 		return m_localPlayers[localPlayerIndex].lastInputData;
 	}
 
+	inline const Map* ClientMatch::GetMap() const
+	{
+		if (!m_map)
+			return nullptr;
+
+		return &m_map.value();
+	}
+
 	inline ParticleRegistry& ClientMatch::GetParticleRegistry()
 	{
 		assert(m_particleRegistry);
@@ -0,0 +1,72 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_CLIENTLIB_CONTENTCACHE_HPP
+#define BURGWAR_CLIENTLIB_CONTENTCACHE_HPP
+
+#include <ClientLib/Export.hpp>
+#include <Nazara/Prerequisites.hpp>
+#include <tsl/hopscotch_map.h>
+#include <array>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace bw
+{
+	class Logger;
+
+	// Content-addressed file cache (files are named after their SHA1), shared between servers
+	class BURGWAR_CLIENTLIB_API ContentCache
+	{
+		public:
+			using Checksum = std::array<Nz::UInt8, 20>;
+
+			ContentCache(const Logger& logger, std::filesystem::path cacheDirectory, Nz::UInt64 maxSize = 0);
+			ContentCache(const ContentCache&) = delete;
+			ContentCache(ContentCache&&) = delete;
+			~ContentCache() = default;
+
+			std::filesystem::path BuildPath(const Checksum& checksum, const std::string_view& extension) const;
+
+			void Evict();
+
+			std::optional<std::filesystem::path> Find(const Checksum& checksum, Nz::UInt64 size, const std::string_view& extension);
+
+			inline const std::filesystem::path& GetCacheDirectory() const;
+			inline Nz::UInt64 GetMaxSize() const;
+
+			bool Load();
+
+			void Register(const std::filesystem::path& filePath);
+
+			bool Save();
+
+			ContentCache& operator=(const ContentCache&) = delete;
+			ContentCache& operator=(ContentCache&&) = delete;
+
+		private:
+			struct Entry
+			{
+				Nz::Int64 lastAccessTime;
+				Nz::Int64 lastWriteTime;
+				Nz::UInt64 size;
+				bool isUsed = false; //< used by the current session, can't be evicted
+				bool isVerified;
+			};
+
+			std::filesystem::path m_cacheDirectory;
+			tsl::hopscotch_map<std::string /*fileName*/, Entry> m_entries;
+			const Logger& m_logger;
+			Nz::UInt64 m_maxSize;
+			bool m_isDirty;
+	};
+}
+
+#include <ClientLib/ContentCache.inl>
+
+#endif
@@ -0,0 +1,18 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <ClientLib/ContentCache.hpp>
+
+namespace bw
+{
+	inline const std::filesystem::path& ContentCache::GetCacheDirectory() const
+	{
+		return m_cacheDirectory;
+	}
+
+	inline Nz::UInt64 ContentCache::GetMaxSize() const
+	{
+		return m_maxSize;
+	}
+}
@@ -56,7 +56,10 @@ namespace bw
 			inline bool IsEnabled() const;
 			bool IsPhysical() const;
 
+			bool ShouldCull(const Nz::Rectf& visibleRect, const Nz::Vector2f& position) const;
+
 			void SyncVisuals();
+			void SyncVisuals(const Nz::Rectf& visibleRect);
 
 			void UpdateHoveringRenderableHoveringHeight(const Nz::InstancedRenderableRef& renderable, float newHoveringHeight);
 			void UpdateHoveringRenderableMatrix(const Nz::InstancedRenderableRef& renderable, const Nz::Matrix4f& offsetMatrix);
@@ -69,6 +72,8 @@ namespace bw
 			LayerVisualEntity& operator=(LayerVisualEntity&&) = delete;
 
 		private:
+			float GetCullingRadius() const;
+			bool IsInsideRect(const Nz::Rectf& rect, const Nz::Vector2f& position) const;
 			void NotifyVisualEntityMoved(VisualEntity* oldPointer, VisualEntity* newPointer);
 			void RegisterVisualEntity(VisualEntity* visualEntity);
 			void UnregisterVisualEntity(VisualEntity* visualEntity);
@@ -92,6 +97,8 @@ namespace bw
 			Ndk::EntityOwner m_entity;
 			EntityId m_uniqueId;
 			LayerIndex m_layerIndex;
+			mutable std::optional<float> m_cullingRadius; //< bounding radius of renderables, reset when they change
+			bool m_isCulled;
 	};
 }
 
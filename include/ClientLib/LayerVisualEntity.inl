@@ -11,7 +11,8 @@ namespace bw
 	inline LayerVisualEntity::LayerVisualEntity(const Ndk::EntityHandle& entity, LayerIndex layerIndex, EntityId uniqueId) :
 	m_entity(entity),
 	m_uniqueId(uniqueId),
-	m_layerIndex(layerIndex)
+	m_layerIndex(layerIndex),
+	m_isCulled(false)
 	{
 		assert(m_entity);
 	}
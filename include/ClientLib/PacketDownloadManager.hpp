@@ -7,12 +7,14 @@
 #ifndef BURGWAR_CLIENTLIB_CLIENTASSETDOWNLOADMANAGER_HPP
 #define BURGWAR_CLIENTLIB_CLIENTASSETDOWNLOADMANAGER_HPP
 
+#include <CoreLib/Utility/ThreadPool.hpp>
 #include <ClientLib/ClientSession.hpp>
 #include <ClientLib/DownloadManager.hpp>
 #include <ClientLib/Export.hpp>
 #include <Nazara/Core/Bitset.hpp>
 #include <Nazara/Core/File.hpp>
 #include <Nazara/Core/AbstractHash.hpp>
+#include <concurrentqueue/concurrentqueue.h>
 #include <filesystem>
 #include <limits>
 
@@ -21,7 +23,9 @@ namespace bw
 	class BURGWAR_CLIENTLIB_API PacketDownloadManager : public DownloadManager
 	{
 		public:
-			PacketDownloadManager(std::shared_ptr<ClientSession> clientSession);
+			PacketDownloadManager(std::shared_ptr<ClientSession> clientSession, std::size_t maxSimultaneousDownload = 8);
+			PacketDownloadManager(const PacketDownloadManager&) = delete;
+			PacketDownloadManager(PacketDownloadManager&&) = delete;
 			~PacketDownloadManager() = default;
 
 			const FileEntry& GetEntry(std::size_t fileIndex) const override;
@@ -32,25 +36,48 @@ namespace bw
 
 			void Update() override;
 
+			PacketDownloadManager& operator=(const PacketDownloadManager&) = delete;
+			PacketDownloadManager& operator=(PacketDownloadManager&&) = delete;
+
 		private:
+			struct Request;
+
+			Request* GetRequest(Nz::UInt32 downloadId);
 			void HandlePacket(const Packets::DownloadClientFileFragment& packet);
 			void HandlePacket(const Packets::DownloadClientFileResponse& packet);
-			void RequestNextFile();
+			void PollHashResults();
+			void RequestNextFiles();
+			void VerifyFile(Request& request);
 
 			struct PendingFile : FileEntry
 			{
 				Nz::Bitset<Nz::UInt64> receivedFragment;
-				Nz::UInt64 fragmentSize;
+				Nz::UInt64 downloadedSize = 0;
+				Nz::UInt64 fragmentSize = 0;
+			};
+
+			struct Request
+			{
+				Nz::File outputFile;
+				std::size_t fileIndex;
+				std::vector<Nz::UInt8> fileContent;
+				bool isActive = false;
+			};
+
+			struct HashResult
+			{
+				std::size_t fileIndex;
+				std::vector<Nz::UInt8> fileContent;
+				bool isValid;
 			};
 
-			Nz::ByteArray m_byteArray;
-			Nz::File m_outputFile;
-			std::unique_ptr<Nz::AbstractHash> m_hash;
-			std::filesystem::path m_clientFileCache;
 			std::shared_ptr<ClientSession> m_clientSession;
 			std::size_t m_nextFileIndex;
-			std::vector<Nz::UInt8> m_fileContent;
+			std::size_t m_pendingHashCount;
 			std::vector<PendingFile> m_downloadList;
+			std::vector<Request> m_requests;
+			moodycamel::ConcurrentQueue<HashResult> m_hashResults;
+			ThreadPool m_hashWorkers; //< Must be destroyed before m_hashResults
 
 			NazaraSlot(ClientSession, OnDownloadClientFileFragment, m_onDownloadFragmentSlot);
 			NazaraSlot(ClientSession, OnDownloadClientFileResponse, m_onDownloadResponseSlot);
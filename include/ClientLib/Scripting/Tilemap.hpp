@@ -11,20 +11,25 @@
 #include <ClientLib/LayerVisualEntity.hpp>
 #include <Nazara/Core/ObjectHandle.hpp>
 #include <Nazara/Math/Matrix4.hpp>
+#include <Nazara/Graphics/Material.hpp>
 #include <Nazara/Graphics/TileMap.hpp>
 #include <NDK/Entity.hpp>
 #include <sol/forward.hpp>
+#include <vector>
 
 namespace bw
 {
+	// Tilemaps are split in fixed-size chunks, each one being a renderable (culled on its own and only rebuilt when one of its tiles changes)
 	class BURGWAR_CLIENTLIB_API Tilemap
 	{
 		public:
-			inline Tilemap(LayerVisualEntityHandle visualEntity, Nz::TileMapRef tilemap, const Nz::Matrix4f& transformMatrix, int renderOrder);
+			inline Tilemap(LayerVisualEntityHandle visualEntity, const Nz::Vector2ui& mapSize, const Nz::Vector2f& tileSize, std::vector<Nz::MaterialRef> materials, const Nz::Matrix4f& transformMatrix, int renderOrder);
 			Tilemap(const Tilemap&) = delete;
 			Tilemap(Tilemap&&) noexcept = default;
 			~Tilemap() = default;
 
+			void EnableTile(unsigned int x, unsigned int y, const Nz::Rectf& texCoords, const Nz::Color& color, std::size_t materialIndex);
+
 			inline const Nz::Vector2ui& GetMapSize() const;
 			inline Nz::Vector2f GetSize() const;
 			inline const Nz::Vector2f& GetTileSize() const;
@@ -34,6 +39,7 @@ namespace bw
 			inline bool IsValid() const;
 			inline bool IsVisible() const;
 
+			void SetColor(const Nz::Color& color);
 			inline void SetOffset(const Nz::Vector2f& newOffset);
 			inline void SetRotation(const Nz::DegreeAnglef& newRotation);
 			void SetTileColor(unsigned int x, unsigned int y, const Nz::Color& color);
@@ -42,12 +48,20 @@ namespace bw
 			Tilemap& operator=(const Tilemap&) = delete;
 			Tilemap& operator=(Tilemap&&) noexcept = default;
 
+			static constexpr unsigned int ChunkSize = 32; //< in tiles
+
 		private:
+			Nz::Matrix4f ComputeChunkMatrix(std::size_t chunkIndex) const;
+			inline std::size_t GetChunkIndex(unsigned int x, unsigned int y) const;
 			void UpdateTransformMatrix();
 
 			LayerVisualEntityHandle m_visualEntity;
 			Nz::Matrix4f m_transformMatrix;
-			Nz::TileMapRef m_tilemap;
+			Nz::Vector2f m_tileSize;
+			Nz::Vector2ui m_chunkCount;
+			Nz::Vector2ui m_mapSize;
+			std::vector<Nz::MaterialRef> m_materials; //< shared by every chunk so they can be batched together
+			std::vector<Nz::TileMapRef> m_chunks; //< chunks without any tile are never created
 			int m_renderOrder;
 			bool m_isVisible;
 	};
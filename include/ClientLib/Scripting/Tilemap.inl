@@ -3,31 +3,36 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <ClientLib/Scripting/Tilemap.hpp>
+#include <cassert>
 
 namespace bw
 {
-	inline Tilemap::Tilemap(LayerVisualEntityHandle visualEntity, Nz::TileMapRef tilemap, const Nz::Matrix4f& transformMatrix, int renderOrder) :
+	inline Tilemap::Tilemap(LayerVisualEntityHandle visualEntity, const Nz::Vector2ui& mapSize, const Nz::Vector2f& tileSize, std::vector<Nz::MaterialRef> materials, const Nz::Matrix4f& transformMatrix, int renderOrder) :
 	m_visualEntity(std::move(visualEntity)),
 	m_transformMatrix(transformMatrix),
-	m_tilemap(std::move(tilemap)),
+	m_tileSize(tileSize),
+	m_chunkCount((mapSize.x + ChunkSize - 1) / ChunkSize, (mapSize.y + ChunkSize - 1) / ChunkSize),
+	m_mapSize(mapSize),
+	m_materials(std::move(materials)),
 	m_renderOrder(renderOrder),
 	m_isVisible(false)
 	{
+		m_chunks.resize(std::size_t(m_chunkCount.x) * m_chunkCount.y);
 	}
 
 	inline const Nz::Vector2ui& Tilemap::GetMapSize() const
 	{
-		return m_tilemap->GetMapSize();
+		return m_mapSize;
 	}
 
 	inline Nz::Vector2f Tilemap::GetSize() const
 	{
-		return m_tilemap->GetSize();
+		return Nz::Vector2f(m_mapSize) * m_tileSize;
 	}
 
 	inline const Nz::Vector2f& Tilemap::GetTileSize() const
 	{
-		return m_tilemap->GetTileSize();
+		return m_tileSize;
 	}
 
 	inline void Tilemap::Hide()
@@ -58,4 +63,10 @@ namespace bw
 
 		UpdateTransformMatrix();
 	}
+
+	inline std::size_t Tilemap::GetChunkIndex(unsigned int x, unsigned int y) const
+	{
+		assert(x < m_mapSize.x && y < m_mapSize.y);
+		return std::size_t(y / ChunkSize) * m_chunkCount.x + x / ChunkSize;
+	}
 }
@@ -8,7 +8,9 @@
 #define BURGWAR_CLIENTLIB_SYSTEMS_VISUALINTERPOLATIONSYSTEM_HPP
 
 #include <ClientLib/Export.hpp>
+#include <Nazara/Math/Rect.hpp>
 #include <NDK/System.hpp>
+#include <optional>
 
 namespace bw
 {
@@ -18,11 +20,15 @@ namespace bw
 			VisualInterpolationSystem();
 			~VisualInterpolationSystem() = default;
 
+			inline void SetVisibleRect(std::optional<Nz::Rectf> visibleRect);
+
 			static Ndk::SystemIndex systemIndex;
 
 		private:
 			void OnEntityAdded(Ndk::Entity* entity) override;
 			void OnUpdate(float elapsedTime) override;
+
+			std::optional<Nz::Rectf> m_visibleRect;
 	};
 }
 
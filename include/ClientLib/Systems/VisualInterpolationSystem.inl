@@ -6,4 +6,9 @@
 
 namespace bw
 {
+	inline void VisualInterpolationSystem::SetVisibleRect(std::optional<Nz::Rectf> visibleRect)
+	{
+		// Entities outside of this rect (if any) are no longer interpolated
+		m_visibleRect = std::move(visibleRect);
+	}
 }
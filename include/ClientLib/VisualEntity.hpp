@@ -12,6 +12,7 @@
 #include <Nazara/Graphics/InstancedRenderable.hpp>
 #include <Nazara/Utility/Node.hpp>
 #include <NDK/EntityOwner.hpp>
+#include <optional>
 #include <vector>
 
 namespace bw
@@ -46,6 +47,8 @@ namespace bw
 
 			inline void Enable(bool enable);
 
+			inline Nz::Matrix4f ComputeHoveringMatrix(const Nz::Matrix4f& offsetMatrix, float hoverOffset) const;
+
 			void UpdateHoveringRenderableHoveringHeight(const Nz::InstancedRenderableRef& renderable, float newHoveringHeight);
 			void UpdateHoveringRenderableMatrix(const Nz::InstancedRenderableRef& renderable, const Nz::Matrix4f& offsetMatrix);
 			void UpdateHoveringRenderableRenderOrder(const Nz::InstancedRenderableRef& renderable, int renderOrder);
@@ -56,14 +59,27 @@ namespace bw
 			struct HoveringRenderable
 			{
 				float offset;
-				Ndk::EntityOwner entity;
 				Nz::InstancedRenderableRef renderable;
+				Nz::Matrix4f offsetMatrix;
+			};
+
+			struct TransformState
+			{
+				Nz::Matrix4f parentMatrix;
+				Nz::Quaternionf rotation;
+				Nz::Vector2f position;
+				Nz::Vector2f scale;
 			};
 
+			std::optional<TransformState> m_lastTransform;
 			std::vector<HoveringRenderable> m_hoveringRenderables;
 			Ndk::EntityOwner m_entity;
+			Ndk::EntityOwner m_hoveringEntity; //< holds every hovering renderable, offsets are part of their local matrix
 			LayerVisualEntityHandle m_visualEntity;
+			Nz::Vector2f m_hoveringPosition;
+			Nz::Vector2f m_hoveringScale;
 			int m_baseRenderOrder;
+			bool m_isHoveringFlipped;
 	};
 }
 
@@ -14,7 +14,14 @@ namespace bw
 	inline void VisualEntity::Enable(bool enable)
 	{
 		m_entity->Enable(enable);
-		for (auto& hoveringRenderable : m_hoveringRenderables)
-			hoveringRenderable.entity->Enable(enable);
+		if (m_hoveringEntity)
+			m_hoveringEntity->Enable(enable);
+	}
+
+	inline Nz::Matrix4f VisualEntity::ComputeHoveringMatrix(const Nz::Matrix4f& offsetMatrix, float hoverOffset) const
+	{
+		// The hovering node only has a positive scale, so the offset has to follow the entity vertical flip
+		float offset = (m_isHoveringFlipped) ? hoverOffset : -hoverOffset;
+		return Nz::Matrix4f::ConcatenateAffine(offsetMatrix, Nz::Matrix4f::Translate(Nz::Vector3f(0.f, offset, 0.f)));
 	}
 }
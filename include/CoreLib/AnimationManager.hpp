@@ -8,36 +8,134 @@
 #define BURGWAR_CORELIB_ANIMATIONMANAGER_HPP
 
 #include <CoreLib/Export.hpp>
-#include <Nazara/Core/Signal.hpp>
-#include <memory>
+#include <Nazara/Core/Color.hpp>
+#include <Nazara/Math/Vector2.hpp>
+#include <NDK/Entity.hpp>
+#include <functional>
+#include <limits>
 #include <vector>
 
 namespace bw
 {
-	class AnimationManager
+	enum class EasingType : Nz::UInt8
+	{
+		Linear,
+		QuadraticIn,
+		QuadraticOut,
+		QuadraticInOut,
+		CubicIn,
+		CubicOut,
+		CubicInOut
+	};
+
+	// Animations are stored by type in contiguous pools, custom update callbacks should only be used when no tween fits
+	class BURGWAR_CORELIB_API AnimationManager
 	{
 		public:
+			using AnimationId = Nz::UInt64;
 			using FinishCallback = std::function<void()>;
 			using UpdateCallback = std::function<bool(float ratio)>;
 
 			AnimationManager() = default;
 			~AnimationManager() = default;
 
-			inline void PushAnimation(float duration, UpdateCallback update, FinishCallback finish);
+			AnimationId AnimatePosition(Ndk::EntityHandle entity, const Nz::Vector2f& from, const Nz::Vector2f& to, float duration, EasingType easing = EasingType::Linear, FinishCallback finish = {});
+			AnimationId AnimateRotation(Ndk::EntityHandle entity, float fromAngle, float toAngle, float duration, EasingType easing = EasingType::Linear, FinishCallback finish = {});
+			AnimationId AnimateValue(float& value, float from, float to, float duration, EasingType easing = EasingType::Linear, FinishCallback finish = {});
+			AnimationId AnimateValue(Nz::Color& value, const Nz::Color& from, const Nz::Color& to, float duration, EasingType easing = EasingType::Linear, FinishCallback finish = {});
+			AnimationId AnimateValue(Nz::Vector2f& value, const Nz::Vector2f& from, const Nz::Vector2f& to, float duration, EasingType easing = EasingType::Linear, FinishCallback finish = {});
+
+			bool Cancel(AnimationId animationId);
+			void Clear();
+
+			inline bool IsPlaying(AnimationId animationId) const;
+
+			AnimationId PushAnimation(float duration, UpdateCallback update, FinishCallback finish);
+
+			void Update(float elapsedTime);
 
-			inline void Update(float elapsedTime);
+			static float ApplyEasing(EasingType easing, float ratio);
+
+			static constexpr AnimationId InvalidAnimationId = 0;
 
 		private:
+			enum class AnimationType : Nz::UInt8
+			{
+				Callback,
+				Color,
+				Float,
+				NodePosition,
+				NodeRotation,
+				Vector2
+			};
+
 			struct Animation
 			{
-				std::function<void()> finishCallback;
-				std::function<bool(float ratio)> updateCallback;
+				FinishCallback finishCallback;
+				EasingType easing;
+				Nz::UInt32 slotIndex;
+				bool isActive;
 				float duration;
-				float elapsedtime;
+				float elapsedTime;
+			};
+
+			struct CallbackAnimation : Animation
+			{
+				UpdateCallback updateCallback;
 			};
 
-			std::vector<Animation> m_newAnimations;
-			std::vector<Animation> m_playingAnimations;
+			struct NodePositionTween : Animation
+			{
+				Ndk::EntityHandle entity;
+				Nz::Vector2f from;
+				Nz::Vector2f to;
+			};
+
+			struct NodeRotationTween : Animation
+			{
+				Ndk::EntityHandle entity;
+				float from;
+				float to;
+			};
+
+			template<typename T>
+			struct ValueTween : Animation
+			{
+				T* target;
+				T from;
+				T to;
+			};
+
+			// Identifies an animation in its pool, generation is incremented each time the slot is freed
+			struct Slot
+			{
+				AnimationType type;
+				Nz::UInt32 generation = 1;
+				Nz::UInt32 poolIndex = std::numeric_limits<Nz::UInt32>::max();
+			};
+
+			void FreeSlot(Nz::UInt32 slotIndex);
+			template<typename T> AnimationId PushAnimation(std::vector<T>& pool, AnimationType type, T&& animation);
+			template<typename T> void UpdatePool(std::vector<T>& pool, float elapsedTime);
+			template<typename F> void VisitPool(AnimationType type, F&& func);
+
+			static bool Apply(CallbackAnimation& animation, float ratio);
+			static bool Apply(NodePositionTween& animation, float ratio);
+			static bool Apply(NodeRotationTween& animation, float ratio);
+			static bool Apply(ValueTween<float>& animation, float ratio);
+			static bool Apply(ValueTween<Nz::Color>& animation, float ratio);
+			static bool Apply(ValueTween<Nz::Vector2f>& animation, float ratio);
+
+			std::vector<CallbackAnimation> m_callbackAnimations;
+			std::vector<FinishCallback> m_finishedCallbacks;
+			std::vector<NodePositionTween> m_nodePositionTweens;
+			std::vector<NodeRotationTween> m_nodeRotationTweens;
+			std::vector<Slot> m_slots;
+			std::vector<ValueTween<float>> m_floatTweens;
+			std::vector<ValueTween<Nz::Color>> m_colorTweens;
+			std::vector<ValueTween<Nz::Vector2f>> m_vec2Tweens;
+			std::vector<Nz::UInt32> m_freeSlots;
+			bool m_isUpdatingPools = false;
 	};
 }
 
@@ -37,7 +37,7 @@ namespace bw
 
 			bool UnserializePacket(PeerRef peer, Nz::NetPacket& packet) const;
 
-			using UnserializeFunction = std::function<void(PeerRef peer, Nz::NetPacket& packet)>;
+			using UnserializeFunction = std::function<bool(PeerRef peer, Nz::NetPacket& packet)>;
 
 			struct IncomingCommand
 			{
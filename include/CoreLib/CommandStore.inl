@@ -108,24 +108,32 @@ namespace bw
 	template<typename Peer>
 	bool CommandStore<Peer>::UnserializePacket(PeerRef peer, Nz::NetPacket& packet) const
 	{
-		Nz::UInt8 opcode;
-		try
+		// A single packet can hold multiple messages, one after another
+		do
 		{
-			packet >> opcode;
-		}
-		catch (const std::exception&)
-		{
-			bwLog(m_logger, LogLevel::Error, "Failed to unserialize opcode");
-			return false;
-		}
+			Nz::UInt8 opcode;
+			try
+			{
+				packet >> opcode;
+			}
+			catch (const std::exception&)
+			{
+				bwLog(m_logger, LogLevel::Error, "Failed to unserialize opcode");
+				return false;
+			}
 
-		if (m_incomingCommands.size() <= opcode || !m_incomingCommands[opcode].enabled)
-		{
-			bwLog(m_logger, LogLevel::Error, "Client :derp: sent invalid or disabled opcode: {}", +opcode);
-			return false;
+			if (m_incomingCommands.size() <= opcode || !m_incomingCommands[opcode].enabled)
+			{
+				bwLog(m_logger, LogLevel::Error, "Client :derp: sent invalid or disabled opcode: {}", +opcode);
+				return false;
+			}
+
+			// Following messages cannot be located if this one failed
+			if (!m_incomingCommands[opcode].unserialize(peer, packet))
+				return false;
 		}
+		while (!packet.GetStream()->EndOfStream());
 
-		m_incomingCommands[opcode].unserialize(peer, packet);
 		return true;
 	}
 }
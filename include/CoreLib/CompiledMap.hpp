@@ -0,0 +1,84 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_CORELIB_COMPILEDMAP_HPP
+#define BURGWAR_CORELIB_COMPILEDMAP_HPP
+
+#include <CoreLib/Export.hpp>
+#include <CoreLib/Map.hpp>
+#include <CoreLib/Utility/MappedFile.hpp>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+namespace bw
+{
+	// Read-only view over a binary map file (.bmap, version 2+), layers are only decoded when requested
+	class BURGWAR_CORELIB_API CompiledMap
+	{
+		public:
+			struct LayerInfo;
+
+			CompiledMap(const std::filesystem::path& mapFile);
+			CompiledMap(const CompiledMap&) = delete;
+			CompiledMap(CompiledMap&&) noexcept = default;
+			~CompiledMap() = default;
+
+			std::vector<Map::Asset> DecodeAssets() const;
+			Map::Layer DecodeLayer(LayerIndex layerIndex) const;
+			std::vector<Map::Script> DecodeScripts() const;
+
+			std::size_t GetAssetCount() const;
+			inline Nz::UInt32 GetGameVersion() const;
+			LayerInfo GetLayerInfo(LayerIndex layerIndex) const;
+			std::size_t GetLayerCount() const;
+			inline const MapInfo& GetMapInfo() const;
+			std::size_t GetScriptCount() const;
+			std::string_view GetString(Nz::UInt32 stringIndex) const;
+
+			CompiledMap& operator=(const CompiledMap&) = delete;
+			CompiledMap& operator=(CompiledMap&&) noexcept = default;
+
+			struct LayerInfo
+			{
+				Nz::Color backgroundColor;
+				std::string_view name;
+				std::size_t entityCount;
+			};
+
+			static bool Compile(const Map& map, const std::filesystem::path& outputPath);
+			static Nz::UInt16 ReadFileVersion(const std::filesystem::path& mapFile);
+
+			static constexpr Nz::UInt16 FileVersion = 2;
+
+		private:
+			struct Section
+			{
+				const Nz::UInt8* data = nullptr;
+				std::size_t size = 0;
+			};
+
+			const Nz::UInt8* GetRecord(const Section& section, std::size_t recordSize, std::size_t recordIndex) const;
+
+			MappedFile m_file;
+			MapInfo m_mapInfo;
+			Section m_assets;
+			Section m_blobs;
+			Section m_entities;
+			Section m_info;
+			Section m_layers;
+			Section m_properties;
+			Section m_propertyData;
+			Section m_scripts;
+			Section m_strings;
+			Nz::UInt32 m_gameVersion;
+			Nz::UInt32 m_stringCount;
+	};
+}
+
+#include <CoreLib/CompiledMap.inl>
+
+#endif
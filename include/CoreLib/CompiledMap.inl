@@ -0,0 +1,18 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/CompiledMap.hpp>
+
+namespace bw
+{
+	inline Nz::UInt32 CompiledMap::GetGameVersion() const
+	{
+		return m_gameVersion;
+	}
+
+	inline const MapInfo& CompiledMap::GetMapInfo() const
+	{
+		return m_mapInfo;
+	}
+}
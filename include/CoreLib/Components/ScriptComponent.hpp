@@ -57,6 +57,7 @@ namespace bw
 			inline bool UnregisterCallbackCustom(std::size_t eventIndex, std::size_t callbackId);
 
 			inline void UpdateElement(std::shared_ptr<const ScriptedElement> element);
+			inline void UpdateProperties(PropertyValueMap properties);
 			void UpdateEntity(const Ndk::EntityHandle& entity);
 
 			static Ndk::ComponentIndex componentIndex;
@@ -275,6 +275,11 @@ namespace bw
 		m_element = std::move(element);
 	}
 
+	inline void ScriptComponent::UpdateProperties(PropertyValueMap properties)
+	{
+		m_properties = std::move(properties);
+	}
+
 	inline bool ScriptComponent::CanTriggerTick(float elapsedTime)
 	{
 		m_timeBeforeTick -= elapsedTime;
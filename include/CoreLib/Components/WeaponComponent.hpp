@@ -8,6 +8,7 @@
 #define BURGWAR_CORELIB_COMPONENTS_WEAPONCOMPONENT_HPP
 
 #include <CoreLib/Export.hpp>
+#include <Nazara/Core/Signal.hpp>
 #include <NDK/Component.hpp>
 
 namespace bw
@@ -24,6 +25,7 @@ namespace bw
 	{
 		public:
 			inline WeaponComponent(Ndk::EntityHandle owner, WeaponAttackMode attackMode);
+			inline WeaponComponent(const WeaponComponent& weapon);
 			~WeaponComponent() = default;
 
 			inline WeaponAttackMode GetAttackMode() const;
@@ -39,6 +41,9 @@ namespace bw
 
 			static Ndk::ComponentIndex componentIndex;
 
+			NazaraSignal(OnActiveUpdate, WeaponComponent* /*emitter*/, bool /*isActive*/);
+			NazaraSignal(OnOwnerUpdate, WeaponComponent* /*emitter*/, const Ndk::EntityHandle& /*newOwner*/);
+
 		private:
 			Ndk::EntityHandle m_owner;
 			WeaponAttackMode m_attackMode;
@@ -14,6 +14,14 @@ namespace bw
 	{
 	}
 
+	inline WeaponComponent::WeaponComponent(const WeaponComponent& weapon) :
+	m_owner(weapon.m_owner),
+	m_attackMode(weapon.m_attackMode),
+	m_isActive(weapon.m_isActive),
+	m_isAttacking(weapon.m_isAttacking)
+	{
+	}
+
 	inline WeaponAttackMode WeaponComponent::GetAttackMode() const
 	{
 		return m_attackMode;
@@ -36,9 +44,14 @@ namespace bw
 
 	inline void WeaponComponent::SetActive(bool isActive)
 	{
-		m_isActive = isActive;
 		if (!isActive)
 			m_isAttacking = false;
+
+		if (m_isActive != isActive)
+		{
+			m_isActive = isActive;
+			OnActiveUpdate(this, isActive);
+		}
 	}
 
 	inline void WeaponComponent::SetAttacking(bool isAttacking)
@@ -49,5 +62,6 @@ namespace bw
 	inline void WeaponComponent::UpdateOwner(Ndk::EntityHandle owner)
 	{
 		m_owner = std::move(owner);
+		OnOwnerUpdate(this, m_owner);
 	}
 }
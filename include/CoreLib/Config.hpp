@@ -9,7 +9,12 @@
 
 namespace bw
 {
-	constexpr std::size_t NetworkChannelCount = 2;
+	// 0: connection and resources
+	// 1: reliable ordered game messages (entity lifecycle and state changes)
+	// 2: player inputs (client to server)
+	// 3: reliable messages which don't need to be ordered with game messages (chat, pings, ...)
+	// 4: latest-value-wins game messages which always carry a full state (unreliable, outdated packets are dropped)
+	constexpr std::size_t NetworkChannelCount = 5;
 }
 
 #endif
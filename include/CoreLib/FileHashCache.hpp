@@ -0,0 +1,77 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_CORELIB_FILEHASHCACHE_HPP
+#define BURGWAR_CORELIB_FILEHASHCACHE_HPP
+
+#include <CoreLib/Export.hpp>
+#include <Nazara/Core/ByteArray.hpp>
+#include <tsl/hopscotch_map.h>
+#include <array>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace bw
+{
+	class Logger;
+
+	// Caches SHA1 checksums of files on disk, keyed by (path, size, last write time), and persists them in a manifest
+	class BURGWAR_CORELIB_API FileHashCache
+	{
+		public:
+			struct FileHash;
+
+			using ProgressCallback = std::function<void(std::size_t processedFileCount, std::size_t fileCount)>; //< may be called from worker threads
+
+			FileHashCache(const Logger& logger, std::filesystem::path manifestPath);
+			FileHashCache(const FileHashCache&) = delete;
+			FileHashCache(FileHashCache&&) = delete;
+			~FileHashCache() = default;
+
+			std::optional<FileHash> ComputeHash(const std::filesystem::path& filePath);
+			std::vector<std::optional<FileHash>> ComputeHashes(const std::vector<std::filesystem::path>& filePaths, const ProgressCallback& progressCallback = nullptr);
+
+			inline const std::filesystem::path& GetManifestPath() const;
+
+			bool Load();
+			bool Save();
+
+			FileHashCache& operator=(const FileHashCache&) = delete;
+			FileHashCache& operator=(FileHashCache&&) = delete;
+
+			struct FileHash
+			{
+				Nz::ByteArray checksum;
+				Nz::UInt64 size;
+			};
+
+		private:
+			struct Entry
+			{
+				std::array<Nz::UInt8, 20> checksum;
+				Nz::Int64 lastWriteTime;
+				Nz::UInt64 size;
+			};
+
+			bool FindEntry(const std::string& key, Nz::UInt64 size, Nz::Int64 lastWriteTime, FileHash& fileHash) const;
+
+			static std::optional<Entry> HashFile(const std::filesystem::path& filePath, Nz::UInt64 size, Nz::Int64 lastWriteTime);
+
+			mutable std::mutex m_mutex;
+			std::filesystem::path m_manifestPath;
+			tsl::hopscotch_map<std::string, Entry> m_entries;
+			const Logger& m_logger;
+			bool m_isDirty;
+	};
+}
+
+#include <CoreLib/FileHashCache.inl>
+
+#endif
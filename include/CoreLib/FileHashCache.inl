@@ -0,0 +1,13 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/FileHashCache.hpp>
+
+namespace bw
+{
+	inline const std::filesystem::path& FileHashCache::GetManifestPath() const
+	{
+		return m_manifestPath;
+	}
+}
@@ -23,6 +23,8 @@ namespace bw
 
 			inline LogSide GetSide() const;
 
+			virtual bool IsLevelEnabled(LogLevel level) const = 0;
+
 			virtual void Log(const LogContext& context, std::string content) const = 0;
 			virtual void LogRaw(const LogContext& context, std::string_view content) const = 0;
 
@@ -0,0 +1,59 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_CORELIB_LOGSYSTEM_ASYNCSINK_HPP
+#define BURGWAR_CORELIB_LOGSYSTEM_ASYNCSINK_HPP
+
+#include <CoreLib/Export.hpp>
+#include <CoreLib/LogSystem/LogContext.hpp>
+#include <CoreLib/LogSystem/LogSink.hpp>
+#include <Nazara/Core/Thread.hpp>
+#include <concurrentqueue/blockingconcurrentqueue.h>
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace bw
+{
+	// Forwards records to another sink from a background thread, records are dropped when the queue is full
+	class BURGWAR_CORELIB_API AsyncSink : public LogSink
+	{
+		public:
+			AsyncSink(std::shared_ptr<LogSink> sink, std::size_t maxQueuedRecords = DefaultMaxQueuedRecords);
+			AsyncSink(const AsyncSink&) = delete;
+			AsyncSink(AsyncSink&&) = delete;
+			~AsyncSink();
+
+			void Write(const LogContext& context, std::string_view content) override;
+
+			AsyncSink& operator=(const AsyncSink&) = delete;
+			AsyncSink& operator=(AsyncSink&&) = delete;
+
+			static constexpr std::size_t DefaultMaxQueuedRecords = 4096;
+
+		private:
+			struct Record
+			{
+				std::string content;
+				LogLevel level;
+				LogSide side;
+				float elapsedTime;
+			};
+
+			void WriteRecord(const Record& record);
+			void WorkerThread();
+
+			std::atomic_bool m_running;
+			std::atomic_size_t m_droppedRecordCount;
+			std::shared_ptr<LogSink> m_sink;
+			moodycamel::BlockingConcurrentQueue<Record> m_records;
+			Nz::Thread m_thread;
+	};
+}
+
+#include <CoreLib/LogSystem/AsyncSink.inl>
+
+#endif
@@ -18,12 +18,21 @@
 #include <memory>
 #include <vector>
 
+// Log levels below this one are stripped at compile-time (0 = Debug, 1 = Info, 2 = Warning, 3 = Error)
+#ifndef BURGWAR_LOG_MINIMUM_LEVEL
+#define BURGWAR_LOG_MINIMUM_LEVEL 0
+#endif
+
+// Level is checked before creating any context, to keep filtered logs as cheap as possible
 #define bwLog(logObject, lvl, ...) do \
 { \
-	auto _bwLogContext = (logObject).PushContext(); \
-	_bwLogContext->level = lvl; \
-	if ((logObject).ShouldLog(*_bwLogContext)) \
-		(logObject).LogFormat(*_bwLogContext, __VA_ARGS__); \
+	if (static_cast<int>(lvl) >= BURGWAR_LOG_MINIMUM_LEVEL && (logObject).IsLevelEnabled(lvl)) \
+	{ \
+		auto _bwLogContext = (logObject).PushContext(); \
+		_bwLogContext->level = lvl; \
+		if ((logObject).ShouldLog(*_bwLogContext)) \
+			(logObject).LogFormat(*_bwLogContext, __VA_ARGS__); \
+	} \
 } \
 while (false)
 
@@ -44,6 +53,8 @@ namespace bw
 			Logger(Logger&&) noexcept = default;
 			~Logger() = default;
 
+			bool IsLevelEnabled(LogLevel level) const override;
+
 			template<typename... Args> void LogFormat(const LogContext& context, Args&& ... args) const;
 
 			void Log(const LogContext& context, std::string content) const override;
@@ -22,6 +22,8 @@ namespace bw
 			LoggerProxy(LoggerProxy&&) noexcept = default;
 			~LoggerProxy() = default;
 
+			bool IsLevelEnabled(LogLevel level) const override;
+
 			template<typename... Args> void LogFormat(const LogContext& context, Args&& ... args) const;
 
 			void Log(const LogContext& context, std::string content) const override;
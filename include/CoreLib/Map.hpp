@@ -82,6 +82,8 @@ namespace bw
 			inline std::vector<Script>& GetScripts();
 			inline const std::vector<Script>& GetScripts() const;
 
+			inline bool HasEntity(EntityId uniqueId) const;
+
 			inline bool IsValid() const;
 
 			inline Entity& MoveEntity(LayerIndex sourceLayerIndex, std::size_t sourceEntityIndex, LayerIndex targetLayerIndex, std::size_t targetEntityIndex);
@@ -362,6 +362,11 @@ namespace bw
 		return m_scripts;
 	}
 
+	inline bool Map::HasEntity(EntityId uniqueId) const
+	{
+		return m_entitiesByUniqueId.find(uniqueId) != m_entitiesByUniqueId.end();
+	}
+
 	inline bool Map::IsValid() const
 	{
 		return m_isValid;
@@ -9,12 +9,17 @@
 
 #include <CoreLib/AssetStore.hpp>
 #include <CoreLib/Export.hpp>
+#include <CoreLib/FileHashCache.hpp>
 #include <CoreLib/Map.hpp>
 #include <CoreLib/MasterServerEntry.hpp>
+#include <CoreLib/MatchEventLog.hpp>
+#include <CoreLib/MatchReplayRecorder.hpp>
 #include <CoreLib/MatchSessions.hpp>
+#include <CoreLib/MatchSpectatorStream.hpp>
 #include <CoreLib/Player.hpp>
 #include <CoreLib/SharedMatch.hpp>
 #include <CoreLib/TerrainLayer.hpp>
+#include <CoreLib/Components/HealthComponent.hpp>
 #include <CoreLib/LogSystem/MatchLogger.hpp>
 #include <CoreLib/Protocol/Packets.hpp>
 #include <CoreLib/Protocol/NetworkStringStore.hpp>
@@ -93,17 +98,22 @@ namespace bw
 			inline const ModSettings& GetModSettings() const;
 			const NetworkStringStore& GetNetworkStringStore() const override;
 			inline Player* GetPlayerByIndex(Nz::UInt16 playerIndex);
+			inline MatchReplayRecorder* GetReplayRecorder();
 			inline const std::shared_ptr<VirtualDirectory>& GetScriptDirectory() const;
 			inline const std::shared_ptr<ServerScriptingLibrary>& GetScriptingLibrary() const;
 			inline MatchSessions& GetSessions();
 			inline const MatchSessions& GetSessions() const;
 			inline const MatchSettings& GetSettings() const;
+			inline MatchSpectatorStream& GetSpectatorStream();
+			inline const MatchSpectatorStream& GetSpectatorStream() const;
 			std::shared_ptr<const SharedGamemode> GetSharedGamemode() const override;
 			inline Terrain& GetTerrain();
 			inline const Terrain& GetTerrain() const;
 			ServerWeaponStore& GetWeaponStore() override;
 			const ServerWeaponStore& GetWeaponStore() const override;
 
+			inline bool HasClientSideMapEntities() const;
+
 			void InitDebugGhosts();
 
 			void RegisterClientAsset(std::string assetPath);
@@ -151,6 +161,9 @@ namespace bw
 				bool sleepWhenEmpty = true;
 				bool registerToMasterServer = true;
 				float tickDuration;
+				std::filesystem::path replayFile; //< if set, everything the match receives is recorded to this file
+				std::optional<Nz::UInt64> randomSeed; //< seed of the scripting random generator, randomized if unset
+				std::string mapPath; //< stored in replays
 			};
 
 			struct ModSettings
@@ -170,10 +183,12 @@ namespace bw
 			};
 
 		private:
+			void BuildClientMap();
 			void BuildMatchData();
 			void OnPlayerReady(Player* player);
 			void OnTick(bool lastTick) override;
 			void RegisterClientAssetInternal(std::string assetPath, Nz::UInt64 assetSize, Nz::ByteArray assetChecksum, std::filesystem::path realPath);
+			void RegisterPendingClientAssets();
 			void SendPingUpdate();
 
 			struct Debug
@@ -189,11 +204,16 @@ namespace bw
 				Ndk::EntityHandle entity;
 
 				NazaraSlot(Ndk::Entity, OnEntityDestruction, onDestruction);
+				NazaraSlot(HealthComponent, OnDied, onDied);
+				NazaraSlot(HealthComponent, OnHealthChange, onHealthChange);
 			};
 
 			std::shared_ptr<ScriptingContext> m_scriptingContext; //< Must be over script based classes
 			std::optional<AssetStore> m_assetStore;
 			std::optional<Debug> m_debug;
+			std::optional<FileHashCache> m_assetHashCache;
+			std::optional<MatchEventLog> m_eventLog;
+			std::optional<MatchReplayRecorder> m_replayRecorder;
 			std::optional<ServerEntityStore> m_entityStore;
 			std::optional<ServerWeaponStore> m_weaponStore;
 			std::size_t m_maxPlayerCount;
@@ -201,6 +221,7 @@ namespace bw
 			std::shared_ptr<ServerScriptingLibrary> m_scriptingLibrary;
 			std::shared_ptr<VirtualDirectory> m_assetDirectory;
 			std::shared_ptr<VirtualDirectory> m_scriptDirectory;
+			std::filesystem::path m_clientMapPath;
 			std::string m_name;
 			std::unique_ptr<Terrain> m_terrain;
 			std::vector<std::shared_ptr<Mod>> m_enabledMods;
@@ -209,6 +230,7 @@ namespace bw
 			mutable Packets::MatchData m_matchData;
 			tsl::hopscotch_map<std::string, ClientAsset> m_clientAssets;
 			tsl::hopscotch_map<std::string, ClientScript> m_clientScripts;
+			tsl::hopscotch_map<std::string, std::filesystem::path> m_pendingClientAssets;
 			tsl::hopscotch_map<EntityId, Entity> m_entitiesByUniqueId;
 			Nz::Bitset<> m_freePlayerId;
 			EntityId m_nextUniqueId;
@@ -217,9 +239,12 @@ namespace bw
 			GamemodeSettings m_gamemodeSettings;
 			Map m_map;
 			MatchSessions m_sessions;
+			MatchSpectatorStream m_spectatorStream;
 			MatchSettings m_settings;
 			ModSettings m_modSettings;
 			NetworkStringStore m_networkStringStore;
+			bool m_deferClientAssetHashing;
+			bool m_isAssetHashCacheDirty;
 			bool m_isResetting;
 			bool m_isMatchRunning;
 	};
@@ -25,6 +25,8 @@ namespace bw
 			if (player != except)
 				player->SendPacket(packet);
 		}, onlyReady);
+
+		m_spectatorStream.BroadcastPacket(packet, onlyReady);
 	}
 
 	template<typename F>
@@ -90,6 +92,11 @@ namespace bw
 		return player;
 	}
 
+	inline MatchReplayRecorder* Match::GetReplayRecorder()
+	{
+		return (m_replayRecorder) ? &m_replayRecorder.value() : nullptr;
+	}
+
 	inline MatchSessions& Match::GetSessions()
 	{
 		return m_sessions;
@@ -105,6 +112,16 @@ namespace bw
 		return m_settings;
 	}
 
+	inline MatchSpectatorStream& Match::GetSpectatorStream()
+	{
+		return m_spectatorStream;
+	}
+
+	inline const MatchSpectatorStream& Match::GetSpectatorStream() const
+	{
+		return m_spectatorStream;
+	}
+
 	inline const std::shared_ptr<VirtualDirectory>& Match::GetScriptDirectory() const
 	{
 		return m_scriptDirectory;
@@ -127,6 +144,11 @@ namespace bw
 		return *m_terrain;
 	}
 
+	inline bool Match::HasClientSideMapEntities() const
+	{
+		return m_matchData.mapChecksum.has_value();
+	}
+
 	inline void Match::Quit()
 	{
 		m_isMatchRunning = false;
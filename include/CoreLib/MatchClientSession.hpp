@@ -11,7 +11,6 @@
 #include <CoreLib/PlayerCommandStore.hpp>
 #include <CoreLib/SessionBridge.hpp>
 #include <CoreLib/Protocol/Packets.hpp>
-#include <CoreLib/Utility/CircularBuffer.hpp>
 #include <Nazara/Core/HandledObject.hpp>
 #include <Nazara/Core/ObjectHandle.hpp>
 #include <filesystem>
@@ -41,10 +40,13 @@ namespace bw
 
 			void Disconnect();
 
+			void FlushPackets();
+
 			template<typename F> void ForEachPlayer(F&& func);
 
 			inline Nz::UInt16 GetLastInputTick() const;
 			inline Nz::UInt32 GetPing() const;
+			inline SessionBridge& GetSessionBridge();
 			inline const SessionBridge& GetSessionBridge() const;
 			inline std::size_t GetSessionId() const;
 			inline MatchClientVisibility& GetVisibility();
@@ -52,6 +54,8 @@ namespace bw
 
 			void HandleIncomingPacket(Nz::NetPacket& packet);
 
+			inline bool IsSpectator() const;
+
 			void OnTick(float elapsedTime);
 
 			template<typename T> void SendPacket(const T& packet);
@@ -71,34 +75,47 @@ namespace bw
 			void HandleIncomingPacket(const Packets::Ready& packet);
 			void HandleIncomingPacket(const Packets::ScriptPacket& packet);
 			void HandleIncomingPacket(Packets::UpdatePlayerName&& packet);
-			void SendClientFile(const std::filesystem::path& filePath);
-			void SendClientFile(const std::vector<Nz::UInt8>& content);
+			void QueueInputs(const Packets::PlayersInput::TickInputs& tickInputs);
+			void QueuePacket(Nz::UInt8 channelId, Nz::ENetPacketFlags flags, Nz::NetPacket&& packet);
+			void SendClientFile(Nz::UInt32 downloadId, const std::filesystem::path& filePath);
+			void SendClientFile(Nz::UInt32 downloadId, const std::vector<Nz::UInt8>& content);
 			void UpdatePeerInfo(const SessionBridge::SessionInfo& sessionInfo);
 
+			static constexpr std::size_t MaxInputBufferDepth = 8;
+			static constexpr std::size_t MaxQueuedInputs = 32;
+			static constexpr std::size_t InputBufferShrinkDelay = 60; //< in ticks
+
 			struct Input
 			{
-				std::vector<std::optional<PlayerInputData>> inputs;
+				std::vector<PlayerInputData> inputs;
 				Nz::UInt16 inputTick;
 			};
 
-			/*struct PendingAssetRequest
+			struct PendingBundle
 			{
-				std::size_t fragmentCount;
-				std::size_t currentFragmentIndex;
-				std::filesystem::path filePath;
-				Nz::UInt64 fragmentSize;
-			};*/
+				Nz::ENetPacketFlags flags;
+				Nz::NetPacket packet;
+				Nz::UInt8 channelId;
+				std::size_t messageCount = 0;
+			};
+
+			void SendBundle(PendingBundle& bundle);
 
-			CircularBuffer<Input> m_queuedInputs;
+			std::vector<Input> m_queuedInputs; //< sorted from oldest to most recent tick
+			std::vector<PendingBundle> m_pendingBundles;
 			Match& m_match;
 			PlayerCommandStore& m_commandStore;
 			std::size_t m_sessionId;
 			std::shared_ptr<SessionBridge> m_bridge;
 			std::unique_ptr<MatchClientVisibility> m_visibility;
-			//std::vector<PendingAssetRequest> m_pendingAssetRequest;
 			std::vector<PlayerHandle> m_players;
+			std::size_t m_inputBufferDepth;
+			std::size_t m_inputBufferOverflowTicks;
 			Nz::UInt16 m_lastInputTick;
 			Nz::UInt32 m_ping;
+			bool m_hasAppliedInput;
+			bool m_isBufferingInputs;
+			bool m_isSpectator;
 			float m_peerInfoUpdateCounter;
 	};
 }
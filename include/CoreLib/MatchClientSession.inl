@@ -27,6 +27,11 @@ namespace bw
 		return m_ping;
 	}
 
+	inline SessionBridge& MatchClientSession::GetSessionBridge()
+	{
+		return *m_bridge;
+	}
+
 	inline const SessionBridge& MatchClientSession::GetSessionBridge() const
 	{
 		return *m_bridge;
@@ -47,6 +52,11 @@ namespace bw
 		return *m_visibility;
 	}
 
+	inline bool MatchClientSession::IsSpectator() const
+	{
+		return m_isSpectator;
+	}
+
 	template<typename T>
 	void MatchClientSession::SendPacket(const T& packet)
 	{
@@ -54,6 +64,6 @@ namespace bw
 		m_commandStore.SerializePacket(data, packet);
 
 		const auto& command = m_commandStore.GetOutgoingCommand<T>();
-		m_bridge->SendPacket(command.channelId, command.flags, std::move(data));
+		QueuePacket(command.channelId, command.flags, std::move(data));
 	}
 }
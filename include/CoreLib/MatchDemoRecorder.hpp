@@ -0,0 +1,50 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_CORELIB_MATCHDEMORECORDER_HPP
+#define BURGWAR_CORELIB_MATCHDEMORECORDER_HPP
+
+#include <CoreLib/Export.hpp>
+#include <CoreLib/Utility/BinaryFileWriter.hpp>
+#include <Nazara/Network/ENetPacket.hpp>
+#include <Nazara/Network/NetPacket.hpp>
+#include <filesystem>
+
+namespace bw
+{
+	class Logger;
+
+	// Writes the spectator stream (what a spectator client receives) to disk, keyframes are tagged so a player can seek to them
+	class BURGWAR_CORELIB_API MatchDemoRecorder
+	{
+		public:
+			MatchDemoRecorder(const Logger& logger, const std::filesystem::path& filePath);
+			MatchDemoRecorder(const MatchDemoRecorder&) = delete;
+			MatchDemoRecorder(MatchDemoRecorder&&) = delete;
+			~MatchDemoRecorder() = default;
+
+			inline void Flush();
+
+			void RecordPacket(Nz::UInt64 tick, Nz::UInt8 channelId, Nz::ENetPacketFlags flags, const Nz::NetPacket& packet, bool isKeyframe);
+
+			MatchDemoRecorder& operator=(const MatchDemoRecorder&) = delete;
+			MatchDemoRecorder& operator=(MatchDemoRecorder&&) = delete;
+
+			static constexpr Nz::UInt32 FileVersion = 1;
+			static constexpr std::size_t HeaderSize = 16;
+
+			static constexpr Nz::UInt8 KeyframeFlag = 1 << 0;
+			static constexpr Nz::UInt8 ReliableFlag = 1 << 1;
+
+		private:
+			BinaryFileWriter m_writer;
+			Nz::UInt64 m_lastTick;
+	};
+}
+
+#include <CoreLib/MatchDemoRecorder.inl>
+
+#endif
@@ -0,0 +1,13 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/MatchDemoRecorder.hpp>
+
+namespace bw
+{
+	inline void MatchDemoRecorder::Flush()
+	{
+		m_writer.Flush();
+	}
+}
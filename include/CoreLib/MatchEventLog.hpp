@@ -0,0 +1,76 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_CORELIB_MATCHEVENTLOG_HPP
+#define BURGWAR_CORELIB_MATCHEVENTLOG_HPP
+
+#include <CoreLib/EntityId.hpp>
+#include <CoreLib/Export.hpp>
+#include <CoreLib/LayerIndex.hpp>
+#include <CoreLib/Utility/BinaryFileWriter.hpp>
+#include <Nazara/Math/Vector2.hpp>
+#include <tsl/hopscotch_map.h>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bw
+{
+	class Logger;
+
+	enum class MatchEventType : Nz::UInt8
+	{
+		String              = 0,
+		TickTiming          = 1,
+		PlayerJoined        = 2,
+		PlayerLeft          = 3,
+		EntitySpawned       = 4,
+		EntityDestroyed     = 5,
+		EntityHealthChanged = 6,
+		EntityDied          = 7
+	};
+
+	// Append-only binary log of typed match events, meant for offline analysis (see MatchEventLogReader)
+	class BURGWAR_CORELIB_API MatchEventLog
+	{
+		public:
+			MatchEventLog(const Logger& logger, const std::filesystem::path& filePath);
+			MatchEventLog(const MatchEventLog&) = delete;
+			MatchEventLog(MatchEventLog&&) = delete;
+			~MatchEventLog() = default;
+
+			inline void Flush();
+
+			void LogEntityDestroyed(Nz::UInt64 tick, EntityId entityId);
+			void LogEntityDied(Nz::UInt64 tick, EntityId entityId, EntityId attackerId);
+			void LogEntityHealthChanged(Nz::UInt64 tick, EntityId entityId, EntityId sourceId, Nz::UInt16 oldHealth, Nz::UInt16 newHealth, Nz::UInt16 maxHealth);
+			void LogEntitySpawned(Nz::UInt64 tick, EntityId entityId, std::string_view entityClass, LayerIndex layerIndex, const Nz::Vector2f& position);
+			void LogPlayerJoined(Nz::UInt64 tick, Nz::UInt16 playerIndex, std::string_view playerName);
+			void LogPlayerLeft(Nz::UInt64 tick, Nz::UInt16 playerIndex, Nz::UInt8 reason);
+			void LogTickTiming(Nz::UInt64 tick, Nz::UInt32 durationUs);
+
+			MatchEventLog& operator=(const MatchEventLog&) = delete;
+			MatchEventLog& operator=(MatchEventLog&&) = delete;
+
+			static constexpr Nz::UInt32 FileVersion = 1;
+			static constexpr std::size_t HeaderSize = 16;
+			static constexpr std::size_t RecordAlignment = 8;
+			static constexpr std::size_t RecordHeaderSize = 8;
+
+		private:
+			std::size_t BeginRecord(MatchEventType type, Nz::UInt64 tick);
+			void EndRecord(std::size_t recordOffset);
+			Nz::UInt32 RegisterString(Nz::UInt64 tick, std::string_view str);
+
+			tsl::hopscotch_map<std::string, Nz::UInt32> m_stringIds;
+			BinaryFileWriter m_writer;
+	};
+}
+
+#include <CoreLib/MatchEventLog.inl>
+
+#endif
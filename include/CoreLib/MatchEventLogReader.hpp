@@ -0,0 +1,106 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_CORELIB_MATCHEVENTLOGREADER_HPP
+#define BURGWAR_CORELIB_MATCHEVENTLOGREADER_HPP
+
+#include <CoreLib/EntityId.hpp>
+#include <CoreLib/Export.hpp>
+#include <CoreLib/LayerIndex.hpp>
+#include <CoreLib/MatchEventLog.hpp>
+#include <CoreLib/Utility/MappedFile.hpp>
+#include <Nazara/Math/Vector2.hpp>
+#include <filesystem>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace bw
+{
+	// Reads events of a memory-mapped match event log, string references are resolved to views of the file
+	class BURGWAR_CORELIB_API MatchEventLogReader
+	{
+		public:
+			struct Event;
+
+			MatchEventLogReader(const std::filesystem::path& filePath);
+			MatchEventLogReader(const MatchEventLogReader&) = delete;
+			MatchEventLogReader(MatchEventLogReader&&) noexcept = default;
+			~MatchEventLogReader() = default;
+
+			inline bool IsTruncated() const;
+
+			bool ReadEvent(Event& event);
+
+			MatchEventLogReader& operator=(const MatchEventLogReader&) = delete;
+			MatchEventLogReader& operator=(MatchEventLogReader&&) noexcept = default;
+
+			struct EntityDestroyed
+			{
+				EntityId entityId;
+			};
+
+			struct EntityDied
+			{
+				EntityId entityId;
+				EntityId attackerId;
+			};
+
+			struct EntityHealthChanged
+			{
+				EntityId entityId;
+				EntityId sourceId;
+				Nz::UInt16 oldHealth;
+				Nz::UInt16 newHealth;
+				Nz::UInt16 maxHealth;
+			};
+
+			struct EntitySpawned
+			{
+				EntityId entityId;
+				std::string_view entityClass;
+				LayerIndex layerIndex;
+				Nz::Vector2f position;
+			};
+
+			struct PlayerJoined
+			{
+				Nz::UInt16 playerIndex;
+				std::string_view playerName;
+			};
+
+			struct PlayerLeft
+			{
+				Nz::UInt16 playerIndex;
+				Nz::UInt8 reason;
+			};
+
+			struct TickTiming
+			{
+				Nz::UInt32 durationUs;
+			};
+
+			using EventData = std::variant<EntityDestroyed, EntityDied, EntityHealthChanged, EntitySpawned, PlayerJoined, PlayerLeft, TickTiming>;
+
+			struct Event
+			{
+				EventData data;
+				Nz::UInt32 tick;
+			};
+
+		private:
+			std::string_view GetString(Nz::UInt32 stringId) const;
+
+			std::size_t m_cursor;
+			std::vector<std::string_view> m_strings;
+			MappedFile m_file;
+			bool m_isTruncated;
+	};
+}
+
+#include <CoreLib/MatchEventLogReader.inl>
+
+#endif
@@ -0,0 +1,16 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/MatchEventLogReader.hpp>
+
+namespace bw
+{
+	/*!
+	* \brief Returns true if the last record of the log was incomplete (server was interrupted while writing it)
+	*/
+	inline bool MatchEventLogReader::IsTruncated() const
+	{
+		return m_isTruncated;
+	}
+}
@@ -0,0 +1,59 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_CORELIB_MATCHREPLAYREADER_HPP
+#define BURGWAR_CORELIB_MATCHREPLAYREADER_HPP
+
+#include <CoreLib/Export.hpp>
+#include <CoreLib/MatchReplayRecorder.hpp>
+#include <CoreLib/Utility/MappedFile.hpp>
+#include <filesystem>
+
+namespace bw
+{
+	// Reads events of a memory-mapped match replay, packet contents are views of the file
+	class BURGWAR_CORELIB_API MatchReplayReader
+	{
+		public:
+			struct Event;
+
+			MatchReplayReader(const std::filesystem::path& filePath);
+			MatchReplayReader(const MatchReplayReader&) = delete;
+			MatchReplayReader(MatchReplayReader&&) noexcept = default;
+			~MatchReplayReader() = default;
+
+			inline const MatchReplayInfo& GetInfo() const;
+
+			inline bool IsTruncated() const;
+
+			bool ReadEvent(Event& event);
+
+			MatchReplayReader& operator=(const MatchReplayReader&) = delete;
+			MatchReplayReader& operator=(MatchReplayReader&&) noexcept = default;
+
+			struct Event
+			{
+				ReplayEventType type;
+				Nz::UInt64 tick;
+				std::size_t sessionId;
+				const Nz::UInt8* packetData;
+				std::size_t packetSize;
+				Nz::UInt16 packetNetCode;
+				Nz::UInt32 ping;
+			};
+
+		private:
+			std::size_t m_cursor;
+			MatchReplayInfo m_info;
+			MappedFile m_file;
+			Nz::UInt64 m_lastTick;
+			bool m_isTruncated;
+	};
+}
+
+#include <CoreLib/MatchReplayReader.inl>
+
+#endif
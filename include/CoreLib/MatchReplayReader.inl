@@ -0,0 +1,18 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/MatchReplayReader.hpp>
+
+namespace bw
+{
+	inline const MatchReplayInfo& MatchReplayReader::GetInfo() const
+	{
+		return m_info;
+	}
+
+	inline bool MatchReplayReader::IsTruncated() const
+	{
+		return m_isTruncated;
+	}
+}
@@ -0,0 +1,80 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_CORELIB_MATCHREPLAYRECORDER_HPP
+#define BURGWAR_CORELIB_MATCHREPLAYRECORDER_HPP
+
+#include <CoreLib/Export.hpp>
+#include <CoreLib/Utility/BinaryFileWriter.hpp>
+#include <Nazara/Network/NetPacket.hpp>
+#include <nlohmann/json.hpp>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace bw
+{
+	class Logger;
+
+	enum class ReplayEventType : Nz::UInt8
+	{
+		SessionConnected    = 0,
+		SessionDisconnected = 1,
+		SessionPacket       = 2,
+		SessionPing         = 3
+	};
+
+	struct MatchReplayInfo
+	{
+		std::string gamemode;
+		std::string gameVersion;
+		std::string mapPath;
+		std::string name;
+		std::vector<std::string> mods;
+		nlohmann::json map; //< Map::Serialize output, used to detect map changes when playing back
+		Nz::UInt64 maxPlayerCount;
+		Nz::UInt64 randomSeed;
+		bool sleepWhenEmpty;
+		float tickDuration;
+	};
+
+	// Records everything a match receives from the outside (sessions and their messages), tagged by tick, so it can be played back (see ReplaySessionManager)
+	class BURGWAR_CORELIB_API MatchReplayRecorder
+	{
+		public:
+			MatchReplayRecorder(const Logger& logger, const std::filesystem::path& filePath, const MatchReplayInfo& replayInfo);
+			MatchReplayRecorder(const MatchReplayRecorder&) = delete;
+			MatchReplayRecorder(MatchReplayRecorder&&) = delete;
+			~MatchReplayRecorder() = default;
+
+			inline void Flush();
+
+			void RecordSessionConnected(Nz::UInt64 tick, std::size_t sessionId);
+			void RecordSessionDisconnected(Nz::UInt64 tick, std::size_t sessionId);
+			void RecordSessionPacket(Nz::UInt64 tick, std::size_t sessionId, const Nz::NetPacket& packet);
+			void RecordSessionPing(Nz::UInt64 tick, std::size_t sessionId, Nz::UInt32 ping);
+
+			MatchReplayRecorder& operator=(const MatchReplayRecorder&) = delete;
+			MatchReplayRecorder& operator=(MatchReplayRecorder&&) = delete;
+
+			static constexpr Nz::UInt32 FileVersion = 1;
+			static constexpr std::size_t HeaderSize = 16;
+
+			static nlohmann::json SerializeInfo(const MatchReplayInfo& replayInfo);
+			static MatchReplayInfo UnserializeInfo(const nlohmann::json& infoJson);
+
+		private:
+			void BeginEvent(ReplayEventType type, Nz::UInt64 tick, std::size_t sessionId);
+			void EndEvent();
+
+			BinaryFileWriter m_writer;
+			Nz::UInt64 m_lastTick;
+	};
+}
+
+#include <CoreLib/MatchReplayRecorder.inl>
+
+#endif
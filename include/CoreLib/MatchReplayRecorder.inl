@@ -0,0 +1,13 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/MatchReplayRecorder.hpp>
+
+namespace bw
+{
+	inline void MatchReplayRecorder::Flush()
+	{
+		m_writer.Flush();
+	}
+}
@@ -36,6 +36,7 @@ namespace bw
 
 			template<typename F> void ForEachSession(F&& cb);
 
+			inline PlayerCommandStore& GetCommandStore();
 			inline Match& GetMatch();
 
 			void Poll();
@@ -20,6 +20,11 @@ namespace bw
 			cb(pair.second);
 	}
 
+	inline PlayerCommandStore& MatchSessions::GetCommandStore()
+	{
+		return m_commandStore;
+	}
+
 	inline Match& MatchSessions::GetMatch()
 	{
 		return m_match;
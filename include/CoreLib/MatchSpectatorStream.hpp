@@ -0,0 +1,84 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_CORELIB_MATCHSPECTATORSTREAM_HPP
+#define BURGWAR_CORELIB_MATCHSPECTATORSTREAM_HPP
+
+#include <CoreLib/Export.hpp>
+#include <CoreLib/MatchClientSession.hpp>
+#include <CoreLib/MatchDemoRecorder.hpp>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace bw
+{
+	class Match;
+	class MatchClientVisibility;
+	class PlayerCommandStore;
+
+	// Builds a single full-visibility stream of the match state and sends the same serialized packets to every spectator (and to a demo file)
+	class BURGWAR_CORELIB_API MatchSpectatorStream
+	{
+		public:
+			MatchSpectatorStream(Match& match, PlayerCommandStore& commandStore);
+			MatchSpectatorStream(const MatchSpectatorStream&) = delete;
+			MatchSpectatorStream(MatchSpectatorStream&&) = delete;
+			~MatchSpectatorStream();
+
+			void AddSpectator(MatchClientSession* session);
+
+			template<typename T> void BroadcastPacket(const T& packet, bool onlyReady = true);
+
+			void Clear();
+
+			inline std::size_t GetSpectatorCount() const;
+			inline MatchClientVisibility* GetVisibility();
+
+			void OnSpectatorReady(MatchClientSession* session);
+
+			void RemoveSpectator(MatchClientSession* session);
+
+			void StartDemo(const std::filesystem::path& demoPath);
+
+			void Update(float elapsedTime);
+
+			MatchSpectatorStream& operator=(const MatchSpectatorStream&) = delete;
+			MatchSpectatorStream& operator=(MatchSpectatorStream&&) = delete;
+
+			static constexpr float DemoKeyframeInterval = 10.f; //< in seconds
+
+		private:
+			class StreamBridge;
+
+			std::unique_ptr<MatchClientSession> CreateStreamSession(std::shared_ptr<StreamBridge> bridge);
+			void Dispatch(Nz::UInt8 channelId, Nz::ENetPacketFlags flags, Nz::NetPacket&& packet, const std::vector<MatchClientSession*>& targets, bool isKeyframe, bool recordDemo);
+			template<typename T> void RecordDemoPacket(const T& packet);
+			void SendKeyframe(bool includeDemo);
+			void SendMatchPrelude();
+			void SendPlayerList(MatchClientSession& session);
+
+			static constexpr std::size_t StreamSessionId = std::numeric_limits<std::size_t>::max();
+
+			std::optional<MatchDemoRecorder> m_demoRecorder;
+			std::shared_ptr<StreamBridge> m_streamBridge;
+			std::unique_ptr<MatchClientSession> m_streamSession;
+			std::vector<MatchClientSession*> m_connectingSpectators; //< authenticated, downloading resources
+			std::vector<MatchClientSession*> m_keyframeTargets;
+			std::vector<MatchClientSession*> m_pendingSpectators; //< ready, waiting for a keyframe
+			std::vector<MatchClientSession*> m_spectators;
+			Match& m_match;
+			PlayerCommandStore& m_commandStore;
+			bool m_isDemoKeyframe;
+			float m_demoKeyframeTimer;
+	};
+}
+
+#include <CoreLib/MatchSpectatorStream.inl>
+
+#endif
@@ -0,0 +1,39 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/MatchSpectatorStream.hpp>
+#include <CoreLib/PlayerCommandStore.hpp>
+
+namespace bw
+{
+	template<typename T>
+	void MatchSpectatorStream::BroadcastPacket(const T& packet, bool onlyReady)
+	{
+		// Serialized once for every spectator receiving the stream
+		if (m_streamSession)
+			m_streamSession->SendPacket(packet);
+
+		if (!onlyReady)
+		{
+			for (MatchClientSession* session : m_connectingSpectators)
+				session->SendPacket(packet);
+
+			for (MatchClientSession* session : m_pendingSpectators)
+				session->SendPacket(packet);
+		}
+	}
+
+	inline std::size_t MatchSpectatorStream::GetSpectatorCount() const
+	{
+		return m_connectingSpectators.size() + m_pendingSpectators.size() + m_spectators.size();
+	}
+
+	inline MatchClientVisibility* MatchSpectatorStream::GetVisibility()
+	{
+		if (!m_streamSession)
+			return nullptr;
+
+		return &m_streamSession->GetVisibility();
+	}
+}
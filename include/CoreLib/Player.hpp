@@ -39,6 +39,8 @@ namespace bw
 			Player(Player&&) noexcept = default;
 			~Player();
 
+			Nz::UInt64 EstimateViewTick() const;
+
 			inline const Ndk::EntityHandle& GetControlledEntity() const;
 			inline const PlayerInputData& GetInputs() const;
 			inline LayerIndex GetLayerIndex() const;
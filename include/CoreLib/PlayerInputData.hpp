@@ -21,8 +21,8 @@ namespace bw
 		bool isMovingLeft = false;
 		bool isMovingRight = false;
 
-		inline bool operator==(const PlayerInputData& rhs);
-		inline bool operator!=(const PlayerInputData& rhs);
+		inline bool operator==(const PlayerInputData& rhs) const;
+		inline bool operator!=(const PlayerInputData& rhs) const;
 	};
 }
 
@@ -6,7 +6,7 @@
 
 namespace bw
 {
-	inline bool PlayerInputData::operator==(const PlayerInputData& rhs)
+	inline bool PlayerInputData::operator==(const PlayerInputData& rhs) const
 	{
 		return aimDirection == rhs.aimDirection && 
 		       isAttacking == rhs.isAttacking && 
@@ -17,7 +17,7 @@ namespace bw
 		       isMovingRight == rhs.isMovingRight;
 	}
 
-	inline bool PlayerInputData::operator!=(const PlayerInputData& rhs)
+	inline bool PlayerInputData::operator!=(const PlayerInputData& rhs) const
 	{
 		return !operator==(rhs);
 	}
@@ -82,6 +82,9 @@ namespace bw
 			PropertyArrayValue& operator=(const PropertyArrayValue&);
 			PropertyArrayValue& operator=(PropertyArrayValue&&) noexcept = default;
 
+			bool operator==(const PropertyArrayValue& container) const;
+			bool operator!=(const PropertyArrayValue& container) const;
+
 		private:
 			std::size_t m_size;
 			std::unique_ptr<UnderlyingType[]> m_arrayData;
@@ -106,6 +109,9 @@ namespace bw
 		PropertySingleValue& operator=(const PropertySingleValue&) = default;
 		PropertySingleValue& operator=(PropertySingleValue&&) = default;
 
+		bool operator==(const PropertySingleValue& property) const;
+		bool operator!=(const PropertySingleValue& property) const;
+
 		UnderlyingType value;
 	};
 
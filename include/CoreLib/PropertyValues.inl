@@ -3,6 +3,7 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <CoreLib/PropertyValues.hpp>
+#include <algorithm>
 #include <cassert>
 
 namespace bw
@@ -120,6 +121,18 @@ namespace bw
 		return *this;
 	}
 
+	template<PropertyType P>
+	bool PropertyArrayValue<P>::operator==(const PropertyArrayValue& container) const
+	{
+		return m_size == container.m_size && std::equal(begin(), end(), container.begin());
+	}
+
+	template<PropertyType P>
+	bool PropertyArrayValue<P>::operator!=(const PropertyArrayValue& container) const
+	{
+		return !operator==(container);
+	}
+
 
 	template<PropertyType P>
 	PropertySingleValue<P>::PropertySingleValue(const UnderlyingType& v) :
@@ -151,6 +164,18 @@ namespace bw
 		return value;
 	}
 
+	template<PropertyType P>
+	bool PropertySingleValue<P>::operator==(const PropertySingleValue& property) const
+	{
+		return value == property.value;
+	}
+
+	template<PropertyType P>
+	bool PropertySingleValue<P>::operator!=(const PropertySingleValue& property) const
+	{
+		return !operator==(property);
+	}
+
 
 	template<typename T>
 	Nz::Vector4<T> TranslateRectToVec(const Nz::Rect<T>& value)
@@ -127,7 +127,8 @@ namespace bw
 				std::optional<PlayerInputData> inputs;
 				std::optional<PlayerMovementData> playerMovement;
 				std::optional<PhysicsProperties> physicsProperties;
-				std::vector<Property> properties;
+				std::vector<Property> properties; //< for map entities, only properties which differ from the map
+				bool isMapEntity = false;
 			};
 		}
 
@@ -250,12 +251,14 @@ namespace bw
 
 		DeclarePacket(DownloadClientFileFragment)
 		{
+			CompressedUnsigned<Nz::UInt32> downloadId;
 			CompressedUnsigned<Nz::UInt32> fragmentIndex;
 			std::vector<Nz::UInt8> fragmentContent;
 		};
 
 		DeclarePacket(DownloadClientFileRequest)
 		{
+			CompressedUnsigned<Nz::UInt32> downloadId;
 			std::string path;
 		};
 
@@ -279,6 +282,7 @@ namespace bw
 
 			using SuccessFailureVariant = std::variant<Success, Failure>; //< TODO: bw::Option?
 
+			CompressedUnsigned<Nz::UInt32> downloadId;
 			SuccessFailureVariant content;
 		};
 
@@ -460,6 +464,7 @@ namespace bw
 			std::vector<Helper::Property> gamemodeProperties;
 			std::vector<ClientFile> assets;
 			std::vector<ClientFile> scripts;
+			std::optional<std::array<Nz::UInt8, 20>> mapChecksum; //< set if map entities are built from the map asset having this checksum
 			Nz::UInt16 currentTick;
 			float tickDuration;
 		};
@@ -560,9 +565,16 @@ namespace bw
 
 		DeclarePacket(PlayersInput)
 		{
+			struct TickInputs
+			{
+				Nz::UInt16 inputTick;
+				std::vector<PlayerInputData> inputs;
+			};
+
 			Nz::UInt16 estimatedServerTick;
-			Nz::UInt16 inputTick;
-			std::vector<std::optional<PlayerInputData>> inputs;
+			std::vector<TickInputs> inputs; //< from the most recent to the oldest, previous ticks are resent to make up for packet loss
+
+			static constexpr std::size_t MaxTickInputs = 16;
 		};
 
 		DeclarePacket(PlayerSelectWeapon)
@@ -0,0 +1,41 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_CORELIB_REPLAYSESSIONBRIDGE_HPP
+#define BURGWAR_CORELIB_REPLAYSESSIONBRIDGE_HPP
+
+#include <CoreLib/Export.hpp>
+#include <CoreLib/SessionBridge.hpp>
+#include <functional>
+#include <vector>
+
+namespace bw
+{
+	class BURGWAR_CORELIB_API ReplaySessionBridge : public SessionBridge
+	{
+		public:
+			inline ReplaySessionBridge();
+			~ReplaySessionBridge();
+
+			void AnswerInfoQuery(Nz::UInt32 ping);
+
+			void Disconnect() override;
+
+			bool IsLocal() const override;
+
+			void QueryInfo(std::function<void(const SessionInfo& info)> callback) const override;
+
+			void SendPacket(Nz::UInt8 channelId, Nz::ENetPacketFlags flags, Nz::NetPacket&& packet) override;
+
+		private:
+			mutable std::vector<std::function<void(const SessionInfo& info)>> m_pendingInfoQueries;
+			SessionInfo m_sessionInfo;
+	};
+}
+
+#include <CoreLib/ReplaySessionBridge.inl>
+
+#endif
@@ -0,0 +1,14 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/ReplaySessionBridge.hpp>
+
+namespace bw
+{
+	inline ReplaySessionBridge::ReplaySessionBridge() :
+	SessionBridge(nullptr),
+	m_sessionInfo()
+	{
+	}
+}
@@ -0,0 +1,52 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_CORELIB_REPLAYSESSIONMANAGER_HPP
+#define BURGWAR_CORELIB_REPLAYSESSIONMANAGER_HPP
+
+#include <CoreLib/Export.hpp>
+#include <CoreLib/MatchReplayReader.hpp>
+#include <CoreLib/SessionManager.hpp>
+#include <tsl/hopscotch_map.h>
+#include <memory>
+
+namespace bw
+{
+	class MatchClientSession;
+	class MatchSessions;
+	class ReplaySessionBridge;
+
+	// Feeds sessions recorded by MatchReplayRecorder back to a match, tick by tick
+	class BURGWAR_CORELIB_API ReplaySessionManager : public SessionManager
+	{
+		public:
+			ReplaySessionManager(MatchSessions* owner, MatchReplayReader replayReader);
+			~ReplaySessionManager();
+
+			inline bool IsFinished() const;
+
+			void Poll() override;
+
+		private:
+			void HandleEvent(const MatchReplayReader::Event& event);
+
+			struct ReplaySession
+			{
+				std::shared_ptr<ReplaySessionBridge> bridge;
+				MatchClientSession* session;
+			};
+
+			tsl::hopscotch_map<std::size_t /*recordedSessionId*/, ReplaySession> m_sessions;
+			MatchReplayReader m_reader;
+			MatchReplayReader::Event m_pendingEvent;
+			bool m_hasPendingEvent;
+			bool m_isFinished;
+	};
+}
+
+#include <CoreLib/ReplaySessionManager.inl>
+
+#endif
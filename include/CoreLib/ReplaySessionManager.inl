@@ -0,0 +1,13 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/ReplaySessionManager.hpp>
+
+namespace bw
+{
+	inline bool ReplaySessionManager::IsFinished() const
+	{
+		return m_isFinished;
+	}
+}
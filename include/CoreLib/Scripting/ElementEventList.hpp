@@ -28,6 +28,9 @@ BURGWAR_EVENT(Tick)
 BURGWAR_EVENT(Frame)
 BURGWAR_EVENT(PostFrame)
 
+// Editor element events
+BURGWAR_EVENT(PropertyChanged)
+
 /*** Entities ***/
 BURGWAR_EVENT(InputUpdate)
 
@@ -29,6 +29,7 @@ namespace bw
 			void RegisterInputControllerClass(ScriptingContext& context) override;
 			void RegisterMatchLibrary(ScriptingContext& context, sol::table& library) override;
 			void RegisterNetworkLibrary(ScriptingContext& context, sol::table& library) override;
+			void RegisterPhysicsLibrary(ScriptingContext& context, sol::table& library) override;
 			void RegisterPlayerClass(ScriptingContext& context);
 			void RegisterScriptLibrary(ScriptingContext& context, sol::table& library) override;
 			void RegisterServerTextureClass(ScriptingContext& context);
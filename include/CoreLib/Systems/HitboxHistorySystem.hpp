@@ -0,0 +1,80 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_CORELIB_SYSTEMS_HITBOXHISTORYSYSTEM_HPP
+#define BURGWAR_CORELIB_SYSTEMS_HITBOXHISTORYSYSTEM_HPP
+
+#include <CoreLib/EntityId.hpp>
+#include <CoreLib/Export.hpp>
+#include <Nazara/Math/Rect.hpp>
+#include <Nazara/Math/Vector2.hpp>
+#include <NDK/EntityList.hpp>
+#include <NDK/System.hpp>
+#include <vector>
+
+namespace bw
+{
+	class SharedMatch;
+
+	// Keeps the world bounding boxes of damageable physics entities for the last few ticks, allowing hit queries
+	// to be evaluated against what clients were seeing instead of the current physics state
+	class BURGWAR_CORELIB_API HitboxHistorySystem : public Ndk::System<HitboxHistorySystem>
+	{
+		public:
+			struct TraceHit;
+
+			HitboxHistorySystem(SharedMatch& match);
+			~HitboxHistorySystem() = default;
+
+			inline Nz::UInt64 GetNewestTick() const;
+			inline Nz::UInt64 GetOldestTick() const;
+			inline bool HasHistory() const;
+
+			template<typename F> void RegionQuery(Nz::UInt64 tick, const Nz::Rectf& rect, F&& callback);
+			template<typename F> void TraceQuery(Nz::UInt64 tick, const Nz::Vector2f& startPos, const Nz::Vector2f& endPos, F&& callback);
+			bool TraceQueryFirst(Nz::UInt64 tick, const Nz::Vector2f& startPos, const Nz::Vector2f& endPos, TraceHit* hitInfo = nullptr, const Ndk::Entity* ignoredEntity = nullptr);
+
+			struct TraceHit
+			{
+				Ndk::EntityHandle entity;
+				Nz::Vector2f hitNormal;
+				Nz::Vector2f hitPos;
+				float fraction;
+			};
+
+			static constexpr float HistoryDuration = 0.5f;
+
+			static Ndk::SystemIndex systemIndex;
+
+		private:
+			struct Snapshot;
+
+			const Snapshot* FetchSnapshot(Nz::UInt64 tick) const;
+			void OnUpdate(float elapsedTime) override;
+
+			static bool IntersectSegment(const Nz::Vector2f& startPos, const Nz::Vector2f& endPos, float minX, float minY, float maxX, float maxY, float* fraction, Nz::Vector2f* hitNormal);
+
+			// Structure of arrays, a query only touches the bounds of each hitbox until it hits something
+			struct Snapshot
+			{
+				Nz::UInt64 tick;
+				std::vector<EntityId> uniqueIds;
+				std::vector<float> maxX;
+				std::vector<float> maxY;
+				std::vector<float> minX;
+				std::vector<float> minY;
+			};
+
+			std::size_t m_newestSnapshot;
+			std::size_t m_snapshotCount;
+			std::vector<Snapshot> m_snapshots;
+			SharedMatch& m_match;
+	};
+}
+
+#include <CoreLib/Systems/HitboxHistorySystem.inl>
+
+#endif
@@ -0,0 +1,107 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/Systems/HitboxHistorySystem.hpp>
+#include <CoreLib/SharedMatch.hpp>
+#include <NDK/World.hpp>
+#include <NDK/Systems/PhysicsSystem2D.hpp>
+#include <cassert>
+
+namespace bw
+{
+	inline Nz::UInt64 HitboxHistorySystem::GetNewestTick() const
+	{
+		assert(HasHistory());
+		return m_snapshots[m_newestSnapshot].tick;
+	}
+
+	inline Nz::UInt64 HitboxHistorySystem::GetOldestTick() const
+	{
+		assert(HasHistory());
+		std::size_t oldestSnapshot = (m_newestSnapshot + m_snapshots.size() + 1 - m_snapshotCount) % m_snapshots.size();
+		return m_snapshots[oldestSnapshot].tick;
+	}
+
+	inline bool HitboxHistorySystem::HasHistory() const
+	{
+		return m_snapshotCount > 0;
+	}
+
+	/*!
+	* \brief Calls callback for every entity overlapping rect at a given tick
+	*
+	* Hitboxes tracked by this system are tested as they were at the requested tick (clamped to the available history),
+	* other bodies are tested against the live physics world.
+	*/
+	template<typename F>
+	void HitboxHistorySystem::RegionQuery(Nz::UInt64 tick, const Nz::Rectf& rect, F&& callback)
+	{
+		if (const Snapshot* snapshot = FetchSnapshot(tick))
+		{
+			float rectMaxX = rect.x + rect.width;
+			float rectMaxY = rect.y + rect.height;
+
+			std::size_t hitboxCount = snapshot->uniqueIds.size();
+			for (std::size_t i = 0; i < hitboxCount; ++i)
+			{
+				if (snapshot->maxX[i] < rect.x || snapshot->minX[i] > rectMaxX || snapshot->maxY[i] < rect.y || snapshot->minY[i] > rectMaxY)
+					continue;
+
+				if (const Ndk::EntityHandle& entity = m_match.RetrieveEntityByUniqueId(snapshot->uniqueIds[i]))
+					callback(entity);
+			}
+		}
+
+		auto& physSystem = GetWorld().GetSystem<Ndk::PhysicsSystem2D>();
+		physSystem.RegionQuery(rect, 0, 0xFFFFFFFF, 0xFFFFFFFF, [&](const Ndk::EntityHandle& entity)
+		{
+			if (!HasHistory() || !HasEntity(entity))
+				callback(entity);
+		});
+	}
+
+	/*!
+	* \brief Calls callback for every entity crossed by a segment at a given tick
+	*
+	* Hitboxes tracked by this system are tested as they were at the requested tick (clamped to the available history),
+	* other bodies are tested against the live physics world.
+	*/
+	template<typename F>
+	void HitboxHistorySystem::TraceQuery(Nz::UInt64 tick, const Nz::Vector2f& startPos, const Nz::Vector2f& endPos, F&& callback)
+	{
+		if (const Snapshot* snapshot = FetchSnapshot(tick))
+		{
+			TraceHit hitInfo;
+
+			std::size_t hitboxCount = snapshot->uniqueIds.size();
+			for (std::size_t i = 0; i < hitboxCount; ++i)
+			{
+				if (!IntersectSegment(startPos, endPos, snapshot->minX[i], snapshot->minY[i], snapshot->maxX[i], snapshot->maxY[i], &hitInfo.fraction, &hitInfo.hitNormal))
+					continue;
+
+				hitInfo.entity = m_match.RetrieveEntityByUniqueId(snapshot->uniqueIds[i]);
+				if (!hitInfo.entity)
+					continue;
+
+				hitInfo.hitPos = Nz::Vector2f::Lerp(startPos, endPos, hitInfo.fraction);
+				callback(hitInfo);
+			}
+		}
+
+		auto& physSystem = GetWorld().GetSystem<Ndk::PhysicsSystem2D>();
+		physSystem.RaycastQuery(startPos, endPos, 1.f, 0, 0xFFFFFFFF, 0xFFFFFFFF, [&](const Ndk::PhysicsSystem2D::RaycastHit& raycastHit)
+		{
+			if (HasHistory() && HasEntity(raycastHit.body))
+				return;
+
+			TraceHit hitInfo;
+			hitInfo.entity = raycastHit.body;
+			hitInfo.fraction = raycastHit.fraction;
+			hitInfo.hitNormal = raycastHit.hitNormal;
+			hitInfo.hitPos = raycastHit.hitPos;
+
+			callback(hitInfo);
+		});
+	}
+}
@@ -96,8 +96,9 @@ namespace bw
 				std::optional<PlayerMovementData> playerMovement;
 				std::optional<PhysicsProperties> physicsProperties;
 				std::string entityClass;
-				tsl::hopscotch_map<std::string /*key*/, PropertyValue> properties;
+				tsl::hopscotch_map<std::string /*key*/, PropertyValue> properties; //< for map entities, only properties which differ from the map
 				std::vector<std::pair<LayerIndex, Ndk::EntityId>> dependentIds;
+				bool isMapEntity;
 			};
 
 			struct EntityDeath
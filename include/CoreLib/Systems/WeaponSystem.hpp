@@ -7,13 +7,27 @@
 #ifndef BURGWAR_CORELIB_SYSTEMS_WEAPONSYSTEM_HPP
 #define BURGWAR_CORELIB_SYSTEMS_WEAPONSYSTEM_HPP
 
+#include <CoreLib/EntityId.hpp>
 #include <CoreLib/Export.hpp>
+#include <CoreLib/Components/WeaponComponent.hpp>
+#include <Nazara/Core/Signal.hpp>
+#include <Nazara/Math/Vector2.hpp>
 #include <NDK/EntityList.hpp>
 #include <NDK/System.hpp>
+#include <tsl/hopscotch_map.h>
+#include <limits>
 #include <vector>
 
+namespace Ndk
+{
+	class NodeComponent;
+}
+
 namespace bw
 {
+	class CooldownComponent;
+	class InputComponent;
+	class ScriptComponent;
 	class SharedMatch;
 
 	class BURGWAR_CORELIB_API WeaponSystem : public Ndk::System<WeaponSystem>
@@ -25,8 +39,60 @@ namespace bw
 			static Ndk::SystemIndex systemIndex;
 
 		private:
+			void ActivateWeapon(Ndk::Entity* weapon);
+			void DeactivateWeapon(Ndk::Entity* weapon);
+			void OnEntityAdded(Ndk::Entity* entity) override;
+			void OnEntityRemoved(Ndk::Entity* entity) override;
 			void OnUpdate(float elapsedTime) override;
 
+			// Packed data of active weapons with their owner components, to avoid looking them up every tick
+			struct ActiveWeapon
+			{
+				Ndk::EntityHandle owner;
+				Ndk::EntityHandle weapon;
+				CooldownComponent* weaponCooldown;
+				EntityId uniqueId;
+				InputComponent* ownerInputs;
+				Ndk::NodeComponent* ownerNode;
+				Ndk::NodeComponent* weaponNode;
+				ScriptComponent* weaponScript;
+				WeaponComponent* weaponComponent;
+				Nz::Vector2f lastAimDirection;
+				std::size_t classIndex;
+				bool isAimValid = false;
+				bool wasOwnerFlipped = false;
+			};
+
+			enum class AttackEventType
+			{
+				Attack,
+				AttackFinish
+			};
+
+			struct AttackEvent
+			{
+				AttackEventType type;
+				EntityId uniqueId;
+				Ndk::EntityHandle weapon;
+				ScriptComponent* weaponScript;
+				std::size_t classIndex;
+			};
+
+			void PushAttackEvent(AttackEventType type, const ActiveWeapon& activeWeapon);
+
+			struct WeaponData
+			{
+				std::size_t activeIndex = InvalidIndex;
+
+				NazaraSlot(WeaponComponent, OnActiveUpdate, onActiveUpdate);
+				NazaraSlot(WeaponComponent, OnOwnerUpdate, onOwnerUpdate);
+			};
+
+			static constexpr std::size_t InvalidIndex = std::numeric_limits<std::size_t>::max();
+
+			std::vector<ActiveWeapon> m_activeWeapons;
+			std::vector<AttackEvent> m_attackEvents;
+			tsl::hopscotch_map<Ndk::EntityId, WeaponData> m_weaponData;
 			SharedMatch& m_match;
 	};
 }
@@ -0,0 +1,66 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_CORELIB_TILEMAPCOLLISIONBUILDER_HPP
+#define BURGWAR_CORELIB_TILEMAPCOLLISIONBUILDER_HPP
+
+#include <CoreLib/Export.hpp>
+#include <Nazara/Math/Rect.hpp>
+#include <Nazara/Math/Vector2.hpp>
+#include <vector>
+
+namespace bw
+{
+	// Merges solid cells of a tilemap into as few rectangles as possible (greedy meshing), cell coordinates are used everywhere
+	class BURGWAR_CORELIB_API TilemapCollisionBuilder
+	{
+		public:
+			struct Segment;
+
+			TilemapCollisionBuilder(const Nz::Vector2ui& mapSize);
+			template<typename T> TilemapCollisionBuilder(const Nz::Vector2ui& mapSize, const T* content);
+			TilemapCollisionBuilder(const TilemapCollisionBuilder&) = default;
+			TilemapCollisionBuilder(TilemapCollisionBuilder&&) noexcept = default;
+			~TilemapCollisionBuilder() = default;
+
+			void Build();
+			std::vector<Segment> BuildOutline() const;
+
+			inline const Nz::Vector2ui& GetMapSize() const;
+			inline const std::vector<Nz::Rectui>& GetRects() const;
+
+			inline bool IsSolid(unsigned int x, unsigned int y) const;
+
+			inline void SetCell(unsigned int x, unsigned int y, bool isSolid);
+
+			bool UpdateCell(unsigned int x, unsigned int y, bool isSolid);
+
+			TilemapCollisionBuilder& operator=(const TilemapCollisionBuilder&) = default;
+			TilemapCollisionBuilder& operator=(TilemapCollisionBuilder&&) noexcept = default;
+
+			struct Segment
+			{
+				Nz::Vector2ui from;
+				Nz::Vector2ui to;
+			};
+
+		private:
+			inline std::size_t GetCellIndex(unsigned int x, unsigned int y) const;
+			void MergeRegion(const Nz::Rectui& region);
+			void RemoveRect(std::size_t rectIndex);
+
+			static constexpr Nz::UInt32 NoRect = 0xFFFFFFFF;
+
+			std::vector<bool> m_cells;
+			std::vector<Nz::Rectui> m_rects;
+			std::vector<Nz::UInt32> m_cellRects; //< index of the rect covering each cell
+			Nz::Vector2ui m_mapSize;
+	};
+}
+
+#include <CoreLib/TilemapCollisionBuilder.inl>
+
+#endif
@@ -0,0 +1,46 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/TilemapCollisionBuilder.hpp>
+#include <cassert>
+
+namespace bw
+{
+	template<typename T>
+	TilemapCollisionBuilder::TilemapCollisionBuilder(const Nz::Vector2ui& mapSize, const T* content) :
+	TilemapCollisionBuilder(mapSize)
+	{
+		for (std::size_t i = 0; i < m_cells.size(); ++i)
+			m_cells[i] = (content[i] != 0);
+
+		Build();
+	}
+
+	inline const Nz::Vector2ui& TilemapCollisionBuilder::GetMapSize() const
+	{
+		return m_mapSize;
+	}
+
+	inline const std::vector<Nz::Rectui>& TilemapCollisionBuilder::GetRects() const
+	{
+		return m_rects;
+	}
+
+	inline bool TilemapCollisionBuilder::IsSolid(unsigned int x, unsigned int y) const
+	{
+		return m_cells[GetCellIndex(x, y)];
+	}
+
+	inline void TilemapCollisionBuilder::SetCell(unsigned int x, unsigned int y, bool isSolid)
+	{
+		// Rects are not updated, Build has to be called afterwards (see UpdateCell)
+		m_cells[GetCellIndex(x, y)] = isSolid;
+	}
+
+	inline std::size_t TilemapCollisionBuilder::GetCellIndex(unsigned int x, unsigned int y) const
+	{
+		assert(x < m_mapSize.x && y < m_mapSize.y);
+		return std::size_t(y) * m_mapSize.x + x;
+	}
+}
@@ -9,6 +9,7 @@
 
 #include <CoreLib/Export.hpp>
 #include <Nazara/Prerequisites.hpp>
+#include <tsl/hopscotch_map.h>
 #include <functional>
 #include <vector>
 
@@ -20,24 +21,47 @@ namespace bw
 	{
 		public:
 			using Callback = std::function<void()>;
+			using TimerId = Nz::UInt64;
 
-			TimerManager() = default;
+			inline TimerManager();
 			~TimerManager() = default;
 
+			inline bool Cancel(TimerId timerId);
 			inline void Clear();
 
-			inline void PushCallback(Nz::UInt64 expirationTime, Callback finish);
+			inline std::size_t GetPendingTimerCount() const;
 
-			inline void Update(Nz::UInt64 now);
+			TimerId PushCallback(Nz::UInt64 expirationTime, Callback callback);
+
+			void Update(Nz::UInt64 now);
+
+			static constexpr TimerId InvalidTimerId = 0;
 
 		private:
-			struct Timer
+			void RemoveCancelledTimers();
+
+			// Only ids are moved around in the heap, callbacks stay in the map
+			struct PendingTimer
 			{
-				Callback callback;
 				Nz::UInt64 expirationTime;
+				TimerId timerId;
+			};
+
+			struct TimerCompare
+			{
+				// std heap functions build a max-heap, reverse order (ids break ties so timers expiring together trigger in creation order)
+				bool operator()(const PendingTimer& lhs, const PendingTimer& rhs) const
+				{
+					if (lhs.expirationTime != rhs.expirationTime)
+						return lhs.expirationTime > rhs.expirationTime;
+
+					return lhs.timerId > rhs.timerId;
+				}
 			};
 
-			std::vector<Timer> m_pendingTimers;
+			std::vector<PendingTimer> m_timerQueue;
+			tsl::hopscotch_map<TimerId, Callback> m_callbacks;
+			TimerId m_nextTimerId;
 	};
 }
 
@@ -6,36 +6,25 @@
 
 namespace bw
 {
-	inline void TimerManager::Clear()
+	inline TimerManager::TimerManager() :
+	m_nextTimerId(InvalidTimerId + 1)
 	{
-		m_pendingTimers.clear();
 	}
 
-	inline void TimerManager::PushCallback(Nz::UInt64 expirationTime, Callback callback)
+	inline bool TimerManager::Cancel(TimerId timerId)
 	{
-		Timer& timer = m_pendingTimers.emplace_back();
-		timer.callback = std::move(callback);
-		timer.expirationTime = expirationTime;
-
-		//TODO: Insertion sort
+		// Timer stays in the queue until it expires or the queue gets compacted
+		return m_callbacks.erase(timerId) > 0;
 	}
 
-	inline void TimerManager::Update(Nz::UInt64 now)
+	inline void TimerManager::Clear()
 	{
-		// Use index instead of iterator because callback may push new timers
-		for (std::size_t i = 0; i < m_pendingTimers.size();)
-		{
-			if (now > m_pendingTimers[i].expirationTime)
-			{
-				auto it = m_pendingTimers.begin() + i;
-
-				Timer timer = std::move(*it);
-				m_pendingTimers.erase(it);
+		m_callbacks.clear();
+		m_timerQueue.clear();
+	}
 
-				timer.callback();
-			}
-			else
-				++i;
-		}
+	inline std::size_t TimerManager::GetPendingTimerCount() const
+	{
+		return m_callbacks.size();
 	}
 }
@@ -0,0 +1,55 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_CORELIB_UTILITY_BINARYFILEWRITER_HPP
+#define BURGWAR_CORELIB_UTILITY_BINARYFILEWRITER_HPP
+
+#include <CoreLib/Export.hpp>
+#include <Nazara/Core/File.hpp>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace bw
+{
+	class Logger;
+
+	// Appends data to a binary file through a memory buffer, written to the file by blocks of FlushThreshold bytes
+	class BURGWAR_CORELIB_API BinaryFileWriter
+	{
+		public:
+			BinaryFileWriter(const Logger& logger, const std::filesystem::path& filePath, std::string fileDescription, std::size_t maxRecordSize);
+			BinaryFileWriter(const BinaryFileWriter&) = delete;
+			BinaryFileWriter(BinaryFileWriter&&) = delete;
+			~BinaryFileWriter();
+
+			void Flush();
+			inline void FlushIfNeeded();
+
+			inline std::vector<Nz::UInt8>& GetBuffer();
+
+			inline void Write(const Nz::UInt8* data, std::size_t size);
+			void WriteHeader(const char* signature, Nz::UInt32 fileVersion, Nz::UInt32 headerData);
+			template<typename T> void WriteLE(T value);
+			inline void WriteVarUInt(Nz::UInt64 value);
+
+			BinaryFileWriter& operator=(const BinaryFileWriter&) = delete;
+			BinaryFileWriter& operator=(BinaryFileWriter&&) = delete;
+
+			static constexpr std::size_t FlushThreshold = 64 * 1024;
+			static constexpr std::size_t HeaderSize = 16;
+
+		private:
+			const Logger& m_logger;
+			std::string m_fileDescription;
+			std::vector<Nz::UInt8> m_buffer;
+			Nz::File m_file;
+	};
+}
+
+#include <CoreLib/Utility/BinaryFileWriter.inl>
+
+#endif
@@ -0,0 +1,36 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/Utility/BinaryFileWriter.hpp>
+#include <CoreLib/Utility/BinaryIO.hpp>
+
+namespace bw
+{
+	inline void BinaryFileWriter::FlushIfNeeded()
+	{
+		if (m_buffer.size() >= FlushThreshold)
+			Flush();
+	}
+
+	inline std::vector<Nz::UInt8>& BinaryFileWriter::GetBuffer()
+	{
+		return m_buffer;
+	}
+
+	inline void BinaryFileWriter::Write(const Nz::UInt8* data, std::size_t size)
+	{
+		m_buffer.insert(m_buffer.end(), data, data + size);
+	}
+
+	template<typename T>
+	void BinaryFileWriter::WriteLE(T value)
+	{
+		bw::WriteLE(m_buffer, value);
+	}
+
+	inline void BinaryFileWriter::WriteVarUInt(Nz::UInt64 value)
+	{
+		bw::WriteVarUInt(m_buffer, value);
+	}
+}
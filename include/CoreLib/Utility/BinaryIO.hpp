@@ -0,0 +1,26 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_CORELIB_UTILITY_BINARYIO_HPP
+#define BURGWAR_CORELIB_UTILITY_BINARYIO_HPP
+
+#include <Nazara/Prerequisites.hpp>
+#include <vector>
+
+namespace bw
+{
+	// Helpers used by our binary file formats, fixed-size values are stored in little-endian and VarUInt are LEB128-encoded
+	template<typename T> T ReadLE(const Nz::UInt8* ptr);
+	inline bool ReadVarUInt(const Nz::UInt8* data, std::size_t size, std::size_t& cursor, Nz::UInt64& value);
+
+	template<typename T> void WriteLE(Nz::UInt8* ptr, T value);
+	template<typename T> void WriteLE(std::vector<Nz::UInt8>& buffer, T value);
+	inline void WriteVarUInt(std::vector<Nz::UInt8>& buffer, Nz::UInt64 value);
+}
+
+#include <CoreLib/Utility/BinaryIO.inl>
+
+#endif
@@ -0,0 +1,72 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/Utility/BinaryIO.hpp>
+#include <Nazara/Core/Endianness.hpp>
+#include <cstring>
+#include <stdexcept>
+
+namespace bw
+{
+	template<typename T>
+	T ReadLE(const Nz::UInt8* ptr)
+	{
+		T value;
+		std::memcpy(&value, ptr, sizeof(T));
+		if (Nz::GetPlatformEndianness() != Nz::Endianness_LittleEndian)
+			Nz::SwapBytes(&value, sizeof(T));
+
+		return value;
+	}
+
+	// Returns false if data ends in the middle of the value
+	bool ReadVarUInt(const Nz::UInt8* data, std::size_t size, std::size_t& cursor, Nz::UInt64& value)
+	{
+		value = 0;
+		for (unsigned int shift = 0; shift < 64; shift += 7)
+		{
+			if (cursor >= size)
+				return false;
+
+			Nz::UInt8 byte = data[cursor++];
+			value |= static_cast<Nz::UInt64>(byte & 0x7F) << shift;
+
+			if ((byte & 0x80) == 0)
+				return true;
+		}
+
+		throw std::runtime_error("corrupted data (invalid varint)");
+	}
+
+	template<typename T>
+	void WriteLE(Nz::UInt8* ptr, T value)
+	{
+		if (Nz::GetPlatformEndianness() != Nz::Endianness_LittleEndian)
+			Nz::SwapBytes(&value, sizeof(T));
+
+		std::memcpy(ptr, &value, sizeof(T));
+	}
+
+	template<typename T>
+	void WriteLE(std::vector<Nz::UInt8>& buffer, T value)
+	{
+		std::size_t offset = buffer.size();
+		buffer.resize(offset + sizeof(T));
+		WriteLE(&buffer[offset], value);
+	}
+
+	void WriteVarUInt(std::vector<Nz::UInt8>& buffer, Nz::UInt64 value)
+	{
+		do
+		{
+			Nz::UInt8 byte = static_cast<Nz::UInt8>(value & 0x7F);
+			value >>= 7;
+			if (value != 0)
+				byte |= 0x80;
+
+			buffer.push_back(byte);
+		}
+		while (value != 0);
+	}
+}
@@ -0,0 +1,47 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_CORELIB_UTILITY_MAPPEDFILE_HPP
+#define BURGWAR_CORELIB_UTILITY_MAPPEDFILE_HPP
+
+#include <CoreLib/Export.hpp>
+#include <Nazara/Prerequisites.hpp>
+#include <filesystem>
+
+namespace bw
+{
+	// Read-only view of a whole file mapped into memory
+	class BURGWAR_CORELIB_API MappedFile
+	{
+		public:
+			inline MappedFile();
+			inline MappedFile(const std::filesystem::path& filePath);
+			MappedFile(const MappedFile&) = delete;
+			inline MappedFile(MappedFile&& file) noexcept;
+			inline ~MappedFile();
+
+			void Close();
+
+			inline const Nz::UInt8* GetData() const;
+			inline std::size_t GetSize() const;
+
+			inline bool IsOpen() const;
+
+			bool Open(const std::filesystem::path& filePath);
+
+			MappedFile& operator=(const MappedFile&) = delete;
+			inline MappedFile& operator=(MappedFile&& file) noexcept;
+
+		private:
+			const Nz::UInt8* m_data;
+			std::size_t m_size;
+			bool m_isOpen;
+	};
+}
+
+#include <CoreLib/Utility/MappedFile.inl>
+
+#endif
@@ -0,0 +1,60 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/Utility/MappedFile.hpp>
+#include <utility>
+
+namespace bw
+{
+	inline MappedFile::MappedFile() :
+	m_data(nullptr),
+	m_size(0),
+	m_isOpen(false)
+	{
+	}
+
+	inline MappedFile::MappedFile(const std::filesystem::path& filePath) :
+	MappedFile()
+	{
+		Open(filePath);
+	}
+
+	inline MappedFile::MappedFile(MappedFile&& file) noexcept :
+	m_data(std::exchange(file.m_data, nullptr)),
+	m_size(std::exchange(file.m_size, 0)),
+	m_isOpen(std::exchange(file.m_isOpen, false))
+	{
+	}
+
+	inline MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	inline const Nz::UInt8* MappedFile::GetData() const
+	{
+		return m_data;
+	}
+
+	inline std::size_t MappedFile::GetSize() const
+	{
+		return m_size;
+	}
+
+	inline bool MappedFile::IsOpen() const
+	{
+		return m_isOpen;
+	}
+
+	inline MappedFile& MappedFile::operator=(MappedFile&& file) noexcept
+	{
+		Close();
+
+		m_data = std::exchange(file.m_data, nullptr);
+		m_size = std::exchange(file.m_size, 0);
+		m_isOpen = std::exchange(file.m_isOpen, false);
+
+		return *this;
+	}
+}
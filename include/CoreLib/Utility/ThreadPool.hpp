@@ -0,0 +1,57 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_CORELIB_THREADPOOL_HPP
+#define BURGWAR_CORELIB_THREADPOOL_HPP
+
+#include <CoreLib/Export.hpp>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bw
+{
+	class BURGWAR_CORELIB_API ThreadPool
+	{
+		public:
+			using Task = std::function<void()>;
+
+			ThreadPool(std::size_t workerCount = 0, std::string name = "Worker");
+			ThreadPool(const ThreadPool&) = delete;
+			ThreadPool(ThreadPool&&) = delete;
+			~ThreadPool();
+
+			inline std::size_t GetWorkerCount() const;
+
+			void PushTask(Task task);
+
+			void WaitForAll();
+
+			ThreadPool& operator=(const ThreadPool&) = delete;
+			ThreadPool& operator=(ThreadPool&&) = delete;
+
+			static std::size_t GetDefaultWorkerCount();
+
+		private:
+			void WorkerThread();
+
+			std::condition_variable m_taskSignal;
+			std::condition_variable m_idleSignal;
+			std::mutex m_mutex;
+			std::queue<Task> m_tasks;
+			std::size_t m_pendingTaskCount;
+			std::vector<std::thread> m_workers;
+			bool m_running;
+	};
+}
+
+#include <CoreLib/Utility/ThreadPool.inl>
+
+#endif
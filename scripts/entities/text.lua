@@ -15,4 +15,19 @@ if (CLIENT) then
 			Text = self:GetProperty("text")
 		})
 	end)
+
+	if (EDITOR) then
+		entity:On("PropertyChanged", function (self, propertyName)
+			if (propertyName == "text") then
+				self.Text:SetText(self:GetProperty("text"))
+			elseif (propertyName == "renderOrder") then
+				-- Render order cannot be changed on an existing text, replace it
+				self.Text:Hide()
+				self.Text = self:AddText({
+					RenderOrder = self:GetProperty("renderOrder"),
+					Text = self:GetProperty("text")
+				})
+			end
+		end)
+	end
 end
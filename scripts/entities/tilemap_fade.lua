@@ -48,13 +48,6 @@ if (CLIENT) then
 	function entity:UpdateAlpha(value)
 		self.Alpha = math.floor(math.clamp(value, minAlpha, maxAlpha))
 
-		local color = { r = 255, g = 255, b = 255, a = self.Alpha }
-
-		local mapSize = self.Tilemap:GetMapSize()
-		for y = 0, mapSize.y - 1 do
-			for x = 0, mapSize.x - 1 do
-				self.Tilemap:SetTileColor(x, y, color)
-			end
-		end
+		self.Tilemap:SetColor({ r = 255, g = 255, b = 255, a = self.Alpha })
 	end
 end
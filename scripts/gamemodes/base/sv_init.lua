@@ -4,8 +4,6 @@ gamemode.PlayerEntity = "entity_burger"
 
 gamemode.PlayerSeeds = {}
 
-math.randomseed(os.time())
-
 gamemode.BasePlayerDeathSlot = gamemode:OnAsync("PlayerDeath", function (self, player, attacker)
 	print(player:GetName() .. " died")
 	timer.Sleep(self:GetProperty("respawntime") * 1000)
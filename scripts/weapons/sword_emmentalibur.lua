@@ -33,7 +33,10 @@ if (SERVER) then
 		local rect = Rect(origin + mins * scale, origin + maxs * scale)
 
 		local ownerEntity = self:GetOwnerEntity()
-		physics.RegionQuery(self:GetLayerIndex(), rect, function (entity)
+		local owner = self:GetOwner()
+		local tick = owner and owner:GetViewTick() or match.GetTick()
+
+		physics.RegionQueryAt(tick, self:GetLayerIndex(), rect, function (entity)
 			if (entity == ownerEntity or entity == self) then
 				return
 			end
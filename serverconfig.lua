@@ -13,10 +13,15 @@ https://burgwar.digitalpulse.software/resources
 	MasterServers = [[
 https://bwmasterserver.digitalpulse.software
 	]],
+	ClientSideMapEntities = true,
+	DemoDirectory = "",
 	DisableWhenEmpty = true,
+	EventLogDirectory = "",
 	Gamemode = "deathmatch",
 	MapPath = "beta_map.bmap",
+	MaxSpectatorCount = 64,
 	Name = "no name set",
+	ReplayDirectory = "",
 	Description = "a description of your server",
 	TickRate = 33,
 }
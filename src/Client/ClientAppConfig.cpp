@@ -14,7 +14,9 @@ namespace bw
 		RegisterBoolOption("Debug.ShowServerGhosts");
 		RegisterBoolOption("Debug.ShowVersion", true);
 		RegisterStringOption("Resources.AssetCacheDirectory", ".assetCache");
+		RegisterIntegerOption("Resources.AssetCacheMaxSize", 0, 0xFFFFFFFF, 2048); //< In MiB, 0 means unlimited
 		RegisterStringOption("Resources.ScriptCacheDirectory", ".scriptCache");
+		RegisterIntegerOption("Resources.ScriptCacheMaxSize", 0, 0xFFFFFFFF, 128); //< In MiB, 0 means unlimited
 		RegisterIntegerOption("WindowSettings.AntialiasingLevel", 0, 16);
 		RegisterBoolOption("WindowSettings.Fullscreen");
 		RegisterBoolOption("WindowSettings.VSync");
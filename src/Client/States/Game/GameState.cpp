@@ -10,14 +10,14 @@
 
 namespace bw
 {
-	GameState::GameState(std::shared_ptr<StateData> stateDataPtr, std::shared_ptr<ClientSession> clientSession, const Packets::AuthSuccess& authSuccess, const Packets::MatchData& matchData, std::shared_ptr<VirtualDirectory> assetDirectory, std::shared_ptr<VirtualDirectory> scriptDirectory) :
+	GameState::GameState(std::shared_ptr<StateData> stateDataPtr, std::shared_ptr<ClientSession> clientSession, const Packets::AuthSuccess& authSuccess, const Packets::MatchData& matchData, std::shared_ptr<ClientAssetStore> assetStore, std::shared_ptr<VirtualDirectory> scriptDirectory) :
 	AbstractState(std::move(stateDataPtr)),
 	m_clientSession(std::move(clientSession))
 	{
 		StateData& stateData = GetStateData();
 
 		m_match = std::make_shared<ClientMatch>(*stateData.app, stateData.window, stateData.window, &stateData.canvas.value(), *m_clientSession, authSuccess, matchData);
-		m_match->LoadAssets(std::move(assetDirectory));
+		m_match->LoadAssets(std::move(assetStore));
 		m_match->LoadScripts(std::move(scriptDirectory));
 
 		if (stateData.app->GetConfig().GetBoolValue("Debug.ShowServerGhosts"))
@@ -13,13 +13,14 @@
 
 namespace bw
 {
+	class ClientAssetStore;
 	class ClientMatch;
 	class VirtualDirectory;
 
 	class GameState final : public AbstractState
 	{
 		public:
-			GameState(std::shared_ptr<StateData> stateDataPtr, std::shared_ptr<ClientSession> clientSession, const Packets::AuthSuccess& authSuccess, const Packets::MatchData& matchData, std::shared_ptr<VirtualDirectory> assetDirectory, std::shared_ptr<VirtualDirectory> scriptDirectory);
+			GameState(std::shared_ptr<StateData> stateDataPtr, std::shared_ptr<ClientSession> clientSession, const Packets::AuthSuccess& authSuccess, const Packets::MatchData& matchData, std::shared_ptr<ClientAssetStore> assetStore, std::shared_ptr<VirtualDirectory> scriptDirectory);
 			~GameState() = default;
 
 			inline const std::shared_ptr<ClientMatch>& GetMatch();
@@ -29,9 +29,22 @@ namespace bw
 
 		m_downloadManagers.emplace_back(std::make_unique<PacketDownloadManager>(m_clientSession));
 
+		// Downloaded files are stored by checksum and shared between servers
+		constexpr Nz::UInt64 MiB = 1024 * 1024;
+
+		const std::string& assetCacheDir = config.GetStringValue("Resources.AssetCacheDirectory");
+		m_assetCache.emplace(app->GetLogger(), assetCacheDir, config.GetIntegerValue<Nz::UInt64>("Resources.AssetCacheMaxSize") * MiB);
+		m_assetCache->Load();
+
+		m_scriptCache.emplace(app->GetLogger(), config.GetStringValue("Resources.ScriptCacheDirectory"), config.GetIntegerValue<Nz::UInt64>("Resources.ScriptCacheMaxSize") * MiB);
+		m_scriptCache->Load();
+
+		m_localHashCache.emplace(app->GetLogger(), std::filesystem::u8path(assetCacheDir) / "localHashes.json");
+		m_localHashCache->Load();
+
 		// Register scripts before adding HTTP download manager (since we won't get theses files from fast download)
 		auto scriptDir = std::make_shared<VirtualDirectory>(config.GetStringValue("Resources.ScriptDirectory"));
-		RegisterFiles(m_matchData.scripts, scriptDir, m_targetScriptDirectory, config.GetStringValue("Resources.ScriptCacheDirectory"), m_scriptData, true);
+		RegisterFiles(m_matchData.scripts, scriptDir, m_targetScriptDirectory, *m_scriptCache, m_scriptData, true);
 
 		if (!m_matchData.fastDownloadUrls.empty())
 		{
@@ -43,7 +56,17 @@ namespace bw
 
 		// Register assets files
 		auto assetDir = std::make_shared<VirtualDirectory>(config.GetStringValue("Resources.AssetDirectory"));
-		RegisterFiles(m_matchData.assets, assetDir, m_targetAssetDirectory, config.GetStringValue("Resources.AssetCacheDirectory"), m_assetData, false);
+		RegisterFiles(m_matchData.assets, assetDir, m_targetAssetDirectory, *m_assetCache, m_assetData, false);
+
+		m_localHashCache->Save();
+
+		// Start decoding assets we already have while the others are downloading, the rest will be prefetched as they arrive
+		m_assetStore = std::make_shared<ClientAssetStore>(app->GetLogger(), m_targetAssetDirectory);
+		for (const auto& asset : m_matchData.assets)
+		{
+			if (m_assetData.find(asset.path) == m_assetData.end())
+				m_assetStore->Prefetch(asset.path);
+		}
 
 		for (auto& downloadManagerPtr : m_downloadManagers)
 		{
@@ -73,9 +96,16 @@ namespace bw
 
 				bwLog(GetStateData().app->GetLogger(), LogLevel::Info, "Downloaded {} ({})", fileEntry.downloadPath, ByteToString(downloadSpeed, true));
 				if (isAsset)
+				{
+					m_assetCache->Register(realPath);
 					m_targetAssetDirectory->StoreFile(fileEntry.downloadPath, realPath);
+					m_assetStore->Prefetch(fileEntry.downloadPath);
+				}
 				else
+				{
+					m_scriptCache->Register(realPath);
 					m_targetScriptDirectory->StoreFile(fileEntry.downloadPath, realPath);
+				}
 
 				UpdateStatus();
 			});
@@ -90,10 +120,19 @@ namespace bw
 				downloadData.downloadedSize = downloadData.totalSize;
 
 				bwLog(GetStateData().app->GetLogger(), LogLevel::Info, "Downloaded {} ({})", fileEntry.downloadPath, ByteToString(downloadSpeed, true));
+
+				// Download managers also write in-memory files to their output path
 				if (isAsset)
+				{
+					m_assetCache->Register(fileEntry.outputPath);
 					m_targetAssetDirectory->StoreFile(fileEntry.downloadPath, content);
+					m_assetStore->Prefetch(fileEntry.downloadPath);
+				}
 				else
+				{
+					m_scriptCache->Register(fileEntry.outputPath);
 					m_targetScriptDirectory->StoreFile(fileEntry.downloadPath, content);
+				}
 
 				UpdateStatus();
 			});
@@ -153,12 +192,20 @@ namespace bw
 				hasFinished = false;
 		}
 
+		m_assetStore->UpdateLoading(ClientAssetStore::AssetLoadingTimeBudget);
+
 		if (hasFinished && !IsSwitching())
 		{
+			for (ContentCache* contentCache : { &*m_assetCache, &*m_scriptCache })
+			{
+				contentCache->Evict();
+				contentCache->Save();
+			}
+
 			bwLog(GetStateData().app->GetLogger(), LogLevel::Info, "Creating match...");
 			UpdateStatus("Entering match...", Nz::Color::White);
 
-			SwitchToState(std::make_shared<GameState>(GetStateDataPtr(), m_clientSession, m_authSuccess, m_matchData, std::move(m_targetAssetDirectory), std::move(m_targetScriptDirectory)), 0.5f);
+			SwitchToState(std::make_shared<GameState>(GetStateDataPtr(), m_clientSession, m_authSuccess, m_matchData, std::move(m_assetStore), std::move(m_targetScriptDirectory)), 0.5f);
 		}
 
 		return true;
@@ -191,7 +238,7 @@ namespace bw
 		m_clientSession->Disconnect();
 	}
 
-	void ResourceDownloadState::RegisterFiles(const std::vector<Packets::MatchData::ClientFile>& files, const std::shared_ptr<VirtualDirectory>& resourceDir, const std::shared_ptr<VirtualDirectory>& targetDir, const std::string& cacheDir, FileMap& fileMap, bool keepInMemory)
+	void ResourceDownloadState::RegisterFiles(const std::vector<Packets::MatchData::ClientFile>& files, const std::shared_ptr<VirtualDirectory>& resourceDir, const std::shared_ptr<VirtualDirectory>& targetDir, ContentCache& contentCache, FileMap& fileMap, bool keepInMemory)
 	{
 		assert(!m_downloadManagers.empty());
 
@@ -227,9 +274,17 @@ namespace bw
 					}
 					else if constexpr (std::is_same_v<T, VirtualDirectory::PhysicalFileEntry>)
 					{
+						std::error_code ec;
+						if (std::filesystem::file_size(arg, ec) != resource.size || ec)
+							return false;
+
+						// Local files rarely change, skip hashing them if their size and last write time didn't change
+						auto fileHash = m_localHashCache->ComputeHash(arg);
+						if (!fileHash || fileHash->size != resource.size || fileHash->checksum != expectedChecksum)
+							return false;
+
 						if (keepInMemory)
 						{
-							Nz::ByteArray fileChecksum;
 							std::vector<Nz::UInt8> content;
 
 							Nz::File file(arg.generic_u8string());
@@ -240,25 +295,11 @@ namespace bw
 							if (file.Read(content.data(), content.size()) != content.size())
 								return false;
 
-							auto fileHash = Nz::AbstractHash::Get(Nz::HashType_SHA1);
-							fileHash->Begin();
-							fileHash->Append(content.data(), content.size());
-
-							if (expectedChecksum != fileHash->End())
-								return false;
-
 							targetDir->StoreFile(resource.path, content);
 							return true;
 						}
 						else
 						{
-							std::size_t fileSize = std::filesystem::file_size(arg);
-							if (fileSize != resource.size)
-								return false;
-
-							if (expectedChecksum != Nz::File::ComputeHash(Nz::HashType_SHA1, arg.generic_u8string()))
-								return false;
-
 							targetDir->StoreFile(resource.path, arg);
 							return true;
 						}
@@ -277,24 +318,15 @@ namespace bw
 			}
 
 			// Try to find file in cache
-			std::string hexChecksum = expectedChecksum.ToHex().ToStdString();
-
-			std::filesystem::path cachePath = cacheDir / std::filesystem::u8path(resource.path);
-			cachePath.replace_extension(hexChecksum + cachePath.extension().generic_u8string());
-
-			if (std::filesystem::is_regular_file(cachePath))
+			std::string extension = std::filesystem::u8path(resource.path).extension().generic_u8string();
+			if (auto cachePathOpt = contentCache.Find(resource.sha1Checksum, resource.size, extension))
 			{
-				std::size_t fileSize = std::filesystem::file_size(cachePath);
-				if (fileSize == resource.size)
-				{
-					if (expectedChecksum == Nz::File::ComputeHash(Nz::HashType_SHA1, cachePath.generic_u8string()))
-					{
-						targetDir->StoreFile(resource.path, cachePath);
-						continue;
-					}
-				}
+				targetDir->StoreFile(resource.path, std::move(*cachePathOpt));
+				continue;
 			}
 
+			std::filesystem::path cachePath = contentCache.BuildPath(resource.sha1Checksum, extension);
+
 			downloadManagerPtr->RegisterFile(resource.path, resource.sha1Checksum, resource.size, std::move(cachePath), keepInMemory);
 			fileMap.emplace(resource.path, FileData{ 0, resource.size });
 		}
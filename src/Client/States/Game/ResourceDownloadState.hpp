@@ -7,7 +7,10 @@
 #ifndef BURGWAR_STATES_GAME_ASSETDOWNLOADSTATE_HPP
 #define BURGWAR_STATES_GAME_ASSETDOWNLOADSTATE_HPP
 
+#include <ClientLib/ClientAssetStore.hpp>
+#include <ClientLib/ContentCache.hpp>
 #include <ClientLib/DownloadManager.hpp>
+#include <CoreLib/FileHashCache.hpp>
 #include <CoreLib/Protocol/Packets.hpp>
 #include <Client/States/Game/CancelableState.hpp>
 #include <NDK/Widgets/LabelWidget.hpp>
@@ -40,14 +43,18 @@ namespace bw
 
 			void OnCancelled() override;
 
-			void RegisterFiles(const std::vector<Packets::MatchData::ClientFile>& files, const std::shared_ptr<VirtualDirectory>& resourceDir, const std::shared_ptr<VirtualDirectory>& targetDir, const std::string& cacheDir, FileMap& fileMap, bool keepInMemory);
+			void RegisterFiles(const std::vector<Packets::MatchData::ClientFile>& files, const std::shared_ptr<VirtualDirectory>& resourceDir, const std::shared_ptr<VirtualDirectory>& targetDir, ContentCache& contentCache, FileMap& fileMap, bool keepInMemory);
 			bool Update(Ndk::StateMachine& fsm, float elapsedTime) override;
 
 			using CancelableState::UpdateStatus;
 			void UpdateStatus();
 
+			std::optional<ContentCache> m_assetCache;
+			std::optional<ContentCache> m_scriptCache;
+			std::optional<FileHashCache> m_localHashCache;
 			FileMap m_assetData;
 			FileMap m_scriptData;
+			std::shared_ptr<ClientAssetStore> m_assetStore;
 			std::shared_ptr<ClientSession> m_clientSession;
 			std::shared_ptr<VirtualDirectory> m_targetAssetDirectory;
 			std::shared_ptr<VirtualDirectory> m_targetScriptDirectory;
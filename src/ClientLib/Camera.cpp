@@ -59,6 +59,21 @@ namespace bw
 		return entityCamera.GetViewport();
 	}
 
+	Nz::Rectf Camera::GetVisibleRect() const
+	{
+		// World area visible at depth 0 (where layers are rendered), built from the viewport corners
+		const Nz::Recti& viewport = GetViewport();
+
+		Nz::Vector2f topLeft = Unproject(Nz::Vector2f(float(viewport.x), float(viewport.y)));
+
+		Nz::Rectf visibleRect(topLeft.x, topLeft.y, 0.f, 0.f);
+		visibleRect.ExtendTo(Unproject(Nz::Vector2f(float(viewport.x + viewport.width), float(viewport.y))));
+		visibleRect.ExtendTo(Unproject(Nz::Vector2f(float(viewport.x), float(viewport.y + viewport.height))));
+		visibleRect.ExtendTo(Unproject(Nz::Vector2f(float(viewport.x + viewport.width), float(viewport.y + viewport.height))));
+
+		return visibleRect;
+	}
+
 	Nz::Vector2f Camera::Project(const Nz::Vector2f& worldPosition) const
 	{
 		auto& entityCamera = m_cameraEntity->GetComponent<Ndk::CameraComponent>();
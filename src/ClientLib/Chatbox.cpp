@@ -84,10 +84,11 @@ namespace bw
 
 	void Chatbox::PrintMessage(std::vector<Item> message)
 	{
-		auto logContext = m_logger.PushContext();
-		logContext->level = LogLevel::Info;
-		if (m_logger.ShouldLog(*logContext))
+		if (m_logger.IsLevelEnabled(LogLevel::Info))
 		{
+			auto logContext = m_logger.PushContext();
+			logContext->level = LogLevel::Info;
+
 			std::string textMessage;
 
 			for (const Item& messageItem : message)
@@ -102,7 +103,8 @@ namespace bw
 				}, messageItem);
 			}
 
-			m_logger.LogFormat(*logContext, "{0}", textMessage);
+			if (m_logger.ShouldLog(*logContext))
+				m_logger.LogFormat(*logContext, "{0}", textMessage);
 		}
 
 		m_chatLines.emplace_back(std::move(message));
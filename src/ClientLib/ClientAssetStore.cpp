@@ -3,9 +3,89 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <ClientLib/ClientAssetStore.hpp>
+#include <CoreLib/Utils.hpp>
+#include <CoreLib/LogSystem/Logger.hpp>
+#include <CoreLib/Utility/VirtualDirectory.hpp>
+#include <Nazara/Core/Clock.hpp>
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
 
 namespace bw
 {
+	namespace
+	{
+		Nz::ModelParameters BuildModelParameters()
+		{
+			Nz::ModelParameters loaderParameters;
+			loaderParameters.material.shaderName = "Basic";
+			loaderParameters.mesh.animated = false;
+			loaderParameters.mesh.center = true;
+			loaderParameters.mesh.storage = Nz::DataStorage_Hardware;
+
+			return loaderParameters;
+		}
+
+		Nz::SoundBufferParams BuildSoundBufferParameters()
+		{
+			Nz::SoundBufferParams loaderParameters;
+			loaderParameters.forceMono = true;
+
+			return loaderParameters;
+		}
+
+		template<typename T>
+		bool IsReady(const std::future<T>& future)
+		{
+			return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		}
+
+		// Decoding happens on a worker thread, the entry is resolved beforehand as VirtualDirectory isn't thread-safe
+		template<typename ResourceType, typename ParameterType>
+		std::future<Nz::ObjectRef<ResourceType>> PushLoadTask(ThreadPool& threadPool, const std::shared_ptr<VirtualDirectory>& assetDirectory, const std::string& assetPath, ParameterType params)
+		{
+			using ResourceRef = Nz::ObjectRef<ResourceType>;
+
+			VirtualDirectory::Entry entry;
+			if (!assetDirectory->GetEntry(assetPath, &entry) || std::holds_alternative<VirtualDirectory::VirtualDirectoryEntry>(entry))
+			{
+				std::promise<ResourceRef> failure;
+				failure.set_value(nullptr);
+
+				return failure.get_future();
+			}
+
+			auto task = std::make_shared<std::packaged_task<ResourceRef()>>([entry = std::move(entry), params = std::move(params)]() -> ResourceRef
+			{
+				return std::visit([&](auto&& arg) -> ResourceRef
+				{
+					using T = std::decay_t<decltype(arg)>;
+					if constexpr (std::is_same_v<T, VirtualDirectory::FileContentEntry>)
+						return ResourceType::LoadFromMemory(arg.data(), arg.size(), params);
+					else if constexpr (std::is_same_v<T, VirtualDirectory::PhysicalFileEntry>)
+						return ResourceType::LoadFromFile(arg.generic_u8string(), params);
+					else if constexpr (std::is_same_v<T, VirtualDirectory::VirtualDirectoryEntry>)
+						return nullptr;
+					else
+						static_assert(AlwaysFalse<T>::value, "non-exhaustive visitor");
+				}, entry);
+			});
+
+			std::future<ResourceRef> result = task->get_future();
+			threadPool.PushTask([task = std::move(task)]() { (*task)(); });
+
+			return result;
+		}
+	}
+
+	ClientAssetStore::ClientAssetStore(const Logger& logger, std::shared_ptr<VirtualDirectory> assetDirectory) :
+	AssetStore(logger, std::move(assetDirectory)),
+	m_loadWorkers(std::min<std::size_t>(ThreadPool::GetDefaultWorkerCount(), 2), "AssetLoader")
+	{
+	}
+
 	void ClientAssetStore::Clear()
 	{
 		AssetStore::Clear();
@@ -13,31 +93,233 @@ namespace bw
 		m_models.clear();
 		m_soundBuffers.clear();
 		m_textures.clear();
+
+		for (auto& spriteMaterials : m_spriteMaterials)
+			spriteMaterials.clear();
+
+		// In-flight tasks will complete in the void
+		m_pendingModels.clear();
+		m_pendingSoundBuffers.clear();
+		m_pendingTextures.clear();
 	}
 
 	const Nz::ModelRef& ClientAssetStore::GetModel(const std::string& modelPath) const
 	{
-		Nz::ModelParameters loaderParameters;
-		loaderParameters.material.shaderName = "Basic";
-		loaderParameters.mesh.animated = false;
-		loaderParameters.mesh.center = true;
-		loaderParameters.mesh.storage = Nz::DataStorage_Hardware;
-
-		return GetResource(modelPath, m_models, loaderParameters);
+		return GetResource(modelPath, m_models, BuildModelParameters());
 	}
 
 	const Nz::SoundBufferRef& ClientAssetStore::GetSoundBuffer(const std::string& soundPath) const
 	{
-		Nz::SoundBufferParams loaderParameters;
-		loaderParameters.forceMono = true;
+		// If the sound is being loaded in the background, wait for it instead of loading it twice
+		if (auto it = m_pendingSoundBuffers.find(soundPath); it != m_pendingSoundBuffers.end())
+		{
+			std::future<Nz::SoundBufferRef> result = std::move(it.value());
+			m_pendingSoundBuffers.erase(it);
+
+			FinishSoundBufferLoading(soundPath, result);
+		}
+
+		return GetResource(soundPath, m_soundBuffers, BuildSoundBufferParameters());
+	}
+
+	const Nz::MaterialRef& ClientAssetStore::GetSpriteMaterial(const std::string& texturePath, bool repeatTexture) const
+	{
+		// Sprites sharing a material end up in the same batch of the render queue, so materials must not be modified by their users
+		auto& spriteMaterials = m_spriteMaterials[(repeatTexture) ? 1 : 0];
+		if (auto it = spriteMaterials.find(texturePath); it != spriteMaterials.end())
+			return it->second;
+
+		Nz::MaterialRef material = Nz::Material::New("Translucent2D");
+		if (!texturePath.empty())
+			material->SetDiffuseMap(GetTexture(texturePath));
 
-		return GetResource(soundPath, m_soundBuffers, loaderParameters);
+		auto& sampler = material->GetDiffuseSampler();
+		sampler.SetFilterMode(Nz::SamplerFilter_Bilinear);
+		if (repeatTexture)
+			sampler.SetWrapMode(Nz::SamplerWrap_Repeat);
+
+		return spriteMaterials.emplace(texturePath, std::move(material)).first->second;
 	}
 
 	const Nz::TextureRef& ClientAssetStore::GetTexture(const std::string& texturePath) const
 	{
+		// Sprites size themselves from their texture, so this has to return a loaded texture
+		if (auto it = m_pendingTextures.find(texturePath); it != m_pendingTextures.end())
+		{
+			std::future<Nz::ImageRef> result = std::move(it.value());
+			m_pendingTextures.erase(it);
+
+			FinishTextureLoading(texturePath, result);
+		}
+
 		Nz::ImageParams loaderParameters;
 
 		return GetResource(texturePath, m_textures, loaderParameters);
 	}
+
+	const Nz::TextureRef& ClientAssetStore::GetTextureAsync(const std::string& texturePath) const
+	{
+		if (auto it = m_textures.find(texturePath); it != m_textures.end())
+			return it->second;
+
+		if (m_pendingTextures.find(texturePath) == m_pendingTextures.end())
+			m_pendingTextures.emplace(texturePath, PushLoadTask<Nz::Image>(m_loadWorkers, GetAssetDirectory(), texturePath, Nz::ImageParams{}));
+
+		// Return a white placeholder which will be filled with the real image once it has been decoded
+		static constexpr std::array<Nz::UInt8, 4> whitePixel = { 0xFF, 0xFF, 0xFF, 0xFF };
+
+		Nz::TextureRef placeholder = Nz::Texture::New();
+		placeholder->Create(Nz::ImageType_2D, Nz::PixelFormatType_RGBA8, 1, 1);
+		placeholder->Update(whitePixel.data());
+
+		return m_textures.emplace(texturePath, std::move(placeholder)).first->second;
+	}
+
+	void ClientAssetStore::Prefetch(const std::string& assetPath)
+	{
+		std::string extension = std::filesystem::u8path(assetPath).extension().generic_u8string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+		if (extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".bmp" || extension == ".tga" || extension == ".gif")
+			PrefetchTexture(assetPath);
+		else if (extension == ".wav" || extension == ".ogg" || extension == ".flac")
+			PrefetchSoundBuffer(assetPath);
+		else if (extension == ".obj" || extension == ".md2" || extension == ".md5mesh")
+			PrefetchModel(assetPath);
+	}
+
+	void ClientAssetStore::PrefetchModel(const std::string& modelPath)
+	{
+		if (m_models.find(modelPath) != m_models.end())
+			return;
+
+		// Models own hardware buffers, they can only be loaded from the main thread (see UpdateLoading)
+		if (std::find(m_pendingModels.begin(), m_pendingModels.end(), modelPath) == m_pendingModels.end())
+			m_pendingModels.push_back(modelPath);
+	}
+
+	void ClientAssetStore::PrefetchSoundBuffer(const std::string& soundPath)
+	{
+		if (m_soundBuffers.find(soundPath) != m_soundBuffers.end() || m_pendingSoundBuffers.find(soundPath) != m_pendingSoundBuffers.end())
+			return;
+
+		// OpenAL calls are thread-safe, sound buffers can be fully loaded by workers
+		m_pendingSoundBuffers.emplace(soundPath, PushLoadTask<Nz::SoundBuffer>(m_loadWorkers, GetAssetDirectory(), soundPath, BuildSoundBufferParameters()));
+	}
+
+	void ClientAssetStore::PrefetchTexture(const std::string& texturePath)
+	{
+		if (m_textures.find(texturePath) != m_textures.end() || m_pendingTextures.find(texturePath) != m_pendingTextures.end())
+			return;
+
+		// Only decode the image on workers, the texture upload happens on the main thread
+		m_pendingTextures.emplace(texturePath, PushLoadTask<Nz::Image>(m_loadWorkers, GetAssetDirectory(), texturePath, Nz::ImageParams{}));
+	}
+
+	void ClientAssetStore::UpdateLoading(Nz::UInt64 timeBudget)
+	{
+		if (!HasPendingLoads())
+			return;
+
+		Nz::UInt64 startTime = Nz::GetElapsedMicroseconds();
+		auto HasTimeLeft = [&] { return Nz::GetElapsedMicroseconds() - startTime < timeBudget; };
+
+		// Always process at least one asset per call to guarantee progress
+		bool hasProcessedAsset = false;
+
+		std::vector<std::string> readyAssets;
+		for (auto it = m_pendingTextures.begin(); it != m_pendingTextures.end(); ++it)
+		{
+			if (IsReady(it->second))
+				readyAssets.push_back(it->first);
+		}
+
+		for (const std::string& texturePath : readyAssets)
+		{
+			if (hasProcessedAsset && !HasTimeLeft())
+				return;
+
+			auto it = m_pendingTextures.find(texturePath);
+			std::future<Nz::ImageRef> result = std::move(it.value());
+			m_pendingTextures.erase(it);
+
+			FinishTextureLoading(texturePath, result);
+			hasProcessedAsset = true;
+		}
+
+		readyAssets.clear();
+		for (auto it = m_pendingSoundBuffers.begin(); it != m_pendingSoundBuffers.end(); ++it)
+		{
+			if (IsReady(it->second))
+				readyAssets.push_back(it->first);
+		}
+
+		for (const std::string& soundPath : readyAssets)
+		{
+			auto it = m_pendingSoundBuffers.find(soundPath);
+			std::future<Nz::SoundBufferRef> result = std::move(it.value());
+			m_pendingSoundBuffers.erase(it);
+
+			// Sound buffers are already loaded, this is cheap
+			FinishSoundBufferLoading(soundPath, result);
+		}
+
+		while (!m_pendingModels.empty())
+		{
+			if (hasProcessedAsset && !HasTimeLeft())
+				return;
+
+			std::string modelPath = std::move(m_pendingModels.back());
+			m_pendingModels.pop_back();
+
+			GetModel(modelPath);
+			hasProcessedAsset = true;
+		}
+	}
+
+	void ClientAssetStore::FinishSoundBufferLoading(const std::string& soundPath, std::future<Nz::SoundBufferRef>& result) const
+	{
+		Nz::SoundBufferRef soundBuffer = result.get();
+		if (!soundBuffer)
+		{
+			bwLog(m_logger, LogLevel::Error, "Failed to load sound {}", soundPath);
+			return;
+		}
+
+		bwLog(m_logger, LogLevel::Debug, "Loaded sound {} in background", soundPath);
+		m_soundBuffers.emplace(soundPath, std::move(soundBuffer));
+	}
+
+	void ClientAssetStore::FinishTextureLoading(const std::string& texturePath, std::future<Nz::ImageRef>& result) const
+	{
+		auto it = m_textures.find(texturePath);
+
+		Nz::ImageRef image = result.get();
+		if (!image)
+		{
+			bwLog(m_logger, LogLevel::Error, "Failed to load texture {}", texturePath);
+
+			// Don't keep the placeholder, so GetTexture tries again (and reports the error) instead of returning a 1x1 texture
+			if (it != m_textures.end())
+				m_textures.erase(it);
+
+			return;
+		}
+
+		// Upload into the placeholder (if any) so everything using it gets the real texture
+		Nz::TextureRef texture = (it != m_textures.end()) ? it->second : Nz::Texture::New();
+		if (!texture->LoadFromImage(*image))
+		{
+			bwLog(m_logger, LogLevel::Error, "Failed to upload texture {}", texturePath);
+
+			if (it != m_textures.end())
+				m_textures.erase(it);
+
+			return;
+		}
+
+		bwLog(m_logger, LogLevel::Debug, "Loaded texture {} in background", texturePath);
+		if (it == m_textures.end())
+			m_textures.emplace(texturePath, std::move(texture));
+	}
 }
@@ -59,7 +59,7 @@ namespace bw
 		OutgoingCommand(PlayerChat,                  Nz::ENetPacketFlag_Reliable, 1);
 		OutgoingCommand(PlayerConsoleCommand,        Nz::ENetPacketFlag_Reliable, 1);
 		OutgoingCommand(PlayerSelectWeapon,          Nz::ENetPacketFlag_Reliable, 0);
-		OutgoingCommand(PlayersInput,                Nz::ENetPacketFlag_Reliable, 0);
+		OutgoingCommand(PlayersInput,                Nz::ENetPacketFlag_Unsequenced, 2);
 		OutgoingCommand(Ready,                       Nz::ENetPacketFlag_Reliable, 0);
 		OutgoingCommand(ScriptPacket,                Nz::ENetPacketFlag_Reliable, 1);
 		OutgoingCommand(UpdatePlayerName,            Nz::ENetPacketFlag_Reliable, 1);
@@ -45,6 +45,7 @@ namespace bw
 	ClientEditorLayer(std::move(layer)),
 	m_entities(std::move(layer.m_entities)),
 	m_serverEntityIds(std::move(layer.m_serverEntityIds)),
+	m_visibleRect(std::move(layer.m_visibleRect)),
 	m_backgroundColor(layer.m_backgroundColor),
 	m_isEnabled(layer.m_isEnabled),
 	m_isPredictionEnabled(layer.m_isPredictionEnabled)
@@ -185,12 +186,29 @@ namespace bw
 		return soundOpt->sound;
 	}
 
+	void ClientLayer::SetVisibleRect(std::optional<Nz::Rectf> visibleRect)
+	{
+		GetWorld().GetSystem<VisualInterpolationSystem>().SetVisibleRect(visibleRect);
+
+		m_visibleRect = std::move(visibleRect);
+	}
+
 	void ClientLayer::SyncVisuals()
 	{
-		ForEachLayerEntity([&](ClientLayerEntity& layerEntity)
+		if (m_visibleRect)
 		{
-			layerEntity.SyncVisuals();
-		});
+			ForEachLayerEntity([&](ClientLayerEntity& layerEntity)
+			{
+				layerEntity.SyncVisuals(*m_visibleRect);
+			});
+		}
+		else
+		{
+			ForEachLayerEntity([&](ClientLayerEntity& layerEntity)
+			{
+				layerEntity.SyncVisuals();
+			});
+		}
 	}
 
 	void ClientLayer::CreateEntity(Nz::UInt32 entityId, const Packets::Helper::EntityData& entityData)
@@ -216,6 +234,33 @@ namespace bw
 
 		EntityId uniqueId = static_cast<EntityId>(entityData.uniqueId);
 
+		// Only properties which changed are sent for map entities, the others come from our copy of the map
+		if (entityData.isMapEntity)
+		{
+			const Map* map = clientMatch.GetMap();
+			std::size_t elementIndex = entityStore.GetElementIndex(entityClass);
+			// Don't merge properties of another class if our map doesn't match the server one
+			const Map::Entity* mapEntity = nullptr;
+			if (map && map->HasEntity(uniqueId) && map->GetEntity(uniqueId).entityType == entityClass)
+				mapEntity = &map->GetEntity(uniqueId);
+
+			if (mapEntity && elementIndex != ClientEntityStore::InvalidIndex)
+			{
+				const auto& element = entityStore.GetElement(elementIndex);
+				for (auto&& [propertyName, propertyValue] : mapEntity->properties)
+				{
+					auto it = element->properties.find(propertyName);
+					if (it == element->properties.end() || !it->second.shared)
+						continue;
+
+					// Doesn't override properties sent by the server
+					properties.emplace(propertyName, propertyValue);
+				}
+			}
+			else
+				bwLog(GetMatch().GetLogger(), LogLevel::Warning, "Map entity #{0} ({1}) not found in map, some of its properties may be missing", uniqueId, entityClass);
+		}
+
 		const ClientLayerEntity* parent = nullptr;
 		if (entityData.parentId)
 		{
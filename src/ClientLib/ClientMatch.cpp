@@ -11,6 +11,7 @@
 #include <CoreLib/Components/WeaponComponent.hpp>
 #include <CoreLib/Scripting/NetworkPacket.hpp>
 #include <CoreLib/Scripting/ScriptingUtils.hpp>
+#include <CoreLib/Utility/VirtualDirectory.hpp>
 #include <CoreLib/Systems/AnimationSystem.hpp>
 #include <CoreLib/Systems/PlayerMovementSystem.hpp>
 #include <CoreLib/Systems/TickCallbackSystem.hpp>
@@ -32,6 +33,7 @@
 #include <ClientLib/Scripting/ClientWeaponLibrary.hpp>
 #include <ClientLib/Components/ClientMatchComponent.hpp>
 #include <ClientLib/Systems/SoundSystem.hpp>
+#include <Nazara/Core/File.hpp>
 #include <Nazara/Graphics/ColorBackground.hpp>
 #include <Nazara/Graphics/TileMap.hpp>
 #include <Nazara/Graphics/TextSprite.hpp>
@@ -43,6 +45,7 @@
 #include <NDK/Components.hpp>
 #include <NDK/Systems.hpp>
 #include <cassert>
+#include <cstring>
 #include <fstream>
 
 namespace bw
@@ -77,6 +80,27 @@ namespace bw
 
 		m_averageTickError.InsertValue(-static_cast<Nz::Int32>(matchData.currentTick));
 
+		m_assetPrefetchList.reserve(matchData.assets.size());
+		for (const auto& asset : matchData.assets)
+		{
+			// The map is not a resource scripts use, it's loaded with the other assets (see LoadAssets)
+			if (matchData.mapChecksum && asset.sha1Checksum == *matchData.mapChecksum)
+			{
+				m_mapAssetPath = asset.path;
+				m_mapChecksum = asset.sha1Checksum;
+				continue;
+			}
+
+			m_assetPrefetchList.push_back(asset.path);
+		}
+
+		// Map entities only carry properties which differ from the map, they can't be built without it
+		if (matchData.mapChecksum && m_mapAssetPath.empty())
+		{
+			bwLog(GetLogger(), LogLevel::Error, "server didn't send its map, leaving match");
+			Quit();
+		}
+
 		m_layers.reserve(matchData.layers.size());
 
 		LayerIndex layerIndex = 0;
@@ -120,9 +144,7 @@ namespace bw
 
 		std::size_t playerCount = authSuccess.players.size();
 
-		m_inputPacket.inputs.resize(playerCount);
-		for (auto& input : m_inputPacket.inputs)
-			input.emplace();
+		m_inputPacket.inputs.reserve(RedundantInputCount);
 
 		m_localPlayers.reserve(playerCount);
 		assert(playerCount != 0xFF);
@@ -292,14 +314,65 @@ namespace bw
 	void ClientMatch::LoadAssets(std::shared_ptr<VirtualDirectory> assetDir)
 	{
 		if (!m_assetStore)
+			return LoadAssets(std::make_shared<ClientAssetStore>(GetLogger(), std::move(assetDir)));
+
+		m_assetStore->UpdateAssetDirectory(std::move(assetDir));
+		m_assetStore->Clear();
+
+		PrepareAssets();
+	}
+
+	void ClientMatch::LoadAssets(std::shared_ptr<ClientAssetStore> assetStore)
+	{
+		// The store may already be loading assets in the background (see ResourceDownloadState)
+		assert(!m_assetStore);
+		m_assetStore = std::move(assetStore);
+		m_particleRegistry.emplace(*m_assetStore);
+
+		PrepareAssets();
+	}
+
+	void ClientMatch::PrepareAssets()
+	{
+		// Start decoding every asset of the match in the background, scripts will pick them up when they need them
+		for (const std::string& assetPath : m_assetPrefetchList)
+			m_assetStore->Prefetch(assetPath);
+
+		if (!m_mapAssetPath.empty())
 		{
-			m_assetStore.emplace(GetLogger(), std::move(assetDir));
-			m_particleRegistry.emplace(m_assetStore.value());
-		}
-		else
-		{
-			m_assetStore->UpdateAssetDirectory(std::move(assetDir));
-			m_assetStore->Clear();
+			m_map.reset();
+
+			// Map entities only carry properties which differ from the map, leave the match if we can't load it
+			const std::shared_ptr<VirtualDirectory>& assetDirectory = m_assetStore->GetAssetDirectory();
+
+			VirtualDirectory::Entry entry;
+			if (!assetDirectory->GetEntry(m_mapAssetPath, &entry) || !std::holds_alternative<VirtualDirectory::PhysicalFileEntry>(entry))
+			{
+				// Compiled maps can only be read from a file
+				bwLog(GetLogger(), LogLevel::Error, "failed to load map: {0} is not a file, leaving match", m_mapAssetPath);
+				Quit();
+				return;
+			}
+
+			const std::filesystem::path& mapPath = std::get<VirtualDirectory::PhysicalFileEntry>(entry);
+
+			Nz::ByteArray checksum = Nz::File::ComputeHash(Nz::HashType_SHA1, mapPath.generic_u8string());
+			if (checksum.GetSize() != m_mapChecksum.size() || std::memcmp(checksum.GetConstBuffer(), m_mapChecksum.data(), m_mapChecksum.size()) != 0)
+			{
+				bwLog(GetLogger(), LogLevel::Error, "failed to load map: {0} checksum doesn't match server map, leaving match", mapPath.generic_u8string());
+				Quit();
+				return;
+			}
+
+			try
+			{
+				m_map = Map::LoadFromBinary(mapPath);
+			}
+			catch (const std::exception& e)
+			{
+				bwLog(GetLogger(), LogLevel::Error, "failed to load map: {0}, leaving match", e.what());
+				Quit();
+			}
 		}
 	}
 
@@ -367,17 +440,7 @@ namespace bw
 		{
 			Ndk::EntityHandle entity = AssertScriptEntity(entityTable);
 
-			m_animationManager.PushAnimation(duration, [=](float ratio)
-			{
-				if (!entity)
-					return false;
-
-				float newAngle = Nz::Lerp(fromAngle, toAngle, ratio);
-				auto& nodeComponent = entity->GetComponent<Ndk::NodeComponent>();
-				nodeComponent.SetRotation(Nz::DegreeAnglef(newAngle));
-
-				return true;
-			}, [this, callback]()
+			m_animationManager.AnimateRotation(entity, fromAngle, toAngle, duration, EasingType::Linear, [this, callback]()
 			{
 				auto result = callback();
 				if (!result.valid())
@@ -393,17 +456,7 @@ namespace bw
 		{
 			Ndk::EntityHandle entity = AssertScriptEntity(entityTable);
 
-			m_animationManager.PushAnimation(duration, [=](float ratio)
-			{
-				if (!entity)
-					return false;
-
-				Nz::Vector2f offset = Nz::Lerp(fromOffset, toOffset, ratio * ratio); //< FIXME
-				auto& nodeComponent = entity->GetComponent<Ndk::NodeComponent>();
-				nodeComponent.SetInitialPosition(offset); //< FIXME
-
-				return true;
-			}, [this, callback]()
+			m_animationManager.AnimatePosition(entity, fromOffset, toOffset, duration, EasingType::QuadraticIn, [this, callback]() //< FIXME: Animates initial position
 			{
 				auto result = callback();
 				if (!result.valid())
@@ -512,6 +565,9 @@ namespace bw
 		if (m_scriptingContext)
 			m_scriptingContext->Update();
 
+		if (m_assetStore)
+			m_assetStore->UpdateLoading(ClientAssetStore::AssetLoadingTimeBudget);
+
 		SharedMatch::Update(elapsedTime);
 
 		if (m_debug)
@@ -594,6 +650,20 @@ namespace bw
 			}
 		}
 
+		// Only the active layer is displayed as is by the camera, other layers may be seen through parallax or scaling and aren't culled
+		std::optional<Nz::Rectf> visibleRect;
+		if (m_camera)
+		{
+			visibleRect = m_camera->GetVisibleRect();
+			visibleRect->x -= VisualCullingMargin;
+			visibleRect->y -= VisualCullingMargin;
+			visibleRect->width += VisualCullingMargin * 2.f;
+			visibleRect->height += VisualCullingMargin * 2.f;
+		}
+
+		for (std::size_t i = 0; i < m_layers.size(); ++i)
+			m_layers[i]->SetVisibleRect((i == m_activeLayerIndex) ? visibleRect : std::nullopt);
+
 		for (auto& layer : m_layers)
 		{
 			if (layer->IsEnabled())
@@ -1824,12 +1894,19 @@ namespace bw
 
 	bool ClientMatch::SendInputs(Nz::UInt16 serverTick, bool force)
 	{
-		assert(m_localPlayers.size() == m_inputPacket.inputs.size());
-
 		m_inputPacket.estimatedServerTick = serverTick;
-		m_inputPacket.inputTick = GetNetworkTick();
 
-		//bwLog(GetLogger(), LogLevel::Debug, "Send input tick: {}", m_inputPacket.inputTick);
+		static_assert(RedundantInputCount <= Packets::PlayersInput::MaxTickInputs);
+
+		// Packets are unreliable, so inputs of the last ticks are resent with every one of them
+		if (m_inputPacket.inputs.size() >= RedundantInputCount)
+			m_inputPacket.inputs.pop_back();
+
+		auto& tickInputs = *m_inputPacket.inputs.emplace(m_inputPacket.inputs.begin());
+		tickInputs.inputTick = GetNetworkTick();
+		tickInputs.inputs.resize(m_localPlayers.size());
+
+		//bwLog(GetLogger(), LogLevel::Debug, "Send input tick: {}", tickInputs.inputTick);
 
 		bool checkInputs = m_hasFocus &&
 		                   !m_chatBox.IsTyping() &&
@@ -1849,10 +1926,9 @@ namespace bw
 			{
 				hasInputData = true;
 				controllerData.lastInputData = input;
-				m_inputPacket.inputs[i] = input;
 			}
-			else
-				m_inputPacket.inputs[i].reset();
+
+			tickInputs.inputs[i] = input;
 		}
 
 		if (hasInputData || force)
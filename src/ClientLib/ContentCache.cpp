@@ -0,0 +1,288 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <ClientLib/ContentCache.hpp>
+#include <CoreLib/Utils.hpp>
+#include <CoreLib/LogSystem/Logger.hpp>
+#include <Nazara/Core/ByteArray.hpp>
+#include <Nazara/Core/File.hpp>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+
+namespace bw
+{
+	namespace
+	{
+		constexpr unsigned int IndexVersion = 1;
+		constexpr const char* IndexFileName = "index.json";
+
+		Nz::Int64 GetTimestamp()
+		{
+			return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+		}
+	}
+
+	ContentCache::ContentCache(const Logger& logger, std::filesystem::path cacheDirectory, Nz::UInt64 maxSize) :
+	m_cacheDirectory(std::move(cacheDirectory)),
+	m_logger(logger),
+	m_maxSize(maxSize),
+	m_isDirty(false)
+	{
+	}
+
+	std::filesystem::path ContentCache::BuildPath(const Checksum& checksum, const std::string_view& extension) const
+	{
+		std::string hexChecksum = Nz::ByteArray(checksum.data(), checksum.size()).ToHex().ToStdString();
+
+		// Spread files in subdirectories to keep directory sizes reasonable
+		std::filesystem::path filePath = m_cacheDirectory / hexChecksum.substr(0, 2);
+		filePath /= std::filesystem::u8path(hexChecksum + std::string(extension));
+
+		return filePath;
+	}
+
+	void ContentCache::Evict()
+	{
+		if (m_maxSize == 0)
+			return;
+
+		struct Candidate
+		{
+			std::string fileName;
+			Nz::Int64 lastAccessTime;
+			Nz::UInt64 size;
+		};
+
+		Nz::UInt64 totalSize = 0;
+		std::vector<Candidate> candidates;
+		for (auto&& [fileName, entry] : m_entries)
+		{
+			totalSize += entry.size;
+			if (!entry.isUsed)
+				candidates.push_back(Candidate{ fileName, entry.lastAccessTime, entry.size });
+		}
+
+		if (totalSize <= m_maxSize)
+			return;
+
+		// Least recently used first
+		std::sort(candidates.begin(), candidates.end(), [](const Candidate& lhs, const Candidate& rhs) { return lhs.lastAccessTime < rhs.lastAccessTime; });
+
+		std::size_t evictedCount = 0;
+		Nz::UInt64 evictedSize = 0;
+		for (const Candidate& candidate : candidates)
+		{
+			if (totalSize <= m_maxSize)
+				break;
+
+			std::filesystem::path filePath = m_cacheDirectory / candidate.fileName.substr(0, 2) / std::filesystem::u8path(candidate.fileName);
+
+			std::error_code ec;
+			std::filesystem::remove(filePath, ec);
+			if (ec)
+			{
+				bwLog(m_logger, LogLevel::Warning, "failed to evict {0} from cache: {1}", filePath.generic_u8string(), ec.message());
+				continue;
+			}
+
+			totalSize -= candidate.size;
+			evictedSize += candidate.size;
+			evictedCount++;
+
+			m_entries.erase(candidate.fileName);
+		}
+
+		if (evictedCount > 0)
+		{
+			bwLog(m_logger, LogLevel::Info, "evicted {0} file(s) ({1}) from {2}", evictedCount, ByteToString(evictedSize), m_cacheDirectory.generic_u8string());
+			m_isDirty = true;
+		}
+	}
+
+	std::optional<std::filesystem::path> ContentCache::Find(const Checksum& checksum, Nz::UInt64 size, const std::string_view& extension)
+	{
+		std::filesystem::path filePath = BuildPath(checksum, extension);
+		std::string fileName = filePath.filename().generic_u8string();
+
+		auto it = m_entries.find(fileName);
+
+		std::error_code ec;
+		Nz::UInt64 fileSize = std::filesystem::file_size(filePath, ec);
+		if (ec || fileSize != size)
+		{
+			if (it != m_entries.end())
+			{
+				m_entries.erase(it);
+				m_isDirty = true;
+			}
+
+			return std::nullopt;
+		}
+
+		auto lastWriteTime = std::filesystem::last_write_time(filePath, ec);
+		if (ec)
+			return std::nullopt;
+
+		Nz::Int64 lastWriteTimeValue = static_cast<Nz::Int64>(lastWriteTime.time_since_epoch().count());
+
+		// Metadata didn't change since the file was verified, trust it
+		if (it == m_entries.end() || !it->second.isVerified || it->second.size != fileSize || it->second.lastWriteTime != lastWriteTimeValue)
+		{
+			Nz::ByteArray fileChecksum = Nz::File::ComputeHash(Nz::HashType_SHA1, filePath.generic_u8string());
+			if (fileChecksum != Nz::ByteArray(checksum.data(), checksum.size()))
+			{
+				bwLog(m_logger, LogLevel::Warning, "cached file {0} is corrupted, removing it", filePath.generic_u8string());
+
+				std::filesystem::remove(filePath, ec);
+				if (it != m_entries.end())
+					m_entries.erase(it);
+
+				m_isDirty = true;
+				return std::nullopt;
+			}
+
+			Entry& entry = m_entries[fileName];
+			entry.isVerified = true;
+			entry.lastWriteTime = lastWriteTimeValue;
+			entry.size = fileSize;
+
+			it = m_entries.find(fileName);
+		}
+
+		Entry& entry = it.value();
+		entry.isUsed = true;
+		entry.lastAccessTime = GetTimestamp();
+
+		m_isDirty = true;
+
+		return filePath;
+	}
+
+	bool ContentCache::Load()
+	{
+		m_entries.clear();
+		m_isDirty = false;
+
+		std::filesystem::path indexPath = m_cacheDirectory / IndexFileName;
+		if (!std::filesystem::is_regular_file(indexPath))
+			return true; //< Empty cache
+
+		Nz::File indexFile(indexPath.generic_u8string(), Nz::OpenMode_ReadOnly);
+		if (!indexFile.IsOpen())
+		{
+			bwLog(m_logger, LogLevel::Error, "failed to open cache index {0}", indexPath.generic_u8string());
+			return false;
+		}
+
+		std::vector<char> content(indexFile.GetSize());
+		if (indexFile.Read(content.data(), content.size()) != content.size())
+		{
+			bwLog(m_logger, LogLevel::Error, "failed to read cache index {0}", indexPath.generic_u8string());
+			return false;
+		}
+
+		try
+		{
+			nlohmann::json index = nlohmann::json::parse(content.begin(), content.end());
+			if (index.value("version", 0U) != IndexVersion)
+			{
+				bwLog(m_logger, LogLevel::Warning, "cache index {0} has an unsupported version, ignoring it", indexPath.generic_u8string());
+				return true;
+			}
+
+			for (auto&& fileEntry : index.at("files"))
+			{
+				Entry entry;
+				entry.isVerified = fileEntry.value("verified", false);
+				entry.lastAccessTime = fileEntry.at("lastAccessTime");
+				entry.lastWriteTime = fileEntry.at("lastWriteTime");
+				entry.size = fileEntry.at("size");
+
+				m_entries.insert_or_assign(fileEntry.at("name").get<std::string>(), std::move(entry));
+			}
+		}
+		catch (const std::exception& e)
+		{
+			bwLog(m_logger, LogLevel::Error, "failed to parse cache index {0}: {1}", indexPath.generic_u8string(), e.what());
+			m_entries.clear();
+			return false;
+		}
+
+		return true;
+	}
+
+	void ContentCache::Register(const std::filesystem::path& filePath)
+	{
+		std::error_code ec;
+		Nz::UInt64 fileSize = std::filesystem::file_size(filePath, ec);
+		if (ec)
+			return;
+
+		auto lastWriteTime = std::filesystem::last_write_time(filePath, ec);
+		if (ec)
+			return;
+
+		// File has been checked by the download manager
+		Entry& entry = m_entries[filePath.filename().generic_u8string()];
+		entry.isUsed = true;
+		entry.isVerified = true;
+		entry.lastAccessTime = GetTimestamp();
+		entry.lastWriteTime = static_cast<Nz::Int64>(lastWriteTime.time_since_epoch().count());
+		entry.size = fileSize;
+
+		m_isDirty = true;
+	}
+
+	bool ContentCache::Save()
+	{
+		if (!m_isDirty)
+			return true;
+
+		auto fileArray = nlohmann::json::array();
+		for (auto&& [fileName, entry] : m_entries)
+		{
+			nlohmann::json fileEntry;
+			fileEntry["name"] = fileName;
+			fileEntry["lastAccessTime"] = entry.lastAccessTime;
+			fileEntry["lastWriteTime"] = entry.lastWriteTime;
+			fileEntry["size"] = entry.size;
+			fileEntry["verified"] = entry.isVerified;
+
+			fileArray.emplace_back(std::move(fileEntry));
+		}
+
+		nlohmann::json index;
+		index["version"] = IndexVersion;
+		index["files"] = std::move(fileArray);
+
+		std::string content = index.dump();
+
+		std::error_code ec;
+		std::filesystem::create_directories(m_cacheDirectory, ec);
+
+		std::filesystem::path indexPath = m_cacheDirectory / IndexFileName;
+		std::filesystem::path tempPath = indexPath;
+		tempPath += ".tmp";
+
+		{
+			Nz::File indexFile(tempPath.generic_u8string(), Nz::OpenMode_WriteOnly | Nz::OpenMode_Truncate);
+			if (!indexFile.IsOpen() || indexFile.Write(content.data(), content.size()) != content.size())
+			{
+				bwLog(m_logger, LogLevel::Error, "failed to write cache index {0}", tempPath.generic_u8string());
+				return false;
+			}
+		}
+
+		std::filesystem::rename(tempPath, indexPath, ec);
+		if (ec)
+		{
+			bwLog(m_logger, LogLevel::Error, "failed to replace cache index {0}: {1}", indexPath.generic_u8string(), ec.message());
+			return false;
+		}
+
+		m_isDirty = false;
+		return true;
+	}
+}
@@ -12,6 +12,8 @@
 #include <CoreLib/Utils.hpp>
 #include <ClientLib/VisualEntity.hpp>
 #include <NDK/Components/NodeComponent.hpp>
+#include <algorithm>
+#include <cmath>
 
 namespace bw
 {
@@ -32,7 +34,9 @@ namespace bw
 	m_visualEntities(std::move(entity.m_visualEntities)),
 	m_entity(std::move(entity.m_entity)),
 	m_uniqueId(std::move(entity.m_uniqueId)),
-	m_layerIndex(std::move(entity.m_layerIndex))
+	m_layerIndex(std::move(entity.m_layerIndex)),
+	m_cullingRadius(entity.m_cullingRadius),
+	m_isCulled(entity.m_isCulled)
 	{
 		entity.m_uniqueId = InvalidEntityId;
 	}
@@ -58,6 +62,8 @@ namespace bw
 		renderableData.renderable = std::move(renderable);
 		renderableData.renderOrder = renderOrder;
 
+		m_cullingRadius.reset();
+
 		for (VisualEntity* visualEntity : m_visualEntities)
 			visualEntity->AttachRenderable(renderableData.renderable, renderableData.offsetMatrix, renderableData.renderOrder);
 	}
@@ -84,6 +90,7 @@ namespace bw
 		if (it != m_attachedRenderables.end())
 		{
 			m_attachedRenderables.erase(it);
+			m_cullingRadius.reset();
 
 			for (VisualEntity* visualEntity : m_visualEntities)
 				visualEntity->DetachRenderable(renderable);
@@ -158,6 +165,15 @@ namespace bw
 		return m_entity->HasComponent<Ndk::PhysicsComponent2D>(); //< TODO: Cache this?
 	}
 
+	bool LayerVisualEntity::ShouldCull(const Nz::Rectf& visibleRect, const Nz::Vector2f& position) const
+	{
+		// The rect only makes sense for the visual entity displayed by the camera layer, entities also displayed elsewhere are never culled
+		if (m_visualEntities.size() > 1)
+			return false;
+
+		return !IsInsideRect(visibleRect, position);
+	}
+
 	void LayerVisualEntity::SyncVisuals()
 	{
 		auto& entityNode = m_entity->GetComponent<Ndk::NodeComponent>();
@@ -168,6 +184,26 @@ namespace bw
 
 		for (VisualEntity* visualEntity : m_visualEntities)
 			visualEntity->Update(position, rotation, scale);
+
+		m_isCulled = false;
+	}
+
+	void LayerVisualEntity::SyncVisuals(const Nz::Rectf& visibleRect)
+	{
+		auto& entityNode = m_entity->GetComponent<Ndk::NodeComponent>();
+		if (ShouldCull(visibleRect, Nz::Vector2f(entityNode.GetPosition(Nz::CoordSys_Global))))
+		{
+			// Sync one last time so visuals don't stay frozen on screen, then wait for the entity to come back
+			if (!m_isCulled)
+			{
+				SyncVisuals();
+				m_isCulled = true;
+			}
+
+			return;
+		}
+
+		SyncVisuals();
 	}
 
 	void LayerVisualEntity::UpdateHoveringRenderableHoveringHeight(const Nz::InstancedRenderableRef& renderable, float newHoveringHeight)
@@ -208,6 +244,8 @@ namespace bw
 			RenderableData& renderableData = *it;
 			renderableData.offsetMatrix = offsetMatrix;
 
+			m_cullingRadius.reset();
+
 			for (VisualEntity* visualEntity : m_visualEntities)
 				visualEntity->UpdateRenderableMatrix(renderable, offsetMatrix);
 		}
@@ -271,6 +309,34 @@ namespace bw
 		}
 	}
 
+	float LayerVisualEntity::GetCullingRadius() const
+	{
+		if (!m_cullingRadius)
+		{
+			Nz::Boxf localBounds = GetLocalBounds();
+
+			Nz::Vector2f extent;
+			extent.x = std::max(std::abs(localBounds.x), std::abs(localBounds.x + localBounds.width));
+			extent.y = std::max(std::abs(localBounds.y), std::abs(localBounds.y + localBounds.height));
+
+			m_cullingRadius = extent.GetLength();
+		}
+
+		return *m_cullingRadius;
+	}
+
+	bool LayerVisualEntity::IsInsideRect(const Nz::Rectf& rect, const Nz::Vector2f& position) const
+	{
+		auto& entityNode = m_entity->GetComponent<Ndk::NodeComponent>();
+		Nz::Vector3f scale = entityNode.GetScale(Nz::CoordSys_Global);
+
+		// Conservative test using a bounding circle, so rotation doesn't matter
+		float radius = GetCullingRadius() * std::max(std::abs(scale.x), std::abs(scale.y));
+
+		return position.x + radius >= rect.x && position.x - radius <= rect.x + rect.width &&
+		       position.y + radius >= rect.y && position.y - radius <= rect.y + rect.height;
+	}
+
 	void LayerVisualEntity::NotifyVisualEntityMoved(VisualEntity* oldPointer, VisualEntity* newPointer)
 	{
 		auto it = std::find(m_visualEntities.begin(), m_visualEntities.end(), oldPointer);
@@ -4,14 +4,21 @@
 
 #include <ClientLib/PacketDownloadManager.hpp>
 #include <CoreLib/Utils.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
 
 namespace bw
 {
-	PacketDownloadManager::PacketDownloadManager(std::shared_ptr<ClientSession> clientSession) :
+	PacketDownloadManager::PacketDownloadManager(std::shared_ptr<ClientSession> clientSession, std::size_t maxSimultaneousDownload) :
 	m_clientSession(std::move(clientSession)),
-	m_nextFileIndex(0)
+	m_nextFileIndex(0),
+	m_pendingHashCount(0),
+	m_hashWorkers(std::min<std::size_t>(ThreadPool::GetDefaultWorkerCount(), 2), "DownloadHash")
 	{
-		m_hash = Nz::AbstractHash::Get(Nz::HashType_SHA1);
+		assert(maxSimultaneousDownload > 0);
+		m_requests.resize(maxSimultaneousDownload);
 
 		m_onDownloadFragmentSlot.Connect(m_clientSession->OnDownloadClientFileFragment, [this](ClientSession*, const Packets::DownloadClientFileFragment& packet)
 		{
@@ -35,11 +42,13 @@ namespace bw
 		if (m_nextFileIndex < m_downloadList.size())
 			return false;
 
-		// Check download completion
-		if (m_nextFileIndex > 0)
+		// Downloads may still be in flight or waiting for their checksum to be verified
+		if (m_pendingHashCount > 0)
+			return false;
+
+		for (const Request& request : m_requests)
 		{
-			std::size_t currentFileIndex = m_nextFileIndex - 1;
-			if (m_downloadList[currentFileIndex].receivedFragment.GetSize() == 0 || !m_downloadList[currentFileIndex].receivedFragment.TestAll())
+			if (request.isActive)
 				return false;
 		}
 
@@ -56,57 +65,75 @@ namespace bw
 		pendingFile.keepInMemory = keepInMemory;
 	}
 
+	void PacketDownloadManager::Update()
+	{
+		PollHashResults();
+		RequestNextFiles();
+	}
+
+	auto PacketDownloadManager::GetRequest(Nz::UInt32 downloadId) -> Request*
+	{
+		// Download id is the file index
+		auto it = std::find_if(m_requests.begin(), m_requests.end(), [&](const Request& request) { return request.isActive && request.fileIndex == downloadId; });
+		if (it == m_requests.end())
+			return nullptr;
+
+		return &*it;
+	}
+
 	void PacketDownloadManager::HandlePacket(const Packets::DownloadClientFileFragment& packet)
 	{
-		assert(m_nextFileIndex > 0 && m_nextFileIndex <= m_downloadList.size());
-		std::size_t currentFileIndex = m_nextFileIndex - 1;
+		Request* request = GetRequest(packet.downloadId);
+		if (!request)
+			throw std::runtime_error("unexpected fragment for download " + std::to_string(packet.downloadId) + " from server");
 
-		PendingFile& pendingFileData = m_downloadList[currentFileIndex];
+		PendingFile& pendingFileData = m_downloadList[request->fileIndex];
 		if (packet.fragmentIndex >= pendingFileData.receivedFragment.GetSize())
 			throw std::runtime_error("unexpected fragment " + std::to_string(packet.fragmentIndex) + " from server");
 
-		std::size_t offset = packet.fragmentIndex * pendingFileData.fragmentSize;
-		m_outputFile.SetCursorPos(offset);
-		m_outputFile.Write(packet.fragmentContent.data(), packet.fragmentContent.size());
+		if (pendingFileData.receivedFragment.Test(packet.fragmentIndex))
+			return; //< Already received
 
-		m_hash->Append(packet.fragmentContent.data(), packet.fragmentContent.size());
-
-		std::size_t downloadedSize = (packet.fragmentIndex + 1) * pendingFileData.fragmentSize;
-		if (pendingFileData.keepInMemory)
+		// Fragments may arrive in any order, write them at their final place
+		Nz::UInt64 offset = packet.fragmentIndex * pendingFileData.fragmentSize;
+		if (offset + packet.fragmentContent.size() > pendingFileData.expectedSize)
 		{
-			if (m_fileContent.size() < downloadedSize)
-				m_fileContent.resize(downloadedSize);
+			request->outputFile.Close();
+			request->outputFile.Delete();
+			request->isActive = false;
 
-			std::memcpy(&m_fileContent[offset], packet.fragmentContent.data(), packet.fragmentContent.size());
+			OnDownloadError(this, request->fileIndex, Error::SizeMismatch);
+			return;
 		}
 
-		OnDownloadProgress(this, currentFileIndex, downloadedSize);
+		request->outputFile.SetCursorPos(offset);
+		request->outputFile.Write(packet.fragmentContent.data(), packet.fragmentContent.size());
 
-		pendingFileData.receivedFragment.Set(packet.fragmentIndex, true);
-		if (pendingFileData.receivedFragment.TestAll())
+		if (pendingFileData.keepInMemory && !packet.fragmentContent.empty())
 		{
-			m_outputFile.Close();
-
-			m_byteArray.Assign(pendingFileData.expectedChecksum.begin(), pendingFileData.expectedChecksum.end());
+			std::size_t fragmentEnd = static_cast<std::size_t>(offset + packet.fragmentContent.size());
+			if (request->fileContent.size() < fragmentEnd)
+				request->fileContent.resize(fragmentEnd);
 
-			if (m_byteArray == m_hash->End())
-			{
-				if (pendingFileData.keepInMemory)
-					OnDownloadFinishedMemory(this, currentFileIndex, m_fileContent, 0);
-				else
-					OnDownloadFinished(this, currentFileIndex, pendingFileData.outputPath, 0);
-			}
-			else
-				OnDownloadError(this, currentFileIndex, Error::ChecksumMismatch);
+			std::memcpy(request->fileContent.data() + offset, packet.fragmentContent.data(), packet.fragmentContent.size());
 		}
+
+		pendingFileData.downloadedSize += packet.fragmentContent.size();
+		pendingFileData.receivedFragment.Set(packet.fragmentIndex, true);
+
+		OnDownloadProgress(this, request->fileIndex, pendingFileData.downloadedSize);
+
+		if (pendingFileData.receivedFragment.TestAll())
+			VerifyFile(*request);
 	}
 
 	void PacketDownloadManager::HandlePacket(const Packets::DownloadClientFileResponse& packet)
 	{
-		assert(m_nextFileIndex > 0 && m_nextFileIndex <= m_downloadList.size());
-		std::size_t currentFileIndex = m_nextFileIndex - 1;
+		Request* request = GetRequest(packet.downloadId);
+		if (!request)
+			throw std::runtime_error("unexpected response for download " + std::to_string(packet.downloadId) + " from server");
 
-		PendingFile& pendingFileData = m_downloadList[currentFileIndex];
+		PendingFile& pendingFileData = m_downloadList[request->fileIndex];
 		std::visit([&](auto&& arg)
 		{
 			using T = std::decay_t<decltype(arg)>;
@@ -124,8 +151,11 @@ namespace bw
 						throw std::runtime_error("failed to create client script cache directory: " + clientFolderPath.generic_u8string());
 				}
 
-				if (!m_outputFile.Open(filePath, Nz::OpenMode_Truncate | Nz::OpenMode_WriteOnly))
+				if (!request->outputFile.Open(filePath, Nz::OpenMode_Truncate | Nz::OpenMode_WriteOnly))
 					throw std::runtime_error("failed to open file " + filePath);
+
+				if (pendingFileData.keepInMemory)
+					request->fileContent.reserve(pendingFileData.expectedSize);
 			}
 			else if constexpr (std::is_same_v<T, Packets::DownloadClientFileResponse::Failure>)
 			{
@@ -139,7 +169,9 @@ namespace bw
 						break;
 				}
 
-				OnDownloadError(this, currentFileIndex, error);
+				request->isActive = false;
+
+				OnDownloadError(this, request->fileIndex, error);
 			}
 			else
 				static_assert(AlwaysFalse<T>::value, "non-exhaustive visitor");
@@ -147,12 +179,28 @@ namespace bw
 		}, packet.content);
 	}
 
-	void PacketDownloadManager::Update()
+	void PacketDownloadManager::PollHashResults()
 	{
-		RequestNextFile();
+		HashResult result;
+		while (m_hashResults.try_dequeue(result))
+		{
+			assert(m_pendingHashCount > 0);
+			m_pendingHashCount--;
+
+			const PendingFile& pendingFileData = m_downloadList[result.fileIndex];
+			if (result.isValid)
+			{
+				if (pendingFileData.keepInMemory)
+					OnDownloadFinishedMemory(this, result.fileIndex, result.fileContent, 0);
+				else
+					OnDownloadFinished(this, result.fileIndex, pendingFileData.outputPath, 0);
+			}
+			else
+				OnDownloadError(this, result.fileIndex, Error::ChecksumMismatch);
+		}
 	}
 
-	void PacketDownloadManager::RequestNextFile()
+	void PacketDownloadManager::RequestNextFiles()
 	{
 		if (IsFinished())
 		{
@@ -160,29 +208,70 @@ namespace bw
 			return;
 		}
 
-		// Don't request next file if current hasn't been downloaded yet
-		if (m_nextFileIndex > 0)
+		if (m_nextFileIndex >= m_downloadList.size())
+			return; //< All remaining files are being processed
+
+		for (Request& request : m_requests)
 		{
-			std::size_t currentFileIndex = m_nextFileIndex - 1;
-			if (m_downloadList[currentFileIndex].receivedFragment.GetSize() == 0 || !m_downloadList[currentFileIndex].receivedFragment.TestAll())
-				return;
+			if (request.isActive)
+				continue;
+
+			const std::string& downloadPath = m_downloadList[m_nextFileIndex].downloadPath;
+
+			request.fileContent.clear();
+			request.fileIndex = m_nextFileIndex;
+			request.isActive = true;
+
+			Packets::DownloadClientFileRequest requestPacket;
+			requestPacket.downloadId = static_cast<Nz::UInt32>(m_nextFileIndex);
+			requestPacket.path = downloadPath;
+
+			m_clientSession->SendPacket(requestPacket);
+
+			OnDownloadStarted(this, m_nextFileIndex, downloadPath);
+
+			if (++m_nextFileIndex >= m_downloadList.size())
+				break;
 		}
+	}
 
-		if (m_nextFileIndex >= m_downloadList.size())
-			return; //< All remaining files are being processed
+	void PacketDownloadManager::VerifyFile(Request& request)
+	{
+		request.outputFile.Close();
+		request.isActive = false; //< Free the slot right away so the next file can be requested while we hash this one
+
+		const PendingFile& pendingFileData = m_downloadList[request.fileIndex];
+		if (pendingFileData.downloadedSize != pendingFileData.expectedSize)
+		{
+			OnDownloadError(this, request.fileIndex, Error::SizeMismatch);
+			return;
+		}
 
-		m_fileContent.clear();
-		m_hash->Begin();
+		m_pendingHashCount++;
 
-		const std::string& downloadPath = m_downloadList[m_nextFileIndex].downloadPath;
+		// Hash on a worker thread, results are dispatched from Update
+		m_hashWorkers.PushTask([this, fileIndex = request.fileIndex, expectedChecksum = pendingFileData.expectedChecksum, filePath = pendingFileData.outputPath.generic_u8string(), fileContent = std::move(request.fileContent), keepInMemory = pendingFileData.keepInMemory]() mutable
+		{
+			Nz::ByteArray checksum;
+			if (keepInMemory)
+			{
+				auto hash = Nz::AbstractHash::Get(Nz::HashType_SHA1);
+				hash->Begin();
+				hash->Append(fileContent.data(), fileContent.size());
 
-		Packets::DownloadClientFileRequest requestPacket;
-		requestPacket.path = downloadPath;
+				checksum = hash->End();
+			}
+			else
+				checksum = Nz::File::ComputeHash(Nz::HashType_SHA1, filePath);
 
-		m_clientSession->SendPacket(requestPacket);
+			HashResult result;
+			result.fileIndex = fileIndex;
+			result.fileContent = std::move(fileContent);
+			result.isValid = (checksum == Nz::ByteArray(expectedChecksum.data(), expectedChecksum.size()));
 
-		OnDownloadStarted(this, m_nextFileIndex, downloadPath);
+			m_hashResults.enqueue(std::move(result));
+		});
 
-		m_nextFileIndex++;
+		request.fileContent = {};
 	}
 }
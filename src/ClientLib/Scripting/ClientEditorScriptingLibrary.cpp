@@ -130,6 +130,7 @@ namespace bw
 			"IsValid", &Tilemap::IsValid,
 			"IsVisible", &Tilemap::IsVisible,
 
+			"SetColor", &Tilemap::SetColor,
 			"SetOffset", &Tilemap::SetOffset,
 			"SetRotation", &Tilemap::SetRotation,
 			"SetTileColor", &Tilemap::SetTileColor,
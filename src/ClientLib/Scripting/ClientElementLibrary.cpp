@@ -100,19 +100,9 @@ namespace bw
 			else
 				color = Nz::Color::White;
 
-			//TODO: Don't create a material everytime
-			Nz::MaterialRef mat = Nz::Material::New("Translucent2D");
-			if (!texturePath.empty())
-				mat->SetDiffuseMap(m_assetStore.GetTexture(texturePath));
-
-			auto& sampler = mat->GetDiffuseSampler();
-			sampler.SetFilterMode(Nz::SamplerFilter_Bilinear);
-			if (repeatTexture)
-				sampler.SetWrapMode(Nz::SamplerWrap_Repeat);
-
 			Nz::SpriteRef sprite = Nz::Sprite::New();
 			sprite->SetColor(color);
-			sprite->SetMaterial(mat);
+			sprite->SetMaterial(m_assetStore.GetSpriteMaterial(texturePath, repeatTexture));
 			sprite->SetTextureCoords(textureCoords);
 
 			if (std::optional<sol::table> cornerColorTable = parameters.get_or<std::optional<sol::table>>("CornerColor", std::nullopt); cornerColorTable)
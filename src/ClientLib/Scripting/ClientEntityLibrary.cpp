@@ -80,24 +80,31 @@ namespace bw
 			if (materials.empty())
 				return {};
 
-			Nz::TileMapRef tileMap = Nz::TileMap::New(mapSize, cellSize, materials.size());
+			// Materials are shared by every chunk of the tilemap
+			std::vector<Nz::MaterialRef> tileMaterials(materials.size());
 			for (auto&& [materialPath, matIndex] : materials)
 			{
 				Nz::MaterialRef material = Nz::Material::New(); //< FIXME
-				material->SetDiffuseMap(m_assetStore.GetTexture(materialPath));
+				material->SetDiffuseMap(m_assetStore.GetTextureAsync(materialPath));
 
 				if (material)
 				{
 					// Force alpha blending
 					material->Configure("Translucent2D");
-					material->SetDiffuseMap(m_assetStore.GetTexture(materialPath)); //< FIXME
+					material->SetDiffuseMap(m_assetStore.GetTextureAsync(materialPath)); //< FIXME
 				}
 				else
 					material = Nz::Material::GetDefault();
 
-				tileMap->SetMaterial(matIndex, material);
+				tileMaterials[matIndex] = std::move(material);
 			}
 
+			Nz::Matrix4f transformMatrix = Nz::Matrix4f::Identity();
+
+			auto& visualComponent = entity->GetComponent<VisualComponent>();
+
+			Tilemap scriptTilemap(visualComponent.GetLayerVisual(), mapSize, cellSize, std::move(tileMaterials), transformMatrix, renderOrder);
+
 			std::size_t cellCount = content.size();
 			std::size_t expectedCellCount = mapSize.x * mapSize.y;
 			if (cellCount != expectedCellCount)
@@ -120,16 +127,11 @@ namespace bw
 						auto matIt = materials.find(tileData.materialPath);
 						assert(matIt != materials.end());
 
-						tileMap->EnableTile(tilePos, tileData.texCoords, Nz::Color::White, matIt->second);
+						scriptTilemap.EnableTile(tilePos.x, tilePos.y, tileData.texCoords, Nz::Color::White, matIt->second);
 					}
 				}
 			}
 
-			Nz::Matrix4f transformMatrix = Nz::Matrix4f::Identity();
-
-			auto& visualComponent = entity->GetComponent<VisualComponent>();
-
-			Tilemap scriptTilemap(visualComponent.GetLayerVisual(), std::move(tileMap), transformMatrix, renderOrder);
 			scriptTilemap.Show();
 
 			return scriptTilemap;
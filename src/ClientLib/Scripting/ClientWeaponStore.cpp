@@ -22,13 +22,8 @@ namespace bw
 	{
 		const auto& weaponClass = GetElement(entityIndex);
 
-		Nz::MaterialRef mat = Nz::Material::New("Translucent2D");
-		mat->SetDiffuseMap(m_assetStore.GetTexture(weaponClass->spriteName));
-		auto& sampler = mat->GetDiffuseSampler();
-		sampler.SetFilterMode(Nz::SamplerFilter_Bilinear);
-
 		Nz::SpriteRef sprite = Nz::Sprite::New();
-		sprite->SetMaterial(mat);
+		sprite->SetMaterial(m_assetStore.GetSpriteMaterial(weaponClass->spriteName));
 		sprite->SetSize(sprite->GetSize() * weaponClass->scale);
 		Nz::Vector2f burgerSize = sprite->GetSize();
 		sprite->SetOrigin(weaponClass->spriteOrigin);
@@ -351,7 +351,7 @@ namespace bw
 			std::string texturePath = parameters["texturePath"];
 
 			Nz::MaterialRef material = Nz::Material::New("Translucent2D");
-			material->SetDiffuseMap(m_clientAssetStore.GetTexture(texturePath));
+			material->SetDiffuseMap(m_clientAssetStore.GetTextureAsync(texturePath));
 
 			return Nz::ParticleFunctionRenderer::New(
 				[=](const Nz::ParticleGroup& /*group*/, const Nz::ParticleMapper& mapper, unsigned int startId, unsigned int endId, Nz::AbstractRenderQueue* renderQueue)
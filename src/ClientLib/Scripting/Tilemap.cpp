@@ -5,11 +5,82 @@
 #include <ClientLib/Scripting/Tilemap.hpp>
 #include <Nazara/Core/Color.hpp>
 #include <sol/sol.hpp>
+#include <algorithm>
 #include <optional>
 #include <stdexcept>
 
 namespace bw
 {
+	void Tilemap::EnableTile(unsigned int x, unsigned int y, const Nz::Rectf& texCoords, const Nz::Color& color, std::size_t materialIndex)
+	{
+		if (x >= m_mapSize.x || y >= m_mapSize.y)
+			throw std::runtime_error("tile position out of range");
+
+		if (materialIndex >= m_materials.size())
+			throw std::runtime_error("material index out of range");
+
+		std::size_t chunkIndex = GetChunkIndex(x, y);
+
+		Nz::TileMapRef& chunk = m_chunks[chunkIndex];
+		if (!chunk)
+		{
+			// Border chunks only cover the remaining tiles
+			unsigned int chunkX = x / ChunkSize * ChunkSize;
+			unsigned int chunkY = y / ChunkSize * ChunkSize;
+			Nz::Vector2ui chunkTileCount(std::min(ChunkSize, m_mapSize.x - chunkX), std::min(ChunkSize, m_mapSize.y - chunkY));
+
+			chunk = Nz::TileMap::New(chunkTileCount, m_tileSize, m_materials.size());
+			for (std::size_t i = 0; i < m_materials.size(); ++i)
+				chunk->SetMaterial(i, m_materials[i]);
+
+			if (m_isVisible)
+				m_visualEntity->AttachRenderable(chunk, ComputeChunkMatrix(chunkIndex), m_renderOrder);
+		}
+
+		chunk->EnableTile(Nz::Vector2ui(x % ChunkSize, y % ChunkSize), texCoords, color, materialIndex);
+	}
+
+	void Tilemap::SetColor(const Nz::Color& color)
+	{
+		for (const Nz::TileMapRef& chunk : m_chunks)
+		{
+			if (!chunk)
+				continue;
+
+			const Nz::Vector2ui& chunkTileCount = chunk->GetMapSize();
+			for (unsigned int y = 0; y < chunkTileCount.y; ++y)
+			{
+				for (unsigned int x = 0; x < chunkTileCount.x; ++x)
+				{
+					Nz::Vector2ui tilePos(x, y);
+
+					const auto& tileData = chunk->GetTile(tilePos);
+					if (tileData.enabled)
+						chunk->EnableTile(tilePos, tileData.textureCoords, color, tileData.layerIndex);
+				}
+			}
+		}
+	}
+
+	void Tilemap::SetTileColor(unsigned int x, unsigned int y, const Nz::Color& color)
+	{
+		if (x >= m_mapSize.x || y >= m_mapSize.y)
+			throw std::runtime_error("tile position out of range");
+
+		// Only the chunk owning the tile has to be regenerated
+		const Nz::TileMapRef& chunk = m_chunks[GetChunkIndex(x, y)];
+		if (!chunk)
+			return;
+
+		Nz::Vector2ui tilePos(x % ChunkSize, y % ChunkSize);
+
+		const auto& tileData = chunk->GetTile(tilePos);
+		if (!tileData.enabled)
+			return;
+
+		chunk->EnableTile(tilePos, tileData.textureCoords, color, tileData.layerIndex);
+	}
+
 	void Tilemap::Show(bool show)
 	{
 		if (!m_visualEntity)
@@ -18,31 +89,40 @@ namespace bw
 		if (show == m_isVisible)
 			return;
 
-		if (show)
-			m_visualEntity->AttachRenderable(m_tilemap, m_transformMatrix, m_renderOrder);
-		else
-			m_visualEntity->DetachRenderable(m_tilemap);
+		for (std::size_t chunkIndex = 0; chunkIndex < m_chunks.size(); ++chunkIndex)
+		{
+			const Nz::TileMapRef& chunk = m_chunks[chunkIndex];
+			if (!chunk)
+				continue;
+
+			if (show)
+				m_visualEntity->AttachRenderable(chunk, ComputeChunkMatrix(chunkIndex), m_renderOrder);
+			else
+				m_visualEntity->DetachRenderable(chunk);
+		}
 
 		m_isVisible = show;
 	}
 
-	void Tilemap::SetTileColor(unsigned int x, unsigned int y, const Nz::Color& color)
+	Nz::Matrix4f Tilemap::ComputeChunkMatrix(std::size_t chunkIndex) const
 	{
-		const Nz::Vector2ui& mapSize = m_tilemap->GetMapSize();
-		if (x >= mapSize.x || y >= mapSize.y)
-			throw std::runtime_error("tile position out of range");
-
-		Nz::Vector2ui tilePos(x, y);
+		unsigned int chunkX = static_cast<unsigned int>(chunkIndex % m_chunkCount.x);
+		unsigned int chunkY = static_cast<unsigned int>(chunkIndex / m_chunkCount.x);
 
-		const auto& tileData = m_tilemap->GetTile(tilePos);
-		if (!tileData.enabled)
-			return;
+		Nz::Vector2f chunkOffset = Nz::Vector2f(float(chunkX * ChunkSize), float(chunkY * ChunkSize)) * m_tileSize;
 
-		m_tilemap->EnableTile(tilePos, tileData.textureCoords, color, tileData.layerIndex);
+		return Nz::Matrix4f::ConcatenateAffine(Nz::Matrix4f::Translate(chunkOffset), m_transformMatrix);
 	}
 
 	void Tilemap::UpdateTransformMatrix()
 	{
-		m_visualEntity->UpdateRenderableMatrix(m_tilemap, m_transformMatrix);
+		if (!m_isVisible)
+			return;
+
+		for (std::size_t chunkIndex = 0; chunkIndex < m_chunks.size(); ++chunkIndex)
+		{
+			if (const Nz::TileMapRef& chunk = m_chunks[chunkIndex])
+				m_visualEntity->UpdateRenderableMatrix(chunk, ComputeChunkMatrix(chunkIndex));
+		}
 	}
 }
@@ -4,6 +4,7 @@
 
 #include <ClientLib/Systems/VisualInterpolationSystem.hpp>
 #include <CoreLib/Utils.hpp>
+#include <ClientLib/Components/VisualComponent.hpp>
 #include <ClientLib/Components/VisualInterpolationComponent.hpp>
 #include <Nazara/Math/Algorithm.hpp>
 #include <NDK/Components/NodeComponent.hpp>
@@ -42,6 +43,17 @@ namespace bw
 			Nz::Vector2f sourcePos = entityLerp.GetLastPosition();
 			Nz::Vector2f targetPos = entityPhysics.GetPosition();
 
+			if (m_visibleRect && entity->HasComponent<VisualComponent>())
+			{
+				const LayerVisualEntityHandle& layerVisual = entity->GetComponent<VisualComponent>().GetLayerVisual();
+				if (layerVisual && layerVisual->ShouldCull(*m_visibleRect, targetPos))
+				{
+					// The node keeps the physics state (set on ticks), interpolation will start back from it once visible again
+					entityLerp.UpdateLastStates(targetPos, targetRot);
+					continue;
+				}
+			}
+
 			Nz::RadianAnglef rotation = sourceRot + (targetRot - sourceRot) * factor;
 			Nz::Vector2f position = sourcePos + (targetPos - sourcePos) * factor;
 
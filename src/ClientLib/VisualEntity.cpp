@@ -13,7 +13,10 @@ namespace bw
 	VisualEntity::VisualEntity(Ndk::World& renderWorld, LayerVisualEntityHandle visualEntityHandle, int baseRenderOrder) :
 	m_entity(renderWorld.CreateEntity()),
 	m_visualEntity(std::move(visualEntityHandle)),
-	m_baseRenderOrder(baseRenderOrder)
+	m_hoveringPosition(Nz::Vector2f::Zero()),
+	m_hoveringScale(Nz::Vector2f::Unit()),
+	m_baseRenderOrder(baseRenderOrder),
+	m_isHoveringFlipped(false)
 	{
 		m_entity->AddComponent<Ndk::NodeComponent>();
 		m_entity->AddComponent<Ndk::GraphicsComponent>();
@@ -28,10 +31,15 @@ namespace bw
 	}
 
 	VisualEntity::VisualEntity(VisualEntity&& entity) noexcept :
+	m_lastTransform(std::move(entity.m_lastTransform)),
 	m_hoveringRenderables(std::move(entity.m_hoveringRenderables)),
 	m_entity(std::move(entity.m_entity)),
+	m_hoveringEntity(std::move(entity.m_hoveringEntity)),
 	m_visualEntity(std::move(entity.m_visualEntity)),
-	m_baseRenderOrder(entity.m_baseRenderOrder)
+	m_hoveringPosition(entity.m_hoveringPosition),
+	m_hoveringScale(entity.m_hoveringScale),
+	m_baseRenderOrder(entity.m_baseRenderOrder),
+	m_isHoveringFlipped(entity.m_isHoveringFlipped)
 	{
 		if (m_visualEntity)
 			m_visualEntity->NotifyVisualEntityMoved(&entity, this);
@@ -46,15 +54,30 @@ namespace bw
 	void VisualEntity::Update(const Nz::Vector2f& position, const Nz::Quaternionf& rotation, const Nz::Vector2f& scale)
 	{
 		auto& visualNode = m_entity->GetComponent<Ndk::NodeComponent>();
-		visualNode.SetPosition(position);
-		visualNode.SetRotation(rotation);
-		visualNode.SetScale(scale);
 
-		Nz::Vector2f absolutePosition = Nz::Vector2f(visualNode.GetPosition(Nz::CoordSys_Global));
-		absolutePosition.x = std::floor(absolutePosition.x);
-		absolutePosition.y = std::floor(absolutePosition.y);
-		visualNode.SetPosition(absolutePosition, Nz::CoordSys_Global);
+		// Most visuals don't move every frame, skip node (and therefore graphics component) invalidation when nothing changed
+		const Nz::Node* parentNode = visualNode.GetParent();
+		Nz::Matrix4f parentMatrix = (parentNode) ? parentNode->GetTransformMatrix() : Nz::Matrix4f::Identity();
 
+		if (!m_lastTransform || m_lastTransform->position != position || m_lastTransform->rotation != rotation || m_lastTransform->scale != scale || m_lastTransform->parentMatrix != parentMatrix)
+		{
+			visualNode.SetPosition(position);
+			visualNode.SetRotation(rotation);
+			visualNode.SetScale(scale);
+
+			Nz::Vector2f absolutePosition = Nz::Vector2f(visualNode.GetPosition(Nz::CoordSys_Global));
+			absolutePosition.x = std::floor(absolutePosition.x);
+			absolutePosition.y = std::floor(absolutePosition.y);
+			visualNode.SetPosition(absolutePosition, Nz::CoordSys_Global);
+
+			auto& lastTransform = m_lastTransform.emplace();
+			lastTransform.parentMatrix = parentMatrix;
+			lastTransform.position = position;
+			lastTransform.rotation = rotation;
+			lastTransform.scale = scale;
+		}
+
+		// Hovering renderables are positioned in the same pass, using a single node (their bounds may change even if the entity didn't move)
 		if (!m_hoveringRenderables.empty())
 		{
 			auto& visualGfx = m_entity->GetComponent<Ndk::GraphicsComponent>();
@@ -63,28 +86,51 @@ namespace bw
 			Nz::Vector2f positiveScale(std::abs(absoluteScale.x), std::abs(absoluteScale.y));
 
 			const Nz::Boxf& aabb = visualGfx.GetAABB();
-			float halfHeight = aabb.height / 2.f;
 			Nz::Vector3f center = aabb.GetCenter();
+			Nz::Vector2f hoveringPosition(center.x, center.y - aabb.height / 2.f);
+
+			bool isFlipped = (absoluteScale.y < 0.f);
+			if (isFlipped != m_isHoveringFlipped)
+			{
+				m_isHoveringFlipped = isFlipped;
+
+				auto& hoveringGfx = m_hoveringEntity->GetComponent<Ndk::GraphicsComponent>();
+				for (const auto& hoveringRenderable : m_hoveringRenderables)
+					hoveringGfx.UpdateLocalMatrix(hoveringRenderable.renderable, ComputeHoveringMatrix(hoveringRenderable.offsetMatrix, hoveringRenderable.offset));
+			}
 
-			for (auto& hoveringRenderable : m_hoveringRenderables)
+			if (hoveringPosition != m_hoveringPosition || positiveScale != m_hoveringScale)
 			{
-				auto& node = hoveringRenderable.entity->GetComponent<Ndk::NodeComponent>();
-				node.SetPosition(center.x, center.y - halfHeight - absoluteScale.y * hoveringRenderable.offset);
+				auto& node = m_hoveringEntity->GetComponent<Ndk::NodeComponent>();
+				node.SetPosition(hoveringPosition);
 				node.SetScale(positiveScale);
+
+				m_hoveringPosition = hoveringPosition;
+				m_hoveringScale = positiveScale;
 			}
 		}
 	}
 
 	void VisualEntity::AttachHoveringRenderable(Nz::InstancedRenderableRef renderable, const Nz::Matrix4f& offsetMatrix, int renderOrder, float hoverOffset)
 	{
+		if (!m_hoveringEntity)
+		{
+			m_hoveringEntity = m_entity->GetWorld()->CreateEntity();
+			m_hoveringEntity->AddComponent<Ndk::GraphicsComponent>();
+			m_hoveringEntity->Enable(m_entity->IsEnabled());
+
+			auto& node = m_hoveringEntity->AddComponent<Ndk::NodeComponent>();
+			node.SetPosition(m_hoveringPosition);
+			node.SetScale(m_hoveringScale);
+		}
+
 		auto& hoveringRenderable = m_hoveringRenderables.emplace_back();
-		hoveringRenderable.entity = m_entity->GetWorld()->CreateEntity();
-		hoveringRenderable.entity->AddComponent<Ndk::NodeComponent>();
 		hoveringRenderable.offset = hoverOffset;
+		hoveringRenderable.offsetMatrix = offsetMatrix;
 		hoveringRenderable.renderable = std::move(renderable);
 
-		auto& gfxComponent = hoveringRenderable.entity->AddComponent<Ndk::GraphicsComponent>();
-		gfxComponent.Attach(hoveringRenderable.renderable, offsetMatrix, renderOrder);
+		auto& gfxComponent = m_hoveringEntity->GetComponent<Ndk::GraphicsComponent>();
+		gfxComponent.Attach(hoveringRenderable.renderable, ComputeHoveringMatrix(offsetMatrix, hoverOffset), renderOrder);
 	}
 
 	void VisualEntity::AttachRenderable(Nz::InstancedRenderableRef renderable, const Nz::Matrix4f& offsetMatrix, int renderOrder)
@@ -100,6 +146,7 @@ namespace bw
 
 			if (hoveringRenderable.renderable == renderable)
 			{
+				m_hoveringEntity->GetComponent<Ndk::GraphicsComponent>().Detach(renderable);
 				m_hoveringRenderables.erase(it);
 				break;
 			}
@@ -118,6 +165,7 @@ namespace bw
 			if (hoveringRenderable.renderable == renderable)
 			{
 				hoveringRenderable.offset = newHoveringHeight;
+				m_hoveringEntity->GetComponent<Ndk::GraphicsComponent>().UpdateLocalMatrix(renderable, ComputeHoveringMatrix(hoveringRenderable.offsetMatrix, newHoveringHeight));
 				break;
 			}
 		}
@@ -129,7 +177,8 @@ namespace bw
 		{
 			if (hoveringRenderable.renderable == renderable)
 			{
-				hoveringRenderable.entity->GetComponent<Ndk::GraphicsComponent>().UpdateLocalMatrix(renderable, offsetMatrix);
+				hoveringRenderable.offsetMatrix = offsetMatrix;
+				m_hoveringEntity->GetComponent<Ndk::GraphicsComponent>().UpdateLocalMatrix(renderable, ComputeHoveringMatrix(offsetMatrix, hoveringRenderable.offset));
 				break;
 			}
 		}
@@ -141,7 +190,7 @@ namespace bw
 		{
 			if (hoveringRenderable.renderable == renderable)
 			{
-				hoveringRenderable.entity->GetComponent<Ndk::GraphicsComponent>().UpdateRenderOrder(renderable, renderOrder);
+				m_hoveringEntity->GetComponent<Ndk::GraphicsComponent>().UpdateRenderOrder(renderable, renderOrder);
 				break;
 			}
 		}
@@ -0,0 +1,388 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/AnimationManager.hpp>
+#include <Nazara/Core/CallOnExit.hpp>
+#include <Nazara/Math/Algorithm.hpp>
+#include <NDK/Components/NodeComponent.hpp>
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <type_traits>
+
+namespace bw
+{
+	auto AnimationManager::AnimatePosition(Ndk::EntityHandle entity, const Nz::Vector2f& from, const Nz::Vector2f& to, float duration, EasingType easing, FinishCallback finish) -> AnimationId
+	{
+		NodePositionTween tween;
+		tween.duration = duration;
+		tween.easing = easing;
+		tween.entity = std::move(entity);
+		tween.finishCallback = std::move(finish);
+		tween.from = from;
+		tween.to = to;
+
+		return PushAnimation(m_nodePositionTweens, AnimationType::NodePosition, std::move(tween));
+	}
+
+	auto AnimationManager::AnimateRotation(Ndk::EntityHandle entity, float fromAngle, float toAngle, float duration, EasingType easing, FinishCallback finish) -> AnimationId
+	{
+		NodeRotationTween tween;
+		tween.duration = duration;
+		tween.easing = easing;
+		tween.entity = std::move(entity);
+		tween.finishCallback = std::move(finish);
+		tween.from = fromAngle;
+		tween.to = toAngle;
+
+		return PushAnimation(m_nodeRotationTweens, AnimationType::NodeRotation, std::move(tween));
+	}
+
+	auto AnimationManager::AnimateValue(float& value, float from, float to, float duration, EasingType easing, FinishCallback finish) -> AnimationId
+	{
+		ValueTween<float> tween;
+		tween.duration = duration;
+		tween.easing = easing;
+		tween.finishCallback = std::move(finish);
+		tween.from = from;
+		tween.target = &value;
+		tween.to = to;
+
+		return PushAnimation(m_floatTweens, AnimationType::Float, std::move(tween));
+	}
+
+	auto AnimationManager::AnimateValue(Nz::Color& value, const Nz::Color& from, const Nz::Color& to, float duration, EasingType easing, FinishCallback finish) -> AnimationId
+	{
+		ValueTween<Nz::Color> tween;
+		tween.duration = duration;
+		tween.easing = easing;
+		tween.finishCallback = std::move(finish);
+		tween.from = from;
+		tween.target = &value;
+		tween.to = to;
+
+		return PushAnimation(m_colorTweens, AnimationType::Color, std::move(tween));
+	}
+
+	auto AnimationManager::AnimateValue(Nz::Vector2f& value, const Nz::Vector2f& from, const Nz::Vector2f& to, float duration, EasingType easing, FinishCallback finish) -> AnimationId
+	{
+		ValueTween<Nz::Vector2f> tween;
+		tween.duration = duration;
+		tween.easing = easing;
+		tween.finishCallback = std::move(finish);
+		tween.from = from;
+		tween.target = &value;
+		tween.to = to;
+
+		return PushAnimation(m_vec2Tweens, AnimationType::Vector2, std::move(tween));
+	}
+
+	bool AnimationManager::Cancel(AnimationId animationId)
+	{
+		if (!IsPlaying(animationId))
+			return false;
+
+		Nz::UInt32 slotIndex = static_cast<Nz::UInt32>(animationId & 0xFFFFFFFF);
+		const Slot& slot = m_slots[slotIndex];
+
+		// Animation is only flagged here as we may be updating its pool, it will be removed by the next update
+		VisitPool(slot.type, [&](auto& pool)
+		{
+			assert(slot.poolIndex < pool.size());
+			pool[slot.poolIndex].isActive = false;
+		});
+
+		FreeSlot(slotIndex);
+
+		return true;
+	}
+
+	void AnimationManager::Clear()
+	{
+		// Finish callbacks of animations which already ended are dropped as well
+		m_finishedCallbacks.clear();
+
+		if (m_isUpdatingPools)
+		{
+			// Clear may be called from an update callback, pools can't be cleared while they're iterated: cancel every animation instead
+			auto CancelAnimations = [&](auto& pool)
+			{
+				for (auto& animation : pool)
+				{
+					if (!animation.isActive)
+						continue;
+
+					animation.isActive = false;
+					FreeSlot(animation.slotIndex);
+				}
+			};
+
+			CancelAnimations(m_callbackAnimations);
+			CancelAnimations(m_colorTweens);
+			CancelAnimations(m_floatTweens);
+			CancelAnimations(m_nodePositionTweens);
+			CancelAnimations(m_nodeRotationTweens);
+			CancelAnimations(m_vec2Tweens);
+			return;
+		}
+
+		m_callbackAnimations.clear();
+		m_colorTweens.clear();
+		m_floatTweens.clear();
+		m_nodePositionTweens.clear();
+		m_nodeRotationTweens.clear();
+		m_vec2Tweens.clear();
+
+		// Rebuild the free list from every slot (slots which were already free must stay in it)
+		m_freeSlots.clear();
+		m_freeSlots.reserve(m_slots.size());
+		for (Nz::UInt32 slotIndex = static_cast<Nz::UInt32>(m_slots.size()); slotIndex-- > 0;)
+		{
+			if (m_slots[slotIndex].poolIndex != std::numeric_limits<Nz::UInt32>::max())
+				FreeSlot(slotIndex);
+			else
+				m_freeSlots.push_back(slotIndex);
+		}
+	}
+
+	auto AnimationManager::PushAnimation(float duration, UpdateCallback update, FinishCallback finish) -> AnimationId
+	{
+		CallbackAnimation animation;
+		animation.duration = duration;
+		animation.easing = EasingType::Linear;
+		animation.finishCallback = std::move(finish);
+		animation.updateCallback = std::move(update);
+
+		return PushAnimation(m_callbackAnimations, AnimationType::Callback, std::move(animation));
+	}
+
+	void AnimationManager::Update(float elapsedTime)
+	{
+		{
+			m_isUpdatingPools = true;
+			Nz::CallOnExit resetUpdating([&] { m_isUpdatingPools = false; });
+
+			UpdatePool(m_colorTweens, elapsedTime);
+			UpdatePool(m_floatTweens, elapsedTime);
+			UpdatePool(m_nodePositionTweens, elapsedTime);
+			UpdatePool(m_nodeRotationTweens, elapsedTime);
+			UpdatePool(m_vec2Tweens, elapsedTime);
+			UpdatePool(m_callbackAnimations, elapsedTime);
+		}
+
+		// Finish callbacks are called last as they may push new animations (in any pool)
+		for (std::size_t i = 0; i < m_finishedCallbacks.size(); ++i)
+		{
+			FinishCallback callback = std::move(m_finishedCallbacks[i]);
+			callback();
+		}
+		m_finishedCallbacks.clear();
+	}
+
+	float AnimationManager::ApplyEasing(EasingType easing, float ratio)
+	{
+		switch (easing)
+		{
+			case EasingType::Linear:
+				return ratio;
+
+			case EasingType::QuadraticIn:
+				return ratio * ratio;
+
+			case EasingType::QuadraticOut:
+				return ratio * (2.f - ratio);
+
+			case EasingType::QuadraticInOut:
+				return (ratio < 0.5f) ? 2.f * ratio * ratio : -1.f + (4.f - 2.f * ratio) * ratio;
+
+			case EasingType::CubicIn:
+				return ratio * ratio * ratio;
+
+			case EasingType::CubicOut:
+			{
+				float t = ratio - 1.f;
+				return t * t * t + 1.f;
+			}
+
+			case EasingType::CubicInOut:
+			{
+				if (ratio < 0.5f)
+					return 4.f * ratio * ratio * ratio;
+
+				float t = 2.f * ratio - 2.f;
+				return 0.5f * t * t * t + 1.f;
+			}
+		}
+
+		return ratio;
+	}
+
+	void AnimationManager::FreeSlot(Nz::UInt32 slotIndex)
+	{
+		Slot& slot = m_slots[slotIndex];
+		slot.generation++;
+		if (slot.generation == 0)
+			slot.generation = 1; //< Keep ids different from InvalidAnimationId
+
+		slot.poolIndex = std::numeric_limits<Nz::UInt32>::max();
+
+		m_freeSlots.push_back(slotIndex);
+	}
+
+	template<typename T>
+	auto AnimationManager::PushAnimation(std::vector<T>& pool, AnimationType type, T&& animation) -> AnimationId
+	{
+		// Apply initial state right away (and don't start animations on invalid targets)
+		if (!Apply(animation, ApplyEasing(animation.easing, 0.f)))
+			return InvalidAnimationId;
+
+		Nz::UInt32 slotIndex;
+		if (!m_freeSlots.empty())
+		{
+			slotIndex = m_freeSlots.back();
+			m_freeSlots.pop_back();
+		}
+		else
+		{
+			slotIndex = static_cast<Nz::UInt32>(m_slots.size());
+			m_slots.emplace_back();
+		}
+
+		Slot& slot = m_slots[slotIndex];
+		slot.poolIndex = static_cast<Nz::UInt32>(pool.size());
+		slot.type = type;
+
+		animation.elapsedTime = 0.f;
+		animation.isActive = true;
+		animation.slotIndex = slotIndex;
+		pool.push_back(std::move(animation));
+
+		return (AnimationId(slot.generation) << 32) | slotIndex;
+	}
+
+	template<typename T>
+	void AnimationManager::UpdatePool(std::vector<T>& pool, float elapsedTime)
+	{
+		// Keep animation count to prevent updating animations pushed during the update
+		std::size_t animationCount = pool.size();
+		for (std::size_t i = 0; i < animationCount; ++i)
+		{
+			if (!pool[i].isActive)
+				continue;
+
+			pool[i].elapsedTime += elapsedTime;
+
+			float ratio = (pool[i].duration > 0.f) ? std::min(pool[i].elapsedTime / pool[i].duration, 1.f) : 1.f;
+
+			bool isRunning;
+			if constexpr (std::is_same_v<T, CallbackAnimation>)
+			{
+				// Custom callbacks may push animations in this pool, don't let it reallocate the callback we're calling
+				CallbackAnimation animation;
+				animation.updateCallback = std::move(pool[i].updateCallback);
+				isRunning = Apply(animation, ApplyEasing(pool[i].easing, ratio));
+				pool[i].updateCallback = std::move(animation.updateCallback);
+			}
+			else
+				isRunning = Apply(pool[i], ApplyEasing(pool[i].easing, ratio));
+
+			T& animation = pool[i];
+			if (!animation.isActive)
+				continue; //< Cancelled by its own update callback
+
+			if (isRunning && ratio < 1.f)
+				continue;
+
+			if (isRunning && animation.finishCallback)
+				m_finishedCallbacks.push_back(std::move(animation.finishCallback));
+
+			animation.isActive = false;
+			FreeSlot(animation.slotIndex);
+		}
+
+		// Remove finished and cancelled animations while keeping their order
+		std::size_t activeCount = 0;
+		for (std::size_t i = 0; i < pool.size(); ++i)
+		{
+			if (!pool[i].isActive)
+				continue;
+
+			if (i != activeCount)
+				pool[activeCount] = std::move(pool[i]);
+
+			m_slots[pool[activeCount].slotIndex].poolIndex = static_cast<Nz::UInt32>(activeCount);
+			activeCount++;
+		}
+		pool.resize(activeCount);
+	}
+
+	template<typename F>
+	void AnimationManager::VisitPool(AnimationType type, F&& func)
+	{
+		switch (type)
+		{
+			case AnimationType::Callback:     return func(m_callbackAnimations);
+			case AnimationType::Color:        return func(m_colorTweens);
+			case AnimationType::Float:        return func(m_floatTweens);
+			case AnimationType::NodePosition: return func(m_nodePositionTweens);
+			case AnimationType::NodeRotation: return func(m_nodeRotationTweens);
+			case AnimationType::Vector2:      return func(m_vec2Tweens);
+		}
+	}
+
+	bool AnimationManager::Apply(CallbackAnimation& animation, float ratio)
+	{
+		return animation.updateCallback(ratio);
+	}
+
+	bool AnimationManager::Apply(NodePositionTween& animation, float ratio)
+	{
+		if (!animation.entity)
+			return false;
+
+		auto& nodeComponent = animation.entity->GetComponent<Ndk::NodeComponent>();
+		nodeComponent.SetInitialPosition(Nz::Lerp(animation.from, animation.to, ratio));
+
+		return true;
+	}
+
+	bool AnimationManager::Apply(NodeRotationTween& animation, float ratio)
+	{
+		if (!animation.entity)
+			return false;
+
+		auto& nodeComponent = animation.entity->GetComponent<Ndk::NodeComponent>();
+		nodeComponent.SetRotation(Nz::DegreeAnglef(Nz::Lerp(animation.from, animation.to, ratio)));
+
+		return true;
+	}
+
+	bool AnimationManager::Apply(ValueTween<float>& animation, float ratio)
+	{
+		*animation.target = Nz::Lerp(animation.from, animation.to, ratio);
+		return true;
+	}
+
+	bool AnimationManager::Apply(ValueTween<Nz::Color>& animation, float ratio)
+	{
+		auto LerpComponent = [&](Nz::UInt8 from, Nz::UInt8 to)
+		{
+			return static_cast<Nz::UInt8>(std::clamp(Nz::Lerp(float(from), float(to), ratio), 0.f, 255.f));
+		};
+
+		Nz::Color& target = *animation.target;
+		target.r = LerpComponent(animation.from.r, animation.to.r);
+		target.g = LerpComponent(animation.from.g, animation.to.g);
+		target.b = LerpComponent(animation.from.b, animation.to.b);
+		target.a = LerpComponent(animation.from.a, animation.to.a);
+
+		return true;
+	}
+
+	bool AnimationManager::Apply(ValueTween<Nz::Vector2f>& animation, float ratio)
+	{
+		*animation.target = Nz::Lerp(animation.from, animation.to, ratio);
+		return true;
+	}
+}
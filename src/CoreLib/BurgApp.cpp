@@ -19,8 +19,10 @@
 #include <CoreLib/Components/ScriptComponent.hpp>
 #include <CoreLib/Components/WeaponComponent.hpp>
 #include <CoreLib/Components/WeaponWielderComponent.hpp>
+#include <CoreLib/LogSystem/AsyncSink.hpp>
 #include <CoreLib/LogSystem/StdSink.hpp>
 #include <CoreLib/Systems/AnimationSystem.hpp>
+#include <CoreLib/Systems/HitboxHistorySystem.hpp>
 #include <CoreLib/Systems/InputSystem.hpp>
 #include <CoreLib/Systems/NetworkSyncSystem.hpp>
 #include <CoreLib/Systems/PlayerMovementSystem.hpp>
@@ -61,7 +63,8 @@ namespace bw
 
 		InstallInterruptHandlers();
 
-		m_logger.RegisterSink(std::make_shared<StdSink>());
+		// Console output is slow, don't let it block the main thread
+		m_logger.RegisterSink(std::make_shared<AsyncSink>(std::make_shared<StdSink>()));
 		m_logger.SetMinimumLogLevel(LogLevel::Debug);
 
 		Ndk::InitializeComponent<AnimationComponent>("Anim");
@@ -79,6 +82,7 @@ namespace bw
 		Ndk::InitializeComponent<WeaponComponent>("Weapon");
 		Ndk::InitializeComponent<WeaponWielderComponent>("WepnWiel");
 		Ndk::InitializeSystem<AnimationSystem>();
+		Ndk::InitializeSystem<HitboxHistorySystem>();
 		Ndk::InitializeSystem<InputSystem>();
 		Ndk::InitializeSystem<NetworkSyncSystem>();
 		Ndk::InitializeSystem<PlayerMovementSystem>();
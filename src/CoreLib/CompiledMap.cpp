@@ -0,0 +1,670 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/CompiledMap.hpp>
+#include <CoreLib/Version.hpp>
+#include <CoreLib/Utility/BinaryIO.hpp>
+#include <Nazara/Core/File.hpp>
+#include <tsl/hopscotch_map.h>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+namespace bw
+{
+	/*
+	Binary map format (version 2), every value is little-endian and every record has a fixed size:
+
+	Header (16 bytes): "Burgrmap", UInt16 version, UInt16 section count, UInt32 game version
+	Section directory (24 bytes per section): UInt32 type, UInt32 reserved, UInt64 offset, UInt64 size
+
+	Strings: UInt32 count, UInt32 reserved, count * (UInt32 offset, UInt32 size), string data
+	Info (12 bytes): UInt32 name, UInt32 author, UInt32 description (string indices)
+	Layers (16 bytes per layer): UInt32 name, UInt8 r/g/b/a, UInt32 first entity, UInt32 entity count
+	Entities (40 bytes per entity): UInt32 type, UInt32 name, float x/y, float rotation, UInt32 first property, UInt32 property count, UInt32 reserved, Int64 unique id
+	Properties (16 bytes per property): UInt32 key, UInt8 type, UInt8 isArray, UInt16 reserved, UInt32 element count, UInt32 value offset (in PropertyData)
+	PropertyData: fixed-size property values (strings are stored as string indices)
+	Scripts (24 bytes per script): UInt32 path, UInt32 reserved, UInt64 offset (in Blobs), UInt64 size
+	Assets (40 bytes per asset): UInt32 path, UInt32 reserved, UInt64 size, UInt8[20] sha1 checksum, UInt32 reserved
+	Blobs: script contents
+
+	Unknown sections are ignored, allowing them to be added without breaking older readers.
+	*/
+
+	namespace
+	{
+		enum class SectionType : Nz::UInt32
+		{
+			Strings      = 0,
+			Info         = 1,
+			Layers       = 2,
+			Entities     = 3,
+			Properties   = 4,
+			PropertyData = 5,
+			Scripts      = 6,
+			Assets       = 7,
+			Blobs        = 8
+		};
+
+		constexpr std::size_t HeaderSize = 16;
+		constexpr std::size_t SectionEntrySize = 24;
+		constexpr std::size_t StringEntrySize = 8;
+		constexpr std::size_t StringHeaderSize = 8;
+		constexpr std::size_t InfoRecordSize = 12;
+		constexpr std::size_t LayerRecordSize = 16;
+		constexpr std::size_t EntityRecordSize = 40;
+		constexpr std::size_t PropertyRecordSize = 16;
+		constexpr std::size_t ScriptRecordSize = 24;
+		constexpr std::size_t AssetRecordSize = 40;
+		constexpr std::size_t SectionAlignment = 8;
+
+		class StringTable
+		{
+			public:
+				StringTable()
+				{
+					Register(std::string());
+				}
+
+				const std::vector<std::string>& GetStrings() const
+				{
+					return m_strings;
+				}
+
+				Nz::UInt32 Register(const std::string& str)
+				{
+					if (auto it = m_indices.find(str); it != m_indices.end())
+						return it->second;
+
+					Nz::UInt32 index = Nz::UInt32(m_strings.size());
+					m_strings.push_back(str);
+					m_indices.emplace(str, index);
+
+					return index;
+				}
+
+			private:
+				std::vector<std::string> m_strings;
+				tsl::hopscotch_map<std::string, Nz::UInt32> m_indices;
+		};
+
+		template<typename T> struct EncodedSize { static constexpr std::size_t Value = sizeof(T); };
+		template<> struct EncodedSize<bool> { static constexpr std::size_t Value = sizeof(Nz::UInt8); };
+		template<> struct EncodedSize<std::string> { static constexpr std::size_t Value = sizeof(Nz::UInt32); };
+		template<typename T> struct EncodedSize<Nz::Vector2<T>> { static constexpr std::size_t Value = 2 * sizeof(T); };
+		template<typename T> struct EncodedSize<Nz::Vector3<T>> { static constexpr std::size_t Value = 3 * sizeof(T); };
+		template<typename T> struct EncodedSize<Nz::Vector4<T>> { static constexpr std::size_t Value = 4 * sizeof(T); };
+
+		template<typename T>
+		void ReadValue(const CompiledMap& /*map*/, const Nz::UInt8* ptr, T& value)
+		{
+			value = ReadLE<T>(ptr);
+		}
+
+		void ReadValue(const CompiledMap& /*map*/, const Nz::UInt8* ptr, bool& value)
+		{
+			value = (*ptr != 0);
+		}
+
+		void ReadValue(const CompiledMap& map, const Nz::UInt8* ptr, std::string& value)
+		{
+			value = map.GetString(ReadLE<Nz::UInt32>(ptr));
+		}
+
+		template<typename T>
+		void ReadValue(const CompiledMap& /*map*/, const Nz::UInt8* ptr, Nz::Vector2<T>& value)
+		{
+			value.x = ReadLE<T>(ptr);
+			value.y = ReadLE<T>(ptr + sizeof(T));
+		}
+
+		template<typename T>
+		void ReadValue(const CompiledMap& /*map*/, const Nz::UInt8* ptr, Nz::Vector3<T>& value)
+		{
+			value.x = ReadLE<T>(ptr);
+			value.y = ReadLE<T>(ptr + sizeof(T));
+			value.z = ReadLE<T>(ptr + 2 * sizeof(T));
+		}
+
+		template<typename T>
+		void ReadValue(const CompiledMap& /*map*/, const Nz::UInt8* ptr, Nz::Vector4<T>& value)
+		{
+			value.x = ReadLE<T>(ptr);
+			value.y = ReadLE<T>(ptr + sizeof(T));
+			value.z = ReadLE<T>(ptr + 2 * sizeof(T));
+			value.w = ReadLE<T>(ptr + 3 * sizeof(T));
+		}
+
+		template<typename T>
+		void WriteValue(std::vector<Nz::UInt8>& buffer, StringTable& /*strings*/, const T& value)
+		{
+			WriteLE(buffer, value);
+		}
+
+		void WriteValue(std::vector<Nz::UInt8>& buffer, StringTable& /*strings*/, bool value)
+		{
+			WriteLE(buffer, Nz::UInt8((value) ? 1 : 0));
+		}
+
+		void WriteValue(std::vector<Nz::UInt8>& buffer, StringTable& strings, const std::string& value)
+		{
+			WriteLE(buffer, strings.Register(value));
+		}
+
+		template<typename T>
+		void WriteValue(std::vector<Nz::UInt8>& buffer, StringTable& /*strings*/, const Nz::Vector2<T>& value)
+		{
+			WriteLE(buffer, value.x);
+			WriteLE(buffer, value.y);
+		}
+
+		template<typename T>
+		void WriteValue(std::vector<Nz::UInt8>& buffer, StringTable& /*strings*/, const Nz::Vector3<T>& value)
+		{
+			WriteLE(buffer, value.x);
+			WriteLE(buffer, value.y);
+			WriteLE(buffer, value.z);
+		}
+
+		template<typename T>
+		void WriteValue(std::vector<Nz::UInt8>& buffer, StringTable& /*strings*/, const Nz::Vector4<T>& value)
+		{
+			WriteLE(buffer, value.x);
+			WriteLE(buffer, value.y);
+			WriteLE(buffer, value.z);
+			WriteLE(buffer, value.w);
+		}
+
+		[[noreturn]] void ThrowCorrupted(const char* reason)
+		{
+			throw std::runtime_error(std::string("corrupted map file (") + reason + ")");
+		}
+	}
+
+	CompiledMap::CompiledMap(const std::filesystem::path& mapFile) :
+	m_gameVersion(0),
+	m_stringCount(0)
+	{
+		if (!m_file.Open(mapFile))
+			throw std::runtime_error("failed to open map file");
+
+		const Nz::UInt8* fileData = m_file.GetData();
+		std::size_t fileSize = m_file.GetSize();
+
+		if (fileSize < HeaderSize || std::memcmp(fileData, "Burgrmap", 8) != 0)
+			throw std::runtime_error("not a valid burger map file");
+
+		Nz::UInt16 fileVersion = ReadLE<Nz::UInt16>(fileData + 8);
+		if (fileVersion < 2)
+			throw std::runtime_error("map file uses the legacy format (version " + std::to_string(fileVersion) + ")");
+
+		if (fileVersion > FileVersion)
+			throw std::runtime_error("unhandled file version (more recent than game)");
+
+		Nz::UInt16 sectionCount = ReadLE<Nz::UInt16>(fileData + 10);
+		m_gameVersion = ReadLE<Nz::UInt32>(fileData + 12);
+
+		if (fileSize - HeaderSize < sectionCount * SectionEntrySize)
+			ThrowCorrupted("truncated section directory");
+
+		bool hasInfo = false;
+		bool hasStrings = false;
+		for (std::size_t i = 0; i < sectionCount; ++i)
+		{
+			const Nz::UInt8* sectionEntry = fileData + HeaderSize + i * SectionEntrySize;
+
+			SectionType sectionType = static_cast<SectionType>(ReadLE<Nz::UInt32>(sectionEntry));
+			Nz::UInt64 sectionOffset = ReadLE<Nz::UInt64>(sectionEntry + 8);
+			Nz::UInt64 sectionSize = ReadLE<Nz::UInt64>(sectionEntry + 16);
+
+			if (sectionOffset > fileSize || sectionSize > fileSize - sectionOffset)
+				ThrowCorrupted("section out of bounds");
+
+			Section section;
+			section.data = fileData + sectionOffset;
+			section.size = static_cast<std::size_t>(sectionSize);
+
+			switch (sectionType)
+			{
+				case SectionType::Assets:       m_assets = section; break;
+				case SectionType::Blobs:        m_blobs = section; break;
+				case SectionType::Entities:     m_entities = section; break;
+				case SectionType::Info:         m_info = section; hasInfo = true; break;
+				case SectionType::Layers:       m_layers = section; break;
+				case SectionType::Properties:   m_properties = section; break;
+				case SectionType::PropertyData: m_propertyData = section; break;
+				case SectionType::Scripts:      m_scripts = section; break;
+				case SectionType::Strings:      m_strings = section; hasStrings = true; break;
+				default:
+					break; //< Ignore sections from more recent versions
+			}
+		}
+
+		if (!hasInfo || !hasStrings)
+			ThrowCorrupted("missing mandatory section");
+
+		if (m_strings.size < StringHeaderSize)
+			ThrowCorrupted("invalid string table");
+
+		m_stringCount = ReadLE<Nz::UInt32>(m_strings.data);
+		if ((m_strings.size - StringHeaderSize) / StringEntrySize < m_stringCount)
+			ThrowCorrupted("invalid string table");
+
+		if (m_info.size < InfoRecordSize)
+			ThrowCorrupted("invalid map info");
+
+		m_mapInfo.name = GetString(ReadLE<Nz::UInt32>(m_info.data));
+		m_mapInfo.author = GetString(ReadLE<Nz::UInt32>(m_info.data + 4));
+		m_mapInfo.description = GetString(ReadLE<Nz::UInt32>(m_info.data + 8));
+	}
+
+	std::vector<Map::Asset> CompiledMap::DecodeAssets() const
+	{
+		std::size_t assetCount = GetAssetCount();
+
+		std::vector<Map::Asset> assets(assetCount);
+		for (std::size_t i = 0; i < assetCount; ++i)
+		{
+			const Nz::UInt8* assetRecord = GetRecord(m_assets, AssetRecordSize, i);
+
+			Map::Asset& asset = assets[i];
+			asset.filepath = GetString(ReadLE<Nz::UInt32>(assetRecord));
+			asset.size = ReadLE<Nz::UInt64>(assetRecord + 8);
+			std::memcpy(asset.sha1Checksum.data(), assetRecord + 16, asset.sha1Checksum.size());
+		}
+
+		return assets;
+	}
+
+	Map::Layer CompiledMap::DecodeLayer(LayerIndex layerIndex) const
+	{
+		const Nz::UInt8* layerRecord = GetRecord(m_layers, LayerRecordSize, layerIndex);
+
+		Map::Layer layer;
+		layer.name = GetString(ReadLE<Nz::UInt32>(layerRecord));
+		layer.backgroundColor = Nz::Color(layerRecord[4], layerRecord[5], layerRecord[6], layerRecord[7]);
+
+		Nz::UInt32 firstEntity = ReadLE<Nz::UInt32>(layerRecord + 8);
+		Nz::UInt32 entityCount = ReadLE<Nz::UInt32>(layerRecord + 12);
+
+		layer.entities.resize(entityCount);
+		for (std::size_t i = 0; i < entityCount; ++i)
+		{
+			const Nz::UInt8* entityRecord = GetRecord(m_entities, EntityRecordSize, std::size_t(firstEntity) + i);
+
+			Map::Entity& entity = layer.entities[i];
+			entity.entityType = GetString(ReadLE<Nz::UInt32>(entityRecord));
+			entity.name = GetString(ReadLE<Nz::UInt32>(entityRecord + 4));
+			entity.position.x = ReadLE<float>(entityRecord + 8);
+			entity.position.y = ReadLE<float>(entityRecord + 12);
+			entity.rotation = Nz::DegreeAnglef::FromDegrees(ReadLE<float>(entityRecord + 16));
+			entity.uniqueId = ReadLE<EntityId>(entityRecord + 32);
+
+			Nz::UInt32 firstProperty = ReadLE<Nz::UInt32>(entityRecord + 20);
+			Nz::UInt32 propertyCount = ReadLE<Nz::UInt32>(entityRecord + 24);
+
+			entity.properties.reserve(propertyCount);
+			for (std::size_t j = 0; j < propertyCount; ++j)
+			{
+				const Nz::UInt8* propertyRecord = GetRecord(m_properties, PropertyRecordSize, std::size_t(firstProperty) + j);
+
+				std::string propertyName(GetString(ReadLE<Nz::UInt32>(propertyRecord)));
+				PropertyType propertyType = static_cast<PropertyType>(propertyRecord[4]);
+				bool isArray = (propertyRecord[5] != 0);
+				Nz::UInt32 elementCount = ReadLE<Nz::UInt32>(propertyRecord + 8);
+				Nz::UInt32 valueOffset = ReadLE<Nz::UInt32>(propertyRecord + 12);
+
+				// Waiting for template lambda in C++20
+				auto Unserialize = [&](auto dummyType)
+				{
+					using T = std::decay_t<decltype(dummyType)>;
+
+					static constexpr PropertyType Property = T::Property;
+					static constexpr std::size_t ElementSize = EncodedSize<PropertyUnderlyingType_t<Property>>::Value;
+
+					std::size_t valueCount = (isArray) ? elementCount : 1;
+					if (valueOffset > m_propertyData.size || valueCount > (m_propertyData.size - valueOffset) / ElementSize)
+						ThrowCorrupted("property value out of bounds");
+
+					const Nz::UInt8* valuePtr = m_propertyData.data + valueOffset;
+					if (isArray)
+					{
+						PropertyArrayValue<Property> elements(elementCount);
+						for (auto& element : elements)
+						{
+							ReadValue(*this, valuePtr, element);
+							valuePtr += ElementSize;
+						}
+
+						entity.properties.emplace(std::move(propertyName), std::move(elements));
+					}
+					else
+					{
+						PropertySingleValue<Property> value;
+						ReadValue(*this, valuePtr, value.value);
+
+						entity.properties.emplace(std::move(propertyName), std::move(value));
+					}
+				};
+
+				switch (propertyType)
+				{
+#define BURGWAR_PROPERTYTYPE(V, T, IT) case PropertyType:: T: Unserialize(PropertyTag<PropertyType:: T>{}); break;
+
+#include <CoreLib/PropertyTypeList.hpp>
+
+					default:
+						ThrowCorrupted("unknown property type");
+				}
+			}
+		}
+
+		return layer;
+	}
+
+	std::vector<Map::Script> CompiledMap::DecodeScripts() const
+	{
+		std::size_t scriptCount = GetScriptCount();
+
+		std::vector<Map::Script> scripts(scriptCount);
+		for (std::size_t i = 0; i < scriptCount; ++i)
+		{
+			const Nz::UInt8* scriptRecord = GetRecord(m_scripts, ScriptRecordSize, i);
+
+			Nz::UInt64 contentOffset = ReadLE<Nz::UInt64>(scriptRecord + 8);
+			Nz::UInt64 contentSize = ReadLE<Nz::UInt64>(scriptRecord + 16);
+			if (contentOffset > m_blobs.size || contentSize > m_blobs.size - contentOffset)
+				ThrowCorrupted("script content out of bounds");
+
+			const Nz::UInt8* content = m_blobs.data + contentOffset;
+
+			Map::Script& script = scripts[i];
+			script.filepath = GetString(ReadLE<Nz::UInt32>(scriptRecord));
+			script.content.assign(content, content + contentSize);
+		}
+
+		return scripts;
+	}
+
+	std::size_t CompiledMap::GetAssetCount() const
+	{
+		return m_assets.size / AssetRecordSize;
+	}
+
+	auto CompiledMap::GetLayerInfo(LayerIndex layerIndex) const -> LayerInfo
+	{
+		const Nz::UInt8* layerRecord = GetRecord(m_layers, LayerRecordSize, layerIndex);
+
+		LayerInfo layerInfo;
+		layerInfo.name = GetString(ReadLE<Nz::UInt32>(layerRecord));
+		layerInfo.backgroundColor = Nz::Color(layerRecord[4], layerRecord[5], layerRecord[6], layerRecord[7]);
+		layerInfo.entityCount = ReadLE<Nz::UInt32>(layerRecord + 12);
+
+		return layerInfo;
+	}
+
+	std::size_t CompiledMap::GetLayerCount() const
+	{
+		return m_layers.size / LayerRecordSize;
+	}
+
+	std::size_t CompiledMap::GetScriptCount() const
+	{
+		return m_scripts.size / ScriptRecordSize;
+	}
+
+	std::string_view CompiledMap::GetString(Nz::UInt32 stringIndex) const
+	{
+		if (stringIndex >= m_stringCount)
+			ThrowCorrupted("string index out of bounds");
+
+		const Nz::UInt8* stringEntry = m_strings.data + StringHeaderSize + stringIndex * StringEntrySize;
+		Nz::UInt32 stringOffset = ReadLE<Nz::UInt32>(stringEntry);
+		Nz::UInt32 stringSize = ReadLE<Nz::UInt32>(stringEntry + 4);
+
+		std::size_t dataOffset = StringHeaderSize + m_stringCount * StringEntrySize;
+		std::size_t dataSize = m_strings.size - dataOffset;
+		if (stringOffset > dataSize || stringSize > dataSize - stringOffset)
+			ThrowCorrupted("string out of bounds");
+
+		return std::string_view(reinterpret_cast<const char*>(m_strings.data + dataOffset + stringOffset), stringSize);
+	}
+
+	bool CompiledMap::Compile(const Map& map, const std::filesystem::path& outputPath)
+	{
+		assert(map.IsValid());
+
+		StringTable strings;
+
+		std::vector<Nz::UInt8> infoSection;
+		std::vector<Nz::UInt8> layerSection;
+		std::vector<Nz::UInt8> entitySection;
+		std::vector<Nz::UInt8> propertySection;
+		std::vector<Nz::UInt8> propertyDataSection;
+		std::vector<Nz::UInt8> scriptSection;
+		std::vector<Nz::UInt8> assetSection;
+		std::vector<Nz::UInt8> blobSection;
+
+		// Map header
+		const MapInfo& mapInfo = map.GetMapInfo();
+		WriteLE(infoSection, strings.Register(mapInfo.name));
+		WriteLE(infoSection, strings.Register(mapInfo.author));
+		WriteLE(infoSection, strings.Register(mapInfo.description));
+
+		// Map layers
+		Nz::UInt32 entityIndex = 0;
+		Nz::UInt32 propertyIndex = 0;
+		for (const Map::Layer& layer : map.GetLayers())
+		{
+			WriteLE(layerSection, strings.Register(layer.name));
+			WriteLE(layerSection, layer.backgroundColor.r);
+			WriteLE(layerSection, layer.backgroundColor.g);
+			WriteLE(layerSection, layer.backgroundColor.b);
+			WriteLE(layerSection, layer.backgroundColor.a);
+			WriteLE(layerSection, entityIndex);
+			WriteLE(layerSection, Nz::UInt32(layer.entities.size()));
+
+			for (const Map::Entity& entity : layer.entities)
+			{
+				WriteLE(entitySection, strings.Register(entity.entityType));
+				WriteLE(entitySection, strings.Register(entity.name));
+				WriteLE(entitySection, entity.position.x);
+				WriteLE(entitySection, entity.position.y);
+				WriteLE(entitySection, entity.rotation.ToDegrees());
+				WriteLE(entitySection, propertyIndex);
+				WriteLE(entitySection, Nz::UInt32(entity.properties.size()));
+				WriteLE(entitySection, Nz::UInt32(0));
+				WriteLE(entitySection, entity.uniqueId);
+
+				for (const auto& [key, value] : entity.properties)
+				{
+					auto [P, isArray] = ExtractPropertyType(value);
+
+					WriteLE(propertySection, strings.Register(key));
+					WriteLE(propertySection, Nz::UInt8(P));
+					WriteLE(propertySection, Nz::UInt8((isArray) ? 1 : 0));
+					WriteLE(propertySection, Nz::UInt16(0));
+
+					Nz::UInt32 valueOffset = Nz::UInt32(propertyDataSection.size());
+
+					std::visit([&](auto&& propertyValue)
+					{
+						using T = std::decay_t<decltype(propertyValue)>;
+						using TypeExtractor = PropertyTypeExtractor<T>;
+						constexpr bool IsArray = TypeExtractor::IsArray;
+
+						if constexpr (IsArray)
+						{
+							WriteLE(propertySection, Nz::UInt32(propertyValue.size()));
+							for (const auto& element : propertyValue)
+								WriteValue(propertyDataSection, strings, element);
+						}
+						else
+						{
+							WriteLE(propertySection, Nz::UInt32(1));
+							WriteValue(propertyDataSection, strings, propertyValue.value);
+						}
+					}, value);
+
+					WriteLE(propertySection, valueOffset);
+
+					propertyIndex++;
+				}
+
+				entityIndex++;
+			}
+		}
+
+		// Scripts
+		for (const Map::Script& script : map.GetScripts())
+		{
+			WriteLE(scriptSection, strings.Register(script.filepath));
+			WriteLE(scriptSection, Nz::UInt32(0));
+			WriteLE(scriptSection, Nz::UInt64(blobSection.size()));
+			WriteLE(scriptSection, Nz::UInt64(script.content.size()));
+
+			blobSection.insert(blobSection.end(), script.content.begin(), script.content.end());
+		}
+
+		// Assets
+		for (const Map::Asset& asset : map.GetAssets())
+		{
+			WriteLE(assetSection, strings.Register(asset.filepath));
+			WriteLE(assetSection, Nz::UInt32(0));
+			WriteLE(assetSection, asset.size);
+			assetSection.insert(assetSection.end(), asset.sha1Checksum.begin(), asset.sha1Checksum.end());
+			WriteLE(assetSection, Nz::UInt32(0));
+		}
+
+		// String table (built last as every other section registers strings)
+		std::vector<Nz::UInt8> stringSection;
+		{
+			const auto& stringList = strings.GetStrings();
+
+			WriteLE(stringSection, Nz::UInt32(stringList.size()));
+			WriteLE(stringSection, Nz::UInt32(0));
+
+			Nz::UInt32 stringOffset = 0;
+			for (const std::string& str : stringList)
+			{
+				WriteLE(stringSection, stringOffset);
+				WriteLE(stringSection, Nz::UInt32(str.size()));
+
+				stringOffset += Nz::UInt32(str.size());
+			}
+
+			for (const std::string& str : stringList)
+				stringSection.insert(stringSection.end(), str.begin(), str.end());
+		}
+
+		std::array<std::pair<SectionType, const std::vector<Nz::UInt8>*>, 9> sections = {
+			{
+				{ SectionType::Strings,      &stringSection },
+				{ SectionType::Info,         &infoSection },
+				{ SectionType::Layers,       &layerSection },
+				{ SectionType::Entities,     &entitySection },
+				{ SectionType::Properties,   &propertySection },
+				{ SectionType::PropertyData, &propertyDataSection },
+				{ SectionType::Scripts,      &scriptSection },
+				{ SectionType::Assets,       &assetSection },
+				{ SectionType::Blobs,        &blobSection }
+			}
+		};
+
+		auto Align = [](Nz::UInt64 offset)
+		{
+			return (offset + SectionAlignment - 1) / SectionAlignment * SectionAlignment;
+		};
+
+		std::vector<Nz::UInt8> header;
+		const char signature[] = "Burgrmap";
+		header.insert(header.end(), signature, signature + 8);
+		WriteLE(header, FileVersion);
+		WriteLE(header, Nz::UInt16(sections.size()));
+		WriteLE(header, GameVersion);
+
+		Nz::UInt64 sectionOffset = Align(HeaderSize + sections.size() * SectionEntrySize);
+		for (const auto& [sectionType, sectionData] : sections)
+		{
+			WriteLE(header, static_cast<Nz::UInt32>(sectionType));
+			WriteLE(header, Nz::UInt32(0));
+			WriteLE(header, sectionOffset);
+			WriteLE(header, Nz::UInt64(sectionData->size()));
+
+			sectionOffset = Align(sectionOffset + sectionData->size());
+		}
+
+		assert(header.size() == HeaderSize + sections.size() * SectionEntrySize);
+
+		// Write to a temporary file first so a failed compilation can't leave a truncated map behind
+		std::filesystem::path tempPath = outputPath;
+		tempPath += ".tmp";
+
+		auto WriteFile = [&]
+		{
+			Nz::File outputFile(tempPath.generic_u8string(), Nz::OpenMode_WriteOnly | Nz::OpenMode_Truncate);
+			if (!outputFile.IsOpen())
+				return false;
+
+			std::array<Nz::UInt8, SectionAlignment> padding = {};
+			auto WriteAligned = [&](const std::vector<Nz::UInt8>& data)
+			{
+				if (outputFile.Write(data.data(), data.size()) != data.size())
+					return false;
+
+				std::size_t paddingSize = static_cast<std::size_t>(Align(outputFile.GetCursorPos()) - outputFile.GetCursorPos());
+				return outputFile.Write(padding.data(), paddingSize) == paddingSize;
+			};
+
+			if (!WriteAligned(header))
+				return false;
+
+			for (const auto& [sectionType, sectionData] : sections)
+			{
+				if (!WriteAligned(*sectionData))
+					return false;
+			}
+
+			return true;
+		};
+
+		std::error_code ec;
+		if (!WriteFile())
+		{
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+
+		std::filesystem::rename(tempPath, outputPath, ec);
+		if (ec)
+		{
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+
+		return true;
+	}
+
+	Nz::UInt16 CompiledMap::ReadFileVersion(const std::filesystem::path& mapFile)
+	{
+		Nz::File file(mapFile.generic_u8string(), Nz::OpenMode_ReadOnly);
+		if (!file.IsOpen())
+			throw std::runtime_error("failed to open map file");
+
+		std::array<Nz::UInt8, 10> header;
+		if (file.Read(header.data(), header.size()) != header.size() || std::memcmp(header.data(), "Burgrmap", 8) != 0)
+			throw std::runtime_error("not a valid burger map file");
+
+		return ReadLE<Nz::UInt16>(header.data() + 8);
+	}
+
+	const Nz::UInt8* CompiledMap::GetRecord(const Section& section, std::size_t recordSize, std::size_t recordIndex) const
+	{
+		if (recordIndex >= section.size / recordSize)
+			ThrowCorrupted("record index out of bounds");
+
+		return section.data + recordIndex * recordSize;
+	}
+}
@@ -0,0 +1,265 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/FileHashCache.hpp>
+#include <CoreLib/LogSystem/Logger.hpp>
+#include <CoreLib/Utility/ThreadPool.hpp>
+#include <Nazara/Core/File.hpp>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace bw
+{
+	namespace
+	{
+		constexpr unsigned int ManifestVersion = 1;
+	}
+
+	FileHashCache::FileHashCache(const Logger& logger, std::filesystem::path manifestPath) :
+	m_manifestPath(std::move(manifestPath)),
+	m_logger(logger),
+	m_isDirty(false)
+	{
+	}
+
+	auto FileHashCache::ComputeHash(const std::filesystem::path& filePath) -> std::optional<FileHash>
+	{
+		return std::move(ComputeHashes({ filePath }).front());
+	}
+
+	auto FileHashCache::ComputeHashes(const std::vector<std::filesystem::path>& filePaths, const ProgressCallback& progressCallback) -> std::vector<std::optional<FileHash>>
+	{
+		struct PendingFile
+		{
+			std::optional<Entry> entry;
+			std::size_t fileIndex;
+			Nz::Int64 lastWriteTime;
+			Nz::UInt64 size;
+		};
+
+		std::vector<std::optional<FileHash>> results(filePaths.size());
+		std::vector<PendingFile> pendingFiles;
+
+		for (std::size_t i = 0; i < filePaths.size(); ++i)
+		{
+			const std::filesystem::path& filePath = filePaths[i];
+
+			std::error_code ec;
+			Nz::UInt64 fileSize = std::filesystem::file_size(filePath, ec);
+			if (ec)
+				continue;
+
+			auto lastWriteTime = std::filesystem::last_write_time(filePath, ec);
+			if (ec)
+				continue;
+
+			Nz::Int64 lastWriteTimeValue = static_cast<Nz::Int64>(lastWriteTime.time_since_epoch().count());
+
+			FileHash fileHash;
+			if (FindEntry(filePath.generic_u8string(), fileSize, lastWriteTimeValue, fileHash))
+			{
+				results[i] = std::move(fileHash);
+				continue;
+			}
+
+			auto& pendingFile = pendingFiles.emplace_back();
+			pendingFile.fileIndex = i;
+			pendingFile.lastWriteTime = lastWriteTimeValue;
+			pendingFile.size = fileSize;
+		}
+
+		std::atomic<std::size_t> processedFileCount = filePaths.size() - pendingFiles.size();
+		if (progressCallback)
+			progressCallback(processedFileCount, filePaths.size());
+
+		if (pendingFiles.empty())
+			return results;
+
+		auto ProcessFile = [&](PendingFile& pendingFile)
+		{
+			pendingFile.entry = HashFile(filePaths[pendingFile.fileIndex], pendingFile.size, pendingFile.lastWriteTime);
+
+			std::size_t fileCount = ++processedFileCount;
+			if (progressCallback)
+				progressCallback(fileCount, filePaths.size());
+		};
+
+		if (pendingFiles.size() == 1)
+			ProcessFile(pendingFiles.front());
+		else
+		{
+			// Hash changed files in parallel, each task writes to its own slot
+			ThreadPool threadPool(std::min(pendingFiles.size(), ThreadPool::GetDefaultWorkerCount()), "FileHash");
+			for (PendingFile& pendingFile : pendingFiles)
+				threadPool.PushTask([&] { ProcessFile(pendingFile); });
+
+			threadPool.WaitForAll();
+		}
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		for (PendingFile& pendingFile : pendingFiles)
+		{
+			const std::filesystem::path& filePath = filePaths[pendingFile.fileIndex];
+			if (!pendingFile.entry)
+			{
+				bwLog(m_logger, LogLevel::Error, "failed to compute hash of {0}", filePath.generic_u8string());
+				continue;
+			}
+
+			const Entry& entry = *pendingFile.entry;
+
+			auto& fileHash = results[pendingFile.fileIndex].emplace();
+			fileHash.checksum = Nz::ByteArray(entry.checksum.data(), entry.checksum.size());
+			fileHash.size = entry.size;
+
+			m_entries.insert_or_assign(filePath.generic_u8string(), entry);
+			m_isDirty = true;
+		}
+
+		bwLog(m_logger, LogLevel::Debug, "hashed {0} file(s) ({1} from cache)", pendingFiles.size(), filePaths.size() - pendingFiles.size());
+
+		return results;
+	}
+
+	bool FileHashCache::Load()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		m_entries.clear();
+		m_isDirty = false;
+
+		if (!std::filesystem::is_regular_file(m_manifestPath))
+			return true; //< Nothing to load yet
+
+		Nz::File manifestFile(m_manifestPath.generic_u8string(), Nz::OpenMode_ReadOnly);
+		if (!manifestFile.IsOpen())
+		{
+			bwLog(m_logger, LogLevel::Error, "failed to open hash manifest {0}", m_manifestPath.generic_u8string());
+			return false;
+		}
+
+		std::vector<char> content(manifestFile.GetSize());
+		if (manifestFile.Read(content.data(), content.size()) != content.size())
+		{
+			bwLog(m_logger, LogLevel::Error, "failed to read hash manifest {0}", m_manifestPath.generic_u8string());
+			return false;
+		}
+
+		try
+		{
+			nlohmann::json manifest = nlohmann::json::parse(content.begin(), content.end());
+			if (manifest.value("version", 0U) != ManifestVersion)
+			{
+				bwLog(m_logger, LogLevel::Warning, "hash manifest {0} has an unsupported version, ignoring it", m_manifestPath.generic_u8string());
+				return true;
+			}
+
+			for (auto&& fileEntry : manifest.at("files"))
+			{
+				Entry entry;
+				entry.checksum = fileEntry.at("checksum");
+				entry.lastWriteTime = fileEntry.at("lastWriteTime");
+				entry.size = fileEntry.at("size");
+
+				m_entries.insert_or_assign(fileEntry.at("path").get<std::string>(), std::move(entry));
+			}
+		}
+		catch (const std::exception& e)
+		{
+			bwLog(m_logger, LogLevel::Error, "failed to parse hash manifest {0}: {1}", m_manifestPath.generic_u8string(), e.what());
+			m_entries.clear();
+			return false;
+		}
+
+		bwLog(m_logger, LogLevel::Debug, "loaded {0} file hash(es) from {1}", m_entries.size(), m_manifestPath.generic_u8string());
+		return true;
+	}
+
+	bool FileHashCache::Save()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if (!m_isDirty)
+			return true;
+
+		auto fileArray = nlohmann::json::array();
+		for (auto&& [path, entry] : m_entries)
+		{
+			// Forget about files which no longer exist
+			if (!std::filesystem::is_regular_file(std::filesystem::u8path(path)))
+				continue;
+
+			nlohmann::json fileEntry;
+			fileEntry["path"] = path;
+			fileEntry["checksum"] = entry.checksum;
+			fileEntry["lastWriteTime"] = entry.lastWriteTime;
+			fileEntry["size"] = entry.size;
+
+			fileArray.emplace_back(std::move(fileEntry));
+		}
+
+		nlohmann::json manifest;
+		manifest["version"] = ManifestVersion;
+		manifest["files"] = std::move(fileArray);
+
+		std::string content = manifest.dump();
+
+		// Write to a temporary file first so a crash can't leave a truncated manifest behind
+		std::filesystem::path tempPath = m_manifestPath;
+		tempPath += ".tmp";
+
+		{
+			Nz::File manifestFile(tempPath.generic_u8string(), Nz::OpenMode_WriteOnly | Nz::OpenMode_Truncate);
+			if (!manifestFile.IsOpen() || manifestFile.Write(content.data(), content.size()) != content.size())
+			{
+				bwLog(m_logger, LogLevel::Error, "failed to write hash manifest {0}", tempPath.generic_u8string());
+				return false;
+			}
+		}
+
+		std::error_code ec;
+		std::filesystem::rename(tempPath, m_manifestPath, ec);
+		if (ec)
+		{
+			bwLog(m_logger, LogLevel::Error, "failed to replace hash manifest {0}: {1}", m_manifestPath.generic_u8string(), ec.message());
+			return false;
+		}
+
+		m_isDirty = false;
+		return true;
+	}
+
+	bool FileHashCache::FindEntry(const std::string& key, Nz::UInt64 size, Nz::Int64 lastWriteTime, FileHash& fileHash) const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		auto it = m_entries.find(key);
+		if (it == m_entries.end())
+			return false;
+
+		const Entry& entry = it->second;
+		if (entry.size != size || entry.lastWriteTime != lastWriteTime)
+			return false;
+
+		fileHash.checksum = Nz::ByteArray(entry.checksum.data(), entry.checksum.size());
+		fileHash.size = entry.size;
+		return true;
+	}
+
+	auto FileHashCache::HashFile(const std::filesystem::path& filePath, Nz::UInt64 size, Nz::Int64 lastWriteTime) -> std::optional<Entry>
+	{
+		Nz::ByteArray checksum = Nz::File::ComputeHash(Nz::HashType_SHA1, filePath.generic_u8string());
+
+		Entry entry;
+		if (checksum.GetSize() != entry.checksum.size())
+			return std::nullopt;
+
+		std::memcpy(entry.checksum.data(), checksum.GetConstBuffer(), checksum.GetSize());
+		entry.lastWriteTime = lastWriteTime;
+		entry.size = size;
+
+		return entry;
+	}
+}
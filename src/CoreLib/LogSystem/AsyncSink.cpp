@@ -0,0 +1,74 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/LogSystem/AsyncSink.hpp>
+#include <cassert>
+#include <chrono>
+
+namespace bw
+{
+	AsyncSink::AsyncSink(std::shared_ptr<LogSink> sink, std::size_t maxQueuedRecords) :
+	m_droppedRecordCount(0),
+	m_sink(std::move(sink)),
+	m_records(maxQueuedRecords)
+	{
+		assert(m_sink);
+
+		m_running.store(true, std::memory_order_release);
+		m_thread = Nz::Thread(&AsyncSink::WorkerThread, this);
+		m_thread.SetName("AsyncLogSink");
+	}
+
+	AsyncSink::~AsyncSink()
+	{
+		m_running.store(false, std::memory_order_release);
+		m_thread.Join();
+	}
+
+	void AsyncSink::Write(const LogContext& context, std::string_view content)
+	{
+		Record record;
+		record.content = content;
+		record.elapsedTime = context.elapsedTime;
+		record.level = context.level;
+		record.side = context.side;
+
+		// Never block or allocate queue memory on the caller thread
+		if (!m_records.try_enqueue(std::move(record)))
+			m_droppedRecordCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void AsyncSink::WriteRecord(const Record& record)
+	{
+		LogContext context;
+		context.elapsedTime = record.elapsedTime;
+		context.level = record.level;
+		context.side = record.side;
+
+		m_sink->Write(context, record.content);
+	}
+
+	void AsyncSink::WorkerThread()
+	{
+		Record record = {};
+		for (;;)
+		{
+			if (m_records.wait_dequeue_timed(record, std::chrono::milliseconds(100)))
+				WriteRecord(record);
+			else if (!m_running.load(std::memory_order_acquire))
+				break; //< Queue has been emptied
+
+			if (std::size_t droppedRecords = m_droppedRecordCount.exchange(0, std::memory_order_relaxed); droppedRecords > 0)
+			{
+				Record warningRecord;
+				warningRecord.content = std::to_string(droppedRecords) + " log record(s) have been dropped (queue is full)";
+				warningRecord.elapsedTime = record.elapsedTime;
+				warningRecord.level = LogLevel::Warning;
+				warningRecord.side = LogSide::Irrelevant;
+
+				WriteRecord(warningRecord);
+			}
+		}
+	}
+}
@@ -11,6 +11,17 @@
 
 namespace bw
 {
+	bool Logger::IsLevelEnabled(LogLevel level) const
+	{
+		if (level < m_minimumLogLevel)
+			return false;
+
+		if (m_logParent && !m_logParent->IsLevelEnabled(level))
+			return false;
+
+		return true;
+	}
+
 	void Logger::Log(const LogContext& context, std::string content) const
 	{
 		OverrideContent(context, content);
@@ -11,6 +11,11 @@ namespace bw
 		m_logParent.InitializeContext(context);
 	}
 
+	bool LoggerProxy::IsLevelEnabled(LogLevel level) const
+	{
+		return m_logParent.IsLevelEnabled(level);
+	}
+
 	void LoggerProxy::Log(const LogContext& context, std::string content) const
 	{
 		OverrideContent(context, content);
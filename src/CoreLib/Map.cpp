@@ -3,6 +3,7 @@
 // For conditions of distribution and use, see copyright notice in Prerequisites.hpp
 
 #include <CoreLib/Map.hpp>
+#include <CoreLib/CompiledMap.hpp>
 #include <CoreLib/Protocol/CompressedInteger.hpp>
 #include <CoreLib/Version.hpp>
 #include <CoreLib/Utils.hpp>
@@ -101,108 +102,9 @@ namespace Nz
 
 namespace bw
 {
-	constexpr Nz::UInt16 MapFileVersion = 1;
-
 	bool Map::Compile(const std::filesystem::path& outputPath)
 	{
-		Nz::File infoFile(outputPath.generic_u8string(), Nz::OpenMode_WriteOnly | Nz::OpenMode_Truncate);
-		if (!infoFile.IsOpen())
-			return false;
-
-		Nz::ByteStream stream(&infoFile);
-		stream.SetDataEndianness(Nz::Endianness_LittleEndian);
-
-		stream.Write("Burgrmap", 8);
-		stream << MapFileVersion;
-
-		// Map header
-		stream << m_mapInfo.name << m_mapInfo.author << m_mapInfo.description;
-
-		// Game version
-		stream << GameVersion;
-
-		// Map layers
-		CompressedUnsigned<Nz::UInt16> layerCount(Nz::UInt16(m_layers.size()));
-		stream << layerCount;
-
-		for (const Layer& layer : m_layers)
-		{
-			stream << layer.name;
-			stream << layer.backgroundColor;
-
-			CompressedUnsigned<Nz::UInt16> entityCount(Nz::UInt16(layer.entities.size()));
-			stream << entityCount;
-
-			for (const Entity& entity : layer.entities)
-			{
-				stream << entity.entityType;
-				stream << entity.name;
-				stream << entity.position.x << entity.position.y;
-				stream << entity.rotation.ToDegrees();
-
-				CompressedSigned<EntityId> compressedUniqueId(entity.uniqueId);
-				stream << compressedUniqueId;
-
-				CompressedUnsigned<Nz::UInt16> propertyCount(Nz::UInt16(entity.properties.size()));
-				stream << propertyCount;
-
-				for (const auto& [key, value] : entity.properties)
-				{
-					stream << key;
-
-					auto [P, isArray] = ExtractPropertyType(value);
-
-					Nz::UInt8 propertyType = Nz::UInt8(P);
-					stream << propertyType;
-
-					stream << isArray;
-
-					std::visit([&](auto&& propertyValue)
-					{
-						using T = std::decay_t<decltype(propertyValue)>;
-						using TypeExtractor = PropertyTypeExtractor<T>;
-						constexpr bool IsArray = TypeExtractor::IsArray;
-
-						if constexpr (IsArray)
-						{
-							CompressedUnsigned<Nz::UInt32> arraySize(Nz::UInt32(propertyValue.size()));
-
-							stream << arraySize;
-							for (const auto& element : propertyValue)
-								stream << element;
-						}
-						else
-							stream << propertyValue.value;
-
-					}, value);
-				}
-			}
-		}
-
-		// Scripts
-		CompressedUnsigned<Nz::UInt32> scriptCount(Nz::UInt32(m_scripts.size()));
-		stream << scriptCount;
-
-		for (const auto& script : m_scripts)
-		{
-			stream << script.filepath;
-			CompressedUnsigned<Nz::UInt64> scriptSize(Nz::UInt64(script.content.size()));
-			stream << scriptSize;
-			stream.Write(script.content.data(), script.content.size());
-		}
-
-		// Assets
-		CompressedUnsigned<Nz::UInt32> assetCount(Nz::UInt32(m_assets.size()));
-		stream << assetCount;
-
-		for (const Asset& asset : m_assets)
-		{
-			stream << asset.filepath;
-			stream << asset.size;
-			stream.Write(asset.sha1Checksum.data(), asset.sha1Checksum.size());
-		}
-
-		return true;
+		return CompiledMap::Compile(*this, outputPath);
 	}
 
 	void Map::RebuildEntityIndices()
@@ -233,12 +135,33 @@ namespace bw
 
 		std::string content = Serialize(*this).dump(1, '\t');
 
-		Nz::File infoFile((mapFolderPath / "info.json").generic_u8string(), Nz::OpenMode_WriteOnly | Nz::OpenMode_Truncate);
-		if (!infoFile.IsOpen())
+		// Write to a temporary file first so a failed save can't leave a truncated map behind
+		std::filesystem::path infoPath = mapFolderPath / "info.json";
+		std::filesystem::path tempPath = infoPath;
+		tempPath += ".tmp";
+
+		auto WriteFile = [&]
+		{
+			Nz::File infoFile(tempPath.generic_u8string(), Nz::OpenMode_WriteOnly | Nz::OpenMode_Truncate);
+			if (!infoFile.IsOpen())
+				return false;
+
+			return infoFile.Write(content.data(), content.size()) == content.size();
+		};
+
+		std::error_code ec;
+		if (!WriteFile())
+		{
+			std::filesystem::remove(tempPath, ec);
 			return false;
+		}
 
-		if (infoFile.Write(content.data(), content.size()) != content.size())
+		std::filesystem::rename(tempPath, infoPath, ec);
+		if (ec)
+		{
+			std::filesystem::remove(tempPath, ec);
 			return false;
+		}
 
 		return true;
 	}
@@ -466,9 +389,36 @@ namespace bw
 		Nz::UInt16 fileVersion;
 		stream >> fileVersion;
 
-		if (fileVersion > MapFileVersion)
+		if (fileVersion > CompiledMap::FileVersion)
 			throw std::runtime_error("unhandled file version (more recent than game)");
 
+		if (fileVersion >= 2)
+		{
+			infoFile.Close();
+
+			// Every layer is decoded here as a Map owns its layers and indexes entities of all of them (and matches instantiate every layer),
+			// use CompiledMap directly to only decode what's needed
+			CompiledMap compiledMap(mapFile);
+			m_mapInfo = compiledMap.GetMapInfo();
+
+			std::size_t layerCount = compiledMap.GetLayerCount();
+			m_layers.clear();
+			m_layers.reserve(layerCount);
+			for (std::size_t i = 0; i < layerCount; ++i)
+				m_layers.push_back(compiledMap.DecodeLayer(static_cast<LayerIndex>(i)));
+
+			m_scripts = compiledMap.DecodeScripts();
+			m_assets = compiledMap.DecodeAssets();
+
+			RebuildEntityIndices();
+			Sanitize();
+
+			m_isValid = true;
+			return;
+		}
+
+		// Legacy format (version 0 and 1), fields are streamed one after another
+
 		// Map header
 		stream >> m_mapInfo.name >> m_mapInfo.author >> m_mapInfo.description;
 
@@ -21,11 +21,19 @@
 #include <CoreLib/Scripting/ServerScriptingLibrary.hpp>
 #include <CoreLib/Systems/NetworkSyncSystem.hpp>
 #include <CoreLib/Utils.hpp>
+#include <CoreLib/Version.hpp>
+#include <Nazara/Core/CallOnExit.hpp>
+#include <Nazara/Core/Clock.hpp>
 #include <Nazara/Core/File.hpp>
 #include <NDK/Components/PhysicsComponent2D.hpp>
+#include <fmt/format.h>
 #include <tsl/hopscotch_set.h>
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <ctime>
 #include <fstream>
+#include <random>
 
 namespace bw
 {
@@ -38,11 +46,99 @@ namespace bw
 	m_gamemodeSettings(std::move(gamemodeSettings)),
 	m_map(std::move(matchSettings.map)),
 	m_sessions(*this),
+	m_spectatorStream(*this, m_sessions.GetCommandStore()),
 	m_settings(std::move(matchSettings)),
 	m_modSettings(std::move(modSettings)),
+	m_deferClientAssetHashing(false),
+	m_isAssetHashCacheDirty(false),
 	m_isResetting(false),
 	m_isMatchRunning(true)
 	{
+		m_assetHashCache.emplace(GetLogger(), m_app.GetConfig().GetStringValue("Resources.AssetHashManifest"));
+		m_assetHashCache->Load();
+
+		if (const std::string& eventLogDirectory = m_app.GetConfig().GetStringValue("ServerSettings.EventLogDirectory"); !eventLogDirectory.empty())
+		{
+			std::time_t now = std::time(nullptr);
+			std::array<char, 32> timeStr;
+			std::strftime(timeStr.data(), timeStr.size(), "%Y%m%d_%H%M%S", std::localtime(&now));
+
+			std::filesystem::path eventLogPath = std::filesystem::u8path(eventLogDirectory) / ("match_" + std::string(timeStr.data()) + ".bwevents");
+
+			try
+			{
+				std::error_code ec;
+				std::filesystem::create_directories(eventLogPath.parent_path(), ec);
+
+				m_eventLog.emplace(GetLogger(), eventLogPath);
+				bwLog(GetLogger(), LogLevel::Info, "logging match events to {0}", eventLogPath.generic_u8string());
+			}
+			catch (const std::exception& e)
+			{
+				bwLog(GetLogger(), LogLevel::Error, "failed to create match event log: {0}", e.what());
+			}
+		}
+
+		if (!m_settings.randomSeed)
+		{
+			std::random_device randomDevice;
+			m_settings.randomSeed = (Nz::UInt64(randomDevice()) << 32) | randomDevice();
+		}
+
+		if (!m_settings.replayFile.empty())
+		{
+			MatchReplayInfo replayInfo;
+			replayInfo.gamemode = m_gamemodeSettings.name;
+			replayInfo.gameVersion = fmt::format("{}.{}.{}", GameMajorVersion, GameMinorVersion, GamePatchVersion);
+			replayInfo.map = Map::Serialize(m_map);
+			replayInfo.mapPath = m_settings.mapPath;
+			replayInfo.maxPlayerCount = m_settings.maxPlayerCount;
+			replayInfo.name = m_settings.name;
+			replayInfo.randomSeed = *m_settings.randomSeed;
+			replayInfo.sleepWhenEmpty = m_settings.sleepWhenEmpty;
+			replayInfo.tickDuration = m_settings.tickDuration;
+
+			for (const auto& [modId, modEntry] : m_modSettings.enabledMods)
+				replayInfo.mods.push_back(modId);
+
+			std::sort(replayInfo.mods.begin(), replayInfo.mods.end());
+
+			try
+			{
+				std::error_code ec;
+				std::filesystem::create_directories(m_settings.replayFile.parent_path(), ec);
+
+				m_replayRecorder.emplace(GetLogger(), m_settings.replayFile, replayInfo);
+				bwLog(GetLogger(), LogLevel::Info, "recording match replay to {0}", m_settings.replayFile.generic_u8string());
+			}
+			catch (const std::exception& e)
+			{
+				bwLog(GetLogger(), LogLevel::Error, "failed to create match replay: {0}", e.what());
+			}
+		}
+
+		if (const std::string& demoDirectory = m_app.GetConfig().GetStringValue("ServerSettings.DemoDirectory"); !demoDirectory.empty())
+		{
+			std::time_t now = std::time(nullptr);
+			std::array<char, 32> timeStr;
+			std::strftime(timeStr.data(), timeStr.size(), "%Y%m%d_%H%M%S", std::localtime(&now));
+
+			std::filesystem::path demoPath = std::filesystem::u8path(demoDirectory) / ("match_" + std::string(timeStr.data()) + ".bwdemo");
+
+			try
+			{
+				std::error_code ec;
+				std::filesystem::create_directories(demoPath.parent_path(), ec);
+
+				m_spectatorStream.StartDemo(demoPath);
+				bwLog(GetLogger(), LogLevel::Info, "recording match demo to {0}", demoPath.generic_u8string());
+			}
+			catch (const std::exception& e)
+			{
+				bwLog(GetLogger(), LogLevel::Error, "failed to create match demo: {0}", e.what());
+			}
+		}
+
 		ReloadMods();
 		ReloadAssets();
 		ReloadScripts();
@@ -50,6 +146,9 @@ namespace bw
 		m_terrain = std::make_unique<Terrain>(*this, m_map);
 		m_terrain->Initialize();
 
+		if (m_app.GetConfig().GetBoolValue("ServerSettings.ClientSideMapEntities"))
+			BuildClientMap();
+
 		m_scriptingContext->LoadDirectoryOpt("map/autorun");
 
 		BuildMatchData();
@@ -77,7 +176,11 @@ namespace bw
 		bwLog(GetLogger(), LogLevel::Info, "match initialized");
 
 		if (m_settings.port != 0)
-			m_sessions.CreateSessionManager<NetworkSessionManager>(m_settings.port, m_settings.maxPlayerCount);
+		{
+			// Spectators are connected peers too
+			std::size_t maxSpectatorCount = m_app.GetConfig().GetIntegerValue<std::size_t>("ServerSettings.MaxSpectatorCount");
+			m_sessions.CreateSessionManager<NetworkSessionManager>(m_settings.port, m_settings.maxPlayerCount + maxSpectatorCount);
+		}
 	}
 
 	Match::~Match()
@@ -86,7 +189,17 @@ namespace bw
 		GetScriptPacketHandlerRegistry().Clear();
 		GetTimerManager().Clear();
 
+		m_spectatorStream.Clear();
 		m_sessions.Clear();
+
+		if (m_isAssetHashCacheDirty)
+			m_assetHashCache->Save();
+
+		if (!m_clientMapPath.empty())
+		{
+			std::error_code ec;
+			std::filesystem::remove(m_clientMapPath, ec);
+		}
 	}
 
 	void Match::BroadcastChatMessage(Player* player, std::string message)
@@ -172,6 +285,9 @@ namespace bw
 
 		m_players[playerIndex] = std::move(playerPtr);
 
+		if (m_eventLog)
+			m_eventLog->LogPlayerJoined(GetCurrentTick(), static_cast<Nz::UInt16>(playerIndex), player->GetName());
+
 		m_gamemode->ExecuteCallback<GamemodeEvent::PlayerConnected>(player->CreateHandle());
 
 		return player;
@@ -268,23 +384,33 @@ namespace bw
 
 	void Match::RegisterClientAsset(std::string assetPath)
 	{
-		if (m_clientAssets.find(assetPath) != m_clientAssets.end())
+		if (m_clientAssets.find(assetPath) != m_clientAssets.end() || m_pendingClientAssets.find(assetPath) != m_pendingClientAssets.end())
 			return;
 
 		VirtualDirectory::Entry entry;
 		if (!m_assetDirectory->GetEntry(assetPath, &entry))
 			throw std::runtime_error(assetPath + " is not a file");
 
-		std::vector<Nz::UInt8> content;
 		if (!std::holds_alternative<VirtualDirectory::PhysicalFileEntry>(entry))
 			throw std::runtime_error(assetPath + " is not a file");
 
 		std::filesystem::path filepath = std::get<VirtualDirectory::PhysicalFileEntry>(entry);
 
-		Nz::UInt64 assetSize = std::filesystem::file_size(filepath);
-		Nz::ByteArray assetHash = Nz::File::ComputeHash(Nz::HashType_SHA1, filepath.generic_u8string());
+		// While scripts are loading, hashing is deferred so all assets registered by scripts get hashed at once (see RegisterPendingClientAssets)
+		if (m_deferClientAssetHashing)
+		{
+			m_pendingClientAssets.emplace(std::move(assetPath), std::move(filepath));
+			return;
+		}
+
+		auto fileHashes = m_assetHashCache->ComputeHashes({ filepath });
+		if (!fileHashes.front())
+			throw std::runtime_error("failed to hash " + assetPath);
 
-		RegisterClientAssetInternal(std::move(assetPath), assetSize, std::move(assetHash), std::move(filepath));
+		RegisterClientAssetInternal(std::move(assetPath), fileHashes.front()->size, std::move(fileHashes.front()->checksum), std::move(filepath));
+
+		// Scripts may register many assets in a row, the manifest is saved once at the end of the tick
+		m_isAssetHashCacheDirty = true;
 	}
 
 	void Match::RegisterClientScript(std::string scriptPath)
@@ -333,6 +459,9 @@ namespace bw
 		entityData.entity = std::move(entity);
 		entityData.onDestruction.Connect(entityData.entity->OnEntityDestruction, [this, uniqueId](Ndk::Entity* entity)
 		{
+			if (m_eventLog)
+				m_eventLog->LogEntityDestroyed(GetCurrentTick(), uniqueId);
+
 			// Don't trigger the Destroyed event when resetting map
 			if (!m_isResetting)
 			{
@@ -342,6 +471,31 @@ namespace bw
 
 			m_entitiesByUniqueId.erase(uniqueId);
 		});
+
+		if (m_eventLog)
+		{
+			std::string_view entityClass;
+			if (entityData.entity->HasComponent<ScriptComponent>())
+				entityClass = entityData.entity->GetComponent<ScriptComponent>().GetElement()->fullName;
+
+			auto& entityMatch = entityData.entity->GetComponent<MatchComponent>();
+			auto& entityNode = entityData.entity->GetComponent<Ndk::NodeComponent>();
+			m_eventLog->LogEntitySpawned(GetCurrentTick(), uniqueId, entityClass, entityMatch.GetLayerIndex(), Nz::Vector2f(entityNode.GetPosition(Nz::CoordSys_Global)));
+
+			if (entityData.entity->HasComponent<HealthComponent>())
+			{
+				auto& entityHealth = entityData.entity->GetComponent<HealthComponent>();
+				entityData.onDied.Connect(entityHealth.OnDied, [this, uniqueId](const HealthComponent* /*health*/, const Ndk::EntityHandle& attacker)
+				{
+					m_eventLog->LogEntityDied(GetCurrentTick(), uniqueId, RetrieveUniqueIdByEntity(attacker));
+				});
+
+				entityData.onHealthChange.Connect(entityHealth.OnHealthChange, [this, uniqueId](HealthComponent* health, Nz::UInt16 newHealth, const Ndk::EntityHandle& source)
+				{
+					m_eventLog->LogEntityHealthChanged(GetCurrentTick(), uniqueId, RetrieveUniqueIdByEntity(source), health->GetHealth(), newHealth, health->GetMaxHealth());
+				});
+			}
+		}
 	}
 
 	void Match::RegisterNetworkString(std::string string)
@@ -374,7 +528,47 @@ namespace bw
 			m_assetStore->Clear();
 		}
 
+		// Refresh already registered assets, unchanged files are served from the hash cache
+		if (!m_clientAssets.empty())
+		{
+			std::vector<std::string> registeredAssets;
+			std::vector<std::filesystem::path> registeredPaths;
+			registeredAssets.reserve(m_clientAssets.size());
+			registeredPaths.reserve(m_clientAssets.size());
+
+			for (auto&& [assetPath, clientAsset] : m_clientAssets)
+			{
+				registeredAssets.push_back(assetPath);
+				registeredPaths.push_back(clientAsset.realPath);
+			}
+
+			auto fileHashes = m_assetHashCache->ComputeHashes(registeredPaths);
+			for (std::size_t i = 0; i < registeredAssets.size(); ++i)
+			{
+				auto it = m_clientAssets.find(registeredAssets[i]);
+				assert(it != m_clientAssets.end());
+
+				if (!fileHashes[i])
+				{
+					bwLog(GetLogger(), LogLevel::Warning, "Asset {0} is no longer available", registeredAssets[i]);
+					m_clientAssets.erase(it);
+					continue;
+				}
+
+				ClientAsset& clientAsset = it.value();
+				if (clientAsset.checksum != fileHashes[i]->checksum || clientAsset.size != fileHashes[i]->size)
+				{
+					bwLog(GetLogger(), LogLevel::Info, "Asset {0} has changed", registeredAssets[i]);
+					clientAsset.checksum = std::move(fileHashes[i]->checksum);
+					clientAsset.size = fileHashes[i]->size;
+				}
+			}
+		}
+
 		assert(m_map.IsValid());
+
+		std::vector<const Map::Asset*> mapAssets;
+		std::vector<std::filesystem::path> mapAssetPaths;
 		for (const auto& asset : m_map.GetAssets())
 		{
 			std::filesystem::path assetPath = assetDirectory;
@@ -386,7 +580,21 @@ namespace bw
 				continue;
 			}
 
-			Nz::UInt64 fileSize = std::filesystem::file_size(assetPath);
+			mapAssets.push_back(&asset);
+			mapAssetPaths.push_back(std::move(assetPath));
+		}
+
+		auto fileHashes = m_assetHashCache->ComputeHashes(mapAssetPaths);
+		for (std::size_t i = 0; i < mapAssets.size(); ++i)
+		{
+			const Map::Asset& asset = *mapAssets[i];
+			if (!fileHashes[i])
+			{
+				bwLog(GetLogger(), LogLevel::Error, "Failed to hash map asset ({0})", asset.filepath);
+				continue;
+			}
+
+			Nz::UInt64 fileSize = fileHashes[i]->size;
 			if (fileSize != asset.size)
 			{
 				bwLog(GetLogger(), LogLevel::Error, "Map asset doesn't match file ({0}): size doesn't match (expected {1}, got {2})", asset.filepath, asset.size, fileSize);
@@ -396,15 +604,17 @@ namespace bw
 			Nz::ByteArray expectedChecksum(asset.sha1Checksum.size(), 0);
 			std::memcpy(expectedChecksum.GetBuffer(), asset.sha1Checksum.data(), asset.sha1Checksum.size());
 
-			Nz::ByteArray fileChecksum = Nz::File::ComputeHash(Nz::HashType_SHA1, assetPath.generic_u8string());
+			Nz::ByteArray& fileChecksum = fileHashes[i]->checksum;
 			if (fileChecksum != expectedChecksum)
 			{
 				bwLog(GetLogger(), LogLevel::Error, "Map asset doesn't match file ({0}): checksum doesn't match", asset.filepath, asset.size, fileSize);
 				continue;
 			}
 
-			RegisterClientAssetInternal(asset.filepath, fileSize, fileChecksum, std::move(assetPath));
+			RegisterClientAssetInternal(asset.filepath, fileSize, std::move(fileChecksum), std::move(mapAssetPaths[i]));
 		}
+
+		m_assetHashCache->Save();
 	}
 
 	void Match::ReloadMods()
@@ -427,6 +637,10 @@ namespace bw
 	{
 		assert(m_assetStore);
 
+		// Assets registered by scripts while loading are hashed together once scripts are loaded
+		m_deferClientAssetHashing = true;
+		Nz::CallOnExit resetDeferHashing([&] { m_deferClientAssetHashing = false; });
+
 		m_clientScripts.clear();
 
 		const std::string& scriptFolder = m_app.GetConfig().GetStringValue("Resources.ScriptDirectory");
@@ -455,6 +669,10 @@ namespace bw
 			m_scriptingContext->ReloadLibraries();
 		}
 
+		// Scripts use a known seed for math.random so matches can be replayed
+		sol::state& luaState = m_scriptingContext->GetLuaState();
+		luaState["math"]["randomseed"](static_cast<Nz::Int64>(*m_settings.randomSeed));
+
 		std::shared_ptr<ServerElementLibrary> serverElementLib;
 
 		if (!m_entityStore)
@@ -541,6 +759,12 @@ namespace bw
 					m_networkStringStore.RegisterString(propertyName);
 			}
 		});
+
+		RegisterPendingClientAssets();
+
+		// Match data has already been built, refresh it for players joining after the reload
+		if (m_terrain)
+			BuildMatchData();
 	}
 
 	void Match::RemovePlayer(Player* player, DisconnectionReason disconnectionReason)
@@ -552,6 +776,9 @@ namespace bw
 
 		m_gamemode->ExecuteCallback<GamemodeEvent::PlayerLeave>(player->CreateHandle());
 
+		if (m_eventLog)
+			m_eventLog->LogPlayerLeft(GetCurrentTick(), static_cast<Nz::UInt16>(player->GetPlayerIndex()), static_cast<Nz::UInt8>(disconnectionReason));
+
 		Packets::ChatMessage chatPacket;
 		chatPacket.content = player->GetName() + " has left";
 
@@ -604,6 +831,10 @@ namespace bw
 			visibility.ShouldIgnoreEvents(true);
 		}
 
+		MatchClientVisibility* spectatorVisibility = m_spectatorStream.GetVisibility();
+		if (spectatorVisibility)
+			spectatorVisibility->ShouldIgnoreEvents(true);
+
 		m_isResetting = true;
 		m_nextUniqueId = m_map.GetFreeUniqueId();
 		m_terrain->Reset();
@@ -620,6 +851,12 @@ namespace bw
 			visibility.ResetVisibleEntities();
 		}
 
+		if (spectatorVisibility)
+		{
+			spectatorVisibility->ShouldIgnoreEvents(false);
+			spectatorVisibility->ResetVisibleEntities();
+		}
+
 		m_gamemode->ExecuteCallback<GamemodeEvent::MapInit>();
 	}
 
@@ -644,6 +881,12 @@ namespace bw
 	{
 		m_sessions.Poll();
 
+		// Answer incoming packets right away instead of waiting for the next tick
+		m_sessions.ForEachSession([](MatchClientSession* session)
+		{
+			session->FlushPackets();
+		});
+
 		for (const auto& masterServerEntryPtr : m_masterServerEntries)
 			masterServerEntryPtr->Update(elapsedTime);
 
@@ -733,8 +976,64 @@ namespace bw
 		return m_isMatchRunning;
 	}
 
+	void Match::BuildClientMap()
+	{
+		// Clients instantiate map entities from their own copy of the map, server scripts are not part of it
+		Map clientMap = m_map;
+		clientMap.GetScripts().clear();
+
+		std::error_code ec;
+		std::filesystem::path clientMapPath = std::filesystem::temp_directory_path(ec);
+		if (ec)
+		{
+			bwLog(GetLogger(), LogLevel::Error, "failed to build client map: {0}", ec.message());
+			return;
+		}
+
+		clientMapPath /= fmt::format("burgwar_map_{:016x}.bmap", *m_settings.randomSeed);
+
+		if (!clientMap.Compile(clientMapPath))
+		{
+			bwLog(GetLogger(), LogLevel::Error, "failed to build client map: failed to compile {0}", clientMapPath.generic_u8string());
+			return;
+		}
+
+		m_clientMapPath = clientMapPath;
+
+		Nz::File mapFile(clientMapPath.generic_u8string());
+		if (!mapFile.Open(Nz::OpenMode_ReadOnly))
+		{
+			bwLog(GetLogger(), LogLevel::Error, "failed to build client map: failed to open {0}", clientMapPath.generic_u8string());
+			return;
+		}
+
+		std::vector<Nz::UInt8> content(mapFile.GetSize());
+		if (mapFile.Read(content.data(), content.size()) != content.size())
+		{
+			bwLog(GetLogger(), LogLevel::Error, "failed to build client map: failed to read {0}", clientMapPath.generic_u8string());
+			return;
+		}
+
+		auto hash = Nz::AbstractHash::Get(Nz::HashType_SHA1);
+		hash->Begin();
+		hash->Append(content.data(), content.size());
+
+		Nz::ByteArray checksum = hash->End();
+
+		auto& mapChecksum = m_matchData.mapChecksum.emplace();
+		assert(mapChecksum.size() == checksum.size());
+		std::memcpy(mapChecksum.data(), checksum.GetConstBuffer(), checksum.GetSize());
+
+		// Sent like any other asset, clients find it through its checksum
+		RegisterClientAssetInternal("map.bmap", content.size(), std::move(checksum), std::move(clientMapPath));
+
+		bwLog(GetLogger(), LogLevel::Info, "map entities will be instantiated client-side ({0})", ByteToString(content.size()));
+	}
+
 	void Match::BuildMatchData()
 	{
+		RegisterPendingClientAssets();
+
 		// Send match data
 		const Map& mapData = m_terrain->GetMap();
 
@@ -833,6 +1132,7 @@ namespace bw
 
 	void Match::OnTick(bool lastTick)
 	{
+		Nz::UInt64 tickStartTime = Nz::GetElapsedMicroseconds();
 		float elapsedTime = GetTickDuration();
 
 		m_sessions.ForEachSession([&](MatchClientSession* session)
@@ -853,6 +1153,17 @@ namespace bw
 		{
 			session->Update(elapsedTime);
 		});
+
+		m_spectatorStream.Update(elapsedTime);
+
+		if (m_isAssetHashCacheDirty)
+		{
+			m_assetHashCache->Save();
+			m_isAssetHashCacheDirty = false;
+		}
+
+		if (m_eventLog)
+			m_eventLog->LogTickTiming(GetCurrentTick(), static_cast<Nz::UInt32>(Nz::GetElapsedMicroseconds() - tickStartTime));
 	}
 
 	void Match::RegisterClientAssetInternal(std::string assetPath, Nz::UInt64 assetSize, Nz::ByteArray assetChecksum, std::filesystem::path realPath)
@@ -883,6 +1194,39 @@ namespace bw
 		}
 	}
 	
+	void Match::RegisterPendingClientAssets()
+	{
+		if (m_pendingClientAssets.empty())
+			return;
+
+		std::vector<std::string> assetPaths;
+		std::vector<std::filesystem::path> realPaths;
+		assetPaths.reserve(m_pendingClientAssets.size());
+		realPaths.reserve(m_pendingClientAssets.size());
+
+		for (auto&& [assetPath, realPath] : m_pendingClientAssets)
+		{
+			assetPaths.push_back(assetPath);
+			realPaths.push_back(realPath);
+		}
+
+		m_pendingClientAssets.clear();
+
+		auto fileHashes = m_assetHashCache->ComputeHashes(realPaths);
+		for (std::size_t i = 0; i < assetPaths.size(); ++i)
+		{
+			if (!fileHashes[i])
+			{
+				bwLog(GetLogger(), LogLevel::Error, "Failed to hash asset {0}", assetPaths[i]);
+				continue;
+			}
+
+			RegisterClientAssetInternal(std::move(assetPaths[i]), fileHashes[i]->size, std::move(fileHashes[i]->checksum), std::move(realPaths[i]));
+		}
+
+		m_assetHashCache->Save();
+	}
+
 	void Match::SendPingUpdate()
 	{
 		Packets::PlayerPingUpdate pingUpdate;
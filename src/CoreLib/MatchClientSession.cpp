@@ -7,30 +7,40 @@
 #include <CoreLib/ConfigFile.hpp>
 #include <CoreLib/Match.hpp>
 #include <CoreLib/MatchClientVisibility.hpp>
+#include <CoreLib/MatchSpectatorStream.hpp>
 #include <CoreLib/NetworkReactor.hpp>
 #include <CoreLib/Player.hpp>
 #include <CoreLib/PlayerCommandStore.hpp>
 #include <CoreLib/Terrain.hpp>
+#include <CoreLib/Utils.hpp>
 #include <CoreLib/Scripting/NetworkPacket.hpp>
 #include <CoreLib/Scripting/ServerGamemode.hpp>
 #include <CoreLib/Components/PlayerControlledComponent.hpp>
 #include <CoreLib/Components/WeaponWielderComponent.hpp>
+#include <Nazara/Network/ENetProtocol.hpp>
+#include <algorithm>
 #include <cassert>
 
 namespace
 {
-	constexpr Nz::UInt64 MaxFragmentSize = 1200;
+	constexpr std::size_t MaxBundleSize = Nz::ENetConstants::ENetHost_DefaultMTU - sizeof(Nz::ENetProtocolHeader) - sizeof(Nz::ENetProtocolSendFragment);
+	constexpr std::size_t MaxFragmentSize = 16 * 1024;
 }
 
 namespace bw
 {
 	MatchClientSession::MatchClientSession(Match& match, std::size_t sessionId, PlayerCommandStore& commandStore, std::shared_ptr<SessionBridge> bridge) :
-	m_queuedInputs(4),
 	m_match(match),
 	m_commandStore(commandStore),
 	m_sessionId(sessionId),
 	m_bridge(std::move(bridge)),
+	m_inputBufferDepth(1),
+	m_inputBufferOverflowTicks(0),
+	m_lastInputTick(0),
 	m_ping(0),
+	m_hasAppliedInput(false),
+	m_isBufferingInputs(true),
+	m_isSpectator(false),
 	m_peerInfoUpdateCounter(0.f)
 	{
 		m_visibility = std::make_unique<MatchClientVisibility>(match, *this);
@@ -42,6 +52,9 @@ namespace bw
 
 	MatchClientSession::~MatchClientSession()
 	{
+		if (m_isSpectator)
+			m_match.GetSpectatorStream().RemoveSpectator(this);
+
 		ForEachPlayer([this](Player* player)
 		{
 			m_match.RemovePlayer(player, DisconnectionReason::PlayerLeft);
@@ -50,38 +63,82 @@ namespace bw
 
 	void MatchClientSession::Disconnect()
 	{
+		FlushPackets();
+
 		m_bridge->Disconnect();
 	}
 
+	void MatchClientSession::FlushPackets()
+	{
+		for (PendingBundle& bundle : m_pendingBundles)
+		{
+			if (bundle.messageCount > 0)
+				SendBundle(bundle);
+		}
+	}
+
 	void MatchClientSession::HandleIncomingPacket(Nz::NetPacket& packet)
 	{
+		if (MatchReplayRecorder* replayRecorder = m_match.GetReplayRecorder())
+			replayRecorder->RecordSessionPacket(m_match.GetCurrentTick(), m_sessionId, packet);
+
 		m_commandStore.UnserializePacket(*this, packet);
 	}
 
 	void MatchClientSession::OnTick(float /*elapsedTime*/)
 	{
-		if (!m_queuedInputs.IsEmpty())
+		// Inputs are played back with a small delay (the jitter buffer) to absorb irregular packet arrival
+		if (m_isBufferingInputs)
 		{
-			Input inputData = m_queuedInputs.Dequeue();
-			m_lastInputTick = inputData.inputTick;
+			if (m_queuedInputs.size() <= m_inputBufferDepth)
+				return;
+
+			m_isBufferingInputs = false;
+		}
 
-			for (std::size_t playerIndex = 0; playerIndex < inputData.inputs.size(); ++playerIndex)
+		if (m_queuedInputs.empty())
+		{
+			// Inputs arrived too late, increase buffer depth and wait for it to fill up again
+			m_inputBufferDepth = std::min(m_inputBufferDepth + 1, MaxInputBufferDepth);
+			m_inputBufferOverflowTicks = 0;
+			m_isBufferingInputs = true;
+
+			/*bwLog(m_match.GetLogger(), LogLevel::Warning, "Player session #{} has no input for this tick", m_sessionId);*/
+			return;
+		}
+
+		// If more inputs than required have been buffered for a while, network conditions improved: reduce latency
+		auto inputIt = m_queuedInputs.begin();
+		if (m_queuedInputs.size() > m_inputBufferDepth + 1)
+		{
+			if (++m_inputBufferOverflowTicks >= InputBufferShrinkDelay)
 			{
-				const auto& inputOpt = inputData.inputs[playerIndex];
-				if (!inputOpt.has_value())
-					continue;
+				if (m_inputBufferDepth > 1)
+					m_inputBufferDepth--;
 
-				m_players[playerIndex]->UpdateInputs(*inputOpt);
+				m_inputBufferOverflowTicks = 0;
+				++inputIt; //< skip oldest input
 			}
 		}
-		/*else
-			bwLog(m_match.GetLogger(), LogLevel::Warning, "Player session #{} has no input for this tick", m_sessionId);*/
+		else
+			m_inputBufferOverflowTicks = 0;
+
+		m_hasAppliedInput = true;
+		m_lastInputTick = inputIt->inputTick;
+
+		for (std::size_t playerIndex = 0; playerIndex < inputIt->inputs.size(); ++playerIndex)
+			m_players[playerIndex]->UpdateInputs(inputIt->inputs[playerIndex]);
+
+		m_queuedInputs.erase(m_queuedInputs.begin(), std::next(inputIt));
 	}
 
 	void MatchClientSession::Update(float elapsedTime)
 	{
 		m_visibility->Update();
 
+		// Send every message of this tick in as few packets as possible
+		FlushPackets();
+
 		m_peerInfoUpdateCounter += elapsedTime;
 		if (m_peerInfoUpdateCounter >= 1.f)
 		{
@@ -103,7 +160,30 @@ namespace bw
 
 		bwLog(m_match.GetLogger(), LogLevel::Info, "Auth request for {0} players", playerCount);
 
-		if (playerCount == 0 || playerCount >= 8) //< For now, we don't have any spectator
+		if (playerCount == 0)
+		{
+			// Spectators have no player, they receive the match spectator stream once ready
+			MatchSpectatorStream& spectatorStream = m_match.GetSpectatorStream();
+
+			std::size_t maxSpectatorCount = m_match.GetApp().GetConfig().GetIntegerValue<std::size_t>("ServerSettings.MaxSpectatorCount");
+			if (m_isSpectator || !m_players.empty() || spectatorStream.GetSpectatorCount() >= maxSpectatorCount)
+			{
+				SendPacket(Packets::AuthFailure());
+				Disconnect();
+				return;
+			}
+
+			m_isSpectator = true;
+			spectatorStream.AddSpectator(this);
+
+			SendPacket(Packets::AuthSuccess());
+			SendPacket(m_match.GetNetworkStringStore().BuildPacket());
+
+			SendPacket(m_match.GetMatchData());
+			return;
+		}
+
+		if (m_isSpectator || playerCount >= 8)
 		{
 			SendPacket(Packets::AuthFailure());
 			Disconnect();
@@ -163,9 +243,9 @@ namespace bw
 		const Match::ClientAsset* clientAsset;
 		const Match::ClientScript* clientScript;
 		if (m_match.GetClientAsset(packet.path, &clientAsset))
-			SendClientFile(clientAsset->realPath);
+			SendClientFile(packet.downloadId, clientAsset->realPath);
 		else if (m_match.GetClientScript(packet.path, &clientScript))
-			SendClientFile(clientScript->content);
+			SendClientFile(packet.downloadId, clientScript->content);
 		else
 			Disconnect();
 	}
@@ -201,26 +281,31 @@ namespace bw
 
 	void MatchClientSession::HandleIncomingPacket(const Packets::PlayersInput& packet)
 	{
-		if (packet.inputs.size() != m_players.size())
+		if (packet.inputs.empty() || packet.inputs.size() > Packets::PlayersInput::MaxTickInputs)
 		{
-			bwLog(m_match.GetLogger(), LogLevel::Error, "Player input count ({0}) doesn't match player count {1}", packet.inputs.size(), m_players.size());
+			bwLog(m_match.GetLogger(), LogLevel::Error, "Invalid input tick count ({0})", packet.inputs.size());
 			return;
 		}
 
-		for (const auto& inputOpt : packet.inputs)
+		for (const auto& tickInputs : packet.inputs)
 		{
-			if (!inputOpt)
-				continue;
+			if (tickInputs.inputs.size() != m_players.size())
+			{
+				bwLog(m_match.GetLogger(), LogLevel::Error, "Player input count ({0}) doesn't match player count {1}", tickInputs.inputs.size(), m_players.size());
+				return;
+			}
 
-			auto& inputs = *inputOpt;
-			if (std::isinf(inputs.aimDirection.x) || std::isinf(inputs.aimDirection.y))
-				return; //< infinite value
+			for (const auto& inputs : tickInputs.inputs)
+			{
+				if (std::isinf(inputs.aimDirection.x) || std::isinf(inputs.aimDirection.y))
+					return; //< infinite value
 
-			if (std::isnan(inputs.aimDirection.x) || std::isnan(inputs.aimDirection.y))
-				return; //< not a number
+				if (std::isnan(inputs.aimDirection.x) || std::isnan(inputs.aimDirection.y))
+					return; //< not a number
 
-			if (std::abs(inputs.aimDirection.GetSquaredLength() - 1.f) > 0.01f)
-				return; //< not a unit vector: ignore
+				if (std::abs(inputs.aimDirection.GetSquaredLength() - 1.f) > 0.01f)
+					return; //< not a unit vector: ignore
+			}
 		}
 
 		// Compute client error
@@ -243,7 +328,9 @@ namespace bw
 
 		SendPacket(correctionPacket);
 
-		m_queuedInputs.Enqueue(Input{ std::move(packet.inputs), packet.inputTick });
+		// Queue from the oldest to the most recent, inputs we already received are ignored
+		for (auto it = packet.inputs.rbegin(); it != packet.inputs.rend(); ++it)
+			QueueInputs(*it);
 	}
 
 	void MatchClientSession::HandleIncomingPacket(const Packets::PlayerSelectWeapon& packet)
@@ -267,6 +354,9 @@ namespace bw
 
 	void MatchClientSession::HandleIncomingPacket(const Packets::Ready& /*packet*/)
 	{
+		if (m_isSpectator)
+			return m_match.GetSpectatorStream().OnSpectatorReady(this);
+
 		ForEachPlayer([this](Player* player)
 		{
 			m_match.OnPlayerReady(player);
@@ -294,13 +384,81 @@ namespace bw
 		m_players[packet.localIndex]->UpdateName(std::move(packet.newName));
 	}
 
-	void MatchClientSession::SendClientFile(const std::filesystem::path& filePath)
+	void MatchClientSession::QueueInputs(const Packets::PlayersInput::TickInputs& tickInputs)
+	{
+		Nz::UInt16 inputTick = tickInputs.inputTick;
+
+		// Already played (or too late to be played)
+		if (m_hasAppliedInput && !IsMoreRecent(inputTick, m_lastInputTick))
+			return;
+
+		auto it = std::find_if(m_queuedInputs.begin(), m_queuedInputs.end(), [&](const Input& input)
+		{
+			return !IsMoreRecent(inputTick, input.inputTick);
+		});
+
+		// Duplicate (inputs are resent in multiple packets)
+		if (it != m_queuedInputs.end() && it->inputTick == inputTick)
+			return;
+
+		m_queuedInputs.insert(it, Input{ tickInputs.inputs, inputTick });
+
+		if (m_queuedInputs.size() > MaxQueuedInputs)
+			m_queuedInputs.erase(m_queuedInputs.begin());
+	}
+
+	void MatchClientSession::QueuePacket(Nz::UInt8 channelId, Nz::ENetPacketFlags flags, Nz::NetPacket&& packet)
+	{
+		// Messages are bundled per channel and reliability to keep their ordering
+		auto it = std::find_if(m_pendingBundles.begin(), m_pendingBundles.end(), [&](const PendingBundle& bundle)
+		{
+			return bundle.channelId == channelId && bundle.flags == flags;
+		});
+
+		if (it == m_pendingBundles.end())
+		{
+			it = m_pendingBundles.emplace(m_pendingBundles.end());
+			it->channelId = channelId;
+			it->flags = flags;
+		}
+
+		PendingBundle& bundle = *it;
+
+		std::size_t messageSize = packet.GetDataSize();
+		if (bundle.messageCount > 0 && bundle.packet.GetDataSize() + messageSize > MaxBundleSize)
+			SendBundle(bundle);
+
+		if (bundle.messageCount == 0)
+			bundle.packet = std::move(packet);
+		else
+			bundle.packet.Write(packet.GetConstData() + Nz::NetPacket::HeaderSize, messageSize);
+
+		bundle.messageCount++;
+
+		// Big messages are not worth waiting for
+		if (bundle.packet.GetDataSize() >= MaxBundleSize)
+			SendBundle(bundle);
+	}
+
+	void MatchClientSession::SendBundle(PendingBundle& bundle)
+	{
+		assert(bundle.messageCount > 0);
+
+		m_bridge->SendPacket(bundle.channelId, bundle.flags, std::move(bundle.packet));
+
+		bundle.packet = Nz::NetPacket();
+		bundle.messageCount = 0;
+	}
+
+	void MatchClientSession::SendClientFile(Nz::UInt32 downloadId, const std::filesystem::path& filePath)
 	{
 		if (!std::filesystem::is_regular_file(filePath))
 		{
 			bwLog(m_match.GetLogger(), LogLevel::Error, "Client asset {} does not exist", filePath.generic_u8string());
 
 			Packets::DownloadClientFileResponse response;
+			response.downloadId = downloadId;
+
 			auto& failure = response.content.emplace<Packets::DownloadClientFileResponse::Failure>();
 			failure.error = Packets::DownloadClientFileResponse::Error::FileNotFound;
 
@@ -316,6 +474,8 @@ namespace bw
 
 			// An error occurred, send 0 fragment to notify the issue
 			Packets::DownloadClientFileResponse response;
+			response.downloadId = downloadId;
+
 			auto& failure = response.content.emplace<Packets::DownloadClientFileResponse::Failure>();
 			failure.error = Packets::DownloadClientFileResponse::Error::FileNotFound;
 
@@ -330,6 +490,8 @@ namespace bw
 
 			// An error occurred, send 0 fragment to notify the issue
 			Packets::DownloadClientFileResponse response;
+			response.downloadId = downloadId;
+
 			auto& failure = response.content.emplace<Packets::DownloadClientFileResponse::Failure>();
 			failure.error = Packets::DownloadClientFileResponse::Error::FileNotFound;
 
@@ -340,36 +502,44 @@ namespace bw
 		file.Close();
 
 		bwLog(m_match.GetLogger(), LogLevel::Info, "Sending asset {}", filePath.generic_u8string());
-		SendClientFile(content);
+		SendClientFile(downloadId, content);
 	}
 
-	void MatchClientSession::SendClientFile(const std::vector<Nz::UInt8>& content)
+	void MatchClientSession::SendClientFile(Nz::UInt32 downloadId, const std::vector<Nz::UInt8>& content)
 	{
-		//std::size_t fragmentCount = clientAsset->size / MaxFragmentSize + ((clientAsset->size % MaxFragmentSize != 0) ? 1 : 0);
-
-		/*auto& pendingRequest = m_pendingAssetRequest.emplace_back();
-		pendingRequest.currentFragmentIndex = 0;
-		pendingRequest.filePath = clientAsset->path;
-		pendingRequest.fragmentCount = fragmentCount;
-		pendingRequest.fragmentSize = MaxFragmentSize;*/
+		// Split the file in fragments, the client can have multiple downloads in flight and reassembles them by downloadId
+		std::size_t fragmentCount = std::max<std::size_t>(content.size() / MaxFragmentSize + ((content.size() % MaxFragmentSize != 0) ? 1 : 0), 1);
 
 		Packets::DownloadClientFileResponse response;
+		response.downloadId = downloadId;
+
 		auto& success = response.content.emplace<Packets::DownloadClientFileResponse::Success>();
-		//success.fragmentCount = static_cast<Nz::UInt32>(fragmentCount);
-		success.fragmentCount = 1;
-		success.fragmentSize = content.size();
+		success.fragmentCount = static_cast<Nz::UInt32>(fragmentCount);
+		success.fragmentSize = MaxFragmentSize;
 
 		SendPacket(response);
 
 		Packets::DownloadClientFileFragment fragment;
-		fragment.fragmentIndex = 0;
-		fragment.fragmentContent = std::move(content);
+		fragment.downloadId = downloadId;
 
-		SendPacket(fragment);
+		for (std::size_t i = 0; i < fragmentCount; ++i)
+		{
+			std::size_t offset = i * MaxFragmentSize;
+			std::size_t fragmentSize = std::min(MaxFragmentSize, content.size() - offset);
+
+			fragment.fragmentIndex = static_cast<Nz::UInt32>(i);
+			fragment.fragmentContent.assign(content.begin() + offset, content.begin() + offset + fragmentSize);
+
+			SendPacket(fragment);
+		}
 	}
 	
 	void MatchClientSession::UpdatePeerInfo(const SessionBridge::SessionInfo& sessionInfo)
 	{
 		m_ping = sessionInfo.ping;
+
+		// Ping is used for lag compensation
+		if (MatchReplayRecorder* replayRecorder = m_match.GetReplayRecorder())
+			replayRecorder->RecordSessionPing(m_match.GetCurrentTick(), m_sessionId, sessionInfo.ping);
 	}
 }
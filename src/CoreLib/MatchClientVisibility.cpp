@@ -1051,6 +1051,9 @@ namespace bw
 			entityData.physicsProperties->momentOfInertia = physicsProperties.momentOfInertia;
 		}
 
+		// For map entities, properties which didn't change since the map were already filtered out (see NetworkSyncSystem)
+		entityData.isMapEntity = creationEvent.isMapEntity;
+
 		for (auto&& [propertyName, propertyValue] : creationEvent.properties)
 		{
 			auto& propertyData = entityData.properties.emplace_back();
@@ -0,0 +1,59 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/MatchDemoRecorder.hpp>
+#include <cassert>
+
+namespace bw
+{
+	/*
+	Match demo format (version 1), every fixed-size value is little-endian:
+
+	Header (16 bytes): "BurgDemo", UInt32 version, UInt32 reserved (0)
+	Packets, one after another:
+	  UInt8 flags (KeyframeFlag, ReliableFlag), VarUInt tick delta (from the previous packet), UInt8 channel id
+	  VarUInt net code, VarUInt size, bytes (as sent to spectators)
+
+	VarUInt are LEB128-encoded.
+	The first keyframe starts with the match data and network strings, followed by the player list and every entity.
+	Playing back linearly means skipping every keyframe packet after the first one, seeking means starting from any keyframe
+	and skipping non-keyframe packets of the same tick.
+	*/
+
+	MatchDemoRecorder::MatchDemoRecorder(const Logger& logger, const std::filesystem::path& filePath) :
+	m_writer(logger, filePath, "match demo", 0xFFFF),
+	m_lastTick(0)
+	{
+		static_assert(HeaderSize == BinaryFileWriter::HeaderSize);
+
+		m_writer.WriteHeader("BurgDemo", FileVersion, 0);
+		m_writer.Flush();
+	}
+
+	void MatchDemoRecorder::RecordPacket(Nz::UInt64 tick, Nz::UInt8 channelId, Nz::ENetPacketFlags flags, const Nz::NetPacket& packet, bool isKeyframe)
+	{
+		assert(tick >= m_lastTick);
+
+		Nz::UInt8 packetFlags = 0;
+		if (isKeyframe)
+			packetFlags |= KeyframeFlag;
+
+		if (flags & Nz::ENetPacketFlag_Reliable)
+			packetFlags |= ReliableFlag;
+
+		std::size_t dataSize = packet.GetDataSize();
+		const Nz::UInt8* data = static_cast<const Nz::UInt8*>(packet.GetConstData()) + Nz::NetPacket::HeaderSize;
+
+		m_writer.WriteLE(packetFlags);
+		m_writer.WriteVarUInt(tick - m_lastTick);
+		m_writer.WriteLE(channelId);
+		m_writer.WriteVarUInt(packet.GetNetCode());
+		m_writer.WriteVarUInt(dataSize);
+		m_writer.Write(data, dataSize);
+
+		m_lastTick = tick;
+
+		m_writer.FlushIfNeeded();
+	}
+}
@@ -0,0 +1,157 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/MatchEventLog.hpp>
+#include <CoreLib/Utility/BinaryIO.hpp>
+#include <cassert>
+
+namespace bw
+{
+	/*
+	Match event log format (version 1), every value is little-endian:
+
+	Header (16 bytes): "BurgEvts", UInt32 version, UInt32 reserved
+	Records, each one starting on a 8 bytes boundary:
+	  Header (8 bytes): UInt8 type, UInt8 reserved, UInt16 payload size (without padding), UInt32 tick (truncated)
+	  Payload, depending on type:
+	    String: UInt32 id, UInt32 size, characters (strings are written once, before the first record using them)
+	    TickTiming: UInt32 duration (microseconds), UInt32 reserved
+	    PlayerJoined: UInt16 player index, UInt16 reserved, UInt32 name (string id)
+	    PlayerLeft: UInt16 player index, UInt8 reason (0 = kicked, 1 = left, 2 = timed out), UInt8 reserved
+	    EntitySpawned: Int64 unique id, UInt32 class (string id), UInt16 layer, UInt16 reserved, float x/y
+	    EntityDestroyed: Int64 unique id
+	    EntityHealthChanged: Int64 unique id, Int64 source unique id, UInt16 old health, UInt16 new health, UInt16 max health, UInt16 reserved
+	    EntityDied: Int64 unique id, Int64 attacker unique id
+
+	Records are only appended, a reader can stop at the last complete record if the server was interrupted.
+	Unknown record types can be skipped using their payload size.
+	*/
+
+	MatchEventLog::MatchEventLog(const Logger& logger, const std::filesystem::path& filePath) :
+	m_writer(logger, filePath, "match event log", RecordHeaderSize + 0xFFFF)
+	{
+		static_assert(HeaderSize == BinaryFileWriter::HeaderSize);
+
+		m_writer.WriteHeader("BurgEvts", FileVersion, 0);
+	}
+
+	void MatchEventLog::LogEntityDestroyed(Nz::UInt64 tick, EntityId entityId)
+	{
+		std::size_t recordOffset = BeginRecord(MatchEventType::EntityDestroyed, tick);
+		m_writer.WriteLE(entityId);
+		EndRecord(recordOffset);
+	}
+
+	void MatchEventLog::LogEntityDied(Nz::UInt64 tick, EntityId entityId, EntityId attackerId)
+	{
+		std::size_t recordOffset = BeginRecord(MatchEventType::EntityDied, tick);
+		m_writer.WriteLE(entityId);
+		m_writer.WriteLE(attackerId);
+		EndRecord(recordOffset);
+	}
+
+	void MatchEventLog::LogEntityHealthChanged(Nz::UInt64 tick, EntityId entityId, EntityId sourceId, Nz::UInt16 oldHealth, Nz::UInt16 newHealth, Nz::UInt16 maxHealth)
+	{
+		std::size_t recordOffset = BeginRecord(MatchEventType::EntityHealthChanged, tick);
+		m_writer.WriteLE(entityId);
+		m_writer.WriteLE(sourceId);
+		m_writer.WriteLE(oldHealth);
+		m_writer.WriteLE(newHealth);
+		m_writer.WriteLE(maxHealth);
+		m_writer.WriteLE(Nz::UInt16(0));
+		EndRecord(recordOffset);
+	}
+
+	void MatchEventLog::LogEntitySpawned(Nz::UInt64 tick, EntityId entityId, std::string_view entityClass, LayerIndex layerIndex, const Nz::Vector2f& position)
+	{
+		Nz::UInt32 classId = RegisterString(tick, entityClass);
+
+		std::size_t recordOffset = BeginRecord(MatchEventType::EntitySpawned, tick);
+		m_writer.WriteLE(entityId);
+		m_writer.WriteLE(classId);
+		m_writer.WriteLE(layerIndex);
+		m_writer.WriteLE(Nz::UInt16(0));
+		m_writer.WriteLE(position.x);
+		m_writer.WriteLE(position.y);
+		EndRecord(recordOffset);
+	}
+
+	void MatchEventLog::LogPlayerJoined(Nz::UInt64 tick, Nz::UInt16 playerIndex, std::string_view playerName)
+	{
+		Nz::UInt32 nameId = RegisterString(tick, playerName);
+
+		std::size_t recordOffset = BeginRecord(MatchEventType::PlayerJoined, tick);
+		m_writer.WriteLE(playerIndex);
+		m_writer.WriteLE(Nz::UInt16(0));
+		m_writer.WriteLE(nameId);
+		EndRecord(recordOffset);
+	}
+
+	void MatchEventLog::LogPlayerLeft(Nz::UInt64 tick, Nz::UInt16 playerIndex, Nz::UInt8 reason)
+	{
+		std::size_t recordOffset = BeginRecord(MatchEventType::PlayerLeft, tick);
+		m_writer.WriteLE(playerIndex);
+		m_writer.WriteLE(reason);
+		m_writer.WriteLE(Nz::UInt8(0));
+		EndRecord(recordOffset);
+	}
+
+	void MatchEventLog::LogTickTiming(Nz::UInt64 tick, Nz::UInt32 durationUs)
+	{
+		std::size_t recordOffset = BeginRecord(MatchEventType::TickTiming, tick);
+		m_writer.WriteLE(durationUs);
+		m_writer.WriteLE(Nz::UInt32(0));
+		EndRecord(recordOffset);
+	}
+
+	std::size_t MatchEventLog::BeginRecord(MatchEventType type, Nz::UInt64 tick)
+	{
+		assert(m_writer.GetBuffer().size() % RecordAlignment == 0);
+
+		std::size_t recordOffset = m_writer.GetBuffer().size();
+		m_writer.WriteLE(static_cast<Nz::UInt8>(type));
+		m_writer.WriteLE(Nz::UInt8(0));
+		m_writer.WriteLE(Nz::UInt16(0)); //< Payload size, filled by EndRecord
+		m_writer.WriteLE(static_cast<Nz::UInt32>(tick));
+
+		return recordOffset;
+	}
+
+	void MatchEventLog::EndRecord(std::size_t recordOffset)
+	{
+		std::vector<Nz::UInt8>& buffer = m_writer.GetBuffer();
+
+		std::size_t payloadSize = buffer.size() - recordOffset - RecordHeaderSize;
+		assert(payloadSize <= 0xFFFF);
+
+		WriteLE(&buffer[recordOffset + 2], static_cast<Nz::UInt16>(payloadSize));
+
+		std::size_t alignedSize = (buffer.size() + RecordAlignment - 1) / RecordAlignment * RecordAlignment;
+		buffer.resize(alignedSize, 0);
+
+		m_writer.FlushIfNeeded();
+	}
+
+	Nz::UInt32 MatchEventLog::RegisterString(Nz::UInt64 tick, std::string_view str)
+	{
+		constexpr std::size_t MaxStringSize = 0xFFFF - 8;
+		if (str.size() > MaxStringSize)
+			str = str.substr(0, MaxStringSize);
+
+		std::string key(str);
+		if (auto it = m_stringIds.find(key); it != m_stringIds.end())
+			return it->second;
+
+		Nz::UInt32 stringId = static_cast<Nz::UInt32>(m_stringIds.size());
+		m_stringIds.emplace(std::move(key), stringId);
+
+		std::size_t recordOffset = BeginRecord(MatchEventType::String, tick);
+		m_writer.WriteLE(stringId);
+		m_writer.WriteLE(static_cast<Nz::UInt32>(str.size()));
+		m_writer.Write(reinterpret_cast<const Nz::UInt8*>(str.data()), str.size());
+		EndRecord(recordOffset);
+
+		return stringId;
+	}
+}
@@ -0,0 +1,186 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/MatchEventLogReader.hpp>
+#include <CoreLib/Utility/BinaryIO.hpp>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace bw
+{
+	MatchEventLogReader::MatchEventLogReader(const std::filesystem::path& filePath) :
+	m_cursor(MatchEventLog::HeaderSize),
+	m_isTruncated(false)
+	{
+		if (!m_file.Open(filePath))
+			throw std::runtime_error("failed to open " + filePath.generic_u8string());
+
+		const Nz::UInt8* fileData = m_file.GetData();
+		if (m_file.GetSize() < MatchEventLog::HeaderSize || std::memcmp(fileData, "BurgEvts", 8) != 0)
+			throw std::runtime_error("not a valid match event log");
+
+		Nz::UInt32 fileVersion = ReadLE<Nz::UInt32>(fileData + 8);
+		if (fileVersion > MatchEventLog::FileVersion)
+			throw std::runtime_error("unsupported match event log version " + std::to_string(fileVersion));
+	}
+
+	bool MatchEventLogReader::ReadEvent(Event& event)
+	{
+		const Nz::UInt8* fileData = m_file.GetData();
+		std::size_t fileSize = m_file.GetSize();
+
+		for (;;)
+		{
+			if (fileSize - m_cursor < MatchEventLog::RecordHeaderSize)
+			{
+				m_isTruncated = (m_cursor != fileSize);
+				return false;
+			}
+
+			const Nz::UInt8* record = fileData + m_cursor;
+			MatchEventType type = static_cast<MatchEventType>(ReadLE<Nz::UInt8>(record));
+			Nz::UInt16 payloadSize = ReadLE<Nz::UInt16>(record + 2);
+			Nz::UInt32 tick = ReadLE<Nz::UInt32>(record + 4);
+
+			if (fileSize - m_cursor - MatchEventLog::RecordHeaderSize < payloadSize)
+			{
+				m_isTruncated = true;
+				return false;
+			}
+
+			const Nz::UInt8* payload = record + MatchEventLog::RecordHeaderSize;
+
+			std::size_t recordSize = MatchEventLog::RecordHeaderSize + payloadSize;
+			recordSize = (recordSize + MatchEventLog::RecordAlignment - 1) / MatchEventLog::RecordAlignment * MatchEventLog::RecordAlignment;
+			m_cursor = std::min(m_cursor + recordSize, fileSize);
+
+			// Records too small for their type are ignored, as unknown ones
+			auto HasPayload = [&](std::size_t expectedSize)
+			{
+				return payloadSize >= expectedSize;
+			};
+
+			event.tick = tick;
+
+			switch (type)
+			{
+				case MatchEventType::String:
+				{
+					if (!HasPayload(8))
+						break;
+
+					Nz::UInt32 stringId = ReadLE<Nz::UInt32>(payload);
+					Nz::UInt32 stringSize = ReadLE<Nz::UInt32>(payload + 4);
+					if (stringSize > payloadSize - 8u)
+						break;
+
+					if (stringId >= m_strings.size())
+						m_strings.resize(stringId + 1);
+
+					m_strings[stringId] = std::string_view(reinterpret_cast<const char*>(payload + 8), stringSize);
+					break;
+				}
+
+				case MatchEventType::TickTiming:
+				{
+					if (!HasPayload(4))
+						break;
+
+					event.data = TickTiming{ ReadLE<Nz::UInt32>(payload) };
+					return true;
+				}
+
+				case MatchEventType::PlayerJoined:
+				{
+					if (!HasPayload(8))
+						break;
+
+					PlayerJoined playerJoined;
+					playerJoined.playerIndex = ReadLE<Nz::UInt16>(payload);
+					playerJoined.playerName = GetString(ReadLE<Nz::UInt32>(payload + 4));
+
+					event.data = playerJoined;
+					return true;
+				}
+
+				case MatchEventType::PlayerLeft:
+				{
+					if (!HasPayload(3))
+						break;
+
+					PlayerLeft playerLeft;
+					playerLeft.playerIndex = ReadLE<Nz::UInt16>(payload);
+					playerLeft.reason = ReadLE<Nz::UInt8>(payload + 2);
+
+					event.data = playerLeft;
+					return true;
+				}
+
+				case MatchEventType::EntitySpawned:
+				{
+					if (!HasPayload(24))
+						break;
+
+					EntitySpawned entitySpawned;
+					entitySpawned.entityId = ReadLE<EntityId>(payload);
+					entitySpawned.entityClass = GetString(ReadLE<Nz::UInt32>(payload + 8));
+					entitySpawned.layerIndex = ReadLE<LayerIndex>(payload + 12);
+					entitySpawned.position.x = ReadLE<float>(payload + 16);
+					entitySpawned.position.y = ReadLE<float>(payload + 20);
+
+					event.data = entitySpawned;
+					return true;
+				}
+
+				case MatchEventType::EntityDestroyed:
+				{
+					if (!HasPayload(8))
+						break;
+
+					event.data = EntityDestroyed{ ReadLE<EntityId>(payload) };
+					return true;
+				}
+
+				case MatchEventType::EntityHealthChanged:
+				{
+					if (!HasPayload(22))
+						break;
+
+					EntityHealthChanged healthChanged;
+					healthChanged.entityId = ReadLE<EntityId>(payload);
+					healthChanged.sourceId = ReadLE<EntityId>(payload + 8);
+					healthChanged.oldHealth = ReadLE<Nz::UInt16>(payload + 16);
+					healthChanged.newHealth = ReadLE<Nz::UInt16>(payload + 18);
+					healthChanged.maxHealth = ReadLE<Nz::UInt16>(payload + 20);
+
+					event.data = healthChanged;
+					return true;
+				}
+
+				case MatchEventType::EntityDied:
+				{
+					if (!HasPayload(16))
+						break;
+
+					EntityDied entityDied;
+					entityDied.entityId = ReadLE<EntityId>(payload);
+					entityDied.attackerId = ReadLE<EntityId>(payload + 8);
+
+					event.data = entityDied;
+					return true;
+				}
+			}
+		}
+	}
+
+	std::string_view MatchEventLogReader::GetString(Nz::UInt32 stringId) const
+	{
+		if (stringId >= m_strings.size())
+			return {};
+
+		return m_strings[stringId];
+	}
+}
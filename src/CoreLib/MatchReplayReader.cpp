@@ -0,0 +1,102 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/MatchReplayReader.hpp>
+#include <CoreLib/Utility/BinaryIO.hpp>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace bw
+{
+	MatchReplayReader::MatchReplayReader(const std::filesystem::path& filePath) :
+	m_cursor(MatchReplayRecorder::HeaderSize),
+	m_lastTick(0),
+	m_isTruncated(false)
+	{
+		if (!m_file.Open(filePath))
+			throw std::runtime_error("failed to open " + filePath.generic_u8string());
+
+		const Nz::UInt8* fileData = m_file.GetData();
+		if (m_file.GetSize() < MatchReplayRecorder::HeaderSize || std::memcmp(fileData, "BurgRply", 8) != 0)
+			throw std::runtime_error("not a valid match replay");
+
+		Nz::UInt32 fileVersion = ReadLE<Nz::UInt32>(fileData + 8);
+		if (fileVersion > MatchReplayRecorder::FileVersion)
+			throw std::runtime_error("unsupported match replay version " + std::to_string(fileVersion));
+
+		Nz::UInt32 infoSize = ReadLE<Nz::UInt32>(fileData + 12);
+		if (m_file.GetSize() - m_cursor < infoSize)
+			throw std::runtime_error("corrupted match replay (truncated info)");
+
+		m_info = MatchReplayRecorder::UnserializeInfo(nlohmann::json::from_cbor(fileData + m_cursor, fileData + m_cursor + infoSize));
+		m_cursor += infoSize;
+	}
+
+	bool MatchReplayReader::ReadEvent(Event& event)
+	{
+		const Nz::UInt8* fileData = m_file.GetData();
+		std::size_t fileSize = m_file.GetSize();
+
+		if (m_cursor >= fileSize)
+			return false;
+
+		// Only commit the cursor once the whole event has been read
+		std::size_t eventStart = m_cursor;
+		auto Truncated = [&]
+		{
+			m_cursor = eventStart;
+			m_isTruncated = true;
+			return false;
+		};
+
+		event.type = static_cast<ReplayEventType>(fileData[m_cursor++]);
+
+		Nz::UInt64 tickDelta;
+		Nz::UInt64 sessionId;
+		if (!ReadVarUInt(fileData, fileSize, m_cursor, tickDelta) || !ReadVarUInt(fileData, fileSize, m_cursor, sessionId))
+			return Truncated();
+
+		event.tick = m_lastTick + tickDelta;
+		event.sessionId = static_cast<std::size_t>(sessionId);
+
+		switch (event.type)
+		{
+			case ReplayEventType::SessionConnected:
+			case ReplayEventType::SessionDisconnected:
+				break;
+
+			case ReplayEventType::SessionPacket:
+			{
+				Nz::UInt64 netCode;
+				Nz::UInt64 packetSize;
+				if (!ReadVarUInt(fileData, fileSize, m_cursor, netCode) || !ReadVarUInt(fileData, fileSize, m_cursor, packetSize) || fileSize - m_cursor < packetSize)
+					return Truncated();
+
+				event.packetData = fileData + m_cursor;
+				event.packetNetCode = static_cast<Nz::UInt16>(netCode);
+				event.packetSize = static_cast<std::size_t>(packetSize);
+				m_cursor += event.packetSize;
+				break;
+			}
+
+			case ReplayEventType::SessionPing:
+			{
+				Nz::UInt64 ping;
+				if (!ReadVarUInt(fileData, fileSize, m_cursor, ping))
+					return Truncated();
+
+				event.ping = static_cast<Nz::UInt32>(ping);
+				break;
+			}
+
+			default:
+				// Events have no size prefix, an unknown one means we cannot go further
+				throw std::runtime_error("unknown replay event type " + std::to_string(static_cast<unsigned int>(event.type)));
+		}
+
+		m_lastTick = event.tick;
+		return true;
+	}
+}
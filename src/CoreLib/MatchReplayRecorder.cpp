@@ -0,0 +1,119 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/MatchReplayRecorder.hpp>
+#include <cassert>
+
+namespace bw
+{
+	/*
+	Match replay format (version 1), every fixed-size value is little-endian:
+
+	Header (16 bytes): "BurgRply", UInt32 version, UInt32 info size
+	Info: CBOR-encoded object (see SerializeInfo)
+	Events, one after another:
+	  UInt8 type, VarUInt tick delta (from the previous event), VarUInt session id
+	  Payload, depending on type:
+	    SessionConnected / SessionDisconnected: none
+	    SessionPacket: VarUInt net code, VarUInt size, bytes (as received by the session)
+	    SessionPing: VarUInt ping (milliseconds)
+
+	VarUInt are LEB128-encoded. Events are recorded on the tick which was about to be run when they were received,
+	a reader can stop at the last complete event if the server was interrupted.
+	*/
+
+	MatchReplayRecorder::MatchReplayRecorder(const Logger& logger, const std::filesystem::path& filePath, const MatchReplayInfo& replayInfo) :
+	m_writer(logger, filePath, "match replay", 0xFFFF),
+	m_lastTick(0)
+	{
+		static_assert(HeaderSize == BinaryFileWriter::HeaderSize);
+
+		std::vector<Nz::UInt8> info = nlohmann::json::to_cbor(SerializeInfo(replayInfo));
+
+		m_writer.WriteHeader("BurgRply", FileVersion, static_cast<Nz::UInt32>(info.size()));
+		m_writer.Write(info.data(), info.size());
+		m_writer.Flush();
+	}
+
+	void MatchReplayRecorder::RecordSessionConnected(Nz::UInt64 tick, std::size_t sessionId)
+	{
+		BeginEvent(ReplayEventType::SessionConnected, tick, sessionId);
+		EndEvent();
+	}
+
+	void MatchReplayRecorder::RecordSessionDisconnected(Nz::UInt64 tick, std::size_t sessionId)
+	{
+		BeginEvent(ReplayEventType::SessionDisconnected, tick, sessionId);
+		EndEvent();
+	}
+
+	void MatchReplayRecorder::RecordSessionPacket(Nz::UInt64 tick, std::size_t sessionId, const Nz::NetPacket& packet)
+	{
+		std::size_t dataSize = packet.GetDataSize();
+		const Nz::UInt8* data = static_cast<const Nz::UInt8*>(packet.GetConstData()) + Nz::NetPacket::HeaderSize;
+
+		BeginEvent(ReplayEventType::SessionPacket, tick, sessionId);
+		m_writer.WriteVarUInt(packet.GetNetCode());
+		m_writer.WriteVarUInt(dataSize);
+		m_writer.Write(data, dataSize);
+		EndEvent();
+	}
+
+	void MatchReplayRecorder::RecordSessionPing(Nz::UInt64 tick, std::size_t sessionId, Nz::UInt32 ping)
+	{
+		BeginEvent(ReplayEventType::SessionPing, tick, sessionId);
+		m_writer.WriteVarUInt(ping);
+		EndEvent();
+	}
+
+	nlohmann::json MatchReplayRecorder::SerializeInfo(const MatchReplayInfo& replayInfo)
+	{
+		nlohmann::json infoJson;
+		infoJson["gamemode"] = replayInfo.gamemode;
+		infoJson["gameVersion"] = replayInfo.gameVersion;
+		infoJson["map"] = replayInfo.map;
+		infoJson["mapPath"] = replayInfo.mapPath;
+		infoJson["maxPlayerCount"] = replayInfo.maxPlayerCount;
+		infoJson["mods"] = replayInfo.mods;
+		infoJson["name"] = replayInfo.name;
+		infoJson["randomSeed"] = replayInfo.randomSeed;
+		infoJson["sleepWhenEmpty"] = replayInfo.sleepWhenEmpty;
+		infoJson["tickDuration"] = replayInfo.tickDuration;
+
+		return infoJson;
+	}
+
+	MatchReplayInfo MatchReplayRecorder::UnserializeInfo(const nlohmann::json& infoJson)
+	{
+		MatchReplayInfo replayInfo;
+		replayInfo.gamemode = infoJson.at("gamemode");
+		replayInfo.gameVersion = infoJson.value("gameVersion", "");
+		replayInfo.map = infoJson.value("map", nlohmann::json{});
+		replayInfo.mapPath = infoJson.at("mapPath");
+		replayInfo.maxPlayerCount = infoJson.at("maxPlayerCount");
+		replayInfo.mods = infoJson.value("mods", std::vector<std::string>{});
+		replayInfo.name = infoJson.value("name", "replay");
+		replayInfo.randomSeed = infoJson.at("randomSeed");
+		replayInfo.sleepWhenEmpty = infoJson.value("sleepWhenEmpty", true);
+		replayInfo.tickDuration = infoJson.at("tickDuration");
+
+		return replayInfo;
+	}
+
+	void MatchReplayRecorder::BeginEvent(ReplayEventType type, Nz::UInt64 tick, std::size_t sessionId)
+	{
+		assert(tick >= m_lastTick);
+
+		m_writer.WriteLE(static_cast<Nz::UInt8>(type));
+		m_writer.WriteVarUInt(tick - m_lastTick);
+		m_writer.WriteVarUInt(sessionId);
+
+		m_lastTick = tick;
+	}
+
+	void MatchReplayRecorder::EndEvent()
+	{
+		m_writer.FlushIfNeeded();
+	}
+}
@@ -43,6 +43,9 @@ namespace bw
 
 		m_sessionIdToSession.insert_or_assign(sessionId, session);
 
+		if (MatchReplayRecorder* replayRecorder = m_match.GetReplayRecorder())
+			replayRecorder->RecordSessionConnected(m_match.GetCurrentTick(), sessionId);
+
 		bwLog(m_match.GetLogger(), LogLevel::Info, "Created session #{0}", sessionId);
 
 		return session;
@@ -53,6 +56,9 @@ namespace bw
 		std::size_t sessionId = session->GetSessionId();
 		m_sessionIdToSession.erase(sessionId);
 
+		if (MatchReplayRecorder* replayRecorder = m_match.GetReplayRecorder())
+			replayRecorder->RecordSessionDisconnected(m_match.GetCurrentTick(), sessionId);
+
 		m_sessionPool.Delete(session);
 
 		bwLog(m_match.GetLogger(), LogLevel::Info, "Deleted session #{0}", sessionId);
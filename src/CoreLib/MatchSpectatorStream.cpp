@@ -0,0 +1,263 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/MatchSpectatorStream.hpp>
+#include <CoreLib/Match.hpp>
+#include <CoreLib/MatchClientVisibility.hpp>
+#include <CoreLib/Player.hpp>
+#include <CoreLib/Components/MatchComponent.hpp>
+#include <algorithm>
+#include <cassert>
+
+namespace bw
+{
+	// Sends what a stream session produces to the spectators of the stream instead of a peer
+	class MatchSpectatorStream::StreamBridge : public SessionBridge
+	{
+		public:
+			StreamBridge(MatchSpectatorStream& stream, std::vector<MatchClientSession*>& targets, bool isStream) :
+			SessionBridge(nullptr),
+			m_targets(targets),
+			m_stream(stream),
+			m_isKeyframe(true),
+			m_isStream(isStream)
+			{
+			}
+
+			void Disconnect() override
+			{
+			}
+
+			bool IsLocal() const override
+			{
+				return false;
+			}
+
+			void QueryInfo(std::function<void(const SessionInfo& info)> /*callback*/) const override
+			{
+				// There's no peer behind a stream session
+			}
+
+			void SendPacket(Nz::UInt8 channelId, Nz::ENetPacketFlags flags, Nz::NetPacket&& packet) override
+			{
+				// The stream is always recorded, keyframes built for late joiners only when a demo keyframe is due
+				bool recordDemo = m_isStream || m_stream.m_isDemoKeyframe;
+				m_stream.Dispatch(channelId, flags, std::move(packet), m_targets, m_isKeyframe, recordDemo);
+			}
+
+			void SetKeyframe(bool isKeyframe)
+			{
+				m_isKeyframe = isKeyframe;
+			}
+
+		private:
+			std::vector<MatchClientSession*>& m_targets;
+			MatchSpectatorStream& m_stream;
+			bool m_isKeyframe;
+			bool m_isStream;
+	};
+
+	MatchSpectatorStream::MatchSpectatorStream(Match& match, PlayerCommandStore& commandStore) :
+	m_match(match),
+	m_commandStore(commandStore),
+	m_isDemoKeyframe(false),
+	m_demoKeyframeTimer(0.f)
+	{
+	}
+
+	MatchSpectatorStream::~MatchSpectatorStream()
+	{
+		Clear();
+	}
+
+	void MatchSpectatorStream::AddSpectator(MatchClientSession* session)
+	{
+		assert(std::find(m_connectingSpectators.begin(), m_connectingSpectators.end(), session) == m_connectingSpectators.end());
+		m_connectingSpectators.push_back(session);
+	}
+
+	void MatchSpectatorStream::Clear()
+	{
+		m_streamSession.reset();
+		m_streamBridge.reset();
+		m_demoRecorder.reset();
+
+		m_connectingSpectators.clear();
+		m_keyframeTargets.clear();
+		m_pendingSpectators.clear();
+		m_spectators.clear();
+	}
+
+	void MatchSpectatorStream::OnSpectatorReady(MatchClientSession* session)
+	{
+		auto it = std::find(m_connectingSpectators.begin(), m_connectingSpectators.end(), session);
+		if (it == m_connectingSpectators.end())
+			return;
+
+		m_connectingSpectators.erase(it);
+		m_pendingSpectators.push_back(session);
+	}
+
+	void MatchSpectatorStream::RemoveSpectator(MatchClientSession* session)
+	{
+		for (auto* sessions : { &m_connectingSpectators, &m_keyframeTargets, &m_pendingSpectators, &m_spectators })
+			sessions->erase(std::remove(sessions->begin(), sessions->end(), session), sessions->end());
+	}
+
+	void MatchSpectatorStream::StartDemo(const std::filesystem::path& demoPath)
+	{
+		m_demoRecorder.emplace(m_match.GetLogger(), demoPath);
+
+		// Make the demo start with a keyframe
+		m_demoKeyframeTimer = DemoKeyframeInterval;
+	}
+
+	void MatchSpectatorStream::Update(float elapsedTime)
+	{
+		if (m_spectators.empty() && m_pendingSpectators.empty() && !m_demoRecorder)
+		{
+			// Nobody is watching, stop building the stream
+			m_streamSession.reset();
+			m_streamBridge.reset();
+			return;
+		}
+
+		if (!m_streamSession)
+		{
+			// The first update of a stream session sends every entity, which makes it a keyframe for everyone
+			m_spectators.insert(m_spectators.end(), m_pendingSpectators.begin(), m_pendingSpectators.end());
+			m_pendingSpectators.clear();
+
+			m_streamBridge = std::make_shared<StreamBridge>(*this, m_spectators, true);
+			m_streamSession = CreateStreamSession(m_streamBridge);
+
+			if (m_demoRecorder)
+			{
+				SendMatchPrelude();
+				m_demoKeyframeTimer = 0.f;
+			}
+
+			SendPlayerList(*m_streamSession);
+			m_streamSession->Update(elapsedTime);
+
+			m_streamBridge->SetKeyframe(false);
+			return;
+		}
+
+		m_streamSession->Update(elapsedTime);
+
+		bool isDemoKeyframeDue = false;
+		if (m_demoRecorder)
+		{
+			m_demoKeyframeTimer += elapsedTime;
+			isDemoKeyframeDue = (m_demoKeyframeTimer >= DemoKeyframeInterval);
+		}
+
+		if (!m_pendingSpectators.empty() || isDemoKeyframeDue)
+			SendKeyframe(isDemoKeyframeDue);
+	}
+
+	std::unique_ptr<MatchClientSession> MatchSpectatorStream::CreateStreamSession(std::shared_ptr<StreamBridge> bridge)
+	{
+		auto session = std::make_unique<MatchClientSession>(m_match, StreamSessionId, m_commandStore, std::move(bridge));
+
+		MatchClientVisibility& visibility = session->GetVisibility();
+		for (LayerIndex layerIndex = 0; layerIndex < m_match.GetLayerCount(); ++layerIndex)
+			visibility.ShowLayer(layerIndex);
+
+		return session;
+	}
+
+	void MatchSpectatorStream::Dispatch(Nz::UInt8 channelId, Nz::ENetPacketFlags flags, Nz::NetPacket&& packet, const std::vector<MatchClientSession*>& targets, bool isKeyframe, bool recordDemo)
+	{
+		packet.FlushBits();
+
+		if (m_demoRecorder && recordDemo)
+			m_demoRecorder->RecordPacket(m_match.GetCurrentTick(), channelId, flags, packet, isKeyframe);
+
+		if (targets.empty())
+			return;
+
+		// Every spectator gets a copy of the same bytes, the last one takes the original
+		// Packets keep the channel and flags of their command: delta messages (such as entity inputs) stay reliable and ordered with entity creation
+		const Nz::UInt8* data = static_cast<const Nz::UInt8*>(packet.GetConstData()) + Nz::NetPacket::HeaderSize;
+		std::size_t dataSize = packet.GetDataSize();
+
+		for (std::size_t i = 0; i < targets.size() - 1; ++i)
+			targets[i]->GetSessionBridge().SendPacket(channelId, flags, Nz::NetPacket(packet.GetNetCode(), data, dataSize));
+
+		targets.back()->GetSessionBridge().SendPacket(channelId, flags, std::move(packet));
+	}
+
+	template<typename T>
+	void MatchSpectatorStream::RecordDemoPacket(const T& packet)
+	{
+		assert(m_demoRecorder);
+
+		Nz::NetPacket data;
+		m_commandStore.SerializePacket(data, packet);
+		data.FlushBits();
+
+		const auto& command = m_commandStore.GetOutgoingCommand<T>();
+		m_demoRecorder->RecordPacket(m_match.GetCurrentTick(), command.channelId, command.flags, data, true);
+	}
+
+	void MatchSpectatorStream::SendKeyframe(bool includeDemo)
+	{
+		m_keyframeTargets = std::move(m_pendingSpectators);
+		m_pendingSpectators.clear();
+
+		m_isDemoKeyframe = includeDemo;
+		if (includeDemo)
+		{
+			SendMatchPrelude();
+			m_demoKeyframeTimer = 0.f;
+		}
+
+		// Keyframes are built by a short-lived session seeing everything, after the stream sent this tick updates
+		// so late joiners can receive the stream starting with the next tick
+		{
+			auto keyframeSession = CreateStreamSession(std::make_shared<StreamBridge>(*this, m_keyframeTargets, false));
+			SendPlayerList(*keyframeSession);
+			keyframeSession->Update(0.f);
+		}
+
+		m_spectators.insert(m_spectators.end(), m_keyframeTargets.begin(), m_keyframeTargets.end());
+		m_keyframeTargets.clear();
+
+		m_isDemoKeyframe = false;
+	}
+
+	void MatchSpectatorStream::SendMatchPrelude()
+	{
+		// Spectators received those while connecting, a demo needs them at every keyframe to be seekable
+		RecordDemoPacket(m_match.GetNetworkStringStore().BuildPacket());
+		RecordDemoPacket(m_match.GetMatchData());
+	}
+
+	void MatchSpectatorStream::SendPlayerList(MatchClientSession& session)
+	{
+		m_match.ForEachPlayer([&](Player* player)
+		{
+			Packets::PlayerJoined joinedPacket;
+			joinedPacket.playerIndex = static_cast<Nz::UInt16>(player->GetPlayerIndex());
+			joinedPacket.playerName = player->GetName();
+
+			session.SendPacket(joinedPacket);
+		});
+
+		m_match.ForEachPlayer([&](Player* player)
+		{
+			const Ndk::EntityHandle& controlledEntity = player->GetControlledEntity();
+			if (!controlledEntity)
+				return;
+
+			Packets::PlayerControlEntity controlledEntityUpdate;
+			controlledEntityUpdate.playerIndex = static_cast<Nz::UInt16>(player->GetPlayerIndex());
+			controlledEntityUpdate.controlledEntityId = controlledEntity->GetComponent<MatchComponent>().GetUniqueId();
+
+			session.SendPacket(controlledEntityUpdate);
+		});
+	}
+}
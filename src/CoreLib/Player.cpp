@@ -28,6 +28,7 @@
 #include <CoreLib/Components/ScriptComponent.hpp>
 #include <CoreLib/Components/WeaponComponent.hpp>
 #include <CoreLib/Scripting/ServerGamemode.hpp>
+#include <cmath>
 
 namespace bw
 {
@@ -51,6 +52,15 @@ namespace bw
 			visibility.HideLayer(static_cast<LayerIndex>(layerIndex));
 	}
 
+	Nz::UInt64 Player::EstimateViewTick() const
+	{
+		// Other entities are displayed as they were received, which happened a round-trip before our inputs reached us
+		Nz::UInt64 currentTick = m_match.GetCurrentTick();
+		Nz::UInt64 latencyTicks = static_cast<Nz::UInt64>(std::round(m_session.GetPing() / (m_match.GetTickDuration() * 1000.f)));
+
+		return (currentTick > latencyTicks) ? currentTick - latencyTicks : 0;
+	}
+
 	void Player::HandleConsoleCommand(const std::string& str)
 	{
 		if (!m_isAdmin)
@@ -28,13 +28,13 @@ namespace bw
 		IncomingCommand(ScriptPacket);
 		IncomingCommand(UpdatePlayerName);
 
-		// Outgoing commands
+		// Outgoing commands (see NetworkChannelCount for channel usage)
 		OutgoingCommand(AuthFailure,                  Nz::ENetPacketFlag_Reliable,    0);
 		OutgoingCommand(AuthSuccess,                  Nz::ENetPacketFlag_Reliable,    0);
-		OutgoingCommand(ChatMessage,                  Nz::ENetPacketFlag_Reliable,    0);
+		OutgoingCommand(ChatMessage,                  Nz::ENetPacketFlag_Reliable,    3);
 		OutgoingCommand(ClientAssetList,              Nz::ENetPacketFlag_Reliable,    0);
 		OutgoingCommand(ClientScriptList,             Nz::ENetPacketFlag_Reliable,    0);
-		OutgoingCommand(ConsoleAnswer,                Nz::ENetPacketFlag_Reliable,    0);
+		OutgoingCommand(ConsoleAnswer,                Nz::ENetPacketFlag_Reliable,    3);
 		OutgoingCommand(ControlEntity,                Nz::ENetPacketFlag_Reliable,    1);
 		OutgoingCommand(CreateEntities,               Nz::ENetPacketFlag_Reliable,    1);
 		OutgoingCommand(DeleteEntities,               Nz::ENetPacketFlag_Reliable,    1);
@@ -52,14 +52,14 @@ namespace bw
 		OutgoingCommand(InputTimingCorrection,        Nz::ENetPacketFlag_Unsequenced, 0);
 		OutgoingCommand(MapReset,                     Nz::ENetPacketFlag_Reliable,    1);
 		OutgoingCommand(MatchData,                    Nz::ENetPacketFlag_Reliable,    0);
-		OutgoingCommand(MatchState,                   0,                              1);
+		OutgoingCommand(MatchState,                   0,                              4);
 		OutgoingCommand(NetworkStrings,               Nz::ENetPacketFlag_Reliable,    0);
 		OutgoingCommand(PlayerControlEntity,          Nz::ENetPacketFlag_Reliable,    1);
 		OutgoingCommand(PlayerJoined,                 Nz::ENetPacketFlag_Reliable,    1);
 		OutgoingCommand(PlayerLayer,                  Nz::ENetPacketFlag_Reliable,    1);
 		OutgoingCommand(PlayerLeaving,                Nz::ENetPacketFlag_Reliable,    1);
 		OutgoingCommand(PlayerNameUpdate,             Nz::ENetPacketFlag_Reliable,    1);
-		OutgoingCommand(PlayerPingUpdate,             Nz::ENetPacketFlag_Reliable,    1);
+		OutgoingCommand(PlayerPingUpdate,             Nz::ENetPacketFlag_Reliable,    3);
 		OutgoingCommand(PlayerWeapons,                Nz::ENetPacketFlag_Reliable,    1);
 		OutgoingCommand(ScriptPacket,                 Nz::ENetPacketFlag_Reliable,    1);
 
@@ -185,6 +185,7 @@ namespace bw
 
 		void Serialize(PacketSerializer& serializer, DownloadClientFileFragment& data)
 		{
+			serializer &= data.downloadId;
 			serializer &= data.fragmentIndex;
 			serializer.SerializeArraySize(data.fragmentContent);
 			if (serializer.IsWriting())
@@ -195,6 +196,7 @@ namespace bw
 
 		void Serialize(PacketSerializer& serializer, DownloadClientFileRequest& data)
 		{
+			serializer &= data.downloadId;
 			serializer &= data.path;
 		}
 
@@ -203,6 +205,8 @@ namespace bw
 			static_assert(std::is_same_v<std::variant_alternative_t<0, DownloadClientFileResponse::SuccessFailureVariant>, DownloadClientFileResponse::Success>);
 			static_assert(std::is_same_v<std::variant_alternative_t<1, DownloadClientFileResponse::SuccessFailureVariant>, DownloadClientFileResponse::Failure>);
 
+			serializer &= data.downloadId;
+
 			Nz::UInt8 type;
 			if (serializer.IsWriting())
 				type = static_cast<Nz::UInt8>(data.content.index());
@@ -475,6 +479,23 @@ namespace bw
 				else
 					serializer.Read(script.sha1Checksum.data(), script.sha1Checksum.size());
 			}
+
+			bool hasMapChecksum;
+			if (serializer.IsWriting())
+				hasMapChecksum = data.mapChecksum.has_value();
+
+			serializer &= hasMapChecksum;
+
+			if (hasMapChecksum)
+			{
+				if (serializer.IsWriting())
+					serializer.Write(data.mapChecksum->data(), data.mapChecksum->size());
+				else
+				{
+					data.mapChecksum.emplace();
+					serializer.Read(data.mapChecksum->data(), data.mapChecksum->size());
+				}
+			}
 		}
 
 		void Serialize(PacketSerializer& serializer, MapReset& data)
@@ -651,28 +672,57 @@ namespace bw
 		void Serialize(PacketSerializer& serializer, PlayersInput& data)
 		{
 			serializer &= data.estimatedServerTick;
-			serializer &= data.inputTick;
 
 			serializer.SerializeArraySize(data.inputs);
 
-			for (auto& input : data.inputs)
+			for (std::size_t i = 0; i < data.inputs.size(); ++i)
 			{
-				bool hasInput;
-				if (serializer.IsWriting())
-					hasInput = input.has_value();
+				auto& tickInputs = data.inputs[i];
 
-				serializer &= hasInput;
+				// Resent inputs are encoded relatively to the more recent ones (tick delta and unchanged inputs)
+				if (i > 0)
+				{
+					const auto& newerInputs = data.inputs[i - 1];
 
-				if (!serializer.IsWriting() && hasInput)
-					input.emplace();
-			}
+					CompressedUnsigned<Nz::UInt16> tickDelta;
+					if (serializer.IsWriting())
+						tickDelta = static_cast<Nz::UInt16>(newerInputs.inputTick - tickInputs.inputTick);
 
-			for (auto& input : data.inputs)
-			{
-				if (!input.has_value())
-					continue;
+					serializer &= tickDelta;
 
-				Serialize(serializer, *input);
+					if (!serializer.IsWriting())
+						tickInputs.inputTick = static_cast<Nz::UInt16>(newerInputs.inputTick - tickDelta);
+				}
+				else
+					serializer &= tickInputs.inputTick;
+
+				serializer.SerializeArraySize(tickInputs.inputs);
+
+				for (std::size_t playerIndex = 0; playerIndex < tickInputs.inputs.size(); ++playerIndex)
+				{
+					auto& input = tickInputs.inputs[playerIndex];
+
+					if (i > 0)
+					{
+						auto& newerInputs = data.inputs[i - 1].inputs;
+
+						bool isUnchanged;
+						if (serializer.IsWriting())
+							isUnchanged = (playerIndex < newerInputs.size() && input == newerInputs[playerIndex]);
+
+						serializer &= isUnchanged;
+
+						if (isUnchanged)
+						{
+							if (!serializer.IsWriting() && playerIndex < newerInputs.size())
+								input = newerInputs[playerIndex];
+
+							continue;
+						}
+					}
+
+					Serialize(serializer, input);
+				}
 			}
 		}
 
@@ -751,6 +801,7 @@ namespace bw
 			serializer &= hasMovementData;
 			serializer &= hasPhysicsProps;
 			serializer &= hasOwner;
+			serializer &= data.isMapEntity;
 
 			if (!serializer.IsWriting())
 			{
@@ -0,0 +1,44 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/ReplaySessionBridge.hpp>
+
+namespace bw
+{
+	ReplaySessionBridge::~ReplaySessionBridge() = default;
+
+	void ReplaySessionBridge::AnswerInfoQuery(Nz::UInt32 ping)
+	{
+		m_sessionInfo.ping = ping;
+
+		// Network queries are answered asynchronously, recorded answers are given back in the same order
+		if (m_pendingInfoQueries.empty())
+			return;
+
+		auto callback = std::move(m_pendingInfoQueries.front());
+		m_pendingInfoQueries.erase(m_pendingInfoQueries.begin());
+
+		callback(m_sessionInfo);
+	}
+
+	void ReplaySessionBridge::Disconnect()
+	{
+		// Disconnections are part of the replay
+	}
+
+	bool ReplaySessionBridge::IsLocal() const
+	{
+		return false;
+	}
+
+	void ReplaySessionBridge::QueryInfo(std::function<void(const SessionInfo& info)> callback) const
+	{
+		m_pendingInfoQueries.emplace_back(std::move(callback));
+	}
+
+	void ReplaySessionBridge::SendPacket(Nz::UInt8 /*channelId*/, Nz::ENetPacketFlags /*flags*/, Nz::NetPacket&& /*packet*/)
+	{
+		m_sessionInfo.totalPacketSent++;
+	}
+}
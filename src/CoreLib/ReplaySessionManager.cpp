@@ -0,0 +1,100 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/ReplaySessionManager.hpp>
+#include <CoreLib/Match.hpp>
+#include <CoreLib/MatchClientSession.hpp>
+#include <CoreLib/MatchSessions.hpp>
+#include <CoreLib/ReplaySessionBridge.hpp>
+#include <CoreLib/LogSystem/Logger.hpp>
+
+namespace bw
+{
+	ReplaySessionManager::ReplaySessionManager(MatchSessions* owner, MatchReplayReader replayReader) :
+	SessionManager(owner),
+	m_reader(std::move(replayReader)),
+	m_hasPendingEvent(false),
+	m_isFinished(false)
+	{
+	}
+
+	ReplaySessionManager::~ReplaySessionManager() = default;
+
+	void ReplaySessionManager::Poll()
+	{
+		if (m_isFinished)
+			return;
+
+		// Events are recorded with the tick which was about to run when they were received
+		Nz::UInt64 currentTick = GetOwner()->GetMatch().GetCurrentTick();
+		for (;;)
+		{
+			if (!m_hasPendingEvent)
+			{
+				if (!m_reader.ReadEvent(m_pendingEvent))
+				{
+					if (m_reader.IsTruncated())
+						bwLog(GetOwner()->GetMatch().GetLogger(), LogLevel::Warning, "replay is truncated, stopping playback at tick {0}", currentTick);
+
+					m_isFinished = true;
+					break;
+				}
+
+				m_hasPendingEvent = true;
+			}
+
+			if (m_pendingEvent.tick > currentTick)
+				break;
+
+			HandleEvent(m_pendingEvent);
+			m_hasPendingEvent = false;
+		}
+	}
+
+	void ReplaySessionManager::HandleEvent(const MatchReplayReader::Event& event)
+	{
+		MatchSessions* owner = GetOwner();
+
+		if (event.type == ReplayEventType::SessionConnected)
+		{
+			std::shared_ptr<ReplaySessionBridge> bridge = std::make_shared<ReplaySessionBridge>();
+			MatchClientSession* session = owner->CreateSession(bridge);
+			if (session->GetSessionId() != event.sessionId)
+				bwLog(owner->GetMatch().GetLogger(), LogLevel::Warning, "replayed session #{0} was recorded as session #{1}, playback may diverge", session->GetSessionId(), event.sessionId);
+
+			m_sessions.insert_or_assign(event.sessionId, ReplaySession{ std::move(bridge), session });
+			return;
+		}
+
+		auto it = m_sessions.find(event.sessionId);
+		if (it == m_sessions.end())
+		{
+			bwLog(owner->GetMatch().GetLogger(), LogLevel::Error, "replay references unknown session #{0}", event.sessionId);
+			return;
+		}
+
+		ReplaySession& replaySession = it.value();
+		switch (event.type)
+		{
+			case ReplayEventType::SessionConnected:
+				break; //< handled above
+
+			case ReplayEventType::SessionDisconnected:
+				owner->DeleteSession(replaySession.session);
+				m_sessions.erase(it);
+				break;
+
+			case ReplayEventType::SessionPacket:
+			{
+				Nz::NetPacket packet(event.packetNetCode, event.packetData, event.packetSize);
+				replaySession.session->HandleIncomingPacket(packet);
+				break;
+			}
+
+			case ReplayEventType::SessionPing:
+				replaySession.bridge->AnswerInfoQuery(event.ping);
+				break;
+		}
+	}
+}
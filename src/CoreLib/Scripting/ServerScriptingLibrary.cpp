@@ -15,6 +15,7 @@
 #include <CoreLib/Scripting/ServerTexture.hpp>
 #include <CoreLib/Scripting/ScriptingUtils.hpp>
 #include <CoreLib/Scripting/SharedElementLibrary.hpp>
+#include <CoreLib/Systems/HitboxHistorySystem.hpp>
 
 namespace bw
 {
@@ -344,6 +345,105 @@ namespace bw
 		});
 	}
 
+	void ServerScriptingLibrary::RegisterPhysicsLibrary(ScriptingContext& context, sol::table& library)
+	{
+		SharedScriptingLibrary::RegisterPhysicsLibrary(context, library);
+
+		// Lag-compensated variants, tracked hitboxes are tested as they were at the given tick (see Player:GetViewTick)
+		library["RegionQueryAt"] = LuaFunction([this](sol::this_state L, Nz::UInt64 tick, LayerIndex layer, const Nz::Rectf& rect, const sol::protected_function& callback)
+		{
+			Match& match = GetMatch();
+			if (layer >= match.GetLayerCount())
+				TriggerLuaArgError(L, 2, "invalid layer index");
+
+			auto& hitboxHistory = match.GetLayer(layer).GetWorld().GetSystem<HitboxHistorySystem>();
+
+			Ndk::EntityList hitEntities;
+			hitboxHistory.RegionQuery(tick, rect, [&](const Ndk::EntityHandle& hitEntity)
+			{
+				if (hitEntities.Has(hitEntity))
+					return;
+
+				hitEntities.Insert(hitEntity);
+
+				if (hitEntity->HasComponent<ScriptComponent>())
+				{
+					auto callbackResult = callback(hitEntity->GetComponent<ScriptComponent>().GetTable());
+					if (!callbackResult.valid())
+					{
+						sol::error err = callbackResult;
+						bwLog(match.GetLogger(), LogLevel::Error, "physics.RegionQueryAt callback failed: {}", err.what());
+					}
+				}
+			});
+		});
+
+		library["TraceAt"] = LuaFunction([this](sol::this_state L, Nz::UInt64 tick, LayerIndex layer, Nz::Vector2f startPos, Nz::Vector2f endPos, std::optional<sol::table> ignoredEntityTable) -> sol::object
+		{
+			Match& match = GetMatch();
+			if (layer >= match.GetLayerCount())
+				TriggerLuaArgError(L, 2, "invalid layer index");
+
+			auto& hitboxHistory = match.GetLayer(layer).GetWorld().GetSystem<HitboxHistorySystem>();
+
+			Ndk::EntityHandle ignoredEntity;
+			if (ignoredEntityTable)
+				ignoredEntity = AssertScriptEntity(*ignoredEntityTable);
+
+			HitboxHistorySystem::TraceHit hitInfo;
+			if (hitboxHistory.TraceQueryFirst(tick, startPos, endPos, &hitInfo, ignoredEntity))
+			{
+				sol::state_view state(L);
+				sol::table result = state.create_table();
+				result["fraction"] = hitInfo.fraction;
+				result["hitPos"] = hitInfo.hitPos;
+				result["hitNormal"] = hitInfo.hitNormal;
+
+				if (hitInfo.entity->HasComponent<ScriptComponent>())
+					result["hitEntity"] = hitInfo.entity->GetComponent<ScriptComponent>().GetTable();
+
+				return result;
+			}
+			else
+				return sol::nil;
+		});
+
+		library["TraceMultipleAt"] = LuaFunction([this](sol::this_state L, Nz::UInt64 tick, LayerIndex layer, Nz::Vector2f startPos, Nz::Vector2f endPos, const sol::protected_function& callback)
+		{
+			Match& match = GetMatch();
+			if (layer >= match.GetLayerCount())
+				TriggerLuaArgError(L, 2, "invalid layer index");
+
+			auto& hitboxHistory = match.GetLayer(layer).GetWorld().GetSystem<HitboxHistorySystem>();
+
+			Ndk::EntityList hitEntities;
+
+			sol::state_view state(L);
+			hitboxHistory.TraceQuery(tick, startPos, endPos, [&](const HitboxHistorySystem::TraceHit& hitInfo)
+			{
+				if (hitEntities.Has(hitInfo.entity))
+					return;
+
+				hitEntities.Insert(hitInfo.entity);
+
+				sol::table result = state.create_table();
+				result["fraction"] = hitInfo.fraction;
+				result["hitPos"] = hitInfo.hitPos;
+				result["hitNormal"] = hitInfo.hitNormal;
+
+				if (hitInfo.entity->HasComponent<ScriptComponent>())
+					result["hitEntity"] = hitInfo.entity->GetComponent<ScriptComponent>().GetTable();
+
+				auto callbackResult = callback(result);
+				if (!callbackResult.valid())
+				{
+					sol::error err = callbackResult;
+					bwLog(match.GetLogger(), LogLevel::Error, "physics.TraceMultipleAt callback failed: {}", err.what());
+				}
+			});
+		});
+	}
+
 	void ServerScriptingLibrary::RegisterPlayerClass(ScriptingContext& context)
 	{
 		sol::state& state = context.GetLuaState();
@@ -362,6 +462,7 @@ namespace bw
 			"GetInputs", LuaFunction(&Player::GetInputs),
 			"GetPlayerIndex", LuaFunction(&Player::GetPlayerIndex),
 			"GetName", LuaFunction(&Player::GetName),
+			"GetViewTick", LuaFunction(&Player::EstimateViewTick),
 			"IsAdmin", LuaFunction(&Player::IsAdmin),
 			"MoveToLayer", LuaFunction([](Player& player, std::optional<LayerIndex> layerIndex)
 			{
@@ -399,6 +500,7 @@ namespace bw
 		library["ReloadAll"] = LuaFunction([this]()
 		{
 			Match& match = GetMatch();
+			match.ReloadAssets();
 			match.ReloadScripts();
 		});
 	}
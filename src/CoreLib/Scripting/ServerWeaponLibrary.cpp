@@ -7,11 +7,15 @@
 #include <CoreLib/Match.hpp>
 #include <CoreLib/Components/AnimationComponent.hpp>
 #include <CoreLib/Components/HealthComponent.hpp>
+#include <CoreLib/Components/PlayerControlledComponent.hpp>
+#include <CoreLib/Components/WeaponComponent.hpp>
 #include <CoreLib/Scripting/ScriptingUtils.hpp>
+#include <CoreLib/Systems/HitboxHistorySystem.hpp>
 #include <NDK/World.hpp>
 #include <NDK/Components/PhysicsComponent2D.hpp>
 #include <NDK/Systems/PhysicsSystem2D.hpp>
 #include <sol/sol.hpp>
+#include <limits>
 
 namespace bw
 {
@@ -54,13 +58,22 @@ namespace bw
 			Ndk::World* world = entity->GetWorld();
 			assert(world);
 
-			auto& physSystem = world->GetSystem<Ndk::PhysicsSystem2D>();
+			auto& hitboxHistory = world->GetSystem<HitboxHistorySystem>();
 
-			Ndk::PhysicsSystem2D::RaycastHit hitInfo;
+			// Hitscan is lag-compensated: when fired by a player, targets are tested where that player saw them
+			Nz::UInt64 tick = std::numeric_limits<Nz::UInt64>::max(); //< clamped to the most recent state
+			const Ndk::EntityHandle& owner = entity->GetComponent<WeaponComponent>().GetOwner();
+			if (owner && owner->HasComponent<PlayerControlledComponent>())
+			{
+				if (Player* player = owner->GetComponent<PlayerControlledComponent>().GetOwner())
+					tick = player->EstimateViewTick();
+			}
+
+			HitboxHistorySystem::TraceHit hitInfo;
 
-			if (physSystem.RaycastQueryFirst(startPos, startPos + direction * 1000.f, 1.f, 0, 0xFFFFFFFF, 0xFFFFFFFF, &hitInfo))
+			if (hitboxHistory.TraceQueryFirst(tick, startPos, startPos + direction * 1000.f, &hitInfo, owner))
 			{
-				const Ndk::EntityHandle& hitEntity = hitInfo.body;
+				const Ndk::EntityHandle& hitEntity = hitInfo.entity;
 
 				if (hitEntity->HasComponent<HealthComponent>())
 					hitEntity->GetComponent<HealthComponent>().Damage(damage, entity);
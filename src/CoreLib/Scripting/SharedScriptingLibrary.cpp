@@ -7,6 +7,7 @@
 #include <CoreLib/CustomInputController.hpp>
 #include <CoreLib/InputController.hpp>
 #include <CoreLib/NoclipPlayerMovementController.hpp>
+#include <CoreLib/TilemapCollisionBuilder.hpp>
 #include <CoreLib/Version.hpp>
 #include <CoreLib/Components/ScriptComponent.hpp>
 #include <CoreLib/Scripting/Constraint.hpp>
@@ -342,6 +343,56 @@ namespace bw
 
 	void SharedScriptingLibrary::RegisterPhysicsLibrary(ScriptingContext& /*context*/, sol::table& library)
 	{
+		library["BuildTilemapColliders"] = LuaFunction([](sol::this_state L, const Nz::Vector2i64& mapSize, const Nz::Vector2f& cellSize, const sol::table& content, std::optional<bool> outline)
+		{
+			if (mapSize.x <= 0 || mapSize.y <= 0)
+				TriggerLuaArgError(L, 1, "invalid map size");
+
+			std::size_t cellCount = std::size_t(mapSize.x) * std::size_t(mapSize.y);
+			if (content.size() < cellCount)
+				TriggerLuaArgError(L, 3, "content has " + std::to_string(content.size()) + " cells, expected " + std::to_string(cellCount));
+
+			std::vector<Nz::Int64> cells(cellCount);
+			for (std::size_t i = 0; i < cellCount; ++i)
+				cells[i] = content.get_or<Nz::Int64>(i + 1, 0);
+
+			TilemapCollisionBuilder builder(Nz::Vector2ui(mapSize), cells.data());
+
+			sol::state_view state(L);
+			if (outline.value_or(false))
+			{
+				std::vector<TilemapCollisionBuilder::Segment> segments = builder.BuildOutline();
+
+				sol::table colliders = state.create_table(int(segments.size()), 0);
+				for (std::size_t i = 0; i < segments.size(); ++i)
+				{
+					lua_createtable(L, 0, 2);
+					luaL_setmetatable(L, "segment");
+					sol::stack_table segment(L);
+					segment["from"] = Nz::Vector2f(segments[i].from) * cellSize;
+					segment["to"] = Nz::Vector2f(segments[i].to) * cellSize;
+
+					colliders[i + 1] = segment;
+					lua_pop(L, 1);
+				}
+
+				return colliders;
+			}
+			else
+			{
+				const std::vector<Nz::Rectui>& rects = builder.GetRects();
+
+				sol::table colliders = state.create_table(int(rects.size()), 0);
+				for (std::size_t i = 0; i < rects.size(); ++i)
+				{
+					const Nz::Rectui& rect = rects[i];
+					colliders[i + 1] = Nz::Rectf(rect.x * cellSize.x, rect.y * cellSize.y, rect.width * cellSize.x, rect.height * cellSize.y);
+				}
+
+				return colliders;
+			}
+		});
+
 		library["CreateDampenedSpringConstraint"] = LuaFunction([](sol::this_state L, const sol::table& firstEntityTable, const sol::table& secondEntityTable, const Nz::Vector2f& firstAnchor, const Nz::Vector2f& secondAnchor, float restLength, float stiffness, float damping)
 		{
 			const Ndk::EntityHandle& firstEntity = AssertScriptEntity(firstEntityTable);
@@ -503,9 +554,14 @@ namespace bw
 
 	void SharedScriptingLibrary::RegisterTimerLibrary(ScriptingContext& /*context*/, sol::table& library)
 	{
+		library["Cancel"] = LuaFunction([&](TimerManager::TimerId timerId)
+		{
+			return m_match.GetTimerManager().Cancel(timerId);
+		});
+
 		library["Create"] = LuaFunction([&](Nz::UInt64 time, sol::main_protected_function callback)
 		{
-			m_match.GetTimerManager().PushCallback(m_match.GetCurrentTime() + time, [this, callback = std::move(callback)]()
+			return m_match.GetTimerManager().PushCallback(m_match.GetCurrentTime() + time, [this, callback = std::move(callback)]()
 			{
 				auto result = callback();
 				if (!result.valid())
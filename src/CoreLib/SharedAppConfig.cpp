@@ -10,11 +10,16 @@ namespace bw
 	ConfigFile(app)
 	{
 		RegisterStringOption("Resources.AssetDirectory");
+		RegisterStringOption("Resources.AssetHashManifest", ".assetHashes.json");
 		RegisterStringOption("Resources.ModDirectory");
 		RegisterStringOption("Resources.ScriptDirectory");
 		RegisterBoolOption("Debug.SendServerState");
+		RegisterBoolOption("ServerSettings.ClientSideMapEntities", true);
+		RegisterStringOption("ServerSettings.DemoDirectory", "");
+		RegisterStringOption("ServerSettings.EventLogDirectory", "");
 		RegisterStringOption("ServerSettings.FastDownloadURLs", "");
 		RegisterStringOption("ServerSettings.MasterServers", "");
+		RegisterIntegerOption("ServerSettings.MaxSpectatorCount", 0, 0xFFFF, 64);
 		RegisterFloatOption("ServerSettings.TickRate");
 	}
 }
@@ -0,0 +1,146 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/Systems/HitboxHistorySystem.hpp>
+#include <CoreLib/SharedMatch.hpp>
+#include <CoreLib/Components/HealthComponent.hpp>
+#include <CoreLib/Components/MatchComponent.hpp>
+#include <NDK/Components/PhysicsComponent2D.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace bw
+{
+	HitboxHistorySystem::HitboxHistorySystem(SharedMatch& match) :
+	m_newestSnapshot(0),
+	m_snapshotCount(0),
+	m_match(match)
+	{
+		Requires<HealthComponent, MatchComponent, Ndk::PhysicsComponent2D>();
+		SetMaximumUpdateRate(0);
+		SetUpdateOrder(75); //< Execute after physics and player movement
+
+		std::size_t snapshotCount = static_cast<std::size_t>(std::ceil(HistoryDuration / match.GetTickDuration())) + 1;
+		m_snapshots.resize(snapshotCount);
+	}
+
+	bool HitboxHistorySystem::TraceQueryFirst(Nz::UInt64 tick, const Nz::Vector2f& startPos, const Nz::Vector2f& endPos, TraceHit* hitInfo, const Ndk::Entity* ignoredEntity)
+	{
+		bool hasHit = false;
+		TraceHit closestHit;
+		TraceQuery(tick, startPos, endPos, [&](const TraceHit& hit)
+		{
+			// The shooter has moved since the requested tick and could be hit by its own trace
+			if (hit.entity.GetObject() == ignoredEntity)
+				return;
+
+			if (!hasHit || hit.fraction < closestHit.fraction)
+			{
+				closestHit = hit;
+				hasHit = true;
+			}
+		});
+
+		if (hasHit && hitInfo)
+			*hitInfo = std::move(closestHit);
+
+		return hasHit;
+	}
+
+	auto HitboxHistorySystem::FetchSnapshot(Nz::UInt64 tick) const -> const Snapshot*
+	{
+		if (!HasHistory())
+			return nullptr;
+
+		// Requests outside of the history are clamped, as the best we can do is to use the closest state we know
+		Nz::UInt64 newestTick = GetNewestTick();
+		Nz::UInt64 oldestTick = GetOldestTick();
+		tick = std::clamp(tick, oldestTick, newestTick);
+
+		// Ticks are usually contiguous, if some were skipped (server lagging behind) we land on an older snapshot and move forward
+		std::size_t offset = static_cast<std::size_t>(std::min<Nz::UInt64>(newestTick - tick, m_snapshotCount - 1));
+		std::size_t snapshotIndex = (m_newestSnapshot + m_snapshots.size() - offset) % m_snapshots.size();
+		for (; offset > 0; --offset)
+		{
+			std::size_t nextIndex = (snapshotIndex + 1) % m_snapshots.size();
+			if (m_snapshots[nextIndex].tick > tick)
+				break;
+
+			snapshotIndex = nextIndex;
+		}
+
+		return &m_snapshots[snapshotIndex];
+	}
+
+	void HitboxHistorySystem::OnUpdate(float /*elapsedTime*/)
+	{
+		std::size_t snapshotIndex = (HasHistory()) ? (m_newestSnapshot + 1) % m_snapshots.size() : 0;
+
+		Snapshot& snapshot = m_snapshots[snapshotIndex];
+		snapshot.tick = m_match.GetCurrentTick();
+		snapshot.uniqueIds.clear();
+		snapshot.maxX.clear();
+		snapshot.maxY.clear();
+		snapshot.minX.clear();
+		snapshot.minY.clear();
+
+		for (const Ndk::EntityHandle& entity : GetEntities())
+		{
+			auto& entityMatch = entity->GetComponent<MatchComponent>();
+			auto& entityPhys = entity->GetComponent<Ndk::PhysicsComponent2D>();
+
+			Nz::Rectf aabb = entityPhys.GetAABB();
+
+			snapshot.uniqueIds.push_back(entityMatch.GetUniqueId());
+			snapshot.maxX.push_back(aabb.x + aabb.width);
+			snapshot.maxY.push_back(aabb.y + aabb.height);
+			snapshot.minX.push_back(aabb.x);
+			snapshot.minY.push_back(aabb.y);
+		}
+
+		m_newestSnapshot = snapshotIndex;
+		m_snapshotCount = std::min(m_snapshotCount + 1, m_snapshots.size());
+	}
+
+	bool HitboxHistorySystem::IntersectSegment(const Nz::Vector2f& startPos, const Nz::Vector2f& endPos, float minX, float minY, float maxX, float maxY, float* fraction, Nz::Vector2f* hitNormal)
+	{
+		// Slab test, segments starting inside a hitbox don't hit it (like physics raycasts, this prevents hitting the shooter)
+		float entryFraction = 0.f;
+		float exitFraction = 1.f;
+		Nz::Vector2f entryNormal = Nz::Vector2f::Zero();
+
+		auto TestAxis = [&](float start, float end, float boxMin, float boxMax, const Nz::Vector2f& axis)
+		{
+			float delta = end - start;
+			if (std::abs(delta) <= std::numeric_limits<float>::epsilon())
+				return start >= boxMin && start <= boxMax;
+
+			float invDelta = 1.f / delta;
+			float nearFraction = (((delta > 0.f) ? boxMin : boxMax) - start) * invDelta;
+			float farFraction = (((delta > 0.f) ? boxMax : boxMin) - start) * invDelta;
+
+			if (nearFraction > entryFraction)
+			{
+				entryFraction = nearFraction;
+				entryNormal = (delta > 0.f) ? -axis : axis;
+			}
+
+			exitFraction = std::min(exitFraction, farFraction);
+			return entryFraction <= exitFraction;
+		};
+
+		if (!TestAxis(startPos.x, endPos.x, minX, maxX, Nz::Vector2f::UnitX()) || !TestAxis(startPos.y, endPos.y, minY, maxY, Nz::Vector2f::UnitY()))
+			return false;
+
+		if (entryNormal == Nz::Vector2f::Zero())
+			return false; //< Segment started inside the hitbox
+
+		*fraction = entryFraction;
+		*hitNormal = entryNormal;
+		return true;
+	}
+
+	Ndk::SystemIndex HitboxHistorySystem::systemIndex;
+}
@@ -134,6 +134,23 @@ namespace bw
 			creationEvent.playerMovement->isFacingRight = entityPlayerMovement.IsFacingRight();
 		}
 
+		// Clients instantiate map entities from their copy of the map, the diff is computed once here for every client
+		const Map::Entity* mapEntity = nullptr;
+
+		Match& match = m_layer.GetMatch();
+		if (match.HasClientSideMapEntities())
+		{
+			const Map& map = match.GetMap();
+			if (map.HasEntity(creationEvent.uniqueId))
+			{
+				const Map::Entity& entityData = map.GetEntity(creationEvent.uniqueId);
+				if (entityData.entityType == creationEvent.entityClass)
+					mapEntity = &entityData;
+			}
+		}
+
+		creationEvent.isMapEntity = (mapEntity != nullptr);
+
 		if (entity->HasComponent<ScriptComponent>())
 		{
 			auto& scriptComponent = entity->GetComponent<ScriptComponent>();
@@ -148,7 +165,15 @@ namespace bw
 				if (!it->second.shared)
 					continue;
 
-				creationEvent.properties.emplace(key, value);
+				bool isMapValue = false;
+				if (mapEntity)
+				{
+					auto mapIt = mapEntity->properties.find(key);
+					isMapValue = (mapIt != mapEntity->properties.end() && mapIt->second == value);
+				}
+
+				if (!isMapValue)
+					creationEvent.properties.emplace(key, value);
 
 				auto RegisterDependentId = [&](EntityId entityId)
 				{
@@ -7,8 +7,10 @@
 #include <CoreLib/Components/CooldownComponent.hpp>
 #include <CoreLib/Components/InputComponent.hpp>
 #include <CoreLib/Components/ScriptComponent.hpp>
-#include <CoreLib/Components/WeaponComponent.hpp>
+#include <CoreLib/Scripting/SharedWeaponStore.hpp>
 #include <NDK/Components/NodeComponent.hpp>
+#include <algorithm>
+#include <cassert>
 
 namespace bw
 {
@@ -19,25 +21,114 @@ namespace bw
 		SetMaximumUpdateRate(0);
 	}
 
+	void WeaponSystem::ActivateWeapon(Ndk::Entity* weapon)
+	{
+		auto it = m_weaponData.find(weapon->GetId());
+		assert(it != m_weaponData.end());
+
+		WeaponData& weaponData = it.value();
+		if (weaponData.activeIndex != InvalidIndex)
+			DeactivateWeapon(weapon); //< Refresh owner data
+
+		auto& weaponComponent = weapon->GetComponent<WeaponComponent>();
+
+		const Ndk::EntityHandle& owner = weaponComponent.GetOwner();
+		if (!weaponComponent.IsActive() || !owner || !owner->HasComponent<InputComponent>())
+			return;
+
+		weaponData.activeIndex = m_activeWeapons.size();
+
+		ActiveWeapon& activeWeapon = m_activeWeapons.emplace_back();
+		activeWeapon.owner = owner;
+		activeWeapon.ownerInputs = &owner->GetComponent<InputComponent>();
+		activeWeapon.ownerNode = &owner->GetComponent<Ndk::NodeComponent>();
+		activeWeapon.weapon = weapon;
+		activeWeapon.weaponComponent = &weaponComponent;
+		activeWeapon.weaponCooldown = &weapon->GetComponent<CooldownComponent>();
+		activeWeapon.weaponNode = &weapon->GetComponent<Ndk::NodeComponent>();
+
+		// Used to order attack callbacks, looked up once here instead of on every attack
+		ScriptComponent& weaponScript = weapon->GetComponent<ScriptComponent>();
+		activeWeapon.weaponScript = &weaponScript;
+		activeWeapon.classIndex = m_match.GetWeaponStore().GetElementIndex(weaponScript.GetElement()->fullName);
+		activeWeapon.uniqueId = m_match.RetrieveUniqueIdByEntity(weapon);
+	}
+
+	void WeaponSystem::DeactivateWeapon(Ndk::Entity* weapon)
+	{
+		auto it = m_weaponData.find(weapon->GetId());
+		assert(it != m_weaponData.end());
+
+		std::size_t activeIndex = it->second.activeIndex;
+		if (activeIndex == InvalidIndex)
+			return;
+
+		it.value().activeIndex = InvalidIndex;
+
+		// Swap with last active weapon to keep the array packed
+		std::size_t lastIndex = m_activeWeapons.size() - 1;
+		if (activeIndex != lastIndex)
+		{
+			m_activeWeapons[activeIndex] = std::move(m_activeWeapons[lastIndex]);
+
+			auto movedIt = m_weaponData.find(m_activeWeapons[activeIndex].weapon->GetId());
+			assert(movedIt != m_weaponData.end());
+			movedIt.value().activeIndex = activeIndex;
+		}
+
+		m_activeWeapons.pop_back();
+	}
+
+	void WeaponSystem::OnEntityAdded(Ndk::Entity* entity)
+	{
+		assert(m_weaponData.find(entity->GetId()) == m_weaponData.end());
+		WeaponData& weaponData = m_weaponData.emplace(entity->GetId(), WeaponData{}).first.value();
+
+		auto& weaponComponent = entity->GetComponent<WeaponComponent>();
+		weaponData.onActiveUpdate.Connect(weaponComponent.OnActiveUpdate, [this](WeaponComponent* weapon, bool isActive)
+		{
+			if (isActive)
+				ActivateWeapon(weapon->GetEntity());
+			else
+				DeactivateWeapon(weapon->GetEntity());
+		});
+
+		weaponData.onOwnerUpdate.Connect(weaponComponent.OnOwnerUpdate, [this](WeaponComponent* weapon, const Ndk::EntityHandle& /*newOwner*/)
+		{
+			ActivateWeapon(weapon->GetEntity());
+		});
+
+		ActivateWeapon(entity);
+	}
+
+	void WeaponSystem::OnEntityRemoved(Ndk::Entity* entity)
+	{
+		DeactivateWeapon(entity);
+
+		m_weaponData.erase(entity->GetId());
+	}
+
 	void WeaponSystem::OnUpdate(float /*elapsedTime*/)
 	{
-		for (const Ndk::EntityHandle& weapon : GetEntities())
+		Nz::UInt64 currentTime = m_match.GetCurrentTime();
+
+		for (ActiveWeapon& activeWeapon : m_activeWeapons)
 		{
-			auto& weaponComponent = weapon->GetComponent<WeaponComponent>();
-			if (!weaponComponent.IsActive())
+			// Owner may have been destroyed since the weapon was activated
+			if (!activeWeapon.owner)
 				continue;
 
-			if (const Ndk::EntityHandle& owner = weaponComponent.GetOwner())
-			{
-				InputComponent& ownerInputs = owner->GetComponent<InputComponent>();
-				Ndk::NodeComponent& ownerNode = owner->GetComponent<Ndk::NodeComponent>();
-				Ndk::NodeComponent& weaponNode = weapon->GetComponent<Ndk::NodeComponent>();
+			const auto& inputs = activeWeapon.ownerInputs->GetInputs();
+			const auto& previousInputs = activeWeapon.ownerInputs->GetPreviousInputs();
 
-				const auto& inputs = ownerInputs.GetInputs();
-				const auto& previousInputs = ownerInputs.GetPreviousInputs();
+			// Only update weapon orientation when the owner aims in another direction or turns around
+			bool isOwnerFlipped = std::signbit(activeWeapon.ownerNode->GetScale(Nz::CoordSys_Local).x);
+			if (!activeWeapon.isAimValid || activeWeapon.lastAimDirection != inputs.aimDirection || activeWeapon.wasOwnerFlipped != isOwnerFlipped)
+			{
+				Ndk::NodeComponent& weaponNode = *activeWeapon.weaponNode;
 
 				Nz::RadianAnglef angle(std::atan2(inputs.aimDirection.y, inputs.aimDirection.x));
-				if (std::signbit(ownerNode.GetScale(Nz::CoordSys_Global).x) != std::signbit(weaponNode.GetScale(Nz::CoordSys_Global).x))
+				if (std::signbit(activeWeapon.ownerNode->GetScale(Nz::CoordSys_Global).x) != std::signbit(weaponNode.GetScale(Nz::CoordSys_Global).x))
 					weaponNode.Scale(-1.f, 1.f);
 
 				if (weaponNode.GetScale().x < 0.f)
@@ -45,38 +136,82 @@ namespace bw
 
 				weaponNode.SetRotation(angle);
 
-				bool isAttacking = false;
-				switch (weaponComponent.GetAttackMode())
-				{
-					case WeaponAttackMode::SingleShot:
-						isAttacking = inputs.isAttacking && !previousInputs.isAttacking;
-						break;
+				activeWeapon.isAimValid = true;
+				activeWeapon.lastAimDirection = inputs.aimDirection;
+				activeWeapon.wasOwnerFlipped = isOwnerFlipped;
+			}
 
-					case WeaponAttackMode::SingleShotRepeat:
-						isAttacking = inputs.isAttacking;
-						break;
-				}
+			WeaponComponent& weaponComponent = *activeWeapon.weaponComponent;
+
+			bool isAttacking = false;
+			switch (weaponComponent.GetAttackMode())
+			{
+				case WeaponAttackMode::SingleShot:
+					isAttacking = inputs.isAttacking && !previousInputs.isAttacking;
+					break;
 
-				if (isAttacking)
+				case WeaponAttackMode::SingleShotRepeat:
+					isAttacking = inputs.isAttacking;
+					break;
+			}
+
+			if (isAttacking)
+			{
+				if (activeWeapon.weaponCooldown->Trigger(currentTime))
 				{
-					auto& weaponCooldown = weapon->GetComponent<CooldownComponent>();
-					if (weaponCooldown.Trigger(m_match.GetCurrentTime()))
-					{
-						auto& weaponScript = weapon->GetComponent<ScriptComponent>();
-						weaponScript.ExecuteCallback<ElementEvent::Attack>(weaponScript.GetTable());
-
-						weaponComponent.SetAttacking(true);
-					}
+					weaponComponent.SetAttacking(true);
+					PushAttackEvent(AttackEventType::Attack, activeWeapon);
 				}
-				else if (!inputs.isAttacking && weaponComponent.IsAttacking())
-				{
-					auto& weaponScript = weapon->GetComponent<ScriptComponent>();
-					weaponScript.ExecuteCallback<ElementEvent::AttackFinish>(weaponScript.GetTable());
+			}
+			else if (!inputs.isAttacking && weaponComponent.IsAttacking())
+			{
+				weaponComponent.SetAttacking(false);
+				PushAttackEvent(AttackEventType::AttackFinish, activeWeapon);
+			}
+		}
 
-					weaponComponent.SetAttacking(false);
-				}
+		if (m_attackEvents.empty())
+			return;
+
+		// Scripts are called once every weapon has been processed (they may activate/deactivate weapons), grouped by weapon class
+		// Order by class index then unique id (not by address) so callbacks run in the same order on every run
+		std::stable_sort(m_attackEvents.begin(), m_attackEvents.end(), [](const AttackEvent& lhs, const AttackEvent& rhs)
+		{
+			if (lhs.classIndex != rhs.classIndex)
+				return lhs.classIndex < rhs.classIndex;
+
+			return lhs.uniqueId < rhs.uniqueId;
+		});
+
+		for (AttackEvent& attackEvent : m_attackEvents)
+		{
+			// A previous callback may have removed or switched off the weapon
+			if (!attackEvent.weapon || !attackEvent.weapon->GetComponent<WeaponComponent>().IsActive())
+				continue;
+
+			ScriptComponent& weaponScript = *attackEvent.weaponScript;
+			switch (attackEvent.type)
+			{
+				case AttackEventType::Attack:
+					weaponScript.ExecuteCallback<ElementEvent::Attack>(weaponScript.GetTable());
+					break;
+
+				case AttackEventType::AttackFinish:
+					weaponScript.ExecuteCallback<ElementEvent::AttackFinish>(weaponScript.GetTable());
+					break;
 			}
 		}
+		m_attackEvents.clear();
+	}
+
+	void WeaponSystem::PushAttackEvent(AttackEventType type, const ActiveWeapon& activeWeapon)
+	{
+		auto& attackEvent = m_attackEvents.emplace_back();
+		attackEvent.type = type;
+		attackEvent.classIndex = activeWeapon.classIndex;
+		attackEvent.uniqueId = activeWeapon.uniqueId;
+		attackEvent.weapon = activeWeapon.weapon;
+		attackEvent.weaponScript = activeWeapon.weaponScript;
 	}
 
 	Ndk::SystemIndex WeaponSystem::systemIndex;
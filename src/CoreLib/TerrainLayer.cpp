@@ -8,6 +8,7 @@
 #include <CoreLib/Components/PlayerControlledComponent.hpp>
 #include <CoreLib/Components/PlayerMovementComponent.hpp>
 #include <CoreLib/Systems/AnimationSystem.hpp>
+#include <CoreLib/Systems/HitboxHistorySystem.hpp>
 #include <CoreLib/Systems/NetworkSyncSystem.hpp>
 #include <CoreLib/Systems/PlayerMovementSystem.hpp>
 #include <Nazara/Physics2D/Arbiter2D.hpp>
@@ -21,6 +22,7 @@ namespace bw
 	m_mapLayer(layerData)
 	{
 		Ndk::World& world = GetWorld();
+		world.AddSystem<HitboxHistorySystem>(match);
 		world.AddSystem<NetworkSyncSystem>(*this);
 
 		ResetEntities();
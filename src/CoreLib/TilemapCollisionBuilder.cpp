@@ -0,0 +1,202 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/TilemapCollisionBuilder.hpp>
+#include <algorithm>
+
+namespace bw
+{
+	TilemapCollisionBuilder::TilemapCollisionBuilder(const Nz::Vector2ui& mapSize) :
+	m_cells(std::size_t(mapSize.x) * mapSize.y, false),
+	m_cellRects(std::size_t(mapSize.x) * mapSize.y, NoRect),
+	m_mapSize(mapSize)
+	{
+	}
+
+	void TilemapCollisionBuilder::Build()
+	{
+		m_rects.clear();
+		std::fill(m_cellRects.begin(), m_cellRects.end(), NoRect);
+
+		MergeRegion(Nz::Rectui(0, 0, m_mapSize.x, m_mapSize.y));
+	}
+
+	auto TilemapCollisionBuilder::BuildOutline() const -> std::vector<Segment>
+	{
+		auto IsSolidOrOut = [&](long long x, long long y)
+		{
+			if (x < 0 || y < 0 || x >= static_cast<long long>(m_mapSize.x) || y >= static_cast<long long>(m_mapSize.y))
+				return false;
+
+			return IsSolid(static_cast<unsigned int>(x), static_cast<unsigned int>(y));
+		};
+
+		std::vector<Segment> segments;
+
+		// Horizontal edges, between row y - 1 and row y, contiguous edges are merged in a single segment
+		for (unsigned int y = 0; y <= m_mapSize.y; ++y)
+		{
+			unsigned int x = 0;
+			while (x < m_mapSize.x)
+			{
+				if (IsSolidOrOut(x, y - 1LL) == IsSolidOrOut(x, y))
+				{
+					x++;
+					continue;
+				}
+
+				unsigned int startX = x;
+				while (x < m_mapSize.x && IsSolidOrOut(x, y - 1LL) != IsSolidOrOut(x, y))
+					x++;
+
+				segments.push_back(Segment{ Nz::Vector2ui(startX, y), Nz::Vector2ui(x, y) });
+			}
+		}
+
+		// Vertical edges, between column x - 1 and column x
+		for (unsigned int x = 0; x <= m_mapSize.x; ++x)
+		{
+			unsigned int y = 0;
+			while (y < m_mapSize.y)
+			{
+				if (IsSolidOrOut(x - 1LL, y) == IsSolidOrOut(x, y))
+				{
+					y++;
+					continue;
+				}
+
+				unsigned int startY = y;
+				while (y < m_mapSize.y && IsSolidOrOut(x - 1LL, y) != IsSolidOrOut(x, y))
+					y++;
+
+				segments.push_back(Segment{ Nz::Vector2ui(x, startY), Nz::Vector2ui(x, y) });
+			}
+		}
+
+		return segments;
+	}
+
+	bool TilemapCollisionBuilder::UpdateCell(unsigned int x, unsigned int y, bool isSolid)
+	{
+		std::size_t cellIndex = GetCellIndex(x, y);
+		if (m_cells[cellIndex] == isSolid)
+			return false;
+
+		m_cells[cellIndex] = isSolid;
+
+		// Only rects touching the cell are removed and their area merged again, other rects are left untouched
+		Nz::Rectui region(x, y, 1, 1);
+		auto RemoveCellRect = [&](unsigned int cellX, unsigned int cellY)
+		{
+			Nz::UInt32 rectIndex = m_cellRects[GetCellIndex(cellX, cellY)];
+			if (rectIndex == NoRect)
+				return;
+
+			region.ExtendTo(m_rects[rectIndex]);
+			RemoveRect(rectIndex);
+		};
+
+		RemoveCellRect(x, y);
+
+		// A new solid cell may allow neighbor rects to grow
+		if (isSolid)
+		{
+			if (x > 0)
+				RemoveCellRect(x - 1, y);
+
+			if (x + 1 < m_mapSize.x)
+				RemoveCellRect(x + 1, y);
+
+			if (y > 0)
+				RemoveCellRect(x, y - 1);
+
+			if (y + 1 < m_mapSize.y)
+				RemoveCellRect(x, y + 1);
+		}
+
+		MergeRegion(region);
+
+		return true;
+	}
+
+	void TilemapCollisionBuilder::MergeRegion(const Nz::Rectui& region)
+	{
+		unsigned int regionRight = region.x + region.width;
+		unsigned int regionBottom = region.y + region.height;
+
+		auto IsFree = [&](unsigned int x, unsigned int y)
+		{
+			std::size_t cellIndex = GetCellIndex(x, y);
+			return m_cells[cellIndex] && m_cellRects[cellIndex] == NoRect;
+		};
+
+		for (unsigned int y = region.y; y < regionBottom; ++y)
+		{
+			for (unsigned int x = region.x; x < regionRight; ++x)
+			{
+				if (!IsFree(x, y))
+					continue;
+
+				// Grow the rect as much as possible horizontally, then vertically while whole rows are free
+				unsigned int width = 1;
+				while (x + width < regionRight && IsFree(x + width, y))
+					width++;
+
+				unsigned int height = 1;
+				while (y + height < regionBottom)
+				{
+					bool isRowFree = true;
+					for (unsigned int i = 0; i < width; ++i)
+					{
+						if (!IsFree(x + i, y + height))
+						{
+							isRowFree = false;
+							break;
+						}
+					}
+
+					if (!isRowFree)
+						break;
+
+					height++;
+				}
+
+				Nz::UInt32 rectIndex = static_cast<Nz::UInt32>(m_rects.size());
+				m_rects.emplace_back(x, y, width, height);
+
+				for (unsigned int rectY = y; rectY < y + height; ++rectY)
+				{
+					for (unsigned int rectX = x; rectX < x + width; ++rectX)
+						m_cellRects[GetCellIndex(rectX, rectY)] = rectIndex;
+				}
+
+				x += width - 1;
+			}
+		}
+	}
+
+	void TilemapCollisionBuilder::RemoveRect(std::size_t rectIndex)
+	{
+		auto AssignRect = [&](const Nz::Rectui& rect, Nz::UInt32 index)
+		{
+			for (unsigned int y = rect.y; y < rect.y + rect.height; ++y)
+			{
+				for (unsigned int x = rect.x; x < rect.x + rect.width; ++x)
+					m_cellRects[GetCellIndex(x, y)] = index;
+			}
+		};
+
+		AssignRect(m_rects[rectIndex], NoRect);
+
+		// Swap with the last rect to keep rects packed
+		std::size_t lastIndex = m_rects.size() - 1;
+		if (rectIndex != lastIndex)
+		{
+			m_rects[rectIndex] = m_rects[lastIndex];
+			AssignRect(m_rects[rectIndex], static_cast<Nz::UInt32>(rectIndex));
+		}
+
+		m_rects.pop_back();
+	}
+}
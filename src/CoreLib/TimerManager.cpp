@@ -0,0 +1,55 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/TimerManager.hpp>
+#include <algorithm>
+
+namespace bw
+{
+	auto TimerManager::PushCallback(Nz::UInt64 expirationTime, Callback callback) -> TimerId
+	{
+		TimerId timerId = m_nextTimerId++;
+		m_callbacks.emplace(timerId, std::move(callback));
+
+		m_timerQueue.push_back({ expirationTime, timerId });
+		std::push_heap(m_timerQueue.begin(), m_timerQueue.end(), TimerCompare{});
+
+		// Don't let cancelled timers accumulate in the queue
+		if (m_timerQueue.size() > 64 && m_timerQueue.size() > 2 * m_callbacks.size())
+			RemoveCancelledTimers();
+
+		return timerId;
+	}
+
+	void TimerManager::Update(Nz::UInt64 now)
+	{
+		// Callbacks may push or cancel timers, always recheck the queue top
+		while (!m_timerQueue.empty() && now > m_timerQueue.front().expirationTime)
+		{
+			TimerId timerId = m_timerQueue.front().timerId;
+
+			std::pop_heap(m_timerQueue.begin(), m_timerQueue.end(), TimerCompare{});
+			m_timerQueue.pop_back();
+
+			auto it = m_callbacks.find(timerId);
+			if (it == m_callbacks.end())
+				continue; //< Timer has been cancelled
+
+			Callback callback = std::move(it.value());
+			m_callbacks.erase(it);
+
+			callback();
+		}
+	}
+
+	void TimerManager::RemoveCancelledTimers()
+	{
+		m_timerQueue.erase(std::remove_if(m_timerQueue.begin(), m_timerQueue.end(), [&](const PendingTimer& timer)
+		{
+			return m_callbacks.find(timer.timerId) == m_callbacks.end();
+		}), m_timerQueue.end());
+
+		std::make_heap(m_timerQueue.begin(), m_timerQueue.end(), TimerCompare{});
+	}
+}
@@ -0,0 +1,50 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/Utility/BinaryFileWriter.hpp>
+#include <CoreLib/LogSystem/Logger.hpp>
+#include <cassert>
+#include <stdexcept>
+
+namespace bw
+{
+	BinaryFileWriter::BinaryFileWriter(const Logger& logger, const std::filesystem::path& filePath, std::string fileDescription, std::size_t maxRecordSize) :
+	m_logger(logger),
+	m_fileDescription(std::move(fileDescription)),
+	m_file(filePath.generic_u8string(), Nz::OpenMode_WriteOnly | Nz::OpenMode_Truncate)
+	{
+		if (!m_file.IsOpen())
+			throw std::runtime_error("failed to open " + filePath.generic_u8string());
+
+		// A record is appended before checking the threshold, so make sure the buffer never has to grow
+		m_buffer.reserve(FlushThreshold + maxRecordSize);
+	}
+
+	BinaryFileWriter::~BinaryFileWriter()
+	{
+		Flush();
+	}
+
+	void BinaryFileWriter::Flush()
+	{
+		if (m_buffer.empty())
+			return;
+
+		if (m_file.Write(m_buffer.data(), m_buffer.size()) != m_buffer.size())
+			bwLog(m_logger, LogLevel::Error, "failed to write {0} ({1} bytes lost)", m_fileDescription, m_buffer.size());
+
+		m_buffer.clear();
+	}
+
+	void BinaryFileWriter::WriteHeader(const char* signature, Nz::UInt32 fileVersion, Nz::UInt32 headerData)
+	{
+		assert(m_buffer.empty());
+
+		Write(reinterpret_cast<const Nz::UInt8*>(signature), 8);
+		WriteLE(fileVersion);
+		WriteLE(headerData);
+
+		assert(m_buffer.size() == HeaderSize);
+	}
+}
@@ -0,0 +1,116 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/Utility/MappedFile.hpp>
+
+#if defined(NAZARA_PLATFORM_WINDOWS)
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+#include <Windows.h>
+#elif defined(NAZARA_PLATFORM_POSIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace bw
+{
+	void MappedFile::Close()
+	{
+		if (!m_isOpen)
+			return;
+
+		if (m_data)
+		{
+#if defined(NAZARA_PLATFORM_WINDOWS)
+			UnmapViewOfFile(m_data);
+#elif defined(NAZARA_PLATFORM_POSIX)
+			munmap(const_cast<Nz::UInt8*>(m_data), m_size);
+#endif
+		}
+
+		m_data = nullptr;
+		m_size = 0;
+		m_isOpen = false;
+	}
+
+	bool MappedFile::Open(const std::filesystem::path& filePath)
+	{
+		Close();
+
+		// File and mapping handles can be closed as soon as the view exists, the view keeps them alive
+#if defined(NAZARA_PLATFORM_WINDOWS)
+		HANDLE fileHandle = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (fileHandle == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(fileHandle, &fileSize))
+		{
+			CloseHandle(fileHandle);
+			return false;
+		}
+
+		// Empty files cannot be mapped
+		if (fileSize.QuadPart > 0)
+		{
+			HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			CloseHandle(fileHandle);
+
+			if (!mappingHandle)
+				return false;
+
+			void* view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(mappingHandle);
+
+			if (!view)
+				return false;
+
+			m_data = static_cast<const Nz::UInt8*>(view);
+			m_size = static_cast<std::size_t>(fileSize.QuadPart);
+		}
+		else
+			CloseHandle(fileHandle);
+#elif defined(NAZARA_PLATFORM_POSIX)
+		int fileDescriptor = open(filePath.c_str(), O_RDONLY);
+		if (fileDescriptor < 0)
+			return false;
+
+		struct stat fileInfo;
+		if (fstat(fileDescriptor, &fileInfo) != 0)
+		{
+			close(fileDescriptor);
+			return false;
+		}
+
+		// Empty files cannot be mapped
+		if (fileInfo.st_size > 0)
+		{
+			void* view = mmap(nullptr, static_cast<std::size_t>(fileInfo.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+			close(fileDescriptor);
+
+			if (view == MAP_FAILED)
+				return false;
+
+			m_data = static_cast<const Nz::UInt8*>(view);
+			m_size = static_cast<std::size_t>(fileInfo.st_size);
+		}
+		else
+			close(fileDescriptor);
+#else
+#error MappedFile is not implemented for this platform
+#endif
+
+		m_isOpen = true;
+		return true;
+	}
+}
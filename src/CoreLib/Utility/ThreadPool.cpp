@@ -0,0 +1,95 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/Utility/ThreadPool.hpp>
+#include <Nazara/Core/Thread.hpp>
+#include <algorithm>
+#include <cassert>
+
+namespace bw
+{
+	ThreadPool::ThreadPool(std::size_t workerCount, std::string name) :
+	m_pendingTaskCount(0),
+	m_running(true)
+	{
+		if (workerCount == 0)
+			workerCount = GetDefaultWorkerCount();
+
+		m_workers.reserve(workerCount);
+		for (std::size_t i = 0; i < workerCount; ++i)
+		{
+			m_workers.emplace_back([this, threadName = name + " #" + std::to_string(i)]
+			{
+				Nz::Thread::SetCurrentThreadName(threadName.c_str());
+				WorkerThread();
+			});
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_running = false;
+		}
+		m_taskSignal.notify_all();
+
+		for (std::thread& worker : m_workers)
+			worker.join();
+	}
+
+	void ThreadPool::PushTask(Task task)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_tasks.push(std::move(task));
+			m_pendingTaskCount++;
+		}
+		m_taskSignal.notify_one();
+	}
+
+	void ThreadPool::WaitForAll()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_idleSignal.wait(lock, [&] { return m_pendingTaskCount == 0; });
+	}
+
+	std::size_t ThreadPool::GetDefaultWorkerCount()
+	{
+		// Leave one core to the calling thread
+		unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		return std::max<std::size_t>((hardwareThreads > 1) ? hardwareThreads - 1 : 1, 1);
+	}
+
+	void ThreadPool::WorkerThread()
+	{
+		for (;;)
+		{
+			Task task;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_taskSignal.wait(lock, [&] { return !m_running || !m_tasks.empty(); });
+
+				// Remaining tasks are discarded on destruction
+				if (!m_running)
+					return;
+
+				task = std::move(m_tasks.front());
+				m_tasks.pop();
+			}
+
+			task();
+
+			bool isIdle;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				assert(m_pendingTaskCount > 0);
+				isIdle = (--m_pendingTaskCount == 0);
+			}
+
+			if (isIdle)
+				m_idleSignal.notify_all();
+		}
+	}
+}
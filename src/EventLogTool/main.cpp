@@ -0,0 +1,217 @@
+// Copyright(C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/MatchEventLogReader.hpp>
+#include <Main/Main.hpp>
+#include <cxxopts.hpp>
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <variant>
+
+namespace
+{
+	template<typename... Ts> struct Overloaded : Ts... { using Ts::operator()...; };
+	template<typename... Ts> Overloaded(Ts...) -> Overloaded<Ts...>;
+
+	const char* ToString(Nz::UInt8 disconnectionReason)
+	{
+		switch (disconnectionReason)
+		{
+			case 0: return "kicked";
+			case 1: return "left";
+			case 2: return "timed out";
+		}
+
+		return "unknown";
+	}
+
+	std::string EscapeCsv(std::string_view str)
+	{
+		std::string escaped = "\"";
+		for (char c : str)
+		{
+			if (c == '"')
+				escaped += '"';
+
+			escaped += c;
+		}
+		escaped += '"';
+
+		return escaped;
+	}
+
+	void WriteCsv(std::FILE* output, bw::MatchEventLogReader& reader)
+	{
+		fmt::print(output, "tick,event,entity,source,player,name,layer,x,y,old_health,new_health,max_health,reason,duration_us\n");
+
+		bw::MatchEventLogReader::Event event;
+		while (reader.ReadEvent(event))
+		{
+			std::visit(Overloaded{
+				[&](const bw::MatchEventLogReader::EntityDestroyed& e)
+				{
+					fmt::print(output, "{},entity_destroyed,{},,,,,,,,,,,\n", event.tick, e.entityId);
+				},
+				[&](const bw::MatchEventLogReader::EntityDied& e)
+				{
+					fmt::print(output, "{},entity_died,{},{},,,,,,,,,,\n", event.tick, e.entityId, e.attackerId);
+				},
+				[&](const bw::MatchEventLogReader::EntityHealthChanged& e)
+				{
+					fmt::print(output, "{},entity_health_changed,{},{},,,,,,{},{},{},,\n", event.tick, e.entityId, e.sourceId, e.oldHealth, e.newHealth, e.maxHealth);
+				},
+				[&](const bw::MatchEventLogReader::EntitySpawned& e)
+				{
+					fmt::print(output, "{},entity_spawned,{},,,{},{},{},{},,,,,\n", event.tick, e.entityId, EscapeCsv(e.entityClass), e.layerIndex, e.position.x, e.position.y);
+				},
+				[&](const bw::MatchEventLogReader::PlayerJoined& e)
+				{
+					fmt::print(output, "{},player_joined,,,{},{},,,,,,,,\n", event.tick, e.playerIndex, EscapeCsv(e.playerName));
+				},
+				[&](const bw::MatchEventLogReader::PlayerLeft& e)
+				{
+					fmt::print(output, "{},player_left,,,{},,,,,,,,{},\n", event.tick, e.playerIndex, ToString(e.reason));
+				},
+				[&](const bw::MatchEventLogReader::TickTiming& e)
+				{
+					fmt::print(output, "{},tick,,,,,,,,,,,,{}\n", event.tick, e.durationUs);
+				}
+			}, event.data);
+		}
+	}
+
+	void WriteJson(std::FILE* output, bw::MatchEventLogReader& reader)
+	{
+		fmt::print(output, "[");
+
+		bool first = true;
+		bw::MatchEventLogReader::Event event;
+		while (reader.ReadEvent(event))
+		{
+			nlohmann::json eventDoc;
+			eventDoc["tick"] = event.tick;
+
+			std::visit(Overloaded{
+				[&](const bw::MatchEventLogReader::EntityDestroyed& e)
+				{
+					eventDoc["event"] = "entity_destroyed";
+					eventDoc["entity"] = e.entityId;
+				},
+				[&](const bw::MatchEventLogReader::EntityDied& e)
+				{
+					eventDoc["event"] = "entity_died";
+					eventDoc["entity"] = e.entityId;
+					eventDoc["attacker"] = e.attackerId;
+				},
+				[&](const bw::MatchEventLogReader::EntityHealthChanged& e)
+				{
+					eventDoc["event"] = "entity_health_changed";
+					eventDoc["entity"] = e.entityId;
+					eventDoc["source"] = e.sourceId;
+					eventDoc["old_health"] = e.oldHealth;
+					eventDoc["new_health"] = e.newHealth;
+					eventDoc["max_health"] = e.maxHealth;
+				},
+				[&](const bw::MatchEventLogReader::EntitySpawned& e)
+				{
+					eventDoc["event"] = "entity_spawned";
+					eventDoc["entity"] = e.entityId;
+					eventDoc["class"] = std::string(e.entityClass);
+					eventDoc["layer"] = e.layerIndex;
+					eventDoc["position"] = { e.position.x, e.position.y };
+				},
+				[&](const bw::MatchEventLogReader::PlayerJoined& e)
+				{
+					eventDoc["event"] = "player_joined";
+					eventDoc["player"] = e.playerIndex;
+					eventDoc["name"] = std::string(e.playerName);
+				},
+				[&](const bw::MatchEventLogReader::PlayerLeft& e)
+				{
+					eventDoc["event"] = "player_left";
+					eventDoc["player"] = e.playerIndex;
+					eventDoc["reason"] = ToString(e.reason);
+				},
+				[&](const bw::MatchEventLogReader::TickTiming& e)
+				{
+					eventDoc["event"] = "tick";
+					eventDoc["duration_us"] = e.durationUs;
+				}
+			}, event.data);
+
+			fmt::print(output, "{}\n{}", (first) ? "" : ",", eventDoc.dump());
+			first = false;
+		}
+
+		fmt::print(output, "\n]\n");
+	}
+}
+
+int BurgWarEventLogTool(int argc, char* argv[])
+{
+	cxxopts::Options options("BurgWarEventLogTool", "Tool for converting BurgWar match event logs");
+	options.add_options()
+		("f,format", "Output format (csv or json)", cxxopts::value<std::string>()->default_value("csv"), "format")
+		("i,input", "Input file", cxxopts::value<std::string>())
+		("o,output", "Output file (standard output if not set)", cxxopts::value<std::string>(), "path")
+		("h,help", "Print usage")
+	;
+
+	options.parse_positional("input");
+	options.positional_help("EVENTLOG");
+
+	try
+	{
+		auto result = options.parse(argc, argv);
+		if (result.count("help") > 0)
+		{
+			fmt::print("{}\n", options.help());
+			return EXIT_SUCCESS;
+		}
+
+		if (result.count("input") == 0)
+		{
+			fmt::print("no input file\n{}\n", options.help());
+			return EXIT_SUCCESS;
+		}
+
+		std::string format = result["format"].as<std::string>();
+		if (format != "csv" && format != "json")
+			throw std::runtime_error("unknown format " + format);
+
+		bw::MatchEventLogReader reader(std::filesystem::u8path(result["input"].as<std::string>()));
+
+		std::FILE* output = stdout;
+		if (result.count("output") > 0)
+		{
+			std::string outputPath = result["output"].as<std::string>();
+			output = std::fopen(outputPath.c_str(), "wb");
+			if (!output)
+				throw std::runtime_error("failed to open " + outputPath);
+		}
+
+		if (format == "csv")
+			WriteCsv(output, reader);
+		else
+			WriteJson(output, reader);
+
+		if (output != stdout)
+			std::fclose(output);
+
+		if (reader.IsTruncated())
+			fmt::print(stderr, "warning: event log ends with an incomplete record\n");
+	}
+	catch (const std::exception& e)
+	{
+		fmt::print(stderr, "{}\n", e.what());
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+BurgWarMain(BurgWarEventLogTool)
@@ -0,0 +1,121 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <MapEditor/Commands/EditorCommand.hpp>
+#include <type_traits>
+
+namespace bw::Commands
+{
+	EditorCommand::EditorCommand(EditorWindow& editor, const QString& label) :
+	m_editor(editor),
+	m_lastUpdate(std::chrono::steady_clock::now()),
+	m_isDiscarded(false)
+	{
+		setText(label);
+	}
+
+	void EditorCommand::Discard()
+	{
+		// Discarded commands no longer affect the map and are removed from the undo stack when reached
+		m_isDiscarded = true;
+		ReleaseData();
+
+		setObsolete(true);
+		setText(text() + " (discarded)");
+	}
+
+	std::size_t EditorCommand::GetMemoryUsage() const
+	{
+		return 0;
+	}
+
+	bool EditorCommand::mergeWith(const QUndoCommand* command)
+	{
+		// QUndoStack only merges commands sharing the same id, which are all editor commands
+		const EditorCommand& editorCommand = static_cast<const EditorCommand&>(*command);
+		if (m_isDiscarded || editorCommand.m_isDiscarded)
+			return false;
+
+		// Only merge continuous edits
+		if (editorCommand.m_lastUpdate - m_lastUpdate > MergeDelay)
+			return false;
+
+		if (!Merge(editorCommand))
+			return false;
+
+		m_lastUpdate = editorCommand.m_lastUpdate;
+		return true;
+	}
+
+	void EditorCommand::redo()
+	{
+		if (!m_isDiscarded)
+			Redo();
+	}
+
+	void EditorCommand::undo()
+	{
+		if (!m_isDiscarded)
+			Undo();
+	}
+
+	bool EditorCommand::Merge(const EditorCommand& /*command*/)
+	{
+		return false;
+	}
+
+	void EditorCommand::ReleaseData()
+	{
+	}
+
+	std::size_t EditorCommand::EstimateMemoryUsage(const Map::Entity& entity)
+	{
+		return sizeof(entity) + entity.entityType.size() + entity.name.size() + EstimateMemoryUsage(entity.properties);
+	}
+
+	std::size_t EditorCommand::EstimateMemoryUsage(const Map::Layer& layer)
+	{
+		std::size_t memoryUsage = sizeof(layer) + layer.name.size();
+		for (const Map::Entity& entity : layer.entities)
+			memoryUsage += EstimateMemoryUsage(entity);
+
+		return memoryUsage;
+	}
+
+	std::size_t EditorCommand::EstimateMemoryUsage(const PropertyValueMap& properties)
+	{
+		std::size_t memoryUsage = 0;
+		for (auto&& [propertyName, propertyValue] : properties)
+			memoryUsage += propertyName.size() + EstimateMemoryUsage(propertyValue);
+
+		return memoryUsage;
+	}
+
+	std::size_t EditorCommand::EstimateMemoryUsage(const PropertyValue& property)
+	{
+		return std::visit([&](auto&& value) -> std::size_t
+		{
+			using T = std::decay_t<decltype(value)>;
+			using PropertyTypeExtractor = PropertyTypeExtractor<T>;
+			using UnderlyingType = typename PropertyTypeExtractor::UnderlyingType;
+
+			std::size_t memoryUsage = sizeof(property);
+
+			if constexpr (PropertyTypeExtractor::IsArray)
+			{
+				memoryUsage += value.GetSize() * sizeof(UnderlyingType);
+
+				if constexpr (std::is_same_v<UnderlyingType, std::string>)
+				{
+					for (const std::string& str : value)
+						memoryUsage += str.size();
+				}
+			}
+			else if constexpr (std::is_same_v<UnderlyingType, std::string>)
+				memoryUsage += (*value).size();
+
+			return memoryUsage;
+		}, property);
+	}
+}
@@ -0,0 +1,66 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_MAPEDITOR_COMMANDS_EDITORCOMMAND_HPP
+#define BURGWAR_MAPEDITOR_COMMANDS_EDITORCOMMAND_HPP
+
+#include <CoreLib/Map.hpp>
+#include <QtWidgets/QUndoCommand>
+#include <chrono>
+
+namespace bw
+{
+	class EditorWindow;
+
+	namespace Commands
+	{
+		class EditorCommand : public QUndoCommand
+		{
+			public:
+				EditorCommand(EditorWindow& editor, const QString& label);
+				~EditorCommand() = default;
+
+				void Discard();
+
+				virtual std::size_t GetMemoryUsage() const;
+
+				inline bool IsDiscarded() const;
+
+				bool mergeWith(const QUndoCommand* command) final;
+				void redo() final;
+				void undo() final;
+
+				static std::size_t EstimateMemoryUsage(const Map::Entity& entity);
+				static std::size_t EstimateMemoryUsage(const Map::Layer& layer);
+				static std::size_t EstimateMemoryUsage(const PropertyValueMap& properties);
+				static std::size_t EstimateMemoryUsage(const PropertyValue& property);
+
+				static constexpr std::chrono::milliseconds MergeDelay = std::chrono::milliseconds(1000);
+
+			protected:
+				virtual bool Merge(const EditorCommand& command);
+				virtual void ReleaseData();
+				virtual void Redo() = 0;
+				virtual void Undo() = 0;
+
+				enum MergeId
+				{
+					EntityUpdateMergeId = 1,
+					PositionUpdateMergeId
+				};
+
+				EditorWindow& m_editor;
+
+			private:
+				std::chrono::steady_clock::time_point m_lastUpdate;
+				bool m_isDiscarded;
+		};
+	}
+}
+
+#include <MapEditor/Commands/EditorCommand.inl>
+
+#endif
@@ -0,0 +1,13 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <MapEditor/Commands/EditorCommand.hpp>
+
+namespace bw::Commands
+{
+	inline bool EditorCommand::IsDiscarded() const
+	{
+		return m_isDiscarded;
+	}
+}
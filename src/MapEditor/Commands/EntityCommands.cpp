@@ -9,11 +9,15 @@
 namespace bw::Commands
 {
 	EntitiesCommand::EntitiesCommand(EditorWindow& editor, std::vector<EntityId> entityUniqueIds, const QString& label) :
-	m_editor(editor),
+	EditorCommand(editor, label),
 	m_entitiesUniqueId(std::move(entityUniqueIds))
 	{
 		assert(!m_entitiesUniqueId.empty());
-		setText(label);
+	}
+
+	std::size_t EntitiesCommand::GetMemoryUsage() const
+	{
+		return sizeof(*this) + m_entitiesUniqueId.size() * sizeof(EntityId);
 	}
 
 	EntityCreationDelete::EntityCreationDelete(EditorWindow& editor, std::vector<EntityId> entityUniqueIds, const QString& label) :
@@ -40,6 +44,15 @@ namespace bw::Commands
 	{
 	}
 
+	std::size_t EntityCreationDelete::GetMemoryUsage() const
+	{
+		std::size_t memoryUsage = EntitiesCommand::GetMemoryUsage();
+		for (const EntityData& entityData : m_entitiesData)
+			memoryUsage += EstimateMemoryUsage(entityData.entity);
+
+		return memoryUsage;
+	}
+
 	void EntityCreationDelete::Create()
 	{
 		assert(!m_entitiesData.empty());
@@ -78,6 +91,12 @@ namespace bw::Commands
 		}
 	}
 
+	void EntityCreationDelete::ReleaseData()
+	{
+		m_entitiesData.clear();
+		m_entitiesData.shrink_to_fit();
+	}
+
 	std::vector<EntityId> EntityCreationDelete::BuildEntitiesUniqueId(std::vector<EntityData>& entitiesData)
 	{
 		// Sort entities by their entity index, ascending (in order to prevent issues when recreating them)
@@ -105,12 +124,12 @@ namespace bw::Commands
 	{
 	}
 
-	void EntityClone::redo()
+	void EntityClone::Redo()
 	{
 		Create();
 	}
 
-	void EntityClone::undo()
+	void EntityClone::Undo()
 	{
 		Delete();
 	}
@@ -133,12 +152,12 @@ namespace bw::Commands
 	{
 	}
 
-	void EntityCreate::redo()
+	void EntityCreate::Redo()
 	{
 		Create();
 	}
 
-	void EntityCreate::undo()
+	void EntityCreate::Undo()
 	{
 		Delete();
 	}
@@ -149,12 +168,12 @@ namespace bw::Commands
 	{
 	}
 
-	void EntityDelete::redo()
+	void EntityDelete::Redo()
 	{
 		Delete();
 	}
 
-	void EntityDelete::undo()
+	void EntityDelete::Undo()
 	{
 		Create();
 	}
@@ -168,13 +187,13 @@ namespace bw::Commands
 		m_originalPosition = m_editor.GetWorkingMap().GetEntityIndices(entityUniqueId);
 	}
 
-	void EntityLayerUpdate::redo()
+	void EntityLayerUpdate::Redo()
 	{
 		assert(m_entitiesUniqueId.size() == 1);
 		m_editor.MoveEntity(m_entitiesUniqueId[0], m_newLayerIndex, m_editor.GetWorkingMap().GetEntityCount(m_newLayerIndex));
 	}
 
-	void EntityLayerUpdate::undo()
+	void EntityLayerUpdate::Undo()
 	{
 		assert(m_entitiesUniqueId.size() == 1);
 		m_editor.MoveEntity(m_entitiesUniqueId[0], m_originalPosition.layerIndex, m_originalPosition.entityIndex);
@@ -183,30 +202,116 @@ namespace bw::Commands
 
 	EntityUpdate::EntityUpdate(EditorWindow& editor, EntityId entityUniqueId, Map::Entity update, EntityInfoUpdateFlags updateFlags) :
 	EntitiesCommand(editor, { entityUniqueId }, "update entity"),
-	m_updateFlags(updateFlags),
-	m_newState(std::move(update))
+	m_updateFlags(updateFlags)
 	{
-		assert(m_newState.uniqueId == entityUniqueId);
+		assert(update.uniqueId == entityUniqueId);
+
+		const Map::Entity& currentEntity = m_editor.GetWorkingMap().GetEntity(entityUniqueId);
+		m_previousState = BuildState(currentEntity, m_updateFlags);
+		m_newState = BuildState(update, m_updateFlags);
 
-		m_previousState = m_editor.GetWorkingMap().GetEntity(entityUniqueId);
+		if (m_updateFlags & EntityInfoUpdate::Properties)
+			m_propertyDelta = PropertyDelta(currentEntity.properties, update.properties);
 	}
 
-	void EntityUpdate::redo()
+	std::size_t EntityUpdate::GetMemoryUsage() const
 	{
-		assert(m_entitiesUniqueId.size() == 1);
-		const Map& map = m_editor.GetWorkingMap();
-		const auto& indices = map.GetEntityIndices(m_entitiesUniqueId[0]);
+		std::size_t memoryUsage = EntitiesCommand::GetMemoryUsage();
+		memoryUsage += m_previousState.entityType.size() + m_previousState.name.size();
+		memoryUsage += m_newState.entityType.size() + m_newState.name.size();
+		memoryUsage += m_propertyDelta.GetMemoryUsage();
+
+		return memoryUsage;
+	}
+
+	int EntityUpdate::id() const
+	{
+		return EntityUpdateMergeId;
+	}
 
-		m_editor.UpdateEntity(indices.layerIndex, indices.entityIndex, m_newState, m_updateFlags);
+	void EntityUpdate::Redo()
+	{
+		Apply(m_newState, false);
+	}
+
+	void EntityUpdate::Undo()
+	{
+		Apply(m_previousState, true);
 	}
 
-	void EntityUpdate::undo()
+	bool EntityUpdate::Merge(const EditorCommand& command)
+	{
+		const EntityUpdate& entityUpdate = static_cast<const EntityUpdate&>(command);
+		if (entityUpdate.m_entitiesUniqueId != m_entitiesUniqueId || entityUpdate.m_updateFlags != m_updateFlags)
+			return false;
+
+		m_newState = entityUpdate.m_newState;
+
+		if (m_updateFlags & EntityInfoUpdate::Properties)
+		{
+			// The merged command has already been applied, rebuild the delta between our previous properties and the current ones
+			const PropertyValueMap& currentProperties = m_editor.GetWorkingMap().GetEntity(m_entitiesUniqueId[0]).properties;
+
+			PropertyValueMap previousProperties = currentProperties;
+			entityUpdate.m_propertyDelta.ApplyPrevious(previousProperties);
+			m_propertyDelta.ApplyPrevious(previousProperties);
+
+			m_propertyDelta = PropertyDelta(previousProperties, currentProperties);
+
+			// Edits cancelling each other can be removed from the stack
+			if (m_updateFlags == EntityInfoUpdate::Properties && m_propertyDelta.IsEmpty())
+				setObsolete(true);
+		}
+
+		return true;
+	}
+
+	void EntityUpdate::ReleaseData()
+	{
+		m_previousState = EntityState{};
+		m_newState = EntityState{};
+		m_propertyDelta = PropertyDelta{};
+	}
+
+	void EntityUpdate::Apply(const EntityState& state, bool previousProperties)
 	{
 		assert(m_entitiesUniqueId.size() == 1);
 		const Map& map = m_editor.GetWorkingMap();
 		const auto& indices = map.GetEntityIndices(m_entitiesUniqueId[0]);
+		const Map::Entity& currentEntity = map.GetEntity(indices.layerIndex, indices.entityIndex);
+
+		Map::Entity entity;
+		entity.uniqueId = currentEntity.uniqueId;
+		entity.entityType = state.entityType;
+		entity.name = state.name;
+		entity.position = state.position;
+		entity.rotation = state.rotation;
+
+		if (m_updateFlags & EntityInfoUpdate::Properties)
+		{
+			entity.properties = currentEntity.properties;
+			if (previousProperties)
+				m_propertyDelta.ApplyPrevious(entity.properties);
+			else
+				m_propertyDelta.ApplyNew(entity.properties);
+		}
 
-		m_editor.UpdateEntity(indices.layerIndex, indices.entityIndex, m_previousState, m_updateFlags);
+		m_editor.UpdateEntity(indices.layerIndex, indices.entityIndex, std::move(entity), m_updateFlags);
+	}
+
+	auto EntityUpdate::BuildState(const Map::Entity& entity, EntityInfoUpdateFlags updateFlags) -> EntityState
+	{
+		EntityState state;
+		if (updateFlags & EntityInfoUpdate::EntityClass)
+			state.entityType = entity.entityType;
+
+		if (updateFlags & EntityInfoUpdate::EntityName)
+			state.name = entity.name;
+
+		state.position = entity.position;
+		state.rotation = entity.rotation;
+
+		return state;
 	}
 
 
@@ -216,7 +321,12 @@ namespace bw::Commands
 	{
 	}
 
-	void PositionUpdate::redo()
+	int PositionUpdate::id() const
+	{
+		return PositionUpdateMergeId;
+	}
+
+	void PositionUpdate::Redo()
 	{
 		for (EntityId entityId : m_entitiesUniqueId)
 		{
@@ -230,7 +340,7 @@ namespace bw::Commands
 		}
 	}
 
-	void PositionUpdate::undo()
+	void PositionUpdate::Undo()
 	{
 		for (EntityId entityId : m_entitiesUniqueId)
 		{
@@ -243,20 +353,37 @@ namespace bw::Commands
 			m_editor.RefreshEntityPositionAndRotation(indices.layerIndex, indices.entityIndex);
 		}
 	}
+
+	bool PositionUpdate::Merge(const EditorCommand& command)
+	{
+		const PositionUpdate& positionUpdate = static_cast<const PositionUpdate&>(command);
+		if (positionUpdate.m_entitiesUniqueId != m_entitiesUniqueId)
+			return false;
+
+		m_offset += positionUpdate.m_offset;
+		return true;
+	}
 	
 	PrefabInstantiate::PrefabInstantiate(EditorWindow& editor, Map::EntityIndices entityIndices, std::vector<Map::Entity> entities) :
+	EditorCommand(editor, "instantiate prefab"),
 	m_entityData(std::move(entities)),
-	m_entityIndices(std::move(entityIndices)),
-	m_editor(editor)
+	m_entityIndices(std::move(entityIndices))
 	{
 		m_entityUniqueIds.reserve(m_entityData.size());
 		for (const auto& entity : m_entityData)
 			m_entityUniqueIds.push_back(entity.uniqueId);
+	}
+
+	std::size_t PrefabInstantiate::GetMemoryUsage() const
+	{
+		std::size_t memoryUsage = sizeof(*this) + m_entityUniqueIds.size() * sizeof(EntityId);
+		for (const Map::Entity& entity : m_entityData)
+			memoryUsage += EstimateMemoryUsage(entity);
 
-		setText("instantiate prefab");
+		return memoryUsage;
 	}
 	
-	void PrefabInstantiate::redo()
+	void PrefabInstantiate::Redo()
 	{
 		LayerIndex layerIndex = m_entityIndices.layerIndex;
 		std::size_t entityIndex = m_entityIndices.entityIndex;
@@ -272,7 +399,7 @@ namespace bw::Commands
 		m_entityData.clear();
 	}
 	
-	void PrefabInstantiate::undo()
+	void PrefabInstantiate::Undo()
 	{
 		assert(m_entityData.empty());
 		for (EntityId uniqueId : m_entityUniqueIds)
@@ -281,4 +408,10 @@ namespace bw::Commands
 			assert(entityData.uniqueId == uniqueId);
 		}
 	}
+
+	void PrefabInstantiate::ReleaseData()
+	{
+		m_entityData.clear();
+		m_entityData.shrink_to_fit();
+	}
 }
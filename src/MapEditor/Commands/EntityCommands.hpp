@@ -9,8 +9,9 @@
 
 #include <CoreLib/Map.hpp>
 #include <MapEditor/Enums.hpp>
+#include <MapEditor/Commands/EditorCommand.hpp>
+#include <MapEditor/Commands/PropertyDelta.hpp>
 #include <Nazara/Math/Vector2.hpp>
-#include <QtWidgets/QUndoCommand>
 
 namespace bw
 {
@@ -18,14 +19,15 @@ namespace bw
 
 	namespace Commands
 	{
-		class EntitiesCommand : public QUndoCommand
+		class EntitiesCommand : public EditorCommand
 		{
 			public:
 				EntitiesCommand(EditorWindow& editor, std::vector<EntityId> entityUniqueIds, const QString& label);
 				~EntitiesCommand() = default;
 
+				std::size_t GetMemoryUsage() const override;
+
 			protected:
-				EditorWindow& m_editor;
 				std::vector<EntityId> m_entitiesUniqueId;
 		};
 
@@ -38,6 +40,8 @@ namespace bw
 				EntityCreationDelete(EditorWindow& editor, const QString& label, std::vector<EntityData> entitiesData);
 				~EntityCreationDelete() = default;
 
+				std::size_t GetMemoryUsage() const override;
+
 				struct EntityData
 				{
 					Map::Entity entity;
@@ -47,6 +51,7 @@ namespace bw
 			protected:
 				void Create();
 				void Delete();
+				void ReleaseData() override;
 
 				static inline EntityData BuildData(Map::EntityIndices entityIndices, Map::Entity entity);
 
@@ -62,8 +67,8 @@ namespace bw
 				EntityClone(EditorWindow& editor, const Map::EntityIndices& sourceEntityIndices, const Map::EntityIndices& targetEntityIndices);
 				~EntityClone() = default;
 
-				void redo() override;
-				void undo() override;
+				void Redo() override;
+				void Undo() override;
 
 			private:
 				static EntityData BuildClone(EditorWindow& editor, const Map::EntityIndices& sourceEntityIndices, const Map::EntityIndices& targetEntityIndices);
@@ -75,8 +80,8 @@ namespace bw
 				EntityCreate(EditorWindow& editor, Map::EntityIndices entityIndices, Map::Entity entity);
 				~EntityCreate() = default;
 
-				void redo() override;
-				void undo() override;
+				void Redo() override;
+				void Undo() override;
 		};
 
 		class EntityDelete final : public EntityCreationDelete
@@ -85,8 +90,8 @@ namespace bw
 				EntityDelete(EditorWindow& editor, std::vector<EntityId> entityUniqueIds);
 				~EntityDelete() = default;
 
-				void redo() override;
-				void undo() override;
+				void Redo() override;
+				void Undo() override;
 		};
 
 		class EntityLayerUpdate final : public EntitiesCommand
@@ -95,8 +100,8 @@ namespace bw
 				EntityLayerUpdate(EditorWindow& editor, EntityId entityUniqueId, LayerIndex newLayerIndex);
 				~EntityLayerUpdate() = default;
 
-				void redo() override;
-				void undo() override;
+				void Redo() override;
+				void Undo() override;
 
 			private:
 				Map::EntityIndices m_originalPosition;
@@ -109,13 +114,35 @@ namespace bw
 				EntityUpdate(EditorWindow& editor, EntityId entityUniqueId, Map::Entity update, EntityInfoUpdateFlags updateFlags);
 				~EntityUpdate() = default;
 
-				void redo() override;
-				void undo() override;
+				std::size_t GetMemoryUsage() const override;
+
+				int id() const override;
+
+				void Redo() override;
+				void Undo() override;
+
+			protected:
+				bool Merge(const EditorCommand& command) override;
+				void ReleaseData() override;
 
 			private:
+				// Properties are stored as a delta, other fields are only stored if updated
+				struct EntityState
+				{
+					std::string entityType;
+					std::string name;
+					Nz::DegreeAnglef rotation;
+					Nz::Vector2f position;
+				};
+
+				void Apply(const EntityState& state, bool previousProperties);
+
+				static EntityState BuildState(const Map::Entity& entity, EntityInfoUpdateFlags updateFlags);
+
 				EntityInfoUpdateFlags m_updateFlags;
-				Map::Entity m_previousState;
-				Map::Entity m_newState;
+				EntityState m_previousState;
+				EntityState m_newState;
+				PropertyDelta m_propertyDelta;
 		};
 
 		class PositionUpdate final : public EntitiesCommand
@@ -124,27 +151,36 @@ namespace bw
 				PositionUpdate(EditorWindow& editor, std::vector<EntityId> entityUniqueIds, const Nz::Vector2f& offset);
 				~PositionUpdate() = default;
 
-				void redo() override;
-				void undo() override;
+				int id() const override;
+
+				void Redo() override;
+				void Undo() override;
+
+			protected:
+				bool Merge(const EditorCommand& command) override;
 
 			private:
 				Nz::Vector2f m_offset;
 		};
 
-		class PrefabInstantiate final : public QUndoCommand
+		class PrefabInstantiate final : public EditorCommand
 		{
 			public:
 				PrefabInstantiate(EditorWindow& editor, Map::EntityIndices entityIndices, std::vector<Map::Entity> entities);
 				~PrefabInstantiate() = default;
 
-				void redo() override;
-				void undo() override;
+				std::size_t GetMemoryUsage() const override;
+
+				void Redo() override;
+				void Undo() override;
+
+			protected:
+				void ReleaseData() override;
 
 			private:
 				std::vector<Map::Entity> m_entityData;
 				std::vector<EntityId> m_entityUniqueIds;
 				Map::EntityIndices m_entityIndices;
-				EditorWindow& m_editor;
 		};
 	}
 }
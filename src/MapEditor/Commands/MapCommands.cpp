@@ -9,9 +9,8 @@
 namespace bw::Commands
 {
 	MapCommand::MapCommand(EditorWindow& editor, const QString& label) :
-	m_editor(editor)
+	EditorCommand(editor, label)
 	{
-		setText(label);
 	}
 
 	
@@ -23,12 +22,12 @@ namespace bw::Commands
 	{
 	}
 
-	void EntitySwap::redo()
+	void EntitySwap::Redo()
 	{
 		SwapEntities();
 	}
 
-	void EntitySwap::undo()
+	void EntitySwap::Undo()
 	{
 		SwapEntities();
 	}
@@ -54,11 +53,27 @@ namespace bw::Commands
 	{
 		assert(m_layerData.has_value());
 		m_editor.CreateLayer(m_layerIndex, std::move(m_layerData.value()));
+		m_layerData.reset();
 	}
 
 	void LayerCreationDelete::Delete()
 	{
-		m_editor.DeleteLayer(m_layerIndex);
+		// Keep the layer to be able to create it back
+		m_layerData = m_editor.DeleteLayer(m_layerIndex);
+	}
+
+	std::size_t LayerCreationDelete::GetMemoryUsage() const
+	{
+		std::size_t memoryUsage = sizeof(*this);
+		if (m_layerData)
+			memoryUsage += EstimateMemoryUsage(*m_layerData);
+
+		return memoryUsage;
+	}
+
+	void LayerCreationDelete::ReleaseData()
+	{
+		m_layerData.reset();
 	}
 
 	
@@ -67,12 +82,12 @@ namespace bw::Commands
 	{
 	}
 
-	void LayerClone::redo()
+	void LayerClone::Redo()
 	{
 		Create();
 	}
 
-	void LayerClone::undo()
+	void LayerClone::Undo()
 	{
 		Delete();
 	}
@@ -92,12 +107,12 @@ namespace bw::Commands
 	{
 	}
 
-	void LayerCreate::redo()
+	void LayerCreate::Redo()
 	{
 		Create();
 	}
 
-	void LayerCreate::undo()
+	void LayerCreate::Undo()
 	{
 		Delete();
 	}
@@ -108,12 +123,12 @@ namespace bw::Commands
 	{
 	}
 
-	void LayerDelete::redo()
+	void LayerDelete::Redo()
 	{
 		Delete();
 	}
 
-	void LayerDelete::undo()
+	void LayerDelete::Undo()
 	{
 		Create();
 	}
@@ -126,12 +141,12 @@ namespace bw::Commands
 	{
 	}
 
-	void LayerSwap::redo()
+	void LayerSwap::Redo()
 	{
 		SwapLayers();
 	}
 
-	void LayerSwap::undo()
+	void LayerSwap::Undo()
 	{
 		SwapLayers();
 	}
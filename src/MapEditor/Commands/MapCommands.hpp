@@ -9,8 +9,8 @@
 
 #include <CoreLib/Map.hpp>
 #include <MapEditor/Enums.hpp>
+#include <MapEditor/Commands/EditorCommand.hpp>
 #include <Nazara/Math/Vector2.hpp>
-#include <QtWidgets/QUndoCommand>
 
 namespace bw
 {
@@ -18,14 +18,11 @@ namespace bw
 
 	namespace Commands
 	{
-		class MapCommand : public QUndoCommand
+		class MapCommand : public EditorCommand
 		{
 			public:
 				MapCommand(EditorWindow& editor, const QString& label);
 				~MapCommand() = default;
-
-			protected:
-				EditorWindow& m_editor;
 		};
 		
 		class EntitySwap final : public MapCommand
@@ -34,8 +31,8 @@ namespace bw
 				EntitySwap(EditorWindow& editor, LayerIndex layerIndex, std::size_t firstEntityIndex, std::size_t secondEntityIndex);
 				~EntitySwap() = default;
 
-				void redo() override;
-				void undo() override;
+				void Redo() override;
+				void Undo() override;
 
 			protected:
 				void SwapEntities();
@@ -52,9 +49,12 @@ namespace bw
 				LayerCreationDelete(EditorWindow& editor, const QString& label, LayerIndex layerIndex, Map::Layer layer);
 				~LayerCreationDelete() = default;
 
+				std::size_t GetMemoryUsage() const override;
+
 			protected:
 				void Create();
 				void Delete();
+				void ReleaseData() override;
 
 			private:
 				std::optional<Map::Layer> m_layerData;
@@ -67,8 +67,8 @@ namespace bw
 				LayerClone(EditorWindow& editor, LayerIndex sourceLayerIndex, LayerIndex targetLayerIndex);
 				~LayerClone() = default;
 
-				void redo() override;
-				void undo() override;
+				void Redo() override;
+				void Undo() override;
 
 			private:
 				static Map::Layer BuildClone(const EditorWindow& editor, LayerIndex layerIndex);
@@ -80,8 +80,8 @@ namespace bw
 				LayerCreate(EditorWindow& editor, LayerIndex layerIndex, Map::Layer layer);
 				~LayerCreate() = default;
 
-				void redo() override;
-				void undo() override;
+				void Redo() override;
+				void Undo() override;
 		};
 		
 		class LayerDelete final : public LayerCreationDelete
@@ -90,8 +90,8 @@ namespace bw
 				LayerDelete(EditorWindow& editor, LayerIndex layerIndex);
 				~LayerDelete() = default;
 
-				void redo() override;
-				void undo() override;
+				void Redo() override;
+				void Undo() override;
 		};
 
 		class LayerSwap final : public MapCommand
@@ -100,8 +100,8 @@ namespace bw
 				LayerSwap(EditorWindow& editor, LayerIndex firstLayerIndex, LayerIndex secondLayerIndex);
 				~LayerSwap() = default;
 
-				void redo() override;
-				void undo() override;
+				void Redo() override;
+				void Undo() override;
 
 			protected:
 				void SwapLayers();
@@ -0,0 +1,182 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <MapEditor/Commands/PropertyDelta.hpp>
+#include <MapEditor/Commands/EditorCommand.hpp>
+#include <algorithm>
+#include <cassert>
+
+namespace bw::Commands
+{
+	PropertyDelta::PropertyDelta(const PropertyValueMap& previousProperties, const PropertyValueMap& newProperties)
+	{
+		for (auto&& [propertyName, previousValue] : previousProperties)
+		{
+			auto it = newProperties.find(propertyName);
+			if (it == newProperties.end())
+			{
+				PropertyChange& change = m_changes.emplace_back();
+				change.name = propertyName;
+				change.previousValue = previousValue;
+				continue;
+			}
+
+			const PropertyValue& newValue = it->second;
+			if (previousValue == newValue)
+				continue;
+
+			PropertyChange& change = m_changes.emplace_back();
+			change.name = propertyName;
+			change.arrayRuns = BuildArrayRuns(previousValue, newValue);
+			if (change.arrayRuns.empty())
+			{
+				change.previousValue = previousValue;
+				change.newValue = newValue;
+			}
+		}
+
+		for (auto&& [propertyName, newValue] : newProperties)
+		{
+			if (previousProperties.find(propertyName) != previousProperties.end())
+				continue;
+
+			PropertyChange& change = m_changes.emplace_back();
+			change.name = propertyName;
+			change.newValue = newValue;
+		}
+	}
+
+	void PropertyDelta::ApplyNew(PropertyValueMap& properties) const
+	{
+		Apply(properties, false);
+	}
+
+	void PropertyDelta::ApplyPrevious(PropertyValueMap& properties) const
+	{
+		Apply(properties, true);
+	}
+
+	std::size_t PropertyDelta::GetMemoryUsage() const
+	{
+		std::size_t memoryUsage = sizeof(*this);
+		for (const PropertyChange& change : m_changes)
+		{
+			memoryUsage += sizeof(change) + change.name.size();
+			if (change.previousValue)
+				memoryUsage += EditorCommand::EstimateMemoryUsage(*change.previousValue);
+
+			if (change.newValue)
+				memoryUsage += EditorCommand::EstimateMemoryUsage(*change.newValue);
+
+			for (const ArrayRun& run : change.arrayRuns)
+				memoryUsage += sizeof(run) + EditorCommand::EstimateMemoryUsage(run.previousValues) + EditorCommand::EstimateMemoryUsage(run.newValues);
+		}
+
+		return memoryUsage;
+	}
+
+	void PropertyDelta::Apply(PropertyValueMap& properties, bool previous) const
+	{
+		for (const PropertyChange& change : m_changes)
+		{
+			if (!change.arrayRuns.empty())
+			{
+				auto it = properties.find(change.name);
+				assert(it != properties.end());
+
+				std::visit([&](auto&& value)
+				{
+					using T = std::decay_t<decltype(value)>;
+					using PropertyTypeExtractor = PropertyTypeExtractor<T>;
+
+					if constexpr (PropertyTypeExtractor::IsArray)
+					{
+						for (const ArrayRun& run : change.arrayRuns)
+						{
+							const T& runValues = std::get<T>((previous) ? run.previousValues : run.newValues);
+							assert(run.offset + runValues.GetSize() <= value.GetSize());
+
+							std::copy(runValues.begin(), runValues.end(), value.begin() + run.offset);
+						}
+					}
+					else
+						assert(!"array runs on a single value property");
+				}, it.value());
+
+				continue;
+			}
+
+			const std::optional<PropertyValue>& value = (previous) ? change.previousValue : change.newValue;
+			if (value)
+				properties.insert_or_assign(change.name, *value);
+			else
+				properties.erase(change.name);
+		}
+	}
+
+	auto PropertyDelta::BuildArrayRuns(const PropertyValue& previousValue, const PropertyValue& newValue) -> std::vector<ArrayRun>
+	{
+		// Only arrays of the same type and size can be patched
+		if (previousValue.index() != newValue.index())
+			return {};
+
+		return std::visit([&](auto&& previousArray) -> std::vector<ArrayRun>
+		{
+			using T = std::decay_t<decltype(previousArray)>;
+			using PropertyTypeExtractor = PropertyTypeExtractor<T>;
+
+			if constexpr (PropertyTypeExtractor::IsArray)
+			{
+				const T& newArray = std::get<T>(newValue);
+
+				std::size_t elementCount = previousArray.GetSize();
+				if (newArray.GetSize() != elementCount)
+					return {};
+
+				std::vector<ArrayRun> runs;
+				std::size_t patchedElementCount = 0;
+
+				std::size_t i = 0;
+				while (i < elementCount)
+				{
+					if (previousArray[i] == newArray[i])
+					{
+						i++;
+						continue;
+					}
+
+					// Extend the run until enough unmodified elements are found
+					std::size_t runStart = i;
+					std::size_t runEnd = i + 1;
+					for (std::size_t j = runEnd; j < elementCount && j - runEnd <= MaxRunGap; ++j)
+					{
+						if (previousArray[j] != newArray[j])
+							runEnd = j + 1;
+					}
+
+					std::size_t runSize = runEnd - runStart;
+
+					T previousValues(runSize);
+					std::copy(previousArray.begin() + runStart, previousArray.begin() + runEnd, previousValues.begin());
+
+					T newValues(runSize);
+					std::copy(newArray.begin() + runStart, newArray.begin() + runEnd, newValues.begin());
+
+					runs.push_back(ArrayRun{ runStart, std::move(previousValues), std::move(newValues) });
+					patchedElementCount += runSize;
+
+					i = runEnd;
+				}
+
+				// Patching most of the array costs more than storing it whole
+				if (patchedElementCount * 2 > elementCount)
+					return {};
+
+				return runs;
+			}
+			else
+				return {};
+		}, previousValue);
+	}
+}
@@ -0,0 +1,65 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_MAPEDITOR_COMMANDS_PROPERTYDELTA_HPP
+#define BURGWAR_MAPEDITOR_COMMANDS_PROPERTYDELTA_HPP
+
+#include <CoreLib/PropertyValues.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace bw::Commands
+{
+	// Difference between two property maps, arrays of the same type and size are stored as runs of modified elements
+	class PropertyDelta
+	{
+		public:
+			PropertyDelta() = default;
+			PropertyDelta(const PropertyValueMap& previousProperties, const PropertyValueMap& newProperties);
+			PropertyDelta(const PropertyDelta&) = default;
+			PropertyDelta(PropertyDelta&&) noexcept = default;
+			~PropertyDelta() = default;
+
+			void ApplyNew(PropertyValueMap& properties) const;
+			void ApplyPrevious(PropertyValueMap& properties) const;
+
+			std::size_t GetMemoryUsage() const;
+
+			inline bool IsEmpty() const;
+
+			PropertyDelta& operator=(const PropertyDelta&) = default;
+			PropertyDelta& operator=(PropertyDelta&&) noexcept = default;
+
+			static constexpr std::size_t MaxRunGap = 8; //< unmodified elements between two runs under this count are merged in a single run
+
+		private:
+			struct ArrayRun
+			{
+				std::size_t offset;
+				PropertyValue previousValues;
+				PropertyValue newValues;
+			};
+
+			struct PropertyChange
+			{
+				std::string name;
+				std::optional<PropertyValue> previousValue; //< unset when the property was not set (or when patched by runs)
+				std::optional<PropertyValue> newValue;
+				std::vector<ArrayRun> arrayRuns;
+			};
+
+			void Apply(PropertyValueMap& properties, bool previous) const;
+
+			static std::vector<ArrayRun> BuildArrayRuns(const PropertyValue& previousValue, const PropertyValue& newValue);
+
+			std::vector<PropertyChange> m_changes;
+	};
+}
+
+#include <MapEditor/Commands/PropertyDelta.inl>
+
+#endif
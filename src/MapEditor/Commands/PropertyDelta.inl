@@ -0,0 +1,13 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <MapEditor/Commands/PropertyDelta.hpp>
+
+namespace bw::Commands
+{
+	inline bool PropertyDelta::IsEmpty() const
+	{
+		return m_changes.empty();
+	}
+}
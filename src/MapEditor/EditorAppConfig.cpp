@@ -11,5 +11,6 @@ namespace bw
 	SharedAppConfig(app)
 	{
 		RegisterStringOption("Resources.EditorDirectory");
+		RegisterIntegerOption("EditorSettings.UndoMemoryLimit", 0, 0xFFFFFFFF, 256); //< In MiB, 0 means unlimited
 	}
 }
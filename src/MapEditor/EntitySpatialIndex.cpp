@@ -0,0 +1,101 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <MapEditor/EntitySpatialIndex.hpp>
+
+namespace bw
+{
+	EntitySpatialIndex::EntitySpatialIndex(float cellSize) :
+	m_cellSize(cellSize)
+	{
+		assert(m_cellSize > 0.f);
+	}
+
+	void EntitySpatialIndex::Clear()
+	{
+		m_cells.clear();
+		m_entities.clear();
+		m_largeEntities.clear();
+	}
+
+	void EntitySpatialIndex::Insert(EntityId uniqueId, const Nz::Rectf& bounds)
+	{
+		CellRange cells = ComputeCellRange(bounds);
+		std::size_t cellCount = std::size_t(cells.last.x - cells.first.x + 1) * std::size_t(cells.last.y - cells.first.y + 1);
+
+		auto it = m_entities.find(uniqueId);
+		if (it != m_entities.end())
+		{
+			EntityData& entityData = it.value();
+
+			// Most moves don't leave the cells the entity was in
+			if (!entityData.isLarge && cellCount <= MaxCellsPerEntity && entityData.cells.first == cells.first && entityData.cells.last == cells.last)
+			{
+				entityData.bounds = bounds;
+				return;
+			}
+
+			Remove(uniqueId);
+		}
+
+		EntityData entityData;
+		entityData.bounds = bounds;
+		entityData.cells = cells;
+		entityData.isLarge = (cellCount > MaxCellsPerEntity);
+
+		if (entityData.isLarge)
+			m_largeEntities.push_back(uniqueId);
+		else
+		{
+			for (int y = cells.first.y; y <= cells.last.y; ++y)
+			{
+				for (int x = cells.first.x; x <= cells.last.x; ++x)
+					m_cells[GetCellKey(x, y)].push_back(uniqueId);
+			}
+		}
+
+		m_entities.emplace(uniqueId, entityData);
+	}
+
+	void EntitySpatialIndex::Remove(EntityId uniqueId)
+	{
+		auto it = m_entities.find(uniqueId);
+		if (it == m_entities.end())
+			return;
+
+		auto RemoveId = [&](std::vector<EntityId>& entities)
+		{
+			auto idIt = std::find(entities.begin(), entities.end(), uniqueId);
+			assert(idIt != entities.end());
+
+			// Order doesn't matter, swap with the last one
+			std::swap(*idIt, entities.back());
+			entities.pop_back();
+		};
+
+		const EntityData& entityData = it->second;
+		if (entityData.isLarge)
+			RemoveId(m_largeEntities);
+		else
+		{
+			const CellRange& cells = entityData.cells;
+			for (int y = cells.first.y; y <= cells.last.y; ++y)
+			{
+				for (int x = cells.first.x; x <= cells.last.x; ++x)
+				{
+					auto cellIt = m_cells.find(GetCellKey(x, y));
+					assert(cellIt != m_cells.end());
+
+					std::vector<EntityId>& cellEntities = cellIt.value();
+					RemoveId(cellEntities);
+
+					if (cellEntities.empty())
+						m_cells.erase(cellIt);
+				}
+			}
+		}
+
+		m_entities.erase(it);
+	}
+}
@@ -0,0 +1,71 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_MAPEDITOR_ENTITYSPATIALINDEX_HPP
+#define BURGWAR_MAPEDITOR_ENTITYSPATIALINDEX_HPP
+
+#include <CoreLib/EntityId.hpp>
+#include <Nazara/Math/Rect.hpp>
+#include <Nazara/Math/Vector2.hpp>
+#include <tsl/hopscotch_map.h>
+#include <vector>
+
+namespace bw
+{
+	// Uniform grid of entity bounds, entities are stored in every cell they overlap and moved when their bounds change
+	class EntitySpatialIndex
+	{
+		public:
+			EntitySpatialIndex(float cellSize = DefaultCellSize);
+			EntitySpatialIndex(const EntitySpatialIndex&) = default;
+			EntitySpatialIndex(EntitySpatialIndex&&) noexcept = default;
+			~EntitySpatialIndex() = default;
+
+			void Clear();
+
+			template<typename F> void ForEachEntity(const Nz::Vector2f& position, F&& func) const;
+			template<typename F> void ForEachEntity(const Nz::Rectf& rect, F&& func) const;
+
+			inline std::size_t GetEntityCount() const;
+
+			void Insert(EntityId uniqueId, const Nz::Rectf& bounds);
+
+			void Remove(EntityId uniqueId);
+
+			EntitySpatialIndex& operator=(const EntitySpatialIndex&) = default;
+			EntitySpatialIndex& operator=(EntitySpatialIndex&&) noexcept = default;
+
+			static constexpr float DefaultCellSize = 256.f;
+			static constexpr std::size_t MaxCellsPerEntity = 64;
+
+		private:
+			struct CellRange
+			{
+				Nz::Vector2i first;
+				Nz::Vector2i last;
+			};
+
+			struct EntityData
+			{
+				CellRange cells;
+				Nz::Rectf bounds;
+				bool isLarge;
+			};
+
+			inline CellRange ComputeCellRange(const Nz::Rectf& rect) const;
+
+			static inline Nz::UInt64 GetCellKey(int x, int y);
+
+			tsl::hopscotch_map<EntityId, EntityData> m_entities;
+			tsl::hopscotch_map<Nz::UInt64, std::vector<EntityId>> m_cells;
+			std::vector<EntityId> m_largeEntities; //< entities overlapping too many cells (such as tilemaps), always tested
+			float m_cellSize;
+	};
+}
+
+#include <MapEditor/EntitySpatialIndex.inl>
+
+#endif
@@ -0,0 +1,112 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <MapEditor/EntitySpatialIndex.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace bw
+{
+	template<typename F>
+	void EntitySpatialIndex::ForEachEntity(const Nz::Vector2f& position, F&& func) const
+	{
+		auto TestEntity = [&](EntityId uniqueId)
+		{
+			auto it = m_entities.find(uniqueId);
+			assert(it != m_entities.end());
+
+			if (it->second.bounds.Contains(position))
+				func(uniqueId);
+		};
+
+		int cellX = static_cast<int>(std::floor(position.x / m_cellSize));
+		int cellY = static_cast<int>(std::floor(position.y / m_cellSize));
+
+		if (auto cellIt = m_cells.find(GetCellKey(cellX, cellY)); cellIt != m_cells.end())
+		{
+			for (EntityId uniqueId : cellIt->second)
+				TestEntity(uniqueId);
+		}
+
+		for (EntityId uniqueId : m_largeEntities)
+			TestEntity(uniqueId);
+	}
+
+	template<typename F>
+	void EntitySpatialIndex::ForEachEntity(const Nz::Rectf& rect, F&& func) const
+	{
+		CellRange queryCells = ComputeCellRange(rect);
+
+		std::size_t queryCellCount = std::size_t(queryCells.last.x - queryCells.first.x + 1) * std::size_t(queryCells.last.y - queryCells.first.y + 1);
+		if (queryCellCount > m_cells.size())
+		{
+			// Rect is bigger than the populated area, testing every entity is cheaper than looking up empty cells
+			for (auto&& [uniqueId, entityData] : m_entities)
+			{
+				if (entityData.bounds.Intersect(rect))
+					func(uniqueId);
+			}
+
+			return;
+		}
+
+		for (int y = queryCells.first.y; y <= queryCells.last.y; ++y)
+		{
+			for (int x = queryCells.first.x; x <= queryCells.last.x; ++x)
+			{
+				auto cellIt = m_cells.find(GetCellKey(x, y));
+				if (cellIt == m_cells.end())
+					continue;
+
+				for (EntityId uniqueId : cellIt->second)
+				{
+					auto it = m_entities.find(uniqueId);
+					assert(it != m_entities.end());
+
+					const EntityData& entityData = it->second;
+
+					// Entities overlapping multiple cells are only reported by the first cell shared with the query
+					int firstX = std::max(queryCells.first.x, entityData.cells.first.x);
+					int firstY = std::max(queryCells.first.y, entityData.cells.first.y);
+					if (x != firstX || y != firstY)
+						continue;
+
+					if (entityData.bounds.Intersect(rect))
+						func(uniqueId);
+				}
+			}
+		}
+
+		for (EntityId uniqueId : m_largeEntities)
+		{
+			auto it = m_entities.find(uniqueId);
+			assert(it != m_entities.end());
+
+			if (it->second.bounds.Intersect(rect))
+				func(uniqueId);
+		}
+	}
+
+	inline std::size_t EntitySpatialIndex::GetEntityCount() const
+	{
+		return m_entities.size();
+	}
+
+	inline auto EntitySpatialIndex::ComputeCellRange(const Nz::Rectf& rect) const -> CellRange
+	{
+		CellRange range;
+		range.first.x = static_cast<int>(std::floor(rect.x / m_cellSize));
+		range.first.y = static_cast<int>(std::floor(rect.y / m_cellSize));
+		range.last.x = static_cast<int>(std::floor((rect.x + rect.width) / m_cellSize));
+		range.last.y = static_cast<int>(std::floor((rect.y + rect.height) / m_cellSize));
+
+		return range;
+	}
+
+	inline Nz::UInt64 EntitySpatialIndex::GetCellKey(int x, int y)
+	{
+		return (Nz::UInt64(Nz::UInt32(x)) << 32) | Nz::UInt32(y);
+	}
+}
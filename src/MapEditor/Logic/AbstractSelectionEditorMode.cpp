@@ -37,18 +37,15 @@ namespace bw
 				LayerVisualEntity* bestEntity = nullptr;
 				float bestEntityArea = std::numeric_limits<float>::infinity();
 
-				layer->ForEachVisualEntity([&](LayerVisualEntity& entity)
+				layer->ForEachVisualEntityOnRay(ray, [&](LayerVisualEntity& entity)
 				{
 					const Nz::Boxf& box = entity.GetGlobalBounds();
 
-					if (ray.Intersect(box))
+					float entityArea = box.width * box.height;
+					if (entityArea < bestEntityArea)
 					{
-						float entityArea = box.width * box.height;
-						if (entityArea < bestEntityArea)
-						{
-							bestEntity = &entity;
-							bestEntityArea = entityArea;
-						}
+						bestEntity = &entity;
+						bestEntityArea = entityArea;
 					}
 				});
 
@@ -46,6 +46,8 @@ namespace bw
 			if (!entity->HasComponent<VisibleLayerComponent>())
 				entity->AddComponent<VisibleLayerComponent>(mapCanvas.GetWorld());
 
+			mapCanvas.LoadLayer(layerIndex);
+
 			auto& visibleLayer = entity->GetComponent<VisibleLayerComponent>();
 			visibleLayer.RegisterVisibleLayer(mapCanvas.GetCamera(), mapCanvas.GetLayer(layerIndex), renderOrder, scale, parallaxFactor);
 		});	}
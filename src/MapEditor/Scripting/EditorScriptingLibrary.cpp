@@ -3,7 +3,9 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <MapEditor/Scripting/EditorScriptingLibrary.hpp>
+#include <CoreLib/Components/ScriptComponent.hpp>
 #include <CoreLib/Scripting/ScriptingContext.hpp>
+#include <CoreLib/Scripting/ScriptingUtils.hpp>
 #include <ClientLib/Utility/TileMapData.hpp>
 #include <MapEditor/Logic/TileMapEditorMode.hpp>
 #include <MapEditor/Widgets/EditorWindow.hpp>
@@ -146,5 +148,45 @@ namespace bw
 			QPoint mousePosition = mapCanvas.mapFromGlobal(QCursor::pos());
 			return mapCanvas.GetCamera().Unproject(Nz::Vector2f(mousePosition.x(), mousePosition.y()));
 		};
+
+		auto CallbackWithEntity = [this](const sol::protected_function& callback, LayerVisualEntity& visualEntity)
+		{
+			const Ndk::EntityHandle& entity = visualEntity.GetEntity();
+			if (!entity->HasComponent<ScriptComponent>())
+				return;
+
+			auto callbackResult = callback(entity->GetComponent<ScriptComponent>().GetTable());
+			if (!callbackResult.valid())
+			{
+				sol::error err = callbackResult;
+				bwLog(GetLogger(), LogLevel::Error, "editor entity query callback failed: {}", err.what());
+			}
+		};
+
+		library["QueryEntitiesAt"] = LuaFunction([this, CallbackWithEntity](sol::this_state L, LayerIndex layer, const Nz::Vector2f& position, const sol::protected_function& callback)
+		{
+			MapCanvas& mapCanvas = GetMapCanvas();
+			if (layer >= mapCanvas.GetLayerCount())
+				TriggerLuaArgError(L, 1, "invalid layer index");
+
+			mapCanvas.LoadLayer(layer);
+			mapCanvas.GetLayer(layer).ForEachVisualEntityAt(position, [&](LayerVisualEntity& visualEntity)
+			{
+				CallbackWithEntity(callback, visualEntity);
+			});
+		});
+
+		library["QueryEntitiesInRect"] = LuaFunction([this, CallbackWithEntity](sol::this_state L, LayerIndex layer, const Nz::Rectf& rect, const sol::protected_function& callback)
+		{
+			MapCanvas& mapCanvas = GetMapCanvas();
+			if (layer >= mapCanvas.GetLayerCount())
+				TriggerLuaArgError(L, 1, "invalid layer index");
+
+			mapCanvas.LoadLayer(layer);
+			mapCanvas.GetLayer(layer).ForEachVisualEntityInRect(rect, [&](LayerVisualEntity& visualEntity)
+			{
+				CallbackWithEntity(callback, visualEntity);
+			});
+		});
 	}
 }
@@ -22,6 +22,7 @@
 #include <MapEditor/Widgets/FileDescDialog.hpp>
 #include <MapEditor/Widgets/PlayWindow.hpp>
 #include <NDK/Components/NodeComponent.hpp>
+#include <QtCore/QCoreApplication>
 #include <QtCore/QSettings>
 #include <QtCore/QStringBuilder>
 #include <QtGui/QKeyEvent>
@@ -33,6 +34,7 @@
 #include <QtWidgets/QHBoxLayout>
 #include <QtWidgets/QMenuBar>
 #include <QtWidgets/QMessageBox>
+#include <QtWidgets/QProgressBar>
 #include <QtWidgets/QPushButton>
 #include <QtWidgets/QStatusBar>
 #include <QtWidgets/QTabWidget>
@@ -59,11 +61,17 @@ namespace bw
 	m_playWindow(nullptr),
 	m_configFile(*this),
 	m_prefabs(this),
-	m_mapDirtyFlag(false)
+	m_mapRevision(0),
+	m_pendingMapTaskCount(0),
+	m_mapDirtyFlag(false),
+	m_mapWorker(1, "MapWriter")
 	{
 		if (!m_configFile.LoadFromFile("editorconfig.lua"))
 			throw std::runtime_error("failed to load config file");
 
+		m_assetHashCache.emplace(GetLogger(), m_config.GetStringValue("Resources.AssetHashManifest"));
+		m_assetHashCache->Load();
+
 		Ndk::InitializeComponent<CanvasComponent>("CanvsCmp");
 
 		LoadMods();
@@ -188,11 +196,19 @@ namespace bw
 		m_showColliders->setChecked(settings.value(settings_showColliders, false).toBool());
 		m_showGrid->setChecked(settings.value(settings_showGrid, true).toBool());
 
+		m_mapTaskProgress = new QProgressBar;
+		m_mapTaskProgress->setMaximumWidth(250);
+		m_mapTaskProgress->hide();
+		statusBar()->addPermanentWidget(m_mapTaskProgress);
+
 		statusBar()->showMessage(tr("Ready"), 0);
 	}
 
 	EditorWindow::~EditorWindow()
 	{
+		// Don't interrupt a save in progress
+		m_mapWorker.WaitForAll();
+
 		m_currentMode->OnLeave();
 		m_currentMode.reset();
 
@@ -232,10 +248,9 @@ namespace bw
 
 	Map::Entity EditorWindow::DeleteEntity(EntityId entityId)
 	{
-		const auto& layerEntity = m_canvas->RetrieveLayerEntityByUniqueId(entityId);
-		assert(layerEntity);
+		const Map::EntityIndices& indices = m_workingMap.GetEntityIndices(entityId);
 
-		if (m_currentLayer == layerEntity->GetLayerIndex())
+		if (m_currentLayer == indices.layerIndex)
 		{
 			std::size_t entityIndex;
 			{
@@ -246,9 +261,8 @@ namespace bw
 			}
 
 			delete m_entityList.listWidget->takeItem(int(entityIndex));
-			EntityId uniqueId = layerEntity->GetUniqueId();
 
-			m_entityIndices.erase(uniqueId);
+			m_entityIndices.erase(entityId);
 
 			// FIXME...
 			for (auto it = m_entityIndices.begin(); it != m_entityIndices.end(); ++it)
@@ -396,9 +410,10 @@ namespace bw
 		contextMenu.exec(pos);
 	}
 
-	void EditorWindow::PushCommand(QUndoCommand* command)
+	void EditorWindow::PushCommand(Commands::EditorCommand* command)
 	{
-		m_undoStack.push(command);
+		m_undoStack.push(command); //< command may be merged and deleted
+		TrimUndoHistory();
 	}
 
 	void EditorWindow::RefreshEntityPositionAndRotation(LayerIndex layerIndex, std::size_t entityIndex)
@@ -534,10 +549,17 @@ namespace bw
 		QListWidgetItem* item = m_entityList.listWidget->item(int(entityIndex));
 		assert(item);
 
-		if (updateFlags & (EntityInfoUpdate::EntityClass | EntityInfoUpdate::Properties))
+		// Only recreate the entity when it cannot be updated in place (a class change or properties without a PropertyChanged callback)
+		bool recreateEntity = false;
+		if (updateFlags & EntityInfoUpdate::EntityClass)
+			recreateEntity = true;
+		else if (updateFlags & EntityInfoUpdate::Properties)
+			recreateEntity = !m_canvas->UpdateEntityProperties(mapEntity.uniqueId, mapEntity.properties);
+
+		if (recreateEntity)
 		{
 			m_canvas->DeleteEntity(mapEntity.uniqueId);
-			m_canvas->CreateEntity(layerIndex, mapEntity.uniqueId, mapEntity.entityType, mapEntity.position, mapEntity.rotation, mapEntity.properties)->GetId();
+			m_canvas->CreateEntity(layerIndex, mapEntity.uniqueId, mapEntity.entityType, mapEntity.position, mapEntity.rotation, mapEntity.properties);
 		}
 		else if (updateFlags & EntityInfoUpdate::PositionRotation)
 			m_canvas->UpdateEntityPositionAndRotation(mapEntity.uniqueId, mapEntity.position, mapEntity.rotation);
@@ -567,6 +589,7 @@ namespace bw
 		m_currentLayer.reset();
 		m_workingMap = std::move(map);
 		m_workingMapPath = std::move(mapPath);
+		m_mapRevision++;
 		m_mapDirtyFlag = false;
 
 		// Reset entity info dialog (as it depends on the map)
@@ -607,7 +630,10 @@ namespace bw
 	void EditorWindow::closeEvent(QCloseEvent* event)
 	{
 		if (CanCloseMap())
+		{
+			WaitForMapTasks();
 			event->accept();
+		}
 		else
 			event->ignore();
 	}
@@ -699,47 +725,75 @@ namespace bw
 
 	void EditorWindow::BuildAssetList()
 	{
-		Map& map = GetWorkingMapMut();
+		auto mapSnapshot = std::make_shared<Map>(m_workingMap);
+		std::filesystem::path assetFolder = std::filesystem::u8path(m_config.GetStringValue("Resources.AssetDirectory"));
+		std::filesystem::path mapPath = m_workingMapPath;
+		std::size_t mapRevision = m_mapRevision;
+		QString progressText = tr("Hashing assets");
+
+		StartMapTask(progressText);
+		m_mapWorker.PushTask([this, mapSnapshot, assetFolder, mapPath, mapRevision, progressText]
+		{
+			std::vector<Map::Asset> assets = BuildAssetList(*mapSnapshot, assetFolder, [&](std::size_t processedFileCount, std::size_t fileCount)
+			{
+				ReportMapTaskProgress(progressText, processedFileCount, fileCount);
+			});
+
+			QMetaObject::invokeMethod(this, [this, assets = std::move(assets), mapPath, mapRevision]() mutable
+			{
+				StopMapTask();
 
+				if (UpdateAssetList(std::move(assets), mapRevision, mapPath))
+					statusBar()->showMessage(tr("Asset list rebuilt"), 3000);
+				else
+					statusBar()->showMessage(tr("Map was modified while hashing assets, asset list was not updated"), 5000);
+			}, Qt::QueuedConnection);
+		});
+	}
+
+	std::vector<Map::Asset> EditorWindow::BuildAssetList(Map& map, const std::filesystem::path& assetFolder, const FileHashCache::ProgressCallback& progressCallback)
+	{
+		// Runs on the map worker thread, only the (thread-safe) hash cache and logger are used
 		tsl::hopscotch_set<std::string> textures;
 		map.ForeachEntityPropertyValue<PropertyType::Texture>([&](Map::Entity& /*entity*/, const std::string& /*name*/, const std::string& texturePath)
 		{
 			textures.insert(texturePath);
 		});
 
-		std::filesystem::path gameResourceFolder = std::filesystem::u8path(m_config.GetStringValue("Resources.AssetDirectory"));
+		std::vector<std::string> texturePaths(textures.begin(), textures.end());
+		std::sort(texturePaths.begin(), texturePaths.end());
 
-		std::vector<Map::Asset>& assets = map.GetAssets();
-		assets.clear();
+		std::vector<std::filesystem::path> fullPaths;
+		fullPaths.reserve(texturePaths.size());
+		for (const std::string& texturePath : texturePaths)
+			fullPaths.push_back(assetFolder / std::filesystem::u8path(texturePath));
 
-		auto hash = Nz::AbstractHash::Get(Nz::HashType_SHA1);
+		auto fileHashes = m_assetHashCache->ComputeHashes(fullPaths, progressCallback);
 
-		for (const std::string& texturePath : textures)
-		{
-			std::filesystem::path fullPath = gameResourceFolder / std::filesystem::u8path(texturePath);
+		std::vector<Map::Asset> assets;
+		assets.reserve(texturePaths.size());
 
+		for (std::size_t i = 0; i < texturePaths.size(); ++i)
+		{
 			auto& asset = assets.emplace_back();
-			asset.filepath = texturePath;
+			asset.filepath = texturePaths[i];
 
-			if (std::filesystem::is_regular_file(fullPath))
+			if (const auto& fileHash = fileHashes[i])
 			{
-				asset.size = std::filesystem::file_size(fullPath);
+				asset.size = fileHash->size;
 
-				Nz::ByteArray assetHash = Nz::File::ComputeHash(hash.get(), fullPath.generic_u8string());
-				assert(assetHash.GetSize() == asset.sha1Checksum.size());
-
-				std::memcpy(asset.sha1Checksum.data(), assetHash.GetConstBuffer(), assetHash.GetSize());
+				assert(fileHash->checksum.GetSize() == asset.sha1Checksum.size());
+				std::memcpy(asset.sha1Checksum.data(), fileHash->checksum.GetConstBuffer(), fileHash->checksum.GetSize());
 			}
 			else
-				bwLog(GetLogger(), LogLevel::Error, "Texture not found: {0}", fullPath.generic_u8string());
+				bwLog(GetLogger(), LogLevel::Error, "Texture not found: {0}", fullPaths[i].generic_u8string());
 		}
 
-		std::sort(assets.begin(), assets.end(), [&](const Map::Asset& lhs, const Map::Asset& rhs)
-		{
-			return lhs.filepath < rhs.filepath;
-		});
+		m_assetHashCache->Save();
 
 		bwLog(GetLogger(), LogLevel::Info, "Finished building assets");
+
+		return assets;
 	}
 
 	void EditorWindow::BuildEntityList(const std::string& editorAssetsFolder)
@@ -1048,6 +1102,10 @@ namespace bw
 			// Save before exit
 			if (!SaveMap())
 				return false; //< Save failed, do not close
+
+			WaitForMapTasks();
+			if (m_mapDirtyFlag)
+				return false; //< Save failed (or was cancelled), do not close
 		}
 
 		return true;
@@ -1064,6 +1122,7 @@ namespace bw
 	void EditorWindow::InvalidateMap()
 	{
 		m_mapDirtyFlag = true;
+		m_mapRevision++;
 		m_saveMapToolbar->setEnabled(true);
 	}
 
@@ -1145,16 +1204,41 @@ namespace bw
 		if (!fileName.endsWith(".bmap"))
 			fileName += ".bmap";
 
-		if (QMessageBox::question(this, tr("Build asset list?"), tr("Do you want to rebuild asset list before compiling map?"), QMessageBox::Yes | QMessageBox::No) == QMessageBox::Yes)
-			BuildAssetList();
+		bool rebuildAssets = (QMessageBox::question(this, tr("Build asset list?"), tr("Do you want to rebuild asset list before compiling map?"), QMessageBox::Yes | QMessageBox::No) == QMessageBox::Yes);
 
-		Map scriptedMap = GetWorkingMap();
-		AddScriptsToMap(scriptedMap);
+		// Scripts are read from the map folder here, hashing and compression happen on the map worker
+		auto scriptedMap = std::make_shared<Map>(GetWorkingMap());
+		AddScriptsToMap(*scriptedMap);
 
-		if (scriptedMap.Compile(fileName.toStdString()))
-			QMessageBox::information(this, tr("Compilation succeeded"), tr("Map has been successfully compiled"), QMessageBox::Ok);
-		else
-			QMessageBox::critical(this, tr("Failed to compile map"), tr("Map failed to compile"), QMessageBox::Ok);
+		std::filesystem::path assetFolder = std::filesystem::u8path(m_config.GetStringValue("Resources.AssetDirectory"));
+		std::filesystem::path mapPath = m_workingMapPath;
+		std::filesystem::path outputPath = fileName.toStdString();
+		std::size_t mapRevision = m_mapRevision;
+		QString compileText = tr("Compiling map");
+		QString hashText = tr("Hashing assets");
+
+		StartMapTask(compileText);
+		m_mapWorker.PushTask([this, scriptedMap, assetFolder, mapPath, mapRevision, outputPath, rebuildAssets, compileText, hashText]
+		{
+			std::optional<std::vector<Map::Asset>> assets;
+			if (rebuildAssets)
+			{
+				assets = BuildAssetList(*scriptedMap, assetFolder, [&](std::size_t processedFileCount, std::size_t fileCount)
+				{
+					ReportMapTaskProgress(hashText, processedFileCount, fileCount);
+				});
+
+				scriptedMap->GetAssets() = *assets;
+			}
+
+			ReportMapTaskProgress(compileText, 0, 0);
+			bool success = scriptedMap->Compile(outputPath);
+
+			QMetaObject::invokeMethod(this, [this, success, assets = std::move(assets), mapPath, mapRevision]() mutable
+			{
+				OnMapCompiled(success, std::move(assets), mapRevision, mapPath);
+			}, Qt::QueuedConnection);
+		});
 	}
 
 	void EditorWindow::OnCreateEntity()
@@ -1484,6 +1568,42 @@ namespace bw
 		PushCommand<Commands::LayerSwap>(oldPosition, newPosition);
 	}
 
+	void EditorWindow::OnMapCompiled(bool success, std::optional<std::vector<Map::Asset>> assets, std::size_t mapRevision, const std::filesystem::path& mapPath)
+	{
+		StopMapTask();
+
+		// The compiled map has its own copy of the assets list, only the working map may be outdated
+		if (assets && !UpdateAssetList(std::move(*assets), mapRevision, mapPath))
+			statusBar()->showMessage(tr("Map was modified while compiling, asset list was not updated"), 5000);
+
+		if (success)
+			QMessageBox::information(this, tr("Compilation succeeded"), tr("Map has been successfully compiled"), QMessageBox::Ok);
+		else
+			QMessageBox::critical(this, tr("Failed to compile map"), tr("Map failed to compile"), QMessageBox::Ok);
+	}
+
+	void EditorWindow::OnMapSaved(bool success, std::size_t mapRevision)
+	{
+		StopMapTask();
+
+		if (success)
+		{
+			// The map may have been edited while it was being saved
+			if (mapRevision == m_mapRevision)
+			{
+				m_mapDirtyFlag = false;
+				m_saveMapToolbar->setEnabled(false);
+			}
+
+			statusBar()->showMessage(tr("Map saved"), 3000);
+		}
+		else
+		{
+			QMessageBox::warning(this, tr("Failed to save map"), tr("Failed to save map (is map folder read-only?)"), QMessageBox::Ok);
+			statusBar()->showMessage(tr("Failed to save map"), 5000);
+		}
+	}
+
 	void EditorWindow::OnMoveEntity(std::size_t entityIndex, LayerIndex targetLayer)
 	{
 		assert(m_currentLayer);
@@ -1634,6 +1754,47 @@ namespace bw
 		m_entityIndices.emplace(entity.uniqueId, entityIndex);
 	}
 
+	void EditorWindow::ReportMapTaskProgress(QString text, std::size_t current, std::size_t total)
+	{
+		// Can be called from the map worker thread
+		QMetaObject::invokeMethod(this, [this, text = std::move(text), current, total]
+		{
+			if (m_pendingMapTaskCount == 0)
+				return;
+
+			if (total > 0)
+				m_mapTaskProgress->setFormat(text + QStringLiteral(" (%v/%m)"));
+			else
+				m_mapTaskProgress->setFormat(text);
+
+			m_mapTaskProgress->setRange(0, int(total));
+			m_mapTaskProgress->setValue(int(current));
+		}, Qt::QueuedConnection);
+	}
+
+	void EditorWindow::TrimUndoHistory()
+	{
+		constexpr std::size_t MiB = 1024 * 1024;
+
+		std::size_t memoryLimit = m_configFile.GetIntegerValue<std::size_t>("EditorSettings.UndoMemoryLimit") * MiB;
+		if (memoryLimit == 0)
+			return;
+
+		// Discard oldest commands once history exceeds the memory limit, most recent command is always kept
+		std::size_t memoryUsage = 0;
+		for (int i = m_undoStack.count() - 1; i >= 0; --i)
+		{
+			// Commands are owned by the undo stack which only gives const access to them
+			auto* command = static_cast<Commands::EditorCommand*>(const_cast<QUndoCommand*>(m_undoStack.command(i)));
+			if (command->IsDiscarded())
+				break; //< older commands were discarded as well
+
+			memoryUsage += command->GetMemoryUsage();
+			if (memoryUsage > memoryLimit && i != m_undoStack.count() - 1)
+				command->Discard();
+		}
+	}
+
 	bool EditorWindow::SaveMap()
 	{
 		if (m_workingMapPath.empty())
@@ -1669,38 +1830,68 @@ namespace bw
 			AddToRecentFileList(workingPath);
 		}
 
-		if (m_workingMap.Save(m_workingMapPath))
+		// Save a snapshot of the map in the background, editing can continue meanwhile
+		auto mapSnapshot = std::make_shared<const Map>(m_workingMap);
+		std::filesystem::path mapPath = m_workingMapPath;
+		std::size_t mapRevision = m_mapRevision;
+
+		StartMapTask(tr("Saving map"));
+		m_mapWorker.PushTask([this, mapSnapshot, mapPath, mapRevision]
 		{
-			m_mapDirtyFlag = false;
-			m_saveMapToolbar->setEnabled(false);
+			bool success = mapSnapshot->Save(mapPath);
 
-			statusBar()->showMessage(tr("Map saved"), 3000);
+			QMetaObject::invokeMethod(this, [this, success, mapRevision]
+			{
+				OnMapSaved(success, mapRevision);
+			}, Qt::QueuedConnection);
+		});
 
-			return true;
-		}
-		else
-		{
-			QMessageBox::warning(this, tr("Failed to save map"), tr("Failed to save map (is map folder read-only?)"), QMessageBox::Ok);
-			statusBar()->showMessage(tr("Failed to save map"), 5000);
+		return true;
+	}
 
-			return false;
-		}
+	void EditorWindow::StartMapTask(const QString& text)
+	{
+		m_pendingMapTaskCount++;
+
+		m_mapTaskProgress->setFormat(text);
+		m_mapTaskProgress->setRange(0, 0); //< busy indicator until progress is reported
+		m_mapTaskProgress->show();
+	}
+
+	void EditorWindow::StopMapTask()
+	{
+		assert(m_pendingMapTaskCount > 0);
+		if (--m_pendingMapTaskCount == 0)
+			m_mapTaskProgress->hide();
+	}
+
+	void EditorWindow::WaitForMapTasks()
+	{
+		m_mapWorker.WaitForAll();
+
+		// Handle completion notifications right away
+		QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
 	}
 
 	void EditorWindow::RebuildCanvas()
 	{
 		m_canvas->Clear();
 
+		// Layers are instantiated lazily, when they become active or visible from another layer
 		m_canvas->ResetLayers(m_workingMap.GetLayerCount());
-		for (std::size_t i = 0; i < m_workingMap.GetLayerCount(); ++i)
-		{
-			const auto& layer = m_workingMap.GetLayer(LayerIndex(i));
+		m_canvas->UpdateActiveLayer(m_currentLayer);
+	}
 
-			for (const auto& entity : layer.entities)
-				m_canvas->CreateEntity(LayerIndex(i), entity.uniqueId, entity.entityType, entity.position, entity.rotation, entity.properties);
-		}
+	bool EditorWindow::UpdateAssetList(std::vector<Map::Asset> assets, std::size_t mapRevision, const std::filesystem::path& mapPath)
+	{
+		// Assets were computed from a snapshot, drop them if the map was edited or replaced since
+		if (mapRevision != m_mapRevision || mapPath != m_workingMapPath)
+			return false;
 
-		m_canvas->UpdateActiveLayer(m_currentLayer);
+		m_workingMap.GetAssets() = std::move(assets);
+		InvalidateMap();
+
+		return true;
 	}
 
 	void EditorWindow::UpdateEntityListButtons()
@@ -9,7 +9,9 @@
 
 #include <NDK/Prerequisites.hpp>
 #include <CoreLib/BurgApp.hpp>
+#include <CoreLib/FileHashCache.hpp>
 #include <CoreLib/Map.hpp>
+#include <CoreLib/Utility/ThreadPool.hpp>
 #include <ClientLib/ClientEditorApp.hpp>
 #include <MapEditor/EditorAppConfig.hpp>
 #include <MapEditor/Enums.hpp>
@@ -25,6 +27,7 @@
 class QAction;
 class QListWidget;
 class QListWidgetItem;
+class QProgressBar;
 class QPushButton;
 class QTabWidget;
 
@@ -37,6 +40,11 @@ namespace bw
 	class ScriptingContext;
 	class VirtualDirectory;
 
+	namespace Commands
+	{
+		class EditorCommand;
+	}
+
 	class EditorWindow : public ClientEditorApp, public QMainWindow
 	{
 		public:
@@ -68,7 +76,7 @@ namespace bw
 
 			void OpenEntityContextMenu(std::optional<std::size_t> entityIndexOpt, const QPoint& pos, QWidget* parent = nullptr);
 
-			void PushCommand(QUndoCommand* command);
+			void PushCommand(Commands::EditorCommand* command);
 			template<typename T, typename... Args> void PushCommand(Args&&... args);
 			void RefreshEntityPositionAndRotation(LayerIndex layerIndex, std::size_t entityIndex);
 
@@ -95,6 +103,7 @@ namespace bw
 			void AlignLayerEntities(LayerIndex layerIndex);
 
 			void BuildAssetList();
+			std::vector<Map::Asset> BuildAssetList(Map& map, const std::filesystem::path& assetFolder, const FileHashCache::ProgressCallback& progressCallback);
 			void BuildEntityList(const std::string& editorAssetsFolder);
 			void BuildLayerList(const std::string& editorAssetsFolder);
 			void BuildMenu();
@@ -126,6 +135,8 @@ namespace bw
 			void OnLayerChanged(int layerIndex);
 			void OnLayerMovedDown();
 			void OnLayerMovedUp();
+			void OnMapCompiled(bool success, std::optional<std::vector<Map::Asset>> assets, std::size_t mapRevision, const std::filesystem::path& mapPath);
+			void OnMapSaved(bool success, std::size_t mapRevision);
 			void OnMoveEntity(std::size_t entityIndex, LayerIndex targetLayer);
 			void OnOpenMap();
 			void OnOpenRecentMap();
@@ -140,6 +151,7 @@ namespace bw
 
 			void RebuildCanvas();
 
+			bool UpdateAssetList(std::vector<Map::Asset> assets, std::size_t mapRevision, const std::filesystem::path& mapPath);
 			void UpdateEntityListButtons();
 			void UpdateLayerListButtons();
 			void RefreshLayerList();
@@ -148,8 +160,16 @@ namespace bw
 
 			void RegisterEntity(std::size_t entityIndex);
 
+			void ReportMapTaskProgress(QString text, std::size_t current, std::size_t total);
+
+			void TrimUndoHistory();
+
 			bool SaveMap();
 
+			void StartMapTask(const QString& text);
+			void StopMapTask();
+			void WaitForMapTasks();
+
 			struct List
 			{
 				QListWidget* listWidget;
@@ -178,6 +198,7 @@ namespace bw
 			QAction* m_showGrid;
 			QMenu* m_layerMenu;
 			QMenu* m_mapMenu;
+			QProgressBar* m_mapTaskProgress;
 			QTabWidget* m_centralTab;
 			QUndoStack m_undoStack;
 			EntityInfoDialog* m_entityInfoDialog;
@@ -186,7 +207,11 @@ namespace bw
 			EditorAppConfig m_configFile;
 			EditorWindowPrefabs m_prefabs;
 			Map m_workingMap;
+			std::optional<FileHashCache> m_assetHashCache;
+			std::size_t m_mapRevision;
+			std::size_t m_pendingMapTaskCount;
 			bool m_mapDirtyFlag;
+			ThreadPool m_mapWorker; //< last member so in-flight tasks finish before anything else is destroyed
 	};
 }
 
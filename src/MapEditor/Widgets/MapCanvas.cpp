@@ -103,6 +103,11 @@ namespace bw
 	{
 		assert(layerIndex < m_layers.size());
 		auto& layer = m_layers[layerIndex];
+
+		// Entities of layers which are not loaded yet will be instantiated from the working map when needed
+		if (!layer.IsLoaded())
+			return Ndk::EntityHandle::InvalidHandle;
+
 		return layer.CreateEntity(uniqueId, entityClass, position, rotation, properties).GetEntity();
 	}
 
@@ -229,6 +234,12 @@ namespace bw
 		return *m_weaponStore;
 	}
 
+	void MapCanvas::LoadLayer(LayerIndex layerIndex)
+	{
+		assert(layerIndex < m_layers.size());
+		m_layers[layerIndex].Load(m_editor.GetWorkingMap().GetLayer(layerIndex));
+	}
+
 	void MapCanvas::ReloadScripts()
 	{
 		if (!m_scriptingContext)
@@ -359,7 +370,7 @@ namespace bw
 
 			if (layerIndex)
 			{
-				assert(layerIndex < m_layers.size());
+				LoadLayer(*layerIndex);
 				visibleLayer.RegisterVisibleLayer(GetCamera(), m_layers[*layerIndex], 0, Nz::Vector2f::Unit(), Nz::Vector2f::Unit());
 			}
 
@@ -371,7 +382,8 @@ namespace bw
 	void MapCanvas::UpdateEntityPositionAndRotation(EntityId entityId, const Nz::Vector2f& position, const Nz::DegreeAnglef& rotation)
 	{
 		auto it = m_entitiesByUniqueId.find(entityId);
-		assert(it != m_entitiesByUniqueId.end());
+		if (it == m_entitiesByUniqueId.end())
+			return; //< entity layer is not loaded
 
 		LayerVisualEntity& layerVisual = *it->second;
 
@@ -381,6 +393,8 @@ namespace bw
 
 		layerVisual.SyncVisuals();
 
+		GetLayer(layerVisual.GetLayerIndex()).RefreshEntityBounds(entityId);
+
 		// Refresh gizmo if an entity it uses has been updated
 		if (m_entityGizmo)
 		{
@@ -396,6 +410,18 @@ namespace bw
 		}
 	}
 
+	bool MapCanvas::UpdateEntityProperties(EntityId entityId, PropertyValueMap properties)
+	{
+		auto it = m_entitiesByUniqueId.find(entityId);
+		if (it == m_entitiesByUniqueId.end())
+			return true; //< entity layer is not loaded, it will use the new properties when instantiated
+
+		LayerIndex layerIndex = it->second->GetLayerIndex();
+		assert(layerIndex < m_layers.size());
+
+		return m_layers[layerIndex].UpdateEntityProperties(entityId, std::move(properties));
+	}
+
 	void MapCanvas::OnKeyPressed(const Nz::WindowEvent::KeyEvent& key)
 	{
 		switch (key.virtualKey)
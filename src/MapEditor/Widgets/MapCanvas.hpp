@@ -64,6 +64,8 @@ namespace bw
 			ClientWeaponStore& GetWeaponStore() override;
 			const ClientWeaponStore& GetWeaponStore() const override;
 
+			void LoadLayer(LayerIndex layerIndex);
+
 			void ReloadScripts();
 			void ResetLayers(std::size_t layerCount);
 
@@ -75,6 +77,7 @@ namespace bw
 
 			void UpdateActiveLayer(std::optional<LayerIndex> layerIndex);
 			void UpdateEntityPositionAndRotation(EntityId entityId, const Nz::Vector2f& position, const Nz::DegreeAnglef& rotation);
+			bool UpdateEntityProperties(EntityId entityId, PropertyValueMap properties);
 
 			NazaraSignal(OnCameraZoomFactorUpdated, MapCanvas* /*emitter*/, float /*zoomFactor*/);
 			NazaraSignal(OnCanvasMouseButtonPressed, MapCanvas* /*emitter*/, const Nz::WindowEvent::MouseButtonEvent& /*mouseButton*/);
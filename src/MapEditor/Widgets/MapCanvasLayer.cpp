@@ -3,16 +3,19 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <MapEditor/Widgets/MapCanvasLayer.hpp>
+#include <CoreLib/Components/ScriptComponent.hpp>
 #include <ClientLib/Components/VisualComponent.hpp>
 #include <MapEditor/Components/CanvasComponent.hpp>
 #include <MapEditor/Widgets/MapCanvas.hpp>
+#include <Nazara/Math/Algorithm.hpp>
 #include <NDK/Components/NodeComponent.hpp>
 
 namespace bw
 {
 	MapCanvasLayer::MapCanvasLayer(MapCanvas& mapCanvas, LayerIndex layerIndex) :
 	ClientEditorLayer(mapCanvas, layerIndex),
-	m_mapCanvas(mapCanvas)
+	m_mapCanvas(mapCanvas),
+	m_isLoaded(false)
 	{
 	}
 
@@ -53,6 +56,7 @@ namespace bw
 
 		LayerVisualEntity& visualEntity = it.value();
 		m_mapCanvas.RegisterEntity(uniqueId, visualEntity.CreateHandle());
+		m_spatialIndex.Insert(uniqueId, ToRect(visualEntity.GetGlobalBounds()));
 
 		OnEntityVisualCreated(this, visualEntity);
 
@@ -68,6 +72,7 @@ namespace bw
 		OnEntityVisualDelete(this, it.value());
 
 		m_layerEntities.erase(it);
+		m_spatialIndex.Remove(uniqueId);
 		m_mapCanvas.UnregisterEntity(uniqueId);
 	}
 
@@ -77,8 +82,118 @@ namespace bw
 			func(it.value());
 	}
 
+	void MapCanvasLayer::ForEachVisualEntityAt(const Nz::Vector2f& position, const std::function<void(LayerVisualEntity& visualEntity)>& func)
+	{
+		m_spatialIndex.ForEachEntity(position, [&](EntityId uniqueId)
+		{
+			auto it = m_layerEntities.find(uniqueId);
+			assert(it != m_layerEntities.end());
+
+			func(it.value());
+		});
+	}
+
+	void MapCanvasLayer::ForEachVisualEntityInRect(const Nz::Rectf& rect, const std::function<void(LayerVisualEntity& visualEntity)>& func)
+	{
+		m_spatialIndex.ForEachEntity(rect, [&](EntityId uniqueId)
+		{
+			auto it = m_layerEntities.find(uniqueId);
+			assert(it != m_layerEntities.end());
+
+			func(it.value());
+		});
+	}
+
+	void MapCanvasLayer::ForEachVisualEntityOnRay(const Nz::Rayf& ray, const std::function<void(LayerVisualEntity& visualEntity)>& func)
+	{
+		// The editor camera looks along the Z axis, so the ray only crosses the layer plane at one point
+		if (Nz::NumberEquals(ray.direction.z, 0.f))
+		{
+			ForEachVisualEntity([&](LayerVisualEntity& visualEntity)
+			{
+				if (ray.Intersect(visualEntity.GetGlobalBounds()))
+					func(visualEntity);
+			});
+			return;
+		}
+
+		float distance = -ray.origin.z / ray.direction.z;
+		Nz::Vector3f layerPosition = ray.GetPoint(distance);
+
+		ForEachVisualEntityAt(Nz::Vector2f(layerPosition.x, layerPosition.y), [&](LayerVisualEntity& visualEntity)
+		{
+			if (ray.Intersect(visualEntity.GetGlobalBounds()))
+				func(visualEntity);
+		});
+	}
+
 	bool MapCanvasLayer::IsEnabled() const
 	{
 		return true;
 	}
+
+	void MapCanvasLayer::Load(const Map::Layer& layerData)
+	{
+		if (m_isLoaded)
+			return;
+
+		// Set first as entities may display this layer (through a visible layer) during their initialization
+		m_isLoaded = true;
+
+		for (const Map::Entity& entity : layerData.entities)
+			CreateEntity(entity.uniqueId, entity.entityType, entity.position, entity.rotation, entity.properties);
+	}
+
+	void MapCanvasLayer::RefreshEntityBounds(EntityId uniqueId)
+	{
+		auto it = m_layerEntities.find(uniqueId);
+		if (it == m_layerEntities.end())
+			return;
+
+		m_spatialIndex.Insert(uniqueId, ToRect(it.value().GetGlobalBounds()));
+	}
+
+	bool MapCanvasLayer::UpdateEntityProperties(EntityId uniqueId, PropertyValueMap properties)
+	{
+		auto it = m_layerEntities.find(uniqueId);
+		if (it == m_layerEntities.end())
+			return false;
+
+		const Ndk::EntityHandle& entity = it.value().GetEntity();
+		if (!entity->HasComponent<ScriptComponent>())
+			return false;
+
+		auto& scriptComponent = entity->GetComponent<ScriptComponent>();
+
+		std::vector<std::string> updatedProperties;
+
+		const PropertyValueMap& currentProperties = scriptComponent.GetProperties();
+		for (auto&& [propertyName, propertyValue] : currentProperties)
+		{
+			auto newIt = properties.find(propertyName);
+			if (newIt == properties.end() || newIt->second != propertyValue)
+				updatedProperties.push_back(propertyName);
+		}
+
+		for (auto&& [propertyName, propertyValue] : properties)
+		{
+			if (currentProperties.find(propertyName) == currentProperties.end())
+				updatedProperties.push_back(propertyName);
+		}
+
+		if (updatedProperties.empty())
+			return true;
+
+		// Entities which cannot react to a property change have to be instantiated again
+		if (!scriptComponent.HasCallbacks(ElementEvent::PropertyChanged))
+			return false;
+
+		scriptComponent.UpdateProperties(std::move(properties));
+		for (const std::string& propertyName : updatedProperties)
+			scriptComponent.ExecuteCallback<ElementEvent::PropertyChanged>(propertyName);
+
+		RefreshEntityBounds(uniqueId);
+
+		return true;
+	}
 }
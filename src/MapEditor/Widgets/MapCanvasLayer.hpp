@@ -7,11 +7,14 @@
 #ifndef BURGWAR_MAPEDITOR_WIDGETS_MAPWIDGETLAYER_HPP
 #define BURGWAR_MAPEDITOR_WIDGETS_MAPWIDGETLAYER_HPP
 
+#include <CoreLib/Map.hpp>
 #include <CoreLib/PropertyValues.hpp>
 #include <CoreLib/SharedLayer.hpp>
 #include <ClientLib/ClientEditorLayer.hpp>
 #include <ClientLib/LayerVisualEntity.hpp>
+#include <MapEditor/EntitySpatialIndex.hpp>
 #include <Nazara/Math/Angle.hpp>
+#include <Nazara/Math/Ray.hpp>
 #include <NDK/World.hpp>
 #include <memory>
 #include <vector>
@@ -32,15 +35,29 @@ namespace bw
 			void DeleteEntity(EntityId uniqueId);
 
 			void ForEachVisualEntity(const std::function<void(LayerVisualEntity& visualEntity)>& func) override;
+			void ForEachVisualEntityAt(const Nz::Vector2f& position, const std::function<void(LayerVisualEntity& visualEntity)>& func);
+			void ForEachVisualEntityInRect(const Nz::Rectf& rect, const std::function<void(LayerVisualEntity& visualEntity)>& func);
+			void ForEachVisualEntityOnRay(const Nz::Rayf& ray, const std::function<void(LayerVisualEntity& visualEntity)>& func);
 
 			bool IsEnabled() const override;
+			inline bool IsLoaded() const;
+
+			void Load(const Map::Layer& layerData);
+
+			void RefreshEntityBounds(EntityId uniqueId);
+
+			bool UpdateEntityProperties(EntityId uniqueId, PropertyValueMap properties);
 
 			MapCanvasLayer& operator=(const MapCanvasLayer&) = default;
 			MapCanvasLayer& operator=(MapCanvasLayer&&) = delete;
 
 		private:
+			static inline Nz::Rectf ToRect(const Nz::Boxf& box);
+
+			EntitySpatialIndex m_spatialIndex;
 			MapCanvas& m_mapCanvas;
 			tsl::hopscotch_map<EntityId, LayerVisualEntity> m_layerEntities;
+			bool m_isLoaded;
 	};
 }
 
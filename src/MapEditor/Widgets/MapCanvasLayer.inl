@@ -6,4 +6,13 @@
 
 namespace bw
 {
+	inline bool MapCanvasLayer::IsLoaded() const
+	{
+		return m_isLoaded;
+	}
+
+	inline Nz::Rectf MapCanvasLayer::ToRect(const Nz::Boxf& box)
+	{
+		return Nz::Rectf(box.x, box.y, box.width, box.height);
+	}
 }
@@ -0,0 +1,32 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <MapTool/MapToolApp.hpp>
+
+namespace bw
+{
+	MapToolApp::MapToolApp() :
+	BurgApp(LogSide::Irrelevant, m_configFile),
+	m_configFile(*this),
+	m_quitRequested(false)
+	{
+		// Tool output is printed directly, only report script and loading issues
+		GetLogger().SetMinimumLogLevel(LogLevel::Warning);
+	}
+
+	bool MapToolApp::LoadConfig(const std::filesystem::path& configPath)
+	{
+		if (!m_configFile.LoadFromFile(configPath))
+			return false;
+
+		LoadMods();
+		return true;
+	}
+
+	void MapToolApp::Quit()
+	{
+		// Maps being compiled are finished, remaining ones are skipped
+		m_quitRequested = true;
+	}
+}
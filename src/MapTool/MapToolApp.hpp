@@ -0,0 +1,38 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_MAPTOOL_MAPTOOLAPP_HPP
+#define BURGWAR_MAPTOOL_MAPTOOLAPP_HPP
+
+#include <CoreLib/BurgApp.hpp>
+#include <CoreLib/SharedAppConfig.hpp>
+#include <atomic>
+#include <filesystem>
+
+namespace bw
+{
+	// Headless application (no match, no rendering), only used for logging, config and mods
+	class MapToolApp : public BurgApp
+	{
+		public:
+			MapToolApp();
+			~MapToolApp() = default;
+
+			inline bool IsQuitRequested() const;
+
+			bool LoadConfig(const std::filesystem::path& configPath);
+
+			void Quit() override;
+
+		private:
+			SharedAppConfig m_configFile;
+			std::atomic_bool m_quitRequested;
+	};
+}
+
+#include <MapTool/MapToolApp.inl>
+
+#endif
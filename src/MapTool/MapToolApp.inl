@@ -0,0 +1,13 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <MapTool/MapToolApp.hpp>
+
+namespace bw
+{
+	inline bool MapToolApp::IsQuitRequested() const
+	{
+		return m_quitRequested;
+	}
+}
@@ -0,0 +1,146 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <MapTool/MapValidator.hpp>
+#include <CoreLib/Mod.hpp>
+#include <CoreLib/Utils.hpp>
+#include <CoreLib/LogSystem/Logger.hpp>
+#include <CoreLib/Scripting/AbstractScriptingLibrary.hpp>
+#include <CoreLib/Scripting/ScriptingContext.hpp>
+#include <CoreLib/Scripting/ServerElementLibrary.hpp>
+#include <CoreLib/Scripting/ServerEntityLibrary.hpp>
+#include <CoreLib/Utility/VirtualDirectory.hpp>
+#include <fmt/format.h>
+#include <algorithm>
+
+namespace bw
+{
+	namespace
+	{
+		// Only what entity scripts need to be declared, libraries depending on a match are left empty
+		class ValidationScriptingLibrary : public AbstractScriptingLibrary
+		{
+			public:
+				using AbstractScriptingLibrary::AbstractScriptingLibrary;
+
+				void RegisterLibrary(ScriptingContext& context) override
+				{
+					sol::state& state = context.GetLuaState();
+					state["CLIENT"] = false;
+					state["SERVER"] = true;
+
+					state.open_libraries();
+
+					for (const char* libraryName : { "game", "match", "network", "physics", "scripts", "timer" })
+						state.create_named_table(libraryName);
+
+					state["RegisterClientAssets"] = []() {}; // Dummy function
+					state["RegisterClientScript"] = []() {}; // Dummy function
+
+					RegisterGlobalLibrary(context);
+					RegisterMetatableLibrary(context);
+					RegisterRandomEngineClass(context);
+
+					context.LoadDirectory("autorun");
+				}
+		};
+
+		std::string FormatPropertyType(PropertyType type, bool isArray)
+		{
+			return (isArray) ? std::string(ToString(type)) + "[]" : std::string(ToString(type));
+		}
+	}
+
+	MapValidator::MapValidator(const Logger& logger, std::filesystem::path scriptDirectory, std::vector<std::shared_ptr<Mod>> mods) :
+	m_scriptDirectory(std::move(scriptDirectory)),
+	m_mods(std::move(mods)),
+	m_logger(logger)
+	{
+	}
+
+	std::vector<std::string> MapValidator::Validate(const Map& map)
+	{
+		// Maps can declare their own entities, which requires a dedicated store
+		bool hasEntityScripts = std::any_of(map.GetScripts().begin(), map.GetScripts().end(), [](const Map::Script& script)
+		{
+			return script.filepath.rfind("entities/", 0) == 0;
+		});
+
+		std::optional<ServerEntityStore> mapEntityStore;
+		if (hasEntityScripts)
+			LoadEntityStore(mapEntityStore, &map);
+		else if (!m_sharedEntityStore)
+			LoadEntityStore(m_sharedEntityStore, nullptr);
+
+		const ServerEntityStore& entityStore = (hasEntityScripts) ? *mapEntityStore : *m_sharedEntityStore;
+
+		std::vector<std::string> errors;
+		for (std::size_t layerIndex = 0; layerIndex < map.GetLayerCount(); ++layerIndex)
+		{
+			const auto& layer = map.GetLayer(static_cast<LayerIndex>(layerIndex));
+			for (const auto& entity : layer.entities)
+			{
+				std::string entityPrefix = fmt::format("layer #{} entity {} ({})", layerIndex, entity.uniqueId, entity.entityType);
+
+				std::size_t elementIndex = entityStore.GetElementIndex(entity.entityType);
+				if (elementIndex == ServerEntityStore::InvalidIndex)
+				{
+					errors.push_back(entityPrefix + ": unknown entity class");
+					continue;
+				}
+
+				const auto& entityClass = entityStore.GetElement(elementIndex);
+
+				for (auto&& [propertyName, propertyValue] : entity.properties)
+				{
+					auto it = entityClass->properties.find(propertyName);
+					if (it == entityClass->properties.end())
+					{
+						errors.push_back(fmt::format("{}: unknown property \"{}\"", entityPrefix, propertyName));
+						continue;
+					}
+
+					const ScriptedProperty& property = it->second;
+
+					auto [propertyType, isArray] = ExtractPropertyType(propertyValue);
+					if (propertyType != property.type || isArray != property.isArray)
+						errors.push_back(fmt::format("{}: property \"{}\" is a {} but should be a {}", entityPrefix, propertyName, FormatPropertyType(propertyType, isArray), FormatPropertyType(property.type, property.isArray)));
+				}
+
+				for (auto&& [propertyName, property] : entityClass->properties)
+				{
+					if (!property.defaultValue && entity.properties.find(propertyName) == entity.properties.end())
+						errors.push_back(fmt::format("{}: missing property \"{}\" (which has no default value)", entityPrefix, propertyName));
+				}
+			}
+		}
+
+		return errors;
+	}
+
+	void MapValidator::LoadEntityStore(std::optional<ServerEntityStore>& entityStore, const Map* map) const
+	{
+		auto scriptDirectory = std::make_shared<VirtualDirectory>(m_scriptDirectory);
+		for (const auto& modPtr : m_mods)
+		{
+			for (const auto& [scriptPath, physicalPath] : modPtr->GetScripts())
+				scriptDirectory->StoreFile(scriptPath, physicalPath);
+		}
+
+		if (map)
+		{
+			for (const auto& mapScript : map->GetScripts())
+				scriptDirectory->StoreFile(mapScript.filepath, mapScript.content);
+		}
+
+		auto scriptingContext = std::make_shared<ScriptingContext>(m_logger, std::move(scriptDirectory));
+		scriptingContext->LoadLibrary(std::make_shared<ValidationScriptingLibrary>(m_logger));
+
+		entityStore.emplace(m_logger, std::move(scriptingContext));
+		entityStore->LoadLibrary(std::make_shared<ServerElementLibrary>(m_logger));
+		entityStore->LoadLibrary(std::make_shared<ServerEntityLibrary>(m_logger));
+		entityStore->LoadDirectory("entities");
+		entityStore->Resolve();
+	}
+}
@@ -0,0 +1,49 @@
+// Copyright (C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#pragma once
+
+#ifndef BURGWAR_MAPTOOL_MAPVALIDATOR_HPP
+#define BURGWAR_MAPTOOL_MAPVALIDATOR_HPP
+
+#include <CoreLib/Map.hpp>
+#include <CoreLib/Scripting/ServerEntityStore.hpp>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace bw
+{
+	class Logger;
+	class Mod;
+
+	// Checks map entities against their scripted class (existence, property names and types) without running a match
+	class MapValidator
+	{
+		public:
+			MapValidator(const Logger& logger, std::filesystem::path scriptDirectory, std::vector<std::shared_ptr<Mod>> mods);
+			MapValidator(const MapValidator&) = delete;
+			MapValidator(MapValidator&&) = delete;
+			~MapValidator() = default;
+
+			std::vector<std::string> Validate(const Map& map);
+
+			MapValidator& operator=(const MapValidator&) = delete;
+			MapValidator& operator=(MapValidator&&) = delete;
+
+		private:
+			void LoadEntityStore(std::optional<ServerEntityStore>& entityStore, const Map* map) const;
+
+			std::filesystem::path m_scriptDirectory;
+			std::optional<ServerEntityStore> m_sharedEntityStore; //< used for maps without their own entity scripts
+			std::vector<std::shared_ptr<Mod>> m_mods;
+			const Logger& m_logger;
+	};
+}
+
+#include <MapTool/MapValidator.inl>
+
+#endif
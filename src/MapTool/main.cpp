@@ -2,27 +2,353 @@
 // This file is part of the "Burgwar" project
 // For conditions of distribution and use, see copyright notice in LICENSE
 
+#include <CoreLib/CompiledMap.hpp>
+#include <CoreLib/FileHashCache.hpp>
 #include <CoreLib/Map.hpp>
+#include <CoreLib/Mod.hpp>
+#include <CoreLib/TilemapCollisionBuilder.hpp>
+#include <CoreLib/Utils.hpp>
+#include <CoreLib/Version.hpp>
+#include <CoreLib/Utility/ThreadPool.hpp>
 #include <Main/Main.hpp>
+#include <MapTool/MapToolApp.hpp>
+#include <MapTool/MapValidator.hpp>
+#include <Nazara/Core/AbstractHash.hpp>
+#include <Nazara/Core/Clock.hpp>
+#include <Nazara/Core/File.hpp>
+#include <Nazara/Core/Initializer.hpp>
+#include <Nazara/Physics2D/Collider2D.hpp>
+#include <Nazara/Physics2D/Physics2D.hpp>
+#include <Nazara/Physics2D/PhysWorld2D.hpp>
+#include <Nazara/Physics2D/RigidBody2D.hpp>
 #include <cxxopts.hpp>
 #include <fmt/format.h>
+#include <nlohmann/json.hpp>
+#include <tsl/hopscotch_map.h>
+#include <algorithm>
 #include <filesystem>
+#include <memory>
+#include <optional>
 #include <stdexcept>
 
+namespace
+{
+	// Colliders as built by tilemap scripts before TilemapCollisionBuilder (only merging cells of the same row)
+	std::vector<Nz::Rectf> BuildRowColliders(const Nz::Vector2ui& mapSize, const Nz::Vector2f& cellSize, const bw::PropertyArrayValue<bw::PropertyType::Integer>& content)
+	{
+		std::vector<Nz::Rectf> colliders;
+		for (unsigned int y = 0; y < mapSize.y; ++y)
+		{
+			unsigned int x = 0;
+			while (x < mapSize.x)
+			{
+				if (content[y * mapSize.x + x] == 0)
+				{
+					x++;
+					continue;
+				}
+
+				unsigned int startX = x;
+				while (x < mapSize.x && content[y * mapSize.x + x] != 0)
+					x++;
+
+				colliders.emplace_back(startX * cellSize.x, y * cellSize.y, (x - startX) * cellSize.x, cellSize.y);
+			}
+		}
+
+		return colliders;
+	}
+
+	// Drops a grid of balls on the colliders and returns the mean physics step duration, in microseconds
+	double BenchmarkPhysicsStep(const std::vector<Nz::Rectf>& colliders, const Nz::Rectf& bounds, float ballRadius)
+	{
+		constexpr std::size_t BallCountX = 16;
+		constexpr std::size_t BallCountY = 8;
+		constexpr std::size_t StepCount = 300;
+
+		Nz::PhysWorld2D world;
+		world.SetGravity(Nz::Vector2f(0.f, 9.81f * 192.f));
+
+		std::vector<Nz::Collider2DRef> boxColliders;
+		boxColliders.reserve(colliders.size());
+		for (const Nz::Rectf& rect : colliders)
+			boxColliders.push_back(Nz::BoxCollider2D::New(rect));
+
+		Nz::RigidBody2D staticBody(&world, 0.f, Nz::CompoundCollider2D::New(std::move(boxColliders)));
+
+		std::vector<Nz::RigidBody2D> balls;
+		balls.reserve(BallCountX * BallCountY);
+		for (std::size_t y = 0; y < BallCountY; ++y)
+		{
+			for (std::size_t x = 0; x < BallCountX; ++x)
+			{
+				Nz::RigidBody2D& ball = balls.emplace_back(&world, 10.f, Nz::CircleCollider2D::New(ballRadius));
+				ball.SetPosition(Nz::Vector2f(bounds.x + bounds.width * (x + 0.5f) / BallCountX, bounds.y + bounds.height * (y + 0.5f) / BallCountY));
+			}
+		}
+
+		Nz::UInt64 startTime = Nz::GetElapsedMicroseconds();
+		for (std::size_t i = 0; i < StepCount; ++i)
+			world.Step(1.f / 60.f);
+
+		return double(Nz::GetElapsedMicroseconds() - startTime) / StepCount;
+	}
+
+	void BenchmarkTilemapColliders(const bw::Map& map)
+	{
+		Nz::Initializer<Nz::Physics2D> physics2D;
+
+		std::size_t totalRowColliders = 0;
+		std::size_t totalMergedColliders = 0;
+		for (std::size_t layerIndex = 0; layerIndex < map.GetLayerCount(); ++layerIndex)
+		{
+			const auto& layer = map.GetLayer(static_cast<bw::LayerIndex>(layerIndex));
+			for (const auto& entity : layer.entities)
+			{
+				if (entity.entityType != "entity_tilemap")
+					continue;
+
+				auto GetProperty = [&](const std::string& name) -> const bw::PropertyValue*
+				{
+					auto it = entity.properties.find(name);
+					return (it != entity.properties.end()) ? &it->second : nullptr;
+				};
+
+				const bw::PropertyValue* mapSizeProperty = GetProperty("mapSize");
+				const bw::PropertyValue* cellSizeProperty = GetProperty("cellSize");
+				const bw::PropertyValue* contentProperty = GetProperty("content");
+
+				auto* mapSizeValue = (mapSizeProperty) ? std::get_if<bw::PropertySingleValue<bw::PropertyType::IntegerSize>>(mapSizeProperty) : nullptr;
+				auto* cellSizeValue = (cellSizeProperty) ? std::get_if<bw::PropertySingleValue<bw::PropertyType::FloatSize>>(cellSizeProperty) : nullptr;
+				auto* contentValue = (contentProperty) ? std::get_if<bw::PropertyArrayValue<bw::PropertyType::Integer>>(contentProperty) : nullptr;
+				if (!mapSizeValue || !cellSizeValue || !contentValue)
+				{
+					fmt::print("- layer #{} tilemap {}: missing properties, skipped\n", layerIndex, entity.uniqueId);
+					continue;
+				}
+
+				Nz::Vector2ui mapSize(**mapSizeValue);
+				Nz::Vector2f cellSize = **cellSizeValue;
+				if (contentValue->size() < std::size_t(mapSize.x) * mapSize.y)
+				{
+					fmt::print("- layer #{} tilemap {}: content is too small, skipped\n", layerIndex, entity.uniqueId);
+					continue;
+				}
+
+				std::vector<Nz::Rectf> rowColliders = BuildRowColliders(mapSize, cellSize, *contentValue);
+
+				Nz::UInt64 buildStartTime = Nz::GetElapsedMicroseconds();
+				bw::TilemapCollisionBuilder builder(mapSize, contentValue->begin());
+				Nz::UInt64 buildTime = Nz::GetElapsedMicroseconds() - buildStartTime;
+
+				std::vector<Nz::Rectf> mergedColliders;
+				for (const Nz::Rectui& rect : builder.GetRects())
+					mergedColliders.emplace_back(rect.x * cellSize.x, rect.y * cellSize.y, rect.width * cellSize.x, rect.height * cellSize.y);
+
+				Nz::Rectf bounds(0.f, 0.f, mapSize.x * cellSize.x, mapSize.y * cellSize.y);
+				float ballRadius = std::min(cellSize.x, cellSize.y) / 4.f;
+
+				double rowStepTime = BenchmarkPhysicsStep(rowColliders, bounds, ballRadius);
+				double mergedStepTime = BenchmarkPhysicsStep(mergedColliders, bounds, ballRadius);
+
+				fmt::print("- layer #{} tilemap {} ({}x{}): {} row colliders ({:.1f}us/step) => {} merged colliders ({:.1f}us/step, built in {}us), {} outline segments\n",
+					layerIndex, entity.uniqueId, mapSize.x, mapSize.y,
+					rowColliders.size(), rowStepTime,
+					mergedColliders.size(), mergedStepTime, buildTime,
+					builder.BuildOutline().size());
+
+				totalRowColliders += rowColliders.size();
+				totalMergedColliders += mergedColliders.size();
+			}
+		}
+
+		fmt::print("\nTotal: {} row colliders => {} merged colliders\n", totalRowColliders, totalMergedColliders);
+	}
+
+	// Incremental compilation manifest (output file name => content hash of the source map)
+	constexpr const char* BuildManifestName = ".maptool.json";
+	constexpr const char* SourceHashManifestName = ".maptool_hashes.json";
+
+	tsl::hopscotch_map<std::string, std::string> LoadBuildManifest(const std::filesystem::path& manifestPath)
+	{
+		tsl::hopscotch_map<std::string, std::string> builds;
+
+		Nz::File manifestFile(manifestPath.generic_u8string(), Nz::OpenMode_ReadOnly);
+		if (!manifestFile.IsOpen())
+			return builds;
+
+		std::vector<Nz::UInt8> content(manifestFile.GetSize());
+		if (manifestFile.Read(content.data(), content.size()) != content.size())
+			return builds;
+
+		try
+		{
+			nlohmann::json manifest = nlohmann::json::parse(content.begin(), content.end());
+			nlohmann::json maps = manifest.value("maps", nlohmann::json::object());
+			for (auto it = maps.begin(); it != maps.end(); ++it)
+				builds.emplace(it.key(), it.value().get<std::string>());
+		}
+		catch (const std::exception& e)
+		{
+			fmt::print(stderr, "failed to parse {}: {}, all maps will be compiled\n", manifestPath.generic_u8string(), e.what());
+			builds.clear();
+		}
+
+		return builds;
+	}
+
+	bool SaveBuildManifest(const std::filesystem::path& manifestPath, const tsl::hopscotch_map<std::string, std::string>& builds)
+	{
+		nlohmann::json maps = nlohmann::json::object();
+		for (auto&& [outputName, contentHash] : builds)
+			maps[outputName] = contentHash;
+
+		nlohmann::json manifest;
+		manifest["maps"] = std::move(maps);
+
+		std::string content = manifest.dump(1, '\t');
+
+		std::filesystem::path tempPath = manifestPath;
+		tempPath += ".tmp";
+
+		{
+			Nz::File manifestFile(tempPath.generic_u8string(), Nz::OpenMode_WriteOnly | Nz::OpenMode_Truncate);
+			if (!manifestFile.IsOpen() || manifestFile.Write(content.data(), content.size()) != content.size())
+				return false;
+		}
+
+		std::error_code ec;
+		std::filesystem::rename(tempPath, manifestPath, ec);
+		return !ec;
+	}
+
+	// Hashes every source file of a map (and the compiled format version), file checksums are cached by path, size and last write time
+	std::string ComputeMapContentHash(bw::FileHashCache& hashCache, const std::filesystem::path& inputPath)
+	{
+		std::vector<std::filesystem::path> filePaths;
+		if (std::filesystem::is_directory(inputPath))
+		{
+			for (const auto& entry : std::filesystem::recursive_directory_iterator(inputPath))
+			{
+				if (entry.is_regular_file())
+					filePaths.push_back(entry.path());
+			}
+
+			std::sort(filePaths.begin(), filePaths.end());
+		}
+		else
+			filePaths.push_back(inputPath);
+
+		auto fileHashes = hashCache.ComputeHashes(filePaths);
+
+		auto hash = Nz::AbstractHash::Get(Nz::HashType_SHA1);
+		hash->Begin();
+
+		Nz::UInt32 versions[] = { bw::GameVersion, bw::CompiledMap::FileVersion };
+		hash->Append(reinterpret_cast<const Nz::UInt8*>(versions), sizeof(versions));
+
+		for (std::size_t i = 0; i < filePaths.size(); ++i)
+		{
+			if (!fileHashes[i])
+				return {}; //< unreadable file, always compile
+
+			std::string relativePath = std::filesystem::relative(filePaths[i], inputPath).generic_u8string();
+			hash->Append(reinterpret_cast<const Nz::UInt8*>(relativePath.data()), relativePath.size() + 1); //< include null terminator as separator
+			hash->Append(fileHashes[i]->checksum.GetConstBuffer(), fileHashes[i]->checksum.GetSize());
+		}
+
+		return hash->End().ToHex().ToStdString();
+	}
+
+	std::size_t ComputePropertyBytes(const bw::PropertyValue& property)
+	{
+		return std::visit([&](auto&& value) -> std::size_t
+		{
+			using T = std::decay_t<decltype(value)>;
+			using PropertyTypeExtractor = bw::PropertyTypeExtractor<T>;
+			using UnderlyingType = typename PropertyTypeExtractor::UnderlyingType;
+
+			if constexpr (PropertyTypeExtractor::IsArray)
+			{
+				if constexpr (std::is_same_v<UnderlyingType, std::string>)
+				{
+					std::size_t byteCount = 0;
+					for (const std::string& str : value)
+						byteCount += str.size();
+
+					return byteCount;
+				}
+				else
+					return value.GetSize() * sizeof(UnderlyingType);
+			}
+			else if constexpr (std::is_same_v<UnderlyingType, std::string>)
+				return (*value).size();
+			else
+				return sizeof(UnderlyingType);
+		}, property);
+	}
+
+	void PrintMapStats(const std::string& inputMap, const bw::Map& map)
+	{
+		std::size_t totalEntityCount = 0;
+		std::size_t totalPropertyBytes = 0;
+
+		fmt::print("{} size statistics:\n", inputMap);
+		for (std::size_t layerIndex = 0; layerIndex < map.GetLayerCount(); ++layerIndex)
+		{
+			const auto& layer = map.GetLayer(static_cast<bw::LayerIndex>(layerIndex));
+
+			std::size_t propertyCount = 0;
+			std::size_t propertyBytes = 0;
+			for (const auto& entity : layer.entities)
+			{
+				for (auto&& [propertyName, propertyValue] : entity.properties)
+				{
+					propertyBytes += propertyName.size() + ComputePropertyBytes(propertyValue);
+					propertyCount++;
+				}
+			}
+
+			fmt::print("- layer #{} ({}): {} entities, {} properties ({})\n", layerIndex, layer.name, layer.entities.size(), propertyCount, bw::ByteToString(propertyBytes));
+
+			totalEntityCount += layer.entities.size();
+			totalPropertyBytes += propertyBytes;
+		}
+
+		Nz::UInt64 assetBytes = 0;
+		for (const auto& asset : map.GetAssets())
+			assetBytes += asset.size;
+
+		std::size_t scriptBytes = 0;
+		for (const auto& script : map.GetScripts())
+			scriptBytes += script.content.size();
+
+		fmt::print("- total: {} entities, {} of properties, {} asset(s) ({}), {} script(s) ({})\n", totalEntityCount, bw::ByteToString(totalPropertyBytes), map.GetAssets().size(), bw::ByteToString(assetBytes), map.GetScripts().size(), bw::ByteToString(scriptBytes));
+	}
+}
+
 int BurgWarMapTool(int argc, char* argv[])
 {
 	cxxopts::Options options("BurgWarMapTool", "Tool for compiling BurgWar maps in CLI");
 	options.add_options()
+		("b,benchmark-colliders", "Build tilemap colliders and compare collider counts and physics step times")
 		("c,compile", "Compile input maps to binary map format")
+		("config", "Config file used to find scripts and mods when validating maps", cxxopts::value<std::string>()->default_value("serverconfig.lua"), "path")
+		("incremental", "Only compile maps whose content changed since they were last compiled to the output folder")
 		("i,input", "Input file(s)", cxxopts::value<std::vector<std::string>>())
+		("j,jobs", "Number of maps compiled in parallel (0 = one per core)", cxxopts::value<unsigned int>()->default_value("0"), "count")
 		("o,output", "Output folder", cxxopts::value<std::string>()->default_value("."), "path")
 		("s,show", "Show informations about the map (default)")
+		("stats", "Show size statistics of the map (entities per layer, property, asset and script bytes)")
+		("validate", "Validate entity classes and properties against the scripts (and mods) of the config file")
 		("h,help", "Print usage")
 	;
 
 	options.parse_positional("input");
 	options.positional_help("MAPS");
 
+	bool hasErrors = false;
+
 	try
 	{
 		auto result = options.parse(argc, argv);
@@ -38,32 +364,164 @@ int BurgWarMapTool(int argc, char* argv[])
 			return EXIT_SUCCESS;
 		}
 
+		bool benchmarkColliders = (result.count("benchmark-colliders") > 0);
+		bool compile = (result.count("compile") > 0);
+		bool incremental = (result.count("incremental") > 0);
+		bool showStats = (result.count("stats") > 0);
+		bool validate = (result.count("validate") > 0);
+
+		bw::MapToolApp app;
+
+		std::optional<bw::MapValidator> validator;
+		if (validate)
+		{
+			const std::string& configPath = result["config"].as<std::string>();
+			if (!app.LoadConfig(configPath))
+			{
+				fmt::print(stderr, "failed to load config file {}\n", configPath);
+				return EXIT_FAILURE;
+			}
+
+			std::vector<std::shared_ptr<bw::Mod>> mods;
+			for (auto&& [modId, modPtr] : app.GetMods())
+				mods.push_back(modPtr);
+
+			validator.emplace(app.GetLogger(), std::filesystem::u8path(app.GetConfig().GetStringValue("Resources.ScriptDirectory")), std::move(mods));
+		}
+
+		struct CompileJob
+		{
+			std::filesystem::path outputPath;
+			std::string contentHash;
+			std::string inputMap;
+			Nz::UInt64 outputSize = 0;
+			bool succeeded = false;
+		};
+
 		std::vector<std::string> inputMaps = result["input"].as<std::vector<std::string>>();
+
+		// Maps are loaded and validated on this thread (scripting isn't thread-safe), compilation happens in parallel
+		std::filesystem::path outputFolder = result["output"].as<std::string>();
+		std::size_t upToDateMapCount = 0;
+		std::vector<CompileJob> compileJobs;
+		std::optional<bw::FileHashCache> sourceHashCache;
+		std::optional<bw::ThreadPool> compilePool; //< destroyed before the jobs its tasks reference
+		tsl::hopscotch_map<std::string, std::string> previousBuilds;
+
+		if (compile)
+		{
+			if (!std::filesystem::is_directory(outputFolder))
+				std::filesystem::create_directories(outputFolder);
+
+			if (incremental)
+			{
+				sourceHashCache.emplace(app.GetLogger(), outputFolder / SourceHashManifestName);
+				sourceHashCache->Load();
+
+				previousBuilds = LoadBuildManifest(outputFolder / BuildManifestName);
+			}
+
+			unsigned int jobCount = result["jobs"].as<unsigned int>();
+			if (jobCount == 0)
+				jobCount = static_cast<unsigned int>(bw::ThreadPool::GetDefaultWorkerCount());
+
+			compilePool.emplace(std::min<std::size_t>(jobCount, inputMaps.size()), "MapCompile");
+			compileJobs.reserve(inputMaps.size()); //< jobs are referenced by compilation tasks
+		}
+
 		for (const std::string& inputMap : inputMaps)
 		{
+			if (app.IsQuitRequested())
+				break;
+
 			std::filesystem::path inputPath = inputMap;
 			std::filesystem::path mapName;
 
-			if (inputMaps.size() > 1)
+			if (inputMaps.size() > 1 && !compile)
 				fmt::print("--- {0} ---\n", inputPath.generic_u8string());
 
+			// Compiled maps can be inspected without decoding their entities
+			if (!compile && !benchmarkColliders && !showStats && !validate && std::filesystem::is_regular_file(inputPath))
+			{
+				try
+				{
+					if (bw::CompiledMap::ReadFileVersion(inputPath) >= 2)
+					{
+						bw::CompiledMap compiledMap(inputPath);
+						const auto& mapInfo = compiledMap.GetMapInfo();
+
+						fmt::print("{input_map} info:\n- Name: {name}\n- Description: {desc}\n- Author: {author}\n", 
+							fmt::arg("input_map", inputMap), 
+							fmt::arg("name", mapInfo.name), 
+							fmt::arg("desc", mapInfo.description), 
+							fmt::arg("author", mapInfo.author));
+
+						std::size_t layerCount = compiledMap.GetLayerCount();
+						fmt::print("\nThis map has {} layer(s):\n", layerCount);
+						for (std::size_t i = 0; i < layerCount; ++i)
+						{
+							auto layerInfo = compiledMap.GetLayerInfo(static_cast<bw::LayerIndex>(i));
+							fmt::print("- layer #{} ({}) has {} entities\n", i, layerInfo.name, layerInfo.entityCount);
+						}
+
+						fmt::print("\nThis map has {} script(s) and {} asset(s)\n", compiledMap.GetScriptCount(), compiledMap.GetAssetCount());
+						continue;
+					}
+				}
+				catch (const std::exception& e)
+				{
+					fmt::print(stderr, "{0}: {1}\n", inputMap, e.what());
+					hasErrors = true;
+					continue;
+				}
+			}
+
+			bool isDirectory = std::filesystem::is_directory(inputPath);
+			if (isDirectory)
+			{
+				if (inputPath.has_filename())
+					mapName = inputPath.filename(); //< foo/bar => bar
+				else
+					mapName = inputPath.parent_path().filename(); //< foo/bar/ => bar
+			}
+			else
+				mapName = inputPath.stem(); //< foo/bar.bmap => bar
+
+			std::filesystem::path outputPath;
+			std::string contentHash;
+			bool isUpToDate = false;
+			if (compile)
+			{
+				outputPath = outputFolder / mapName;
+				if (outputPath.extension() != "bmap")
+					outputPath += ".bmap";
+
+				// Unchanged maps don't even need to be loaded (unless they have to be validated or inspected)
+				if (sourceHashCache && std::filesystem::exists(inputPath))
+				{
+					contentHash = ComputeMapContentHash(*sourceHashCache, inputPath);
+
+					auto it = previousBuilds.find(outputPath.filename().generic_u8string());
+					if (!contentHash.empty() && it != previousBuilds.end() && it->second == contentHash && std::filesystem::is_regular_file(outputPath))
+					{
+						fmt::print("{0} is up to date\n", inputMap);
+						upToDateMapCount++;
+						isUpToDate = true;
+
+						if (!validate && !showStats)
+							continue;
+					}
+				}
+			}
+
 			bw::Map map;
 
 			try
 			{
-				if (std::filesystem::is_directory(inputPath))
-				{
+				if (isDirectory)
 					map = bw::Map::LoadFromDirectory(inputPath);
-					if (inputPath.has_filename())
-						mapName = inputPath.filename(); //< foo/bar => bar
-					else
-						mapName = inputPath.parent_path().filename(); //< foo/bar/ => bar
-				}
 				else if (std::filesystem::is_regular_file(inputPath))
-				{
 					map = bw::Map::LoadFromBinary(inputPath);
-					mapName = inputPath.stem(); //< foo/bar.bmap => bar
-				}
 				else if (std::filesystem::exists(inputPath))
 					throw std::runtime_error(inputMap + " is neither a directory nor a binary");
 				else
@@ -72,25 +530,57 @@ int BurgWarMapTool(int argc, char* argv[])
 			catch (const std::exception& e)
 			{
 				fmt::print(stderr, "{0}: {1}\n", inputMap, e.what());
+				hasErrors = true;
 				continue;
 			}
 
-			if (result.count("compile") > 0)
+			if (validator)
 			{
-				std::filesystem::path outputPath = result["output"].as<std::string>();
-				if (!std::filesystem::is_directory(outputPath))
-					std::filesystem::create_directories(outputPath);
+				std::vector<std::string> errors = validator->Validate(map);
+				for (const std::string& error : errors)
+					fmt::print(stderr, "{0}: {1}\n", inputMap, error);
 
-				outputPath /= mapName;
-				if (outputPath.extension() != "bmap")
-					outputPath += ".bmap";
+				if (!errors.empty())
+				{
+					hasErrors = true;
+
+					if (compile)
+					{
+						fmt::print(stderr, "{0}: {1} validation error(s), map will not be compiled\n", inputMap, errors.size());
+						continue;
+					}
+				}
+				else
+					fmt::print("{0}: validation passed\n", inputMap);
+			}
 
-				if (!map.Compile(outputPath))
-					throw std::runtime_error("failed to compile map: failed to open " + outputPath.generic_u8string());
+			if (showStats)
+				PrintMapStats(inputMap, map);
+
+			if (compile)
+			{
+				if (isUpToDate)
+					continue;
 
-				fmt::print("successfully compiled map {0} to {1}\n", inputMap, outputPath.generic_u8string());
+				CompileJob& compileJob = compileJobs.emplace_back();
+				compileJob.contentHash = std::move(contentHash);
+				compileJob.inputMap = inputMap;
+				compileJob.outputPath = std::move(outputPath);
+
+				// Each task only writes to its own job
+				compilePool->PushTask([&compileJob, mapPtr = std::make_shared<bw::Map>(std::move(map))]
+				{
+					compileJob.succeeded = mapPtr->Compile(compileJob.outputPath);
+					if (compileJob.succeeded)
+					{
+						std::error_code ec;
+						compileJob.outputSize = std::filesystem::file_size(compileJob.outputPath, ec);
+					}
+				});
 			}
-			else
+			else if (benchmarkColliders)
+				BenchmarkTilemapColliders(map);
+			else if (!showStats && !validate)
 			{
 				// Show info about the map
 				const auto& mapInfo = map.GetMapInfo();
@@ -110,17 +600,53 @@ int BurgWarMapTool(int argc, char* argv[])
 				}
 			}
 		}
+
+		if (compilePool)
+		{
+			compilePool->WaitForAll();
+
+			std::size_t compiledMapCount = 0;
+			for (const CompileJob& compileJob : compileJobs)
+			{
+				if (compileJob.succeeded)
+				{
+					fmt::print("successfully compiled map {0} to {1} ({2})\n", compileJob.inputMap, compileJob.outputPath.generic_u8string(), bw::ByteToString(compileJob.outputSize));
+					compiledMapCount++;
+
+					if (!compileJob.contentHash.empty())
+						previousBuilds[compileJob.outputPath.filename().generic_u8string()] = compileJob.contentHash;
+				}
+				else
+				{
+					fmt::print(stderr, "failed to compile map {0} to {1}\n", compileJob.inputMap, compileJob.outputPath.generic_u8string());
+					hasErrors = true;
+				}
+			}
+
+			if (sourceHashCache)
+			{
+				sourceHashCache->Save();
+
+				if (!SaveBuildManifest(outputFolder / BuildManifestName, previousBuilds))
+					fmt::print(stderr, "failed to save {0}\n", (outputFolder / BuildManifestName).generic_u8string());
+			}
+
+			if (inputMaps.size() > 1)
+				fmt::print("\n{0} map(s) compiled, {1} up to date, {2} not compiled\n", compiledMapCount, upToDateMapCount, inputMaps.size() - compiledMapCount - upToDateMapCount);
+		}
 	}
 	catch (const cxxopts::OptionException& e)
 	{
 		fmt::print(stderr, "{}\n{}\n", e.what(), options.help());
+		return EXIT_FAILURE;
 	}
 	catch (const std::exception& e)
 	{
 		fmt::print(stderr, "{}\n", e.what());
+		return EXIT_FAILURE;
 	}
 
-	return EXIT_SUCCESS;
+	return (hasErrors) ? EXIT_FAILURE : EXIT_SUCCESS;
 }
 
 BurgWarMain(BurgWarMapTool)
@@ -3,24 +3,98 @@
 // For conditions of distribution and use, see copyright notice in LICENSE
 
 #include <Server/ServerApp.hpp>
+#include <CoreLib/MatchReplayReader.hpp>
+#include <CoreLib/Utils.hpp>
+#include <CoreLib/LogSystem/Logger.hpp>
+#include <Nazara/Core/Clock.hpp>
+#include <cxxopts.hpp>
+#include <algorithm>
+#include <array>
+#include <ctime>
+#include <filesystem>
+#include <numeric>
 #include <thread>
+#include <vector>
 
 namespace bw
 {
+	namespace
+	{
+		Map LoadMap(const std::string& mapPath)
+		{
+			if (!EndsWith(mapPath, ".bmap"))
+			{
+				if (std::filesystem::is_directory(mapPath))
+					return Map::LoadFromDirectory(mapPath);
+				else
+					return Map::LoadFromBinary(mapPath + ".bmap");
+			}
+			else
+				return Map::LoadFromBinary(mapPath);
+		}
+	}
+
 	ServerApp::ServerApp(int argc, char* argv[]) :
 	Application(argc, argv),
 	BurgApp(LogSide::Server, m_configFile),
-	m_configFile(*this)
+	m_configFile(*this),
+	m_replayManager(nullptr)
 	{
 		if (!m_configFile.LoadFromFile("serverconfig.lua"))
 			throw std::runtime_error("failed to load config file");
 
+		cxxopts::Options options("BurgWarServer", "BurgWar dedicated server");
+		options.allow_unrecognised_options();
+		options.add_options()
+			("replay", "Play a match replay back as fast as possible and print tick timings", cxxopts::value<std::string>(), "file")
+			("replay-map", "Map to use instead of the one stored in the replay", cxxopts::value<std::string>(), "path")
+		;
+
+		auto commandLine = options.parse(argc, argv);
+
 		LoadMods();
 
+		if (commandLine.count("replay") > 0)
+		{
+			MatchReplayReader replayReader(std::filesystem::u8path(commandLine["replay"].as<std::string>()));
+			const MatchReplayInfo& replayInfo = replayReader.GetInfo();
+
+			Match::GamemodeSettings gamemodeSettings;
+			gamemodeSettings.name = replayInfo.gamemode;
+
+			Match::MatchSettings matchSettings;
+			matchSettings.sleepWhenEmpty = replayInfo.sleepWhenEmpty;
+			matchSettings.maxPlayerCount = replayInfo.maxPlayerCount;
+			matchSettings.name = replayInfo.name;
+			matchSettings.port = 0;
+			matchSettings.randomSeed = replayInfo.randomSeed;
+			matchSettings.registerToMasterServer = false;
+			matchSettings.tickDuration = replayInfo.tickDuration;
+			matchSettings.mapPath = (commandLine.count("replay-map") > 0) ? commandLine["replay-map"].as<std::string>() : replayInfo.mapPath;
+			matchSettings.map = LoadMap(matchSettings.mapPath);
+
+			if (Map::Serialize(matchSettings.map) != replayInfo.map)
+				bwLog(GetLogger(), LogLevel::Warning, "map {0} differs from the one the replay was recorded with, playback may diverge", matchSettings.mapPath);
+
+			Match::ModSettings modSettings;
+			for (const std::string& modId : replayInfo.mods)
+			{
+				if (GetMods().find(modId) != GetMods().end())
+					modSettings.enabledMods[modId] = Match::ModSettings::ModEntry{};
+				else
+					bwLog(GetLogger(), LogLevel::Warning, "replay was recorded with mod {0} which is not installed, playback may diverge", modId);
+			}
+
+			m_match = std::make_unique<Match>(*this, std::move(matchSettings), std::move(gamemodeSettings), std::move(modSettings));
+			m_replayManager = m_match->GetSessions().CreateSessionManager<ReplaySessionManager>(std::move(replayReader));
+			return;
+		}
+
 		Nz::UInt16 maxPlayerCount = m_configFile.GetIntegerValue<Nz::UInt16>("ServerSettings.MaxPlayerCount");
 		Nz::UInt16 serverPort = m_configFile.GetIntegerValue<Nz::UInt16>("ServerSettings.Port");
 		const std::string& gamemode = m_configFile.GetStringValue("ServerSettings.Gamemode");
 		const std::string& mapPath = m_configFile.GetStringValue("ServerSettings.MapPath");
+		const std::string& replayDirectory = m_configFile.GetStringValue("ServerSettings.ReplayDirectory");
 		const std::string& serverDesc = m_configFile.GetStringValue("ServerSettings.Description");
 		const std::string& serverName = m_configFile.GetStringValue("ServerSettings.Name");
 		float tickRate = m_configFile.GetFloatValue<float>("ServerSettings.TickRate");
@@ -36,17 +110,19 @@ namespace bw
 		matchSettings.name = serverName;
 		matchSettings.port = serverPort;
 		matchSettings.tickDuration = 1.f / tickRate;
+		matchSettings.mapPath = mapPath;
 
-		// Load map
-		if (!EndsWith(mapPath, ".bmap"))
+		if (!replayDirectory.empty())
 		{
-			if (std::filesystem::is_directory(mapPath))
-				matchSettings.map = Map::LoadFromDirectory(mapPath);
-			else
-				matchSettings.map = Map::LoadFromBinary(mapPath + ".bmap");
+			std::time_t now = std::time(nullptr);
+			std::array<char, 32> timeStr;
+			std::strftime(timeStr.data(), timeStr.size(), "%Y%m%d_%H%M%S", std::localtime(&now));
+
+			matchSettings.replayFile = std::filesystem::u8path(replayDirectory) / ("match_" + std::string(timeStr.data()) + ".bwreplay");
 		}
-		else
-			matchSettings.map = Map::LoadFromBinary(mapPath);
+
+		// Load map
+		matchSettings.map = LoadMap(mapPath);
 
 		Match::ModSettings modSettings;
 
@@ -59,6 +135,9 @@ namespace bw
 
 	int ServerApp::Run()
 	{
+		if (m_replayManager)
+			return RunReplay();
+
 		Nz::Clock updateClock;
 		Nz::UInt64 tickDuration = static_cast<Nz::UInt64>(m_match->GetTickDuration() * 1'000'000);
 
@@ -87,6 +166,49 @@ namespace bw
 		return 0;
 	}
 	
+	int ServerApp::RunReplay()
+	{
+		float tickDuration = m_match->GetTickDuration();
+
+		// Each update runs exactly one tick, as fast as possible
+		std::vector<Nz::UInt64> updateDurations;
+		Nz::UInt64 startTime = Nz::GetElapsedMicroseconds();
+		while (Application::Run() && !m_replayManager->IsFinished())
+		{
+			BurgApp::Update();
+
+			Nz::UInt64 updateStartTime = Nz::GetElapsedMicroseconds();
+			if (!m_match->Update(tickDuration))
+				break;
+
+			updateDurations.push_back(Nz::GetElapsedMicroseconds() - updateStartTime);
+		}
+		Nz::UInt64 totalTime = Nz::GetElapsedMicroseconds() - startTime;
+
+		if (updateDurations.empty())
+		{
+			bwLog(GetLogger(), LogLevel::Warning, "replay has no tick to play");
+			return 0;
+		}
+
+		double matchDuration = updateDurations.size() * tickDuration;
+		double playbackDuration = totalTime / 1'000'000.0;
+		bwLog(GetLogger(), LogLevel::Info, "replay finished: {0} ticks ({1:.1f}s of match) played in {2:.2f}s ({3:.1f}x realtime)", updateDurations.size(), matchDuration, playbackDuration, matchDuration / playbackDuration);
+
+		Nz::UInt64 totalUpdateTime = std::accumulate(updateDurations.begin(), updateDurations.end(), Nz::UInt64(0));
+		std::sort(updateDurations.begin(), updateDurations.end());
+
+		auto Percentile = [&](double percentile)
+		{
+			std::size_t index = static_cast<std::size_t>(percentile * updateDurations.size());
+			return updateDurations[std::min(index, updateDurations.size() - 1)];
+		};
+
+		bwLog(GetLogger(), LogLevel::Info, "tick time (us): mean {0}, p50 {1}, p95 {2}, p99 {3}, max {4}", totalUpdateTime / updateDurations.size(), Percentile(0.5), Percentile(0.95), Percentile(0.99), updateDurations.back());
+
+		return 0;
+	}
+
 	void ServerApp::Quit()
 	{
 		Application::Quit();
@@ -9,6 +9,7 @@
 
 #include <CoreLib/BurgApp.hpp>
 #include <CoreLib/Match.hpp>
+#include <CoreLib/ReplaySessionManager.hpp>
 #include <Server/ServerAppConfig.hpp>
 #include <NDK/Application.hpp>
 #include <memory>
@@ -25,8 +26,11 @@ namespace bw
 			void Quit() override;
 
 		private:
+			int RunReplay();
+
 			ServerAppConfig m_configFile;
 			std::unique_ptr<Match> m_match;
+			ReplaySessionManager* m_replayManager;
 	};
 }
 
@@ -14,6 +14,7 @@ namespace bw
 		RegisterStringOption("ServerSettings.MapPath");
 		RegisterIntegerOption("ServerSettings.MaxPlayerCount", 1, 0xFFFF, 16);
 		RegisterIntegerOption("ServerSettings.Port", 1, 0xFFFF, 14768);
+		RegisterStringOption("ServerSettings.ReplayDirectory", "");
 		RegisterBoolOption("ServerSettings.SleepWhenEmpty", true);
 
 		RegisterStringOption("ServerSettings.Description", "", [](std::string value) -> tl::expected<std::string, std::string>
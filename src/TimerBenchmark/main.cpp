@@ -0,0 +1,207 @@
+// Copyright(C) 2020 Jérôme Leclercq
+// This file is part of the "Burgwar" project
+// For conditions of distribution and use, see copyright notice in LICENSE
+
+#include <CoreLib/TimerManager.hpp>
+#include <Main/Main.hpp>
+#include <Nazara/Core/Clock.hpp>
+#include <cxxopts.hpp>
+#include <fmt/format.h>
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// TimerManager as it was before storing timers in a heap (unsorted vector, scanned and erased from each update)
+	class VectorTimerManager
+	{
+		public:
+			using Callback = bw::TimerManager::Callback;
+			using TimerId = bw::TimerManager::TimerId;
+
+			bool Cancel(TimerId timerId)
+			{
+				// The vector version had no cancellation, this is what erasing a timer from it would cost
+				auto it = std::find_if(m_pendingTimers.begin(), m_pendingTimers.end(), [&](const Timer& timer) { return timer.timerId == timerId; });
+				if (it == m_pendingTimers.end())
+					return false;
+
+				m_pendingTimers.erase(it);
+				return true;
+			}
+
+			TimerId PushCallback(Nz::UInt64 expirationTime, Callback callback)
+			{
+				Timer& timer = m_pendingTimers.emplace_back();
+				timer.callback = std::move(callback);
+				timer.expirationTime = expirationTime;
+				timer.timerId = m_nextTimerId++;
+
+				return timer.timerId;
+			}
+
+			void Update(Nz::UInt64 now)
+			{
+				// Use index instead of iterator because callback may push new timers
+				for (std::size_t i = 0; i < m_pendingTimers.size();)
+				{
+					if (now > m_pendingTimers[i].expirationTime)
+					{
+						auto it = m_pendingTimers.begin() + i;
+
+						Timer timer = std::move(*it);
+						m_pendingTimers.erase(it);
+						timer.callback();
+					}
+					else
+						++i;
+				}
+			}
+
+		private:
+			struct Timer
+			{
+				Callback callback;
+				Nz::UInt64 expirationTime;
+				TimerId timerId;
+			};
+
+			std::vector<Timer> m_pendingTimers;
+			TimerId m_nextTimerId = 1;
+	};
+
+	struct BenchmarkResult
+	{
+		double cancelTime;
+		double expiryTime;
+		double pushTime;
+		double sameTickExpiryTime;
+	};
+
+	double ElapsedMilliseconds(Nz::UInt64 startTime)
+	{
+		return (Nz::GetElapsedMicroseconds() - startTime) / 1000.0;
+	}
+
+	template<typename T>
+	BenchmarkResult RunBenchmark(const std::vector<Nz::UInt64>& expirationTimes, Nz::UInt64 tickCount, unsigned int seed)
+	{
+		BenchmarkResult result;
+
+		std::size_t triggerCount = 0;
+		auto callback = [&] { triggerCount++; };
+
+		// Timers spread over the ticks, updated once per tick like a match does
+		{
+			T timerManager;
+
+			Nz::UInt64 startTime = Nz::GetElapsedMicroseconds();
+			for (Nz::UInt64 expirationTime : expirationTimes)
+				timerManager.PushCallback(expirationTime, callback);
+
+			result.pushTime = ElapsedMilliseconds(startTime);
+
+			startTime = Nz::GetElapsedMicroseconds();
+			for (Nz::UInt64 tick = 0; tick <= tickCount; ++tick)
+				timerManager.Update(tick);
+
+			result.expiryTime = ElapsedMilliseconds(startTime);
+		}
+
+		// Every timer firing on the same tick
+		{
+			T timerManager;
+			for (std::size_t i = 0; i < expirationTimes.size(); ++i)
+				timerManager.PushCallback(0, callback);
+
+			Nz::UInt64 startTime = Nz::GetElapsedMicroseconds();
+			timerManager.Update(1);
+
+			result.sameTickExpiryTime = ElapsedMilliseconds(startTime);
+		}
+
+		// Half of the timers cancelled, in random order
+		{
+			T timerManager;
+
+			std::vector<typename T::TimerId> timerIds;
+			timerIds.reserve(expirationTimes.size());
+			for (Nz::UInt64 expirationTime : expirationTimes)
+				timerIds.push_back(timerManager.PushCallback(expirationTime, callback));
+
+			std::shuffle(timerIds.begin(), timerIds.end(), std::mt19937(seed));
+			timerIds.resize(timerIds.size() / 2);
+
+			Nz::UInt64 startTime = Nz::GetElapsedMicroseconds();
+			for (typename T::TimerId timerId : timerIds)
+				timerManager.Cancel(timerId);
+
+			result.cancelTime = ElapsedMilliseconds(startTime);
+		}
+
+		if (triggerCount != 2 * expirationTimes.size())
+			throw std::runtime_error(std::to_string(triggerCount) + " timers triggered, expected " + std::to_string(2 * expirationTimes.size()));
+
+		return result;
+	}
+}
+
+int BurgWarTimerBenchmark(int argc, char* argv[])
+{
+	cxxopts::Options options("BurgWarTimerBenchmark", "Compares the heap-based TimerManager against the previous vector implementation");
+	options.add_options()
+		("n,count", "Number of timers", cxxopts::value<std::size_t>()->default_value("100000"), "count")
+		("seed", "Random seed used for expiration times and cancellation order", cxxopts::value<unsigned int>()->default_value("42"), "seed")
+		("t,ticks", "Number of ticks timers expire over", cxxopts::value<Nz::UInt64>()->default_value("1000"), "count")
+		("h,help", "Print usage")
+	;
+
+	try
+	{
+		auto result = options.parse(argc, argv);
+		if (result.count("help") > 0)
+		{
+			fmt::print("{}\n", options.help());
+			return EXIT_SUCCESS;
+		}
+
+		std::size_t timerCount = result["count"].as<std::size_t>();
+		unsigned int seed = result["seed"].as<unsigned int>();
+		Nz::UInt64 tickCount = std::max<Nz::UInt64>(result["ticks"].as<Nz::UInt64>(), 1);
+
+		std::mt19937 randomGenerator(seed);
+		std::uniform_int_distribution<Nz::UInt64> tickDistribution(0, tickCount - 1);
+
+		std::vector<Nz::UInt64> expirationTimes(timerCount);
+		for (Nz::UInt64& expirationTime : expirationTimes)
+			expirationTime = tickDistribution(randomGenerator);
+
+		fmt::print("{} timers expiring over {} ticks\n", timerCount, tickCount);
+
+		BenchmarkResult vectorResult = RunBenchmark<VectorTimerManager>(expirationTimes, tickCount, seed);
+		BenchmarkResult heapResult = RunBenchmark<bw::TimerManager>(expirationTimes, tickCount, seed);
+
+		auto PrintRow = [](const char* name, double vectorTime, double heapTime)
+		{
+			fmt::print("{:<20}{:>12.2f}ms{:>12.2f}ms\n", name, vectorTime, heapTime);
+		};
+
+		fmt::print("\n{:<20}{:>14}{:>14}\n", "", "vector", "heap");
+		PrintRow("push", vectorResult.pushTime, heapResult.pushTime);
+		PrintRow("expiry", vectorResult.expiryTime, heapResult.expiryTime);
+		PrintRow("expiry (same tick)", vectorResult.sameTickExpiryTime, heapResult.sameTickExpiryTime);
+		PrintRow("cancel (half)", vectorResult.cancelTime, heapResult.cancelTime);
+	}
+	catch (const std::exception& e)
+	{
+		fmt::print(stderr, "{}\n", e.what());
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
+
+BurgWarMain(BurgWarTimerBenchmark)
@@ -228,7 +228,7 @@ target("BurgWarServer")
 	add_deps("Main", "CoreLib")
 	add_headerfiles("src/Server/**.hpp", "src/Server/**.inl")
 	add_files("src/Server/**.cpp")
-	add_packages("nazaraserver")
+	add_packages("cxxopts", "nazaraserver")
 
 	after_install(function (target)
 		os.vcp("serverconfig.lua", path.join(target:installdir(), "bin"))
@@ -246,6 +246,28 @@ target("BurgWarMapTool")
 	add_files("src/MapTool/**.cpp")
 	add_packages("cxxopts", "nazaraserver")
 
+target("BurgWarEventLogTool")
+	set_group("Executable")
+	set_basename("eventlogtool")
+
+	set_kind("binary")
+	add_rules("install_symbolfile")
+
+	add_deps("Main", "CoreLib")
+	add_files("src/EventLogTool/**.cpp")
+	add_packages("cxxopts", "nazaraserver")
+
+target("BurgWarTimerBenchmark")
+	set_group("Executable")
+	set_basename("timerbenchmark")
+
+	set_kind("binary")
+	add_rules("install_symbolfile")
+
+	add_deps("Main", "CoreLib")
+	add_files("src/TimerBenchmark/**.cpp")
+	add_packages("cxxopts", "nazaraserver")
+
 if has_config("build_mapeditor") then
 	target("BurgWarMapEditor")
 		set_group("Executable")